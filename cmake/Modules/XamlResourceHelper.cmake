@@ -1,13 +1,34 @@
-# target_add_rc(target FILES <file1> [file2 ...] DESTINATION <path> DEPENDS <depend1> [depend2 ...] WORKING_DIRECTORY)
+# target_add_rc(target FILES <file1> [file2 ...] DESTINATION <path> DEPENDS <depend1> [depend2 ...] WORKING_DIRECTORY [PACK] [PACK_FILE <path>] [BINARY hex|incbin|embed])
+# PACK compresses the resources into one blob embedded in the output;
+# PACK_FILE writes the blob to the path instead, which is mapped by its file name from the directory
+# of the executable when loaded, so it should be written to or installed beside the executable.
+# The output registers its resources with xaml_resource, so the target is linked to it privately,
+# and should use the keyword signature of target_link_libraries too.
+# BINARY chooses how the binary files are embedded without PACK; incbin and embed refer to the files instead of parsing hex.
 function(target_add_rc target)
-    set(TARGET_ADD_RC_ONE_VALUE_ARGS DESTINATION WORKING_DIRECTORY)
+    set(TARGET_ADD_RC_OPTIONS PACK)
+    set(TARGET_ADD_RC_ONE_VALUE_ARGS DESTINATION WORKING_DIRECTORY PACK_FILE BINARY)
     set(TARGET_ADD_RC_MULTI_VALUE_ARGS FILES DEPENDS)
-    cmake_parse_arguments(TARGET_ADD_RC "" "${TARGET_ADD_RC_ONE_VALUE_ARGS}" "${TARGET_ADD_RC_MULTI_VALUE_ARGS}" ${ARGN})
+    cmake_parse_arguments(TARGET_ADD_RC "${TARGET_ADD_RC_OPTIONS}" "${TARGET_ADD_RC_ONE_VALUE_ARGS}" "${TARGET_ADD_RC_MULTI_VALUE_ARGS}" ${ARGN})
+    set(TARGET_ADD_RC_OUTPUTS ${TARGET_ADD_RC_DESTINATION})
+    set(TARGET_ADD_RC_FLAGS)
+    if(TARGET_ADD_RC_PACK_FILE)
+        list(APPEND TARGET_ADD_RC_OUTPUTS ${TARGET_ADD_RC_PACK_FILE})
+        list(APPEND TARGET_ADD_RC_FLAGS --pack-file ${TARGET_ADD_RC_PACK_FILE})
+    elseif(TARGET_ADD_RC_PACK)
+        list(APPEND TARGET_ADD_RC_FLAGS --pack)
+    endif()
+    if(TARGET_ADD_RC_BINARY)
+        list(APPEND TARGET_ADD_RC_FLAGS --binary ${TARGET_ADD_RC_BINARY})
+    endif()
+    # The output is not rewritten if nothing it depends on changes, as recorded in the manifest.
     add_custom_command(
-        OUTPUT ${TARGET_ADD_RC_DESTINATION}
+        OUTPUT ${TARGET_ADD_RC_OUTPUTS}
+        BYPRODUCTS ${TARGET_ADD_RC_DESTINATION}.manifest
         DEPENDS ${TARGET_ADD_RC_DEPENDS} ${TARGET_ADD_RC_FILES}
-        COMMAND ${XAMLRC_PATH} ${TARGET_ADD_RC_FILES} -o ${TARGET_ADD_RC_DESTINATION} --no-logo
+        COMMAND ${XAMLRC_PATH} ${TARGET_ADD_RC_FILES} -o ${TARGET_ADD_RC_DESTINATION} ${TARGET_ADD_RC_FLAGS} --no-logo
         WORKING_DIRECTORY ${TARGET_ADD_RC_WORKING_DIRECTORY}
     )
     target_sources(${target} PRIVATE ${TARGET_ADD_RC_DESTINATION})
+    target_link_libraries(${target} PRIVATE xaml_resource)
 endfunction()
@@ -5,6 +5,10 @@
 
 EXTERN_C XAML_CMDLINE_API xaml_result XAML_CALL xaml_cmdline_deserialize(xaml_type_info*, xaml_cmdline_options*, xaml_object**) XAML_NOEXCEPT;
 
+// Parses the arguments and assigns them to a new object directly, without the intermediate options.
+EXTERN_C XAML_CMDLINE_API xaml_result XAML_CALL xaml_cmdline_deserialize_args(xaml_type_info*, XAML_VECTOR_VIEW_1_NAME(xaml_string) *, xaml_object**) XAML_NOEXCEPT;
+EXTERN_C XAML_CMDLINE_API xaml_result XAML_CALL xaml_cmdline_deserialize_argv(xaml_type_info*, int, char**, xaml_object**) XAML_NOEXCEPT;
+
 #ifdef __cplusplus
 template <typename T>
 xaml_result XAML_CALL xaml_cmdline_deserialize(xaml_meta_context* ctx, xaml_vector_view<xaml_string>* args, T** ptr) noexcept
@@ -13,10 +17,8 @@ xaml_result XAML_CALL xaml_cmdline_deserialize(xaml_meta_context* ctx, xaml_vect
     XAML_RETURN_IF_FAILED(ctx->get_type<T>(&info));
     xaml_ptr<xaml_type_info> t;
     XAML_RETURN_IF_FAILED(info->query(&t));
-    xaml_ptr<xaml_cmdline_options> opts;
-    XAML_RETURN_IF_FAILED(xaml_cmdline_parse(t, args, &opts));
     xaml_ptr<xaml_object> obj;
-    XAML_RETURN_IF_FAILED(xaml_cmdline_deserialize(t, opts, &obj));
+    XAML_RETURN_IF_FAILED(xaml_cmdline_deserialize_args(t, args, &obj));
     return obj->query(ptr);
 }
 
@@ -27,10 +29,8 @@ xaml_result XAML_CALL xaml_cmdline_deserialize(xaml_meta_context* ctx, int argc,
     XAML_RETURN_IF_FAILED(ctx->get_type<T>(&info));
     xaml_ptr<xaml_type_info> t;
     XAML_RETURN_IF_FAILED(info->query(&t));
-    xaml_ptr<xaml_cmdline_options> opts;
-    XAML_RETURN_IF_FAILED(xaml_cmdline_parse_argv(t, argc, argv, &opts));
     xaml_ptr<xaml_object> obj;
-    XAML_RETURN_IF_FAILED(xaml_cmdline_deserialize(t, opts, &obj));
+    XAML_RETURN_IF_FAILED(xaml_cmdline_deserialize_argv(t, argc, argv, &obj));
     return obj->query(ptr);
 }
 #endif // __cplusplus
@@ -0,0 +1,245 @@
+#include <args.hpp>
+#include <iterator>
+#include <nowide/fstream.hpp>
+#include <sf/sformat.hpp>
+
+using namespace std;
+
+// Deep enough for any real use, and stops a file including itself.
+static constexpr int s_max_response_depth = 16;
+
+static constexpr bool is_space(char c) noexcept
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+}
+
+// Splits the content in place, so that the tokens refer to it.
+// The arguments are separated by whitespaces, and quoted by either ' or ".
+// A backslash escapes a following quote, backslash or whitespace,
+// and is kept before the other characters, which leaves Windows paths alone.
+static void split_response(string& content, vector<string_view>& tokens)
+{
+    size_t size = content.size();
+    size_t read = 0, write = 0;
+    while (true)
+    {
+        while (read < size && is_space(content[read])) read++;
+        if (read >= size) break;
+        size_t start = write;
+        char quote = '\0';
+        for (; read < size; read++)
+        {
+            char c = content[read];
+            if (c == '\\' && read + 1 < size)
+            {
+                char next = content[read + 1];
+                if (next == '"' || next == '\'' || next == '\\' || is_space(next))
+                {
+                    content[write++] = next;
+                    read++;
+                    continue;
+                }
+            }
+            if (quote)
+            {
+                if (c == quote)
+                    quote = '\0';
+                else
+                    content[write++] = c;
+            }
+            else if (c == '"' || c == '\'')
+                quote = c;
+            else if (is_space(c))
+                break;
+            else
+                content[write++] = c;
+        }
+        tokens.emplace_back(content.data() + start, write - start);
+    }
+}
+
+xaml_result xaml_cmdline_args::append(xaml_cmdline_arg const& arg, int depth) noexcept
+try
+{
+    if (arg.view.size() < 2 || arg.view[0] != '@')
+    {
+        items.push_back(arg);
+        return XAML_S_OK;
+    }
+    string path{ arg.view.substr(1) };
+    nowide::ifstream stream{ path, ios_base::in | ios_base::binary };
+    if (!stream)
+    {
+        items.push_back(arg);
+        return XAML_S_OK;
+    }
+    if (depth >= s_max_response_depth)
+    {
+        // Reported once here, and returned through the outer levels without raising.
+        string msg = sf::sprint(U("Response file nested deeper than {}: {}"), s_max_response_depth, path);
+        xaml_result_raise_message(XAML_E_OUTOFBOUNDS, xaml_result_raise_error, msg.c_str());
+        return XAML_E_OUTOFBOUNDS;
+    }
+    string& content = contents.emplace_back(istreambuf_iterator<char>{ stream }, istreambuf_iterator<char>{});
+    vector<string_view> tokens;
+    split_response(content, tokens);
+    items.reserve(items.size() + tokens.size());
+    for (string_view token : tokens)
+    {
+        xaml_result hr = append({ token, nullptr, false }, depth + 1);
+        if (XAML_FAILED(hr)) return hr;
+    }
+    return XAML_S_OK;
+}
+XAML_CATCH_RETURN()
+
+xaml_result xaml_cmdline_args_new(xaml_vector_view<xaml_string>* args, xaml_cmdline_args* ptr) noexcept
+try
+{
+    int32_t size;
+    XAML_RETURN_IF_FAILED(args->get_size(&size));
+    ptr->items.reserve(size);
+    for (int32_t i = 0; i < size; i++)
+    {
+        xaml_ptr<xaml_string> item;
+        XAML_RETURN_IF_FAILED(args->get_at(i, &item));
+        string_view view;
+        XAML_RETURN_IF_FAILED(to_string_view(item, &view));
+        // The vector keeps the item alive.
+        XAML_RETURN_IF_FAILED(ptr->append({ view, item.get(), false }));
+    }
+    return XAML_S_OK;
+}
+XAML_CATCH_RETURN()
+
+xaml_result xaml_cmdline_args_new(int argc, char** argv, xaml_cmdline_args* ptr) noexcept
+try
+{
+    if (argc > 1) ptr->items.reserve(argc - 1);
+    for (int i = 1; i < argc; i++)
+    {
+        XAML_RETURN_IF_FAILED(ptr->append({ argv[i], nullptr, true }));
+    }
+    return XAML_S_OK;
+}
+XAML_CATCH_RETURN()
+
+xaml_result xaml_cmdline_arg_box(xaml_cmdline_arg const& arg, xaml_string** ptr) noexcept
+{
+    if (arg.str) return arg.str->query(ptr);
+    if (arg.persistent) return xaml_string_new_view(arg.view, ptr);
+    return xaml_string_new(arg.view, ptr);
+}
+
+template <typename T>
+static xaml_result parse_box(string_view str, xaml_object** ptr) noexcept
+{
+    T value;
+    if constexpr (__can_stof_v<T>)
+    {
+        XAML_RETURN_IF_FAILED(__stof<T>(str, &value));
+    }
+    else
+    {
+        XAML_RETURN_IF_FAILED(__stoi<T>(str, &value));
+    }
+    return xaml_box_value(value, ptr);
+}
+
+static constexpr pair<xaml_guid, xaml_result (*)(string_view, xaml_object**) noexcept> s_parsers[] = {
+    { xaml_type_guid_v<bool>, parse_box<bool> },
+    { xaml_type_guid_v<int8_t>, parse_box<int8_t> },
+    { xaml_type_guid_v<int16_t>, parse_box<int16_t> },
+    { xaml_type_guid_v<int32_t>, parse_box<int32_t> },
+    { xaml_type_guid_v<int64_t>, parse_box<int64_t> },
+    { xaml_type_guid_v<uint8_t>, parse_box<uint8_t> },
+    { xaml_type_guid_v<uint16_t>, parse_box<uint16_t> },
+    { xaml_type_guid_v<uint32_t>, parse_box<uint32_t> },
+    { xaml_type_guid_v<uint64_t>, parse_box<uint64_t> },
+    { xaml_type_guid_v<float>, parse_box<float> },
+    { xaml_type_guid_v<double>, parse_box<double> },
+};
+
+xaml_result xaml_cmdline_resolver::init(xaml_type_info* type) noexcept
+{
+    m_type = type;
+    return type->get_attribute(&m_option);
+}
+
+xaml_result xaml_cmdline_resolver::get_target(xaml_ptr<xaml_string> const& name, xaml_cmdline_target** ptr) noexcept
+try
+{
+    string_view view;
+    XAML_RETURN_IF_FAILED(to_string_view(name, &view));
+    auto it = m_names.find(view);
+    if (it != m_names.end())
+    {
+        *ptr = it->second;
+        return XAML_S_OK;
+    }
+    xaml_cmdline_target& target = m_targets.emplace_back();
+    target.name = name;
+    target.index = m_targets.size() - 1;
+    if (name && XAML_SUCCEEDED(m_type->get_property(name, &target.prop)))
+    {
+        XAML_RETURN_IF_FAILED(target.prop->get_type(&target.type));
+        XAML_RETURN_IF_FAILED(target.prop->get_can_write(&target.writable));
+        for (auto& [id, parse] : s_parsers)
+        {
+            if (id == target.type) target.parse = parse;
+        }
+    }
+    else if (name && XAML_SUCCEEDED(m_type->get_collection_property(name, &target.cprop)))
+    {
+        XAML_RETURN_IF_FAILED(target.cprop->get_can_add(&target.writable));
+    }
+    m_names.emplace(view, &target);
+    *ptr = &target;
+    return XAML_S_OK;
+}
+XAML_CATCH_RETURN()
+
+xaml_result xaml_cmdline_resolver::find_long_arg(string_view name, xaml_cmdline_target** ptr) noexcept
+try
+{
+    auto it = m_long_args.find(name);
+    if (it != m_long_args.end())
+    {
+        *ptr = it->second;
+        return XAML_S_OK;
+    }
+    // The name is followed by the value in "--name=value", so it cannot be viewed.
+    xaml_ptr<xaml_string> name_str;
+    XAML_RETURN_IF_FAILED(xaml_string_new(name, &name_str));
+    xaml_ptr<xaml_string> prop;
+    XAML_RETURN_IF_FAILED(m_option->find_long_arg(name_str, &prop));
+    XAML_RETURN_IF_FAILED(get_target(prop, ptr));
+    m_long_args.emplace(name, *ptr);
+    return XAML_S_OK;
+}
+XAML_CATCH_RETURN()
+
+xaml_result xaml_cmdline_resolver::find_short_arg(char name, xaml_cmdline_target** ptr) noexcept
+{
+    xaml_cmdline_target*& target = m_short_args[static_cast<unsigned char>(name)];
+    if (!target)
+    {
+        xaml_ptr<xaml_string> prop;
+        XAML_RETURN_IF_FAILED(m_option->find_short_arg(name, &prop));
+        XAML_RETURN_IF_FAILED(get_target(prop, &target));
+    }
+    *ptr = target;
+    return XAML_S_OK;
+}
+
+xaml_result xaml_cmdline_resolver::get_default_property(xaml_cmdline_target** ptr) noexcept
+{
+    if (!m_default)
+    {
+        xaml_ptr<xaml_string> prop;
+        XAML_RETURN_IF_FAILED(m_option->get_default_property(&prop));
+        XAML_RETURN_IF_FAILED(get_target(prop, &m_default));
+    }
+    *ptr = m_default;
+    return XAML_S_OK;
+}
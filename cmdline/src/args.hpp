@@ -0,0 +1,170 @@
+#ifndef XAML_CMDLINE_ARGS_HPP
+#define XAML_CMDLINE_ARGS_HPP
+
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <xaml/cmdline/option.h>
+#include <xaml/cmdline/parser.h>
+
+// An argument viewed without copying.
+struct xaml_cmdline_arg
+{
+    std::string_view view;
+    // The string the view refers to, if it is the whole of one.
+    xaml_string* str;
+    // Whether the view outlives the parsed result, like argv.
+    bool persistent;
+};
+
+// The arguments, with the response files expanded.
+struct xaml_cmdline_args
+{
+    std::vector<xaml_cmdline_arg> items;
+    // The contents of the response files, to which the items refer.
+    std::deque<std::string> contents;
+
+    // Appends an argument, or the arguments in the file if it is like "@file".
+    // Like GCC, an argument naming no readable file is kept as is.
+    xaml_result append(xaml_cmdline_arg const& arg, int depth = 0) noexcept;
+};
+
+xaml_result xaml_cmdline_args_new(xaml_vector_view<xaml_string>* args, xaml_cmdline_args* ptr) noexcept;
+xaml_result xaml_cmdline_args_new(int argc, char** argv, xaml_cmdline_args* ptr) noexcept;
+
+// Boxes the argument, referring it if possible.
+xaml_result xaml_cmdline_arg_box(xaml_cmdline_arg const& arg, xaml_string** ptr) noexcept;
+
+// A property an option resolves to.
+struct xaml_cmdline_target
+{
+    xaml_ptr<xaml_string> name;
+    xaml_ptr<xaml_property_info> prop;
+    xaml_ptr<xaml_collection_property_info> cprop;
+    // The index of the target in the resolver.
+    std::size_t index{};
+    xaml_guid type{};
+    bool writable{};
+    // Parses the value of a primitive type and boxes it, or null for the others.
+    xaml_result (*parse)(std::string_view, xaml_object**) noexcept {};
+};
+
+// Resolves the options once per name, so that the arguments cost a hash lookup each.
+struct xaml_cmdline_resolver
+{
+    xaml_ptr<xaml_type_info> m_type;
+    xaml_ptr<xaml_cmdline_option> m_option;
+    std::deque<xaml_cmdline_target> m_targets;
+    std::unordered_map<std::string_view, xaml_cmdline_target*> m_names;
+    // The keys refer to the arguments.
+    std::unordered_map<std::string_view, xaml_cmdline_target*> m_long_args;
+    std::array<xaml_cmdline_target*, 256> m_short_args{};
+    xaml_cmdline_target* m_default{};
+
+    xaml_result init(xaml_type_info* type) noexcept;
+    xaml_result find_long_arg(std::string_view name, xaml_cmdline_target** ptr) noexcept;
+    xaml_result find_short_arg(char name, xaml_cmdline_target** ptr) noexcept;
+    xaml_result get_default_property(xaml_cmdline_target** ptr) noexcept;
+
+private:
+    xaml_result get_target(xaml_ptr<xaml_string> const& name, xaml_cmdline_target** ptr) noexcept;
+};
+
+// Walks the arguments and reports the values to the sink, which has
+// set(target, arg), set_switch(target) and add(target, arg).
+template <typename TSink>
+xaml_result xaml_cmdline_parse_args(xaml_type_info* type, xaml_cmdline_args const& args, TSink& sink) noexcept
+{
+    xaml_cmdline_resolver resolver{};
+    XAML_RETURN_IF_FAILED(resolver.init(type));
+    std::size_t size = args.items.size();
+    std::size_t i = 0;
+    // The value is either inline, or the next argument.
+    auto take_value = [&](xaml_cmdline_target* target, xaml_cmdline_arg const& value, bool is_switch) noexcept -> xaml_result {
+        if (target->prop)
+        {
+            if (!value.view.empty()) return sink.set(*target, value);
+            if (is_switch) return sink.set_switch(*target);
+        }
+        else if (target->cprop)
+        {
+            if (!value.view.empty()) return sink.add(*target, value);
+        }
+        else
+        {
+            return XAML_S_OK;
+        }
+        if (++i >= size) return XAML_E_OUTOFBOUNDS;
+        return target->prop ? sink.set(*target, args.items[i]) : sink.add(*target, args.items[i]);
+    };
+    for (; i < size; i++)
+    {
+        xaml_cmdline_arg const& item = args.items[i];
+        std::string_view arg = item.view;
+        if (arg.empty())
+            continue;
+        else if (arg[0] == '-')
+        {
+            if (arg.size() == 1)
+                return XAML_E_FAIL;
+            else if (arg[1] == '-')
+            {
+                if (arg.size() == 2) return XAML_E_FAIL;
+                std::string_view long_arg = arg.substr(2);
+                std::size_t index = long_arg.find_first_of('=');
+                std::string_view maybe_value = {};
+                if (index != std::string_view::npos)
+                {
+                    maybe_value = long_arg.substr(index + 1);
+                    long_arg = long_arg.substr(0, index);
+                }
+                xaml_cmdline_target* target;
+                XAML_RETURN_IF_FAILED(resolver.find_long_arg(long_arg, &target));
+                XAML_RETURN_IF_FAILED(take_value(target, { maybe_value, nullptr, item.persistent }, target->type == xaml_type_guid_v<bool>));
+            }
+            else
+            {
+                std::string_view switches_or_value = arg.substr(2);
+                xaml_cmdline_target* target;
+                XAML_RETURN_IF_FAILED(resolver.find_short_arg(arg[1], &target));
+                if (target->prop && target->type == xaml_type_guid_v<bool>)
+                {
+                    XAML_RETURN_IF_FAILED(sink.set_switch(*target));
+                    for (char other_short_arg : switches_or_value)
+                    {
+                        xaml_cmdline_target* other;
+                        XAML_RETURN_IF_FAILED(resolver.find_short_arg(other_short_arg, &other));
+                        if (other->prop)
+                        {
+                            XAML_RETURN_IF_FAILED(sink.set_switch(*other));
+                        }
+                    }
+                }
+                else
+                {
+                    XAML_RETURN_IF_FAILED(take_value(target, { switches_or_value, nullptr, item.persistent }, false));
+                }
+            }
+        }
+        else
+        {
+            xaml_cmdline_target* target;
+            XAML_RETURN_IF_FAILED(resolver.get_default_property(&target));
+            if (target->prop)
+            {
+                XAML_RETURN_IF_FAILED(sink.set(*target, item));
+            }
+            else if (target->cprop)
+            {
+                XAML_RETURN_IF_FAILED(sink.add(*target, item));
+            }
+        }
+    }
+    return XAML_S_OK;
+}
+
+#endif // !XAML_CMDLINE_ARGS_HPP
@@ -1,3 +1,4 @@
+#include <args.hpp>
 #include <xaml/cmdline/deserializer.h>
 
 using namespace std;
@@ -46,3 +47,62 @@ xaml_result XAML_CALL xaml_cmdline_deserialize(xaml_type_info* type, xaml_cmdlin
     XAML_FOREACH_END();
     return result->query(ptr);
 }
+
+// Assigns the values to the object as they are parsed.
+// The primitive values are parsed and boxed as their types, and the others as strings.
+struct xaml_cmdline_object_sink
+{
+    xaml_ptr<xaml_object> result;
+    xaml_ptr<xaml_object> true_value;
+
+    xaml_result set(xaml_cmdline_target const& target, xaml_cmdline_arg const& arg) noexcept
+    {
+        if (!target.writable) return XAML_S_OK;
+        if (target.parse)
+        {
+            xaml_ptr<xaml_object> value;
+            XAML_RETURN_IF_FAILED(target.parse(arg.view, &value));
+            return target.prop->set(result, value);
+        }
+        xaml_ptr<xaml_string> value;
+        XAML_RETURN_IF_FAILED(xaml_cmdline_arg_box(arg, &value));
+        return target.prop->set(result, value);
+    }
+
+    xaml_result set_switch(xaml_cmdline_target const& target) noexcept
+    {
+        if (!target.writable) return XAML_S_OK;
+        if (!true_value) XAML_RETURN_IF_FAILED(xaml_box_value(true, &true_value));
+        return target.prop->set(result, true_value);
+    }
+
+    xaml_result add(xaml_cmdline_target const& target, xaml_cmdline_arg const& arg) noexcept
+    {
+        if (!target.writable) return XAML_S_OK;
+        xaml_ptr<xaml_string> value;
+        XAML_RETURN_IF_FAILED(xaml_cmdline_arg_box(arg, &value));
+        return target.cprop->add(result, value);
+    }
+};
+
+static xaml_result deserialize_args(xaml_type_info* type, xaml_cmdline_args const& args, xaml_object** ptr) noexcept
+{
+    xaml_cmdline_object_sink sink{};
+    XAML_RETURN_IF_FAILED(type->construct(&sink.result));
+    XAML_RETURN_IF_FAILED(xaml_cmdline_parse_args(type, args, sink));
+    return sink.result->query(ptr);
+}
+
+xaml_result XAML_CALL xaml_cmdline_deserialize_args(xaml_type_info* type, xaml_vector_view<xaml_string>* args, xaml_object** ptr) noexcept
+{
+    xaml_cmdline_args items{};
+    XAML_RETURN_IF_FAILED(xaml_cmdline_args_new(args, &items));
+    return deserialize_args(type, items, ptr);
+}
+
+xaml_result XAML_CALL xaml_cmdline_deserialize_argv(xaml_type_info* type, int argc, char** argv, xaml_object** ptr) noexcept
+{
+    xaml_cmdline_args items{};
+    XAML_RETURN_IF_FAILED(xaml_cmdline_args_new(argc, argv, &items));
+    return deserialize_args(type, items, ptr);
+}
@@ -0,0 +1,37 @@
+#ifndef XAML_TEST_OPTIONS_H
+#define XAML_TEST_OPTIONS_H
+
+#include <xaml/meta/meta_context.h>
+#include <xaml/meta/meta_macros.h>
+#include <xaml/vector.h>
+
+#ifndef xaml_enumerator_1__xaml_string_defined
+    #define xaml_enumerator_1__xaml_string_defined
+XAML_ENUMERATOR_1_TYPE(XAML_T_O(xaml_string))
+#endif // !xaml_enumerator_1__xaml_string_defined
+
+#ifndef xaml_vector_view_1__xaml_string_defined
+    #define xaml_vector_view_1__xaml_string_defined
+XAML_VECTOR_VIEW_1_TYPE(XAML_T_O(xaml_string))
+#endif // !xaml_vector_view_1__xaml_string_defined
+
+XAML_CLASS(xaml_test_options, { 0x3b0e6f52, 0x8d1a, 0x4c77, { 0x9e, 0x40, 0x61, 0x2f, 0xa8, 0x13, 0xd5, 0x7c } })
+
+#define XAML_TEST_OPTIONS_VTBL(type)                                       \
+    XAML_VTBL_INHERIT(XAML_OBJECT_VTBL(type));                             \
+    XAML_METHOD(get_inputs, type, XAML_VECTOR_VIEW_1_NAME(xaml_string)**); \
+    XAML_CPROP(input, type, xaml_string*, xaml_string*);                   \
+    XAML_PROP(name, type, xaml_string**, xaml_string*);                    \
+    XAML_PROP(count, type, XAML_STD int32_t*, XAML_STD int32_t);           \
+    XAML_PROP(verbose, type, bool*, bool);                                 \
+    XAML_PROP(quiet, type, bool*, bool)
+
+XAML_DECL_INTERFACE_(xaml_test_options, xaml_object)
+{
+    XAML_DECL_VTBL(xaml_test_options, XAML_TEST_OPTIONS_VTBL);
+};
+
+EXTERN_C xaml_result XAML_CALL xaml_test_options_new(xaml_test_options**) XAML_NOEXCEPT;
+EXTERN_C xaml_result XAML_CALL xaml_test_options_register(xaml_meta_context*) XAML_NOEXCEPT;
+
+#endif // !XAML_TEST_OPTIONS_H
@@ -0,0 +1,240 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <string>
+#include <test_check.hpp>
+#include <test_options.h>
+#include <vector>
+#include <xaml/cmdline/deserializer.h>
+
+using namespace std;
+using namespace std::filesystem;
+
+// Parses the arguments and the response files, and assigns them to the options directly.
+
+static xaml_ptr<xaml_meta_context> s_ctx;
+
+static void write_file(path const& file, string const& content)
+{
+    ofstream stream{ file, ios_base::binary };
+    stream << content;
+}
+
+// Keeps the arguments alive and writable, like argv.
+struct test_argv
+{
+    vector<string> args;
+    vector<char*> argv;
+
+    test_argv(initializer_list<string> list) : args{ "cmdline_test" }
+    {
+        args.insert(args.end(), list);
+        for (string& arg : args) argv.push_back(arg.data());
+    }
+
+    int argc() const noexcept { return (int)argv.size(); }
+};
+
+static xaml_result parse(test_argv& args, xaml_test_options** ptr) noexcept
+{
+    return xaml_cmdline_deserialize(s_ctx.get(), args.argc(), args.argv.data(), ptr);
+}
+
+static vector<string> get_inputs(xaml_test_options* options)
+{
+    vector<string> result;
+    xaml_ptr<xaml_vector_view<xaml_string>> inputs;
+    XAML_THROW_IF_FAILED(options->get_inputs(&inputs));
+    int32_t size;
+    XAML_THROW_IF_FAILED(inputs->get_size(&size));
+    for (int32_t i = 0; i < size; i++)
+    {
+        xaml_ptr<xaml_string> item;
+        XAML_THROW_IF_FAILED(inputs->get_at(i, &item));
+        string_view view;
+        XAML_THROW_IF_FAILED(to_string_view(item, &view));
+        result.emplace_back(view);
+    }
+    return result;
+}
+
+static string get_name(xaml_test_options* options)
+{
+    xaml_ptr<xaml_string> name;
+    XAML_THROW_IF_FAILED(options->get_name(&name));
+    string_view view;
+    XAML_THROW_IF_FAILED(to_string_view(name, &view));
+    return string{ view };
+}
+
+static void test_options()
+{
+    {
+        test_argv args{ "--name=foo", "--count=42", "-v", "a.txt", "b.txt" };
+        xaml_ptr<xaml_test_options> options;
+        CHECK_OK(parse(args, &options));
+        CHECK(get_name(options) == "foo");
+        int32_t count;
+        CHECK_OK(options->get_count(&count));
+        CHECK(count == 42);
+        bool verbose, quiet;
+        CHECK_OK(options->get_verbose(&verbose));
+        CHECK_OK(options->get_quiet(&quiet));
+        CHECK(verbose && !quiet);
+        CHECK((get_inputs(options) == vector<string>{ "a.txt", "b.txt" }));
+    }
+    {
+        // The value is the next argument, or follows a short option.
+        // The short switches are combined.
+        test_argv args{ "--name", "bar", "-c7", "-qv" };
+        xaml_ptr<xaml_test_options> options;
+        CHECK_OK(parse(args, &options));
+        CHECK(get_name(options) == "bar");
+        int32_t count;
+        CHECK_OK(options->get_count(&count));
+        CHECK(count == 7);
+        bool verbose, quiet;
+        CHECK_OK(options->get_verbose(&verbose));
+        CHECK_OK(options->get_quiet(&quiet));
+        CHECK(verbose && quiet);
+    }
+    {
+        test_argv args{ "--count=abc" };
+        xaml_ptr<xaml_test_options> options;
+        CHECK(XAML_FAILED(parse(args, &options)));
+    }
+    {
+        // The value of the last option is missing.
+        test_argv args{ "--count" };
+        xaml_ptr<xaml_test_options> options;
+        CHECK(parse(args, &options) == (xaml_result)XAML_E_OUTOFBOUNDS);
+    }
+}
+
+static void test_response_file()
+{
+    write_file("quotes.rsp",
+               "'a b' \"c d\"\te\\ f\n"
+               "\\\"g\\\" C:\\dir\\file \"it's\" 'say \"hi\"'\r\n"
+               "x\"y z\"w \\\\ \"\"");
+    test_argv args{ "@quotes.rsp", "--name=n" };
+    xaml_ptr<xaml_test_options> options;
+    CHECK_OK(parse(args, &options));
+    // The empty quotes are an empty argument, which is skipped.
+    CHECK((get_inputs(options) == vector<string>{ "a b", "c d", "e f", "\"g\"", "C:\\dir\\file", "it's", "say \"hi\"", "xy zw", "\\" }));
+    CHECK(get_name(options) == "n");
+}
+
+static void test_nested()
+{
+    write_file("outer.rsp", "one @inner.rsp four");
+    write_file("inner.rsp", "two --count=3 three");
+    test_argv args{ "@outer.rsp", "@missing.rsp", "@" };
+    xaml_ptr<xaml_test_options> options;
+    CHECK_OK(parse(args, &options));
+    // A name of no readable file is kept as is.
+    CHECK((get_inputs(options) == vector<string>{ "one", "two", "three", "four", "@missing.rsp", "@" }));
+    int32_t count;
+    CHECK_OK(options->get_count(&count));
+    CHECK(count == 3);
+}
+
+static void test_depth()
+{
+    write_file("self.rsp", "a @self.rsp");
+    test_argv args{ "@self.rsp" };
+    xaml_ptr<xaml_test_options> options;
+    CHECK(parse(args, &options) == (xaml_result)XAML_E_OUTOFBOUNDS);
+
+    // Nested as deep as allowed.
+    for (int i = 1; i < 16; i++)
+    {
+        write_file("level" + to_string(i) + ".rsp", "@level" + to_string(i + 1) + ".rsp");
+    }
+    write_file("level16.rsp", "deepest");
+    test_argv deep_args{ "@level1.rsp" };
+    CHECK_OK(parse(deep_args, &options));
+    CHECK((get_inputs(options) == vector<string>{ "deepest" }));
+}
+
+using ms = chrono::duration<double, milli>;
+
+static void check_bench_inputs(xaml_test_options* options, int32_t count)
+{
+    vector<string> inputs = get_inputs(options);
+    CHECK(inputs.size() == (size_t)count);
+    CHECK(inputs.back() == "input" + to_string(count - 1) + ".txt");
+}
+
+// Times the arguments parsed to the options and deserialized after,
+// and assigned directly, both from argv and from a response file.
+static void test_bench()
+{
+    constexpr int32_t count = 200000;
+    xaml_ptr<xaml_reflection_info> info;
+    XAML_THROW_IF_FAILED(s_ctx->get_type<xaml_test_options>(&info));
+    xaml_ptr<xaml_type_info> type;
+    XAML_THROW_IF_FAILED(info->query(&type));
+
+    test_argv args{};
+    {
+        ofstream stream{ "bench.rsp", ios_base::binary };
+        for (int32_t i = 0; i < count; i++)
+        {
+            string input = "input" + to_string(i) + ".txt";
+            stream << input << '\n';
+            args.args.push_back(move(input));
+        }
+        args.argv.clear();
+        for (string& arg : args.args) args.argv.push_back(arg.data());
+    }
+    test_argv rsp_args{ "@bench.rsp" };
+
+    auto start = chrono::steady_clock::now();
+    xaml_ptr<xaml_cmdline_options> opts;
+    CHECK_OK(xaml_cmdline_parse_argv(type, args.argc(), args.argv.data(), &opts));
+    xaml_ptr<xaml_object> obj;
+    CHECK_OK(xaml_cmdline_deserialize(type, opts, &obj));
+    auto options_time = chrono::steady_clock::now() - start;
+    {
+        xaml_ptr<xaml_test_options> options;
+        CHECK_OK(obj->query(&options));
+        check_bench_inputs(options, count);
+    }
+
+    start = chrono::steady_clock::now();
+    xaml_ptr<xaml_test_options> options;
+    CHECK_OK(parse(args, &options));
+    auto direct_time = chrono::steady_clock::now() - start;
+    check_bench_inputs(options, count);
+
+    start = chrono::steady_clock::now();
+    CHECK_OK(parse(rsp_args, &options));
+    auto rsp_time = chrono::steady_clock::now() - start;
+    check_bench_inputs(options, count);
+
+    cout << count << " arguments parsed to the options and deserialized in " << ms(options_time).count() << " ms, "
+         << "directly in " << ms(direct_time).count() << " ms, "
+         << "and from a response file in " << ms(rsp_time).count() << " ms." << endl;
+}
+
+int main()
+{
+    XAML_THROW_IF_FAILED(xaml_meta_context_new(&s_ctx));
+    XAML_THROW_IF_FAILED(xaml_test_options_register(s_ctx));
+    path dir = temp_directory_path() / "cmdline_test";
+    remove_all(dir);
+    create_directories(dir);
+    current_path(dir);
+    test_options();
+    test_response_file();
+    test_nested();
+    test_depth();
+    test_bench();
+    current_path(temp_directory_path());
+    remove_all(dir);
+    s_ctx = nullptr;
+    return report_failures();
+}
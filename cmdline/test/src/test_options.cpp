@@ -0,0 +1,57 @@
+#include <test_options.h>
+#include <xaml/cmdline/option.h>
+
+struct xaml_test_options_impl : xaml_implement<xaml_test_options_impl, xaml_test_options>
+{
+    xaml_ptr<xaml_vector<xaml_string>> m_inputs;
+
+    xaml_result XAML_CALL add_input(xaml_string* value) noexcept override
+    {
+        return m_inputs->append(value);
+    }
+
+    xaml_result XAML_CALL remove_input(xaml_string*) noexcept override
+    {
+        return XAML_E_NOTIMPL;
+    }
+
+    xaml_result XAML_CALL get_inputs(xaml_vector_view<xaml_string>** ptr) noexcept override
+    {
+        return m_inputs->query(ptr);
+    }
+
+    XAML_PROP_PTR_IMPL(name, xaml_string)
+    XAML_PROP_IMPL(count, std::int32_t, std::int32_t*, std::int32_t)
+    XAML_PROP_IMPL(verbose, bool, bool*, bool)
+    XAML_PROP_IMPL(quiet, bool, bool*, bool)
+
+    xaml_result XAML_CALL init() noexcept
+    {
+        return xaml_vector_new(&m_inputs);
+    }
+};
+
+xaml_result XAML_CALL xaml_test_options_new(xaml_test_options** ptr) noexcept
+{
+    return xaml_object_init<xaml_test_options_impl>(ptr);
+}
+
+xaml_result XAML_CALL xaml_test_options_register(xaml_meta_context* ctx) noexcept
+{
+    XAML_TYPE_INFO_NEW(xaml_test_options, "test_options.h");
+    XAML_TYPE_INFO_ADD_CTOR(xaml_test_options_new);
+    XAML_TYPE_INFO_ADD_CPROP(input, xaml_string);
+    XAML_TYPE_INFO_ADD_PROP(name, xaml_string);
+    XAML_TYPE_INFO_ADD_PROP(count, std::int32_t);
+    XAML_TYPE_INFO_ADD_PROP(verbose, bool);
+    XAML_TYPE_INFO_ADD_PROP(quiet, bool);
+    xaml_ptr<xaml_cmdline_option> opt;
+    XAML_RETURN_IF_FAILED(xaml_cmdline_option_new(&opt));
+    XAML_RETURN_IF_FAILED(opt->add_arg('n', U("name"), U("name"), U("Name")));
+    XAML_RETURN_IF_FAILED(opt->add_arg('c', U("count"), U("count"), U("Count")));
+    XAML_RETURN_IF_FAILED(opt->add_arg('v', U("verbose"), U("verbose"), U("Verbose")));
+    XAML_RETURN_IF_FAILED(opt->add_arg('q', U("quiet"), U("quiet"), U("Quiet")));
+    XAML_RETURN_IF_FAILED(opt->add_arg(0, {}, U("input"), U("Input files")));
+    XAML_RETURN_IF_FAILED(__info->add_attribute(opt.get()));
+    return ctx->add_type(__info);
+}
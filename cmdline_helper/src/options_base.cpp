@@ -51,9 +51,9 @@ xaml_result XAML_CALL xaml_cmdline_parse_and_print(xaml_meta_context* ctx, xaml_
     XAML_RETURN_IF_FAILED(ctx->get_type(id, &info));
     xaml_ptr<xaml_type_info> t;
     XAML_RETURN_IF_FAILED(info->query(&t));
-    xaml_ptr<xaml_cmdline_options> opts;
+    xaml_ptr<xaml_object> obj;
     {
-        xaml_result __hr = xaml_cmdline_parse_argv(t, argc, argv, &opts);
+        xaml_result __hr = xaml_cmdline_deserialize_argv(t, argc, argv, &obj);
         if (XAML_FAILED(__hr))
         {
             sf::println(nowide::cerr, U("Command line parse error: {}"), xaml_result_get_message(__hr));
@@ -61,8 +61,6 @@ xaml_result XAML_CALL xaml_cmdline_parse_and_print(xaml_meta_context* ctx, xaml_
             exit(1);
         }
     }
-    xaml_ptr<xaml_object> obj;
-    XAML_RETURN_IF_FAILED(xaml_cmdline_deserialize(t, opts, &obj));
     xaml_ptr<xaml_cmdline_options_base> options;
     XAML_RETURN_IF_FAILED(obj->query(&options));
 
@@ -6,10 +6,13 @@
 
 XAML_CLASS(xaml_detector_options, { 0xd1e430b3, 0xb91f, 0x4cba, { 0x87, 0x81, 0xda, 0x1d, 0x48, 0x59, 0xef, 0x7e } })
 
-#define XAML_DETECTOR_OPTIONS_VTBL(type)                     \
-    XAML_VTBL_INHERIT(XAML_CMDLINE_OPTIONS_BASE_VTBL(type)); \
-    XAML_PROP(recursive, type, bool*, bool);                 \
-    XAML_PROP(path, type, xaml_string**, xaml_string*)
+#define XAML_DETECTOR_OPTIONS_VTBL(type)                        \
+    XAML_VTBL_INHERIT(XAML_CMDLINE_OPTIONS_BASE_VTBL(type));    \
+    XAML_PROP(recursive, type, bool*, bool);                    \
+    XAML_PROP(path, type, xaml_string**, xaml_string*);         \
+    XAML_PROP(profile, type, bool*, bool);                      \
+    XAML_PROP(runs, type, XAML_STD int32_t*, XAML_STD int32_t); \
+    XAML_PROP(json, type, xaml_string**, xaml_string*)
 
 XAML_DECL_INTERFACE_(xaml_detector_options, xaml_cmdline_options_base)
 {
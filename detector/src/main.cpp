@@ -2,6 +2,7 @@
 #include <nowide/args.hpp>
 #include <nowide/iostream.hpp>
 #include <options.h>
+#include <profile.hpp>
 #include <sf/format.hpp>
 #include <unordered_map>
 #include <xaml/version.h>
@@ -36,6 +37,22 @@ int main(int argc, char** argv)
     xaml_ptr<xaml_string> path_str;
     XAML_THROW_IF_FAILED(options->get_path(&path_str));
 
+    bool recursive;
+    XAML_THROW_IF_FAILED(options->get_recursive(&recursive));
+
+    bool profile;
+    XAML_THROW_IF_FAILED(options->get_profile(&profile));
+    xaml_ptr<xaml_string> json;
+    XAML_THROW_IF_FAILED(options->get_json(&json));
+    // Writing the profile implies profiling.
+    if (profile || json)
+    {
+        int32_t runs;
+        XAML_THROW_IF_FAILED(options->get_runs(&runs));
+        XAML_THROW_IF_FAILED(xaml_detector_profile(path_str, recursive, runs, json));
+        return 0;
+    }
+
     xaml_ptr<xaml_module> m;
     XAML_THROW_IF_FAILED(xaml_module_new(&m));
     XAML_THROW_IF_FAILED(m->open(path_str));
@@ -43,8 +60,6 @@ int main(int argc, char** argv)
     xaml_ptr<xaml_meta_context> ctx;
     XAML_THROW_IF_FAILED(xaml_meta_context_new(&ctx));
 
-    bool recursive;
-    XAML_THROW_IF_FAILED(options->get_recursive(&recursive));
     if (recursive)
         XAML_THROW_IF_FAILED(ctx->add_module_recursive(m));
     else
@@ -6,6 +6,9 @@ struct xaml_detector_options_impl : xaml_cmdline_options_base_implement<xaml_det
 {
     XAML_PROP_IMPL(recursive, bool, bool*, bool)
     XAML_PROP_PTR_IMPL(path, xaml_string)
+    XAML_PROP_IMPL(profile, bool, bool*, bool)
+    XAML_PROP_IMPL(runs, int32_t, int32_t*, int32_t)
+    XAML_PROP_PTR_IMPL(json, xaml_string)
 };
 
 xaml_result XAML_CALL xaml_detector_options_new(xaml_detector_options** ptr) noexcept
@@ -20,6 +23,9 @@ xaml_result XAML_CALL xaml_detector_options_register(xaml_meta_context* ctx) noe
     XAML_RETURN_IF_FAILED(xaml_cmdline_options_base_members(__info));
     XAML_TYPE_INFO_ADD_PROP(recursive, bool);
     XAML_TYPE_INFO_ADD_PROP(path, xaml_string);
+    XAML_TYPE_INFO_ADD_PROP(profile, bool);
+    XAML_TYPE_INFO_ADD_PROP(runs, int32_t);
+    XAML_TYPE_INFO_ADD_PROP(json, xaml_string);
     XAML_TYPE_INFO_ADD_DEF_PROP(path);
     xaml_ptr<xaml_cmdline_option> opt;
     XAML_RETURN_IF_FAILED(xaml_cmdline_option_new(&opt));
@@ -27,6 +33,9 @@ xaml_result XAML_CALL xaml_detector_options_register(xaml_meta_context* ctx) noe
     XAML_RETURN_IF_FAILED(opt->add_arg(0, U("version"), U("version"), U("Print version info")));
     XAML_RETURN_IF_FAILED(opt->add_arg('r', U("recursive"), U("recursive"), U("Load modules recursively")));
     XAML_RETURN_IF_FAILED(opt->add_arg(0, U("no-logo"), U("no_logo"), U("Cancellation to show copyright information")));
+    XAML_RETURN_IF_FAILED(opt->add_arg('p', U("profile"), U("profile"), U("Profile loading the modules and registering the types")));
+    XAML_RETURN_IF_FAILED(opt->add_arg(0, U("runs"), U("runs"), U("Times to load the modules when profiling, 10 by default")));
+    XAML_RETURN_IF_FAILED(opt->add_arg(0, U("json"), U("json"), U("Write the profile as JSON to a file, or - for the standard output; implies --profile")));
     XAML_RETURN_IF_FAILED(opt->add_arg(0, {}, U("path"), U("Library path")));
     XAML_RETURN_IF_FAILED(__info->add_attribute(opt.get()));
     return ctx->add_type(__info);
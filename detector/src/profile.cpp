@@ -0,0 +1,375 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <nowide/fstream.hpp>
+#include <nowide/iostream.hpp>
+#include <profile.hpp>
+#include <sf/format.hpp>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <xaml/meta/meta_context.h>
+
+using namespace std;
+
+// Counts the allocations through the global operator new.
+// The modules share it where the symbols are interposed, like ELF and Mach-O,
+// but not on Windows, where a module may link a runtime of its own.
+static atomic<uint64_t> s_alloc_count{ 0 };
+static atomic<uint64_t> s_alloc_bytes{ 0 };
+
+static void* counted_alloc(size_t size) noexcept
+{
+    s_alloc_count.fetch_add(1, memory_order_relaxed);
+    s_alloc_bytes.fetch_add(size, memory_order_relaxed);
+    return malloc(size ? size : 1);
+}
+
+void* operator new(size_t size)
+{
+    if (void* p = counted_alloc(size)) return p;
+    throw bad_alloc{};
+}
+
+void* operator new[](size_t size) { return ::operator new(size); }
+void* operator new(size_t size, nothrow_t const&) noexcept { return counted_alloc(size); }
+void* operator new[](size_t size, nothrow_t const&) noexcept { return counted_alloc(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, nothrow_t const&) noexcept { free(p); }
+void operator delete[](void* p, nothrow_t const&) noexcept { free(p); }
+
+struct profile_cost
+{
+    int64_t ns;
+    uint64_t allocs;
+    uint64_t bytes;
+
+    profile_cost& operator+=(profile_cost const& other) noexcept
+    {
+        ns += other.ns;
+        allocs += other.allocs;
+        bytes += other.bytes;
+        return *this;
+    }
+
+    profile_cost& operator-=(profile_cost const& other) noexcept
+    {
+        ns -= other.ns;
+        allocs -= other.allocs;
+        bytes -= other.bytes;
+        return *this;
+    }
+};
+
+struct profile_sample
+{
+    chrono::steady_clock::time_point time;
+    uint64_t allocs;
+    uint64_t bytes;
+
+    static profile_sample now() noexcept
+    {
+        return { chrono::steady_clock::now(), s_alloc_count.load(memory_order_relaxed), s_alloc_bytes.load(memory_order_relaxed) };
+    }
+
+    profile_cost operator-(profile_sample const& begin) const noexcept
+    {
+        return { chrono::duration_cast<chrono::nanoseconds>(time - begin.time).count(), allocs - begin.allocs, bytes - begin.bytes };
+    }
+};
+
+struct profile_entry
+{
+    string kind;
+    string module;
+    string name;
+    // The time of each run.
+    vector<int64_t> times;
+    // The allocations are the same in the runs except the first, so the last one is kept.
+    uint64_t allocs;
+    uint64_t bytes;
+    int64_t median;
+};
+
+struct profile_report
+{
+    vector<profile_entry> entries;
+    unordered_map<string, size_t> indices;
+
+    void record(string_view kind, string_view module, string_view name, profile_cost const& cost)
+    {
+        string key{ kind };
+        key += '\n';
+        key += module;
+        key += '\n';
+        key += name;
+        auto [it, inserted] = indices.emplace(move(key), entries.size());
+        if (inserted) entries.push_back({ (string)kind, (string)module, (string)name, {}, 0, 0, 0 });
+        profile_entry& entry = entries[it->second];
+        entry.times.push_back(cost.ns);
+        entry.allocs = cost.allocs;
+        entry.bytes = cost.bytes;
+    }
+};
+
+// Forwards to the real context, and takes a sample whenever a type is added,
+// so that the cost of each *_register function, including the *_members it calls, is known.
+struct xaml_detector_profile_context : xaml_implement<xaml_detector_profile_context, xaml_meta_context>
+{
+    xaml_ptr<xaml_meta_context> m_inner;
+    profile_report* m_report;
+    string m_module{};
+    profile_sample m_begin{};
+    // The cost of the recording itself, to be excluded from register_types.
+    profile_cost m_overhead{};
+
+    xaml_detector_profile_context(xaml_ptr<xaml_meta_context> const& inner, profile_report* report) noexcept
+        : m_inner(inner), m_report(report)
+    {
+    }
+
+    void begin(string_view module)
+    {
+        m_module = module;
+        m_overhead = {};
+        m_begin = profile_sample::now();
+    }
+
+    xaml_result XAML_CALL get_modules(xaml_map_view<xaml_string, xaml_module>** ptr) noexcept override
+    {
+        return m_inner->get_modules(ptr);
+    }
+
+    xaml_result XAML_CALL add_module(xaml_module* mod) noexcept override
+    {
+        return m_inner->add_module(mod);
+    }
+
+    xaml_result XAML_CALL add_module_recursive(xaml_module* mod) noexcept override
+    {
+        return m_inner->add_module_recursive(mod);
+    }
+
+    xaml_result XAML_CALL get_namespace(xaml_string* xml_ns, xaml_string** ptr) noexcept override
+    {
+        return m_inner->get_namespace(xml_ns, ptr);
+    }
+
+    xaml_result XAML_CALL add_namespace(xaml_string* xml_ns, xaml_string* ns) noexcept override
+    {
+        return m_inner->add_namespace(xml_ns, ns);
+    }
+
+    xaml_result XAML_CALL get_types(xaml_map_view<xaml_guid, xaml_reflection_info>** ptr) noexcept override
+    {
+        return m_inner->get_types(ptr);
+    }
+
+    xaml_result XAML_CALL get_type(xaml_guid const& type, xaml_reflection_info** ptr) noexcept override
+    {
+        return m_inner->get_type(type, ptr);
+    }
+
+    xaml_result XAML_CALL get_type_by_name(xaml_string* name, xaml_reflection_info** ptr) noexcept override
+    {
+        return m_inner->get_type_by_name(name, ptr);
+    }
+
+    xaml_result XAML_CALL get_type_by_namespace_name(xaml_string* ns, xaml_string* name, xaml_reflection_info** ptr) noexcept override
+    {
+        return m_inner->get_type_by_namespace_name(ns, name, ptr);
+    }
+
+    xaml_result XAML_CALL get_name_by_namespace_name(xaml_string* ns, xaml_string* name, xaml_string** ptr) noexcept override
+    {
+        return m_inner->get_name_by_namespace_name(ns, name, ptr);
+    }
+
+    xaml_result XAML_CALL add_type(xaml_reflection_info* info) noexcept override
+    try
+    {
+        XAML_RETURN_IF_FAILED(m_inner->add_type(info));
+        profile_sample end = profile_sample::now();
+        xaml_ptr<xaml_string> name;
+        XAML_RETURN_IF_FAILED(info->get_name(&name));
+        string_view name_view;
+        XAML_RETURN_IF_FAILED(to_string_view(name, &name_view));
+        m_report->record(U("type"), m_module, name_view, end - m_begin);
+        m_begin = profile_sample::now();
+        m_overhead += m_begin - end;
+        return XAML_S_OK;
+    }
+    XAML_CATCH_RETURN()
+
+    xaml_result XAML_CALL bind(xaml_weak_reference* wtarget, xaml_string* target_prop, xaml_weak_reference* wsource, xaml_string* source_prop, xaml_binding_mode mode, xaml_converter* converter, xaml_object* parameter, xaml_string* language) noexcept override
+    {
+        return m_inner->bind(wtarget, target_prop, wsource, source_prop, mode, converter, parameter, language);
+    }
+};
+
+struct profile_run
+{
+    profile_report& report;
+    xaml_ptr<xaml_detector_profile_context> ctx{};
+    unordered_set<string> loaded{};
+    // The modules are kept until the run ends, like in a context.
+    vector<xaml_ptr<xaml_module>> modules{};
+
+    // Mirrors xaml_meta_context::add_module_recursive.
+    xaml_result load(xaml_string* path, bool recursive) noexcept
+    try
+    {
+        profile_sample begin = profile_sample::now();
+        xaml_ptr<xaml_module> m;
+        XAML_RETURN_IF_FAILED(xaml_module_new(&m));
+        XAML_RETURN_IF_FAILED(m->open(path));
+        profile_cost open_cost = profile_sample::now() - begin;
+
+        xaml_ptr<xaml_string> name;
+        XAML_RETURN_IF_FAILED(m->get_name(&name));
+        string_view name_view;
+        XAML_RETURN_IF_FAILED(to_string_view(name, &name_view));
+        if (!loaded.emplace(name_view).second) return XAML_S_OK;
+        modules.push_back(m);
+        report.record(U("dlopen"), name_view, name_view, open_cost);
+
+        ctx->begin(name_view);
+        begin = profile_sample::now();
+        xaml_ptr<xaml_module_info> info;
+        XAML_RETURN_IF_FAILED(m->get_info(&info));
+        XAML_RETURN_IF_FAILED(info->register_types(ctx));
+        profile_cost register_cost = profile_sample::now() - begin;
+        register_cost -= ctx->m_overhead;
+        report.record(U("register_types"), name_view, name_view, register_cost);
+
+        if (recursive)
+        {
+            xaml_ptr<xaml_vector_view<xaml_string>> dependencies;
+            XAML_RETURN_IF_FAILED(info->get_dependencies(&dependencies));
+            if (dependencies)
+            {
+                XAML_FOREACH_START(xaml_string, dep, dependencies);
+                {
+                    XAML_RETURN_IF_FAILED(load(dep, true));
+                }
+                XAML_FOREACH_END();
+            }
+        }
+        return XAML_S_OK;
+    }
+    XAML_CATCH_RETURN()
+};
+
+static string json_escape(string_view str)
+{
+    constexpr char hex[] = "0123456789abcdef";
+    string result;
+    result.reserve(str.size());
+    for (char c : str)
+    {
+        if (c == '"' || c == '\\')
+        {
+            result += '\\';
+            result += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            result += U("\\u00");
+            result += hex[c >> 4];
+            result += hex[c & 0xF];
+        }
+        else
+        {
+            result += c;
+        }
+    }
+    return result;
+}
+
+static void print_table(ostream& stream, vector<profile_entry const*> const& entries)
+{
+    stream << right << setw(12) << U("Median(us)") << setw(12) << U("First(us)") << setw(10) << U("Allocs") << setw(12) << U("Bytes") << U("  ")
+           << left << setw(16) << U("Kind") << setw(20) << U("Module") << U("Name") << '\n';
+    stream << fixed << setprecision(1);
+    for (auto entry : entries)
+    {
+        stream << right << setw(12) << entry->median / 1000.0 << setw(12) << entry->times.front() / 1000.0
+               << setw(10) << entry->allocs << setw(12) << entry->bytes << U("  ")
+               << left << setw(16) << entry->kind << setw(20) << entry->module << entry->name << '\n';
+    }
+}
+
+static void print_json(ostream& stream, string_view path, bool recursive, int32_t runs, vector<profile_entry const*> const& entries)
+{
+    stream << U("{\n");
+    stream << U("  \"module\": \"") << json_escape(path) << U("\",\n");
+    stream << U("  \"recursive\": ") << (recursive ? U("true") : U("false")) << U(",\n");
+    stream << U("  \"runs\": ") << runs << U(",\n");
+    stream << U("  \"entries\": [");
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        auto entry = entries[i];
+        stream << (i ? U(",\n") : U("\n"));
+        stream << U("    { \"kind\": \"") << json_escape(entry->kind)
+               << U("\", \"module\": \"") << json_escape(entry->module)
+               << U("\", \"name\": \"") << json_escape(entry->name)
+               << U("\", \"median_ns\": ") << entry->median
+               << U(", \"first_ns\": ") << entry->times.front()
+               << U(", \"allocations\": ") << entry->allocs
+               << U(", \"bytes\": ") << entry->bytes << U(" }");
+    }
+    stream << U("\n  ]\n}\n");
+}
+
+xaml_result xaml_detector_profile(xaml_ptr<xaml_string> const& path, bool recursive, int32_t runs, xaml_ptr<xaml_string> const& json) noexcept
+try
+{
+    if (runs <= 0) runs = 10;
+    profile_report report{};
+    for (int32_t i = 0; i < runs; i++)
+    {
+        xaml_ptr<xaml_meta_context> inner;
+        XAML_RETURN_IF_FAILED(xaml_meta_context_new(&inner));
+        profile_run run{ report };
+        XAML_RETURN_IF_FAILED(xaml_object_new<xaml_detector_profile_context>(&run.ctx, inner, &report));
+        XAML_RETURN_IF_FAILED(run.load(path, recursive));
+    }
+
+    vector<profile_entry const*> entries;
+    entries.reserve(report.entries.size());
+    for (auto& entry : report.entries)
+    {
+        vector<int64_t> sorted = entry.times;
+        sort(sorted.begin(), sorted.end());
+        entry.median = sorted[sorted.size() / 2];
+        entries.push_back(&entry);
+    }
+    stable_sort(entries.begin(), entries.end(), [](profile_entry const* lhs, profile_entry const* rhs) { return lhs->median > rhs->median; });
+
+    string_view path_view = to_string_view(path);
+    string_view json_view = to_string_view(json);
+    if (json_view != U("-"))
+    {
+        sf::println(nowide::cout, U("Profiled {} in {} runs"), quoted(path_view), runs);
+        print_table(nowide::cout, entries);
+    }
+    if (json_view == U("-"))
+    {
+        print_json(nowide::cout, path_view, recursive, runs, entries);
+    }
+    else if (!json_view.empty())
+    {
+        nowide::ofstream stream{ (string)json_view };
+        if (!stream) return XAML_E_FAIL;
+        print_json(stream, path_view, recursive, runs, entries);
+    }
+    return XAML_S_OK;
+}
+XAML_CATCH_RETURN()
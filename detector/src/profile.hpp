@@ -0,0 +1,12 @@
+#ifndef XAMLD_PROFILE_HPP
+#define XAMLD_PROFILE_HPP
+
+#include <cstdint>
+#include <xaml/string.h>
+
+// Loads the module in a fresh context for several runs, and reports the time and the allocations
+// spent in opening each module, in its register_types, and in registering each type of it.
+// The report is printed as a table, and written as JSON if a file is given, or "-" for the standard output.
+xaml_result xaml_detector_profile(xaml_ptr<xaml_string> const& path, bool recursive, std::int32_t runs, xaml_ptr<xaml_string> const& json) noexcept;
+
+#endif // !XAMLD_PROFILE_HPP
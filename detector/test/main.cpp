@@ -0,0 +1,69 @@
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <test_check.hpp>
+
+#ifndef XAML_WIN32
+    #include <sys/wait.h>
+#endif // !XAML_WIN32
+
+using namespace std;
+using namespace std::filesystem;
+
+// Profiles an in-tree module with xamld, and checks the entries written as JSON.
+
+static int run(string const& args)
+{
+    string command = "\"" XAMLD_PATH "\" --no-logo " + args;
+#ifdef XAML_WIN32
+    // The whole command is quoted again by cmd.
+    return system(("\"" + command + "\"").c_str());
+#else
+    command += " >/dev/null 2>&1";
+    int res = system(command.c_str());
+    return WIFEXITED(res) ? WEXITSTATUS(res) : -1;
+#endif // XAML_WIN32
+}
+
+static string read_file(path const& file)
+{
+    ifstream stream{ file, ios_base::binary };
+    return { istreambuf_iterator<char>{ stream }, istreambuf_iterator<char>{} };
+}
+
+static bool has_entry(string const& json, string_view kind)
+{
+    return json.find("\"kind\": \"" + string{ kind } + "\"") != string::npos;
+}
+
+static void test_profile()
+{
+    CHECK(run("--profile --runs 2 --json profile.json \"" XAMLD_MODULE_PATH "\"") == 0);
+    string json = read_file("profile.json");
+    CHECK(json.find("\"runs\": 2") != string::npos);
+    CHECK(has_entry(json, "dlopen"));
+    CHECK(has_entry(json, "register_types"));
+    CHECK(has_entry(json, "type"));
+    CHECK(json.find("\"name\": \"xaml_data_template\"") != string::npos);
+}
+
+static void test_json_implies_profile()
+{
+    CHECK(run("--runs 1 --json implied.json \"" XAMLD_MODULE_PATH "\"") == 0);
+    CHECK(has_entry(read_file("implied.json"), "register_types"));
+}
+
+int main()
+{
+    path dir = temp_directory_path() / "xamld_test";
+    remove_all(dir);
+    create_directories(dir);
+    current_path(dir);
+    test_profile();
+    test_json_implies_profile();
+    current_path(temp_directory_path());
+    remove_all(dir);
+    return report_failures();
+}
@@ -85,6 +85,10 @@
     #define XAML_CMDLINE_API __XAML_IMPORT
 #endif // !XAML_CMDLINE_API
 
+#ifndef XAML_RESOURCE_API
+    #define XAML_RESOURCE_API __XAML_IMPORT
+#endif // !XAML_RESOURCE_API
+
 #ifndef EXTERN_C
     #ifdef __cplusplus
         #define EXTERN_C extern "C"
@@ -0,0 +1,29 @@
+#ifndef XAML_TEST_CHECK_HPP
+#define XAML_TEST_CHECK_HPP
+
+#include <iostream>
+
+// The checks of the tests, which report the failures and go on.
+
+inline int failures = 0;
+
+#define CHECK(expr)                                                                               \
+    do                                                                                            \
+    {                                                                                             \
+        if (!(expr))                                                                              \
+        {                                                                                         \
+            std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " << #expr << std::endl; \
+            failures++;                                                                           \
+        }                                                                                         \
+    } while (0)
+
+#define CHECK_OK(expr) CHECK(XAML_SUCCEEDED(expr))
+
+// Prints the count of the failures, and returns the exit code of the test.
+inline int report_failures()
+{
+    std::cout << failures << " failure(s)." << std::endl;
+    return failures ? 1 : 0;
+}
+
+#endif // !XAML_TEST_CHECK_HPP
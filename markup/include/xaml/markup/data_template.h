@@ -5,14 +5,25 @@
 #include <xaml/markup/template_base.h>
 #include <xaml/meta/meta_macros.h>
 
+#ifndef xaml_delegate_2__xaml_object__xaml_object_defined
+    #define xaml_delegate_2__xaml_object__xaml_object_defined
+XAML_DELEGATE_2_TYPE(XAML_T_O(xaml_object), XAML_T_O(xaml_object))
+#endif // !xaml_delegate_2__xaml_object__xaml_object_defined
+
 XAML_CLASS(xaml_data_template, { 0xa416dc5c, 0x8476, 0x4ec0, { 0xae, 0x92, 0x9d, 0x49, 0x90, 0xaa, 0xdc, 0x3f } })
 
-#define XAML_DATA_TEMPLATE_VTBL(type)                                  \
-    XAML_VTBL_INHERIT(XAML_TEMPLATE_BASE_VTBL(type));                  \
-    XAML_PROP(converter, type, xaml_converter**, xaml_converter*);     \
-    XAML_PROP(converter_parameter, type, xaml_object**, xaml_object*); \
-    XAML_PROP(converter_language, type, xaml_string**, xaml_string*)
+#define XAML_DATA_TEMPLATE_VTBL(type)                                                                                          \
+    XAML_VTBL_INHERIT(XAML_TEMPLATE_BASE_VTBL(type));                                                                          \
+    XAML_PROP(converter, type, xaml_converter**, xaml_converter*);                                                             \
+    XAML_PROP(converter_parameter, type, xaml_object**, xaml_object*);                                                         \
+    XAML_PROP(converter_language, type, xaml_string**, xaml_string*);                                                          \
+    XAML_PROP(binder, type, XAML_DELEGATE_2_NAME(xaml_object, xaml_object)**, XAML_DELEGATE_2_NAME(xaml_object, xaml_object)*); \
+    XAML_PROP(pool_limit, type, XAML_STD int32_t*, XAML_STD int32_t);                                                          \
+    XAML_METHOD(get_pool_stats, type, XAML_STD int64_t*, XAML_STD int64_t*)
 
+// A data template creates the objects for the items through the converter.
+// When a binder is set, the objects given back by recycle are pooled by the type of their data,
+// and the binder is invoked with a pooled object and the new data instead of converting it again.
 XAML_DECL_INTERFACE_(xaml_data_template, xaml_template_base)
 {
     XAML_DECL_VTBL(xaml_data_template, XAML_DATA_TEMPLATE_VTBL);
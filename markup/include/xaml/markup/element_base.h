@@ -28,13 +28,19 @@ XAML_CLASS(xaml_element_base, { 0x326263f6, 0x2e97, 0x4b7d, { 0xb2, 0xbd, 0x29,
 XAML_DELEGATE_2_TYPE(XAML_T_O(xaml_object), XAML_T_O(xaml_element_base))
 #endif // !xaml_delegate_2__xaml_object__xaml_element_base_defined
 
+#ifndef xaml_delegate_2__xaml_object__xaml_string_defined
+    #define xaml_delegate_2__xaml_object__xaml_string_defined
+XAML_DELEGATE_2_TYPE(XAML_T_O(xaml_object), XAML_T_O(xaml_string))
+#endif // !xaml_delegate_2__xaml_object__xaml_string_defined
+
 #define XAML_ELEMENT_BASE_VTBL(type)                                                    \
     XAML_VTBL_INHERIT(XAML_WEAK_REFERENCE_SOURCE_VTBL(type));                           \
     XAML_METHOD(add_resource, type, xaml_string*, xaml_object*);                        \
     XAML_METHOD(get_resource, type, xaml_string*, xaml_object**);                       \
     XAML_METHOD(get_resources, type, XAML_MAP_VIEW_2_NAME(xaml_string, xaml_object)**); \
     XAML_PROP(parent, type, xaml_element_base**, xaml_element_base*);                   \
-    XAML_EVENT(parent_changed, type, xaml_object, xaml_element_base)
+    XAML_EVENT(parent_changed, type, xaml_object, xaml_element_base);                   \
+    XAML_EVENT(resource_changed, type, xaml_object, xaml_string)
 
 XAML_DECL_INTERFACE_(xaml_element_base, xaml_weak_reference_source)
 {
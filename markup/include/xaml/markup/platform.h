@@ -8,6 +8,7 @@
 #define XAML_PLATFORM_GTK3 U("gtk3")
 #define XAML_PLATFORM_QT5 U("qt5")
 #define XAML_PLATFORM_COCOA U("cocoa")
+#define XAML_PLATFORM_HEADLESS U("headless")
 
 #ifdef XAML_UI_WINDOWS
     #define XAML_PLATFORM_CURRENT XAML_PLATFORM_WINDOWS
@@ -17,6 +18,8 @@
     #define XAML_PLATFORM_CURRENT XAML_PLATFORM_QT5
 #elif defined(XAML_UI_COCOA)
     #define XAML_PLATFORM_CURRENT XAML_PLATFORM_COCOA
+#elif defined(XAML_UI_HEADLESS)
+    #define XAML_PLATFORM_CURRENT XAML_PLATFORM_HEADLESS
 #endif // XAML_UI_WINDOWS
 
 XAML_CLASS(xaml_platform_on, { 0x89bc56ec, 0xd68e, 0x4149, { 0xbd, 0x39, 0x1d, 0x77, 0xc2, 0x51, 0xa9, 0xaf } })
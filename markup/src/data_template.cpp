@@ -1,14 +1,44 @@
+#include <unordered_map>
+#include <vector>
 #include <xaml/markup/data_template.h>
 
+using namespace std;
+
 struct xaml_data_template_impl : xaml_implement<xaml_data_template_impl, xaml_data_template>
 {
+    using binder_type = xaml_delegate<xaml_object, xaml_object>;
+
     XAML_PROP_IMPL(data_type, xaml_guid, xaml_guid*, xaml_guid const&)
     XAML_PROP_PTR_IMPL(converter, xaml_converter)
     XAML_PROP_PTR_IMPL(converter_parameter, xaml_object)
     XAML_PROP_PTR_IMPL(converter_language, xaml_string)
+    XAML_PROP_PTR_IMPL(binder, binder_type)
+    XAML_PROP_IMPL(pool_limit, int32_t, int32_t*, int32_t)
+
+    // The recycled objects, by the type of the data they were created for.
+    unordered_map<xaml_guid, vector<xaml_ptr<xaml_object>>> m_pool{};
+    int64_t m_pool_hits{ 0 };
+    int64_t m_pool_misses{ 0 };
+
+    xaml_data_template_impl() noexcept : m_pool_limit(64) {}
 
     xaml_result XAML_CALL create(xaml_object* value, xaml_object** ptr) noexcept override
     {
+        if (m_binder && m_converter && value)
+        {
+            xaml_guid type;
+            XAML_RETURN_IF_FAILED(value->get_guid(&type));
+            auto it = m_pool.find(type);
+            if (it != m_pool.end() && !it->second.empty())
+            {
+                xaml_ptr<xaml_object> obj = move(it->second.back());
+                it->second.pop_back();
+                m_pool_hits++;
+                XAML_RETURN_IF_FAILED(m_binder->invoke(obj, value));
+                return obj.query(ptr);
+            }
+            m_pool_misses++;
+        }
         if (m_converter)
         {
             return m_converter->convert(value, m_data_type, m_converter_parameter, m_converter_language, ptr);
@@ -23,6 +53,27 @@ struct xaml_data_template_impl : xaml_implement<xaml_data_template_impl, xaml_da
             return XAML_S_OK;
         }
     }
+
+    xaml_result XAML_CALL recycle(xaml_object* value, xaml_object* obj) noexcept override
+    try
+    {
+        // Without a binder, an object could not show other data,
+        // and without a converter, the object is the data itself rather than a container of it.
+        if (!m_binder || !m_converter || !value || !obj || obj == value) return XAML_S_OK;
+        xaml_guid type;
+        XAML_RETURN_IF_FAILED(value->get_guid(&type));
+        auto& pool = m_pool[type];
+        if ((int32_t)pool.size() < m_pool_limit) pool.emplace_back(obj);
+        return XAML_S_OK;
+    }
+    XAML_CATCH_RETURN()
+
+    xaml_result XAML_CALL get_pool_stats(int64_t* phits, int64_t* pmisses) noexcept override
+    {
+        *phits = m_pool_hits;
+        *pmisses = m_pool_misses;
+        return XAML_S_OK;
+    }
 };
 
 xaml_result XAML_CALL xaml_data_template_new(xaml_data_template** ptr) noexcept
@@ -37,6 +88,7 @@ xaml_result XAML_CALL xaml_data_template_members(xaml_type_info_registration* __
     XAML_TYPE_INFO_ADD_PROP(converter, xaml_converter);
     XAML_TYPE_INFO_ADD_PROP(converter_parameter, xaml_object);
     XAML_TYPE_INFO_ADD_PROP(converter_language, xaml_string);
+    XAML_TYPE_INFO_ADD_PROP(pool_limit, int32_t);
     return XAML_S_OK;
 }
 
@@ -1,21 +1,7 @@
+#include <resource_resolver.hpp>
 #include <xaml/markup/dynamic_resource.h>
 #include <xaml/markup/element_base.h>
 
-static xaml_result find_resource(xaml_ptr<xaml_element_base> element, xaml_ptr<xaml_string> const& key, xaml_object** ptr) noexcept
-{
-    while (element)
-    {
-        if (XAML_SUCCEEDED(element->get_resource(key, ptr)))
-        {
-            return XAML_S_OK;
-        }
-        xaml_element_base* next_element;
-        XAML_RETURN_IF_FAILED(element->get_parent(&next_element));
-        element = next_element;
-    }
-    return XAML_E_KEYNOTFOUND;
-}
-
 struct xaml_dynamic_resource_impl : xaml_implement<xaml_dynamic_resource_impl, xaml_dynamic_resource>
 {
     XAML_PROP_PTR_IMPL(key, xaml_string)
@@ -26,21 +12,24 @@ struct xaml_dynamic_resource_impl : xaml_implement<xaml_dynamic_resource_impl, x
         XAML_RETURN_IF_FAILED(mkctx->get_current_element(&current_element));
         xaml_ptr<xaml_element_base> element;
         XAML_RETURN_IF_FAILED(current_element->query(&element));
+        std::shared_ptr<xaml_resource_resolver> resolver;
+        XAML_RETURN_IF_FAILED(xaml_resource_resolver_current(&resolver));
         xaml_ptr<xaml_object> res_obj;
-        XAML_RETURN_IF_FAILED(find_resource(element, m_key, &res_obj));
+        XAML_RETURN_IF_FAILED(resolver->find(element, m_key, &res_obj));
         xaml_ptr<xaml_object> current_object;
         XAML_RETURN_IF_FAILED(mkctx->get_current_object(&current_object));
         xaml_ptr<xaml_string> current_property;
         XAML_RETURN_IF_FAILED(mkctx->get_current_property(&current_property));
-        xaml_guid type;
-        XAML_RETURN_IF_FAILED(current_object->get_guid(&type));
-        xaml_ptr<xaml_reflection_info> ref;
-        XAML_RETURN_IF_FAILED(ctx->get_type(type, &ref));
-        xaml_ptr<xaml_type_info> info;
-        XAML_RETURN_IF_FAILED(ref->query(&info));
         xaml_ptr<xaml_property_info> prop_info;
-        XAML_RETURN_IF_FAILED(info->get_property(current_property, &prop_info));
-        return prop_info->set(current_object, res_obj);
+        XAML_RETURN_IF_FAILED(resolver->find_property(ctx, current_object, current_property, &prop_info));
+        XAML_RETURN_IF_FAILED(prop_info->set(current_object, res_obj));
+        // A property of the element is set again when the resource changes,
+        // while one of a nested extension has been consumed already.
+        if (current_object.get() == current_element.get())
+        {
+            XAML_RETURN_IF_FAILED(resolver->watch(element, m_key, prop_info, res_obj));
+        }
+        return XAML_S_OK;
     }
 };
 
@@ -5,6 +5,7 @@ xaml_result XAML_CALL xaml_element_base_members(xaml_type_info_registration* __i
     using self_type = xaml_element_base;
     XAML_TYPE_INFO_ADD_PROP_RD(resources, XAML_MAP_VIEW_2_NAME(xaml_string, xaml_object));
     XAML_TYPE_INFO_ADD_EVENT(parent_changed);
+    XAML_TYPE_INFO_ADD_EVENT(resource_changed);
     return XAML_S_OK;
 }
 
@@ -0,0 +1,257 @@
+#include <resource_resolver.hpp>
+#include <unordered_set>
+#include <xaml/meta/type_info.h>
+
+using namespace std;
+
+// Tells whether the weak reference still refers to the element,
+// as the address of a dead element may be taken by a new one.
+static bool is_alive(xaml_ptr<xaml_weak_reference> const& weak, xaml_element_base* element) noexcept
+{
+    xaml_ptr<xaml_element_base> alive;
+    return XAML_SUCCEEDED(weak->resolve(&alive)) && alive.get() == element;
+}
+
+xaml_result xaml_resource_resolver::find(xaml_element_base* element, xaml_string* key, xaml_object** ptr) noexcept
+try
+{
+    string_view key_view;
+    XAML_RETURN_IF_FAILED(to_string_view(key, &key_view));
+    // The elements walked through before the resource, which all resolve to it.
+    vector<xaml_ptr<xaml_element_base>> walked;
+    xaml_ptr<xaml_object> value;
+    xaml_ptr<xaml_element_base> current = element;
+    while (current)
+    {
+        auto it = m_cache.find({ current.get(), key_view });
+        if (it != m_cache.end() && it->second.generation == m_generation && is_alive(it->second.element, current.get()))
+        {
+            value = it->second.value;
+            break;
+        }
+        walked.push_back(current);
+        XAML_RETURN_IF_FAILED(subscribe(current));
+        if (XAML_SUCCEEDED(current->get_resource(key, &value))) break;
+        value = nullptr;
+        xaml_ptr<xaml_element_base> next;
+        XAML_RETURN_IF_FAILED(current->get_parent(&next));
+        current = next;
+    }
+    for (auto& e : walked)
+    {
+        xaml_ptr<xaml_weak_reference> weak;
+        XAML_RETURN_IF_FAILED(e->get_weak_reference(&weak));
+        auto it = m_cache.find({ e.get(), key_view });
+        if (it == m_cache.end())
+        {
+            // The view of the map refers to the key kept by the entry.
+            m_cache.emplace(xaml_resource_key{ e.get(), key_view }, xaml_resource_entry{ m_generation, weak, key, value });
+        }
+        else
+        {
+            it->second.generation = m_generation;
+            it->second.element = weak;
+            it->second.value = value;
+        }
+    }
+    if (m_cache.size() >= m_prune_size) prune();
+    if (!value) return XAML_E_KEYNOTFOUND;
+    return value.query(ptr);
+}
+XAML_CATCH_RETURN()
+
+xaml_result xaml_resource_resolver::find_property(xaml_meta_context* ctx, xaml_object* obj, xaml_string* name, xaml_property_info** ptr) noexcept
+try
+{
+    xaml_guid type;
+    XAML_RETURN_IF_FAILED(obj->get_guid(&type));
+    string_view name_view;
+    XAML_RETURN_IF_FAILED(to_string_view(name, &name_view));
+    auto it = m_properties.find({ type, name_view });
+    if (it == m_properties.end())
+    {
+        xaml_ptr<xaml_reflection_info> ref;
+        XAML_RETURN_IF_FAILED(ctx->get_type(type, &ref));
+        xaml_ptr<xaml_type_info> info;
+        XAML_RETURN_IF_FAILED(ref->query(&info));
+        xaml_ptr<xaml_property_info> prop;
+        XAML_RETURN_IF_FAILED(info->get_property(name, &prop));
+        it = m_properties.emplace(xaml_property_key{ type, name_view }, xaml_property_entry{ name, prop }).first;
+    }
+    return it->second.prop.query(ptr);
+}
+XAML_CATCH_RETURN()
+
+xaml_result xaml_resource_resolver::watch(xaml_element_base* element, xaml_string* key, xaml_property_info* prop, xaml_object* value) noexcept
+try
+{
+    string_view key_view;
+    XAML_RETURN_IF_FAILED(to_string_view(key, &key_view));
+    auto it = m_watchers.find({ element, key_view });
+    if (it != m_watchers.end() && is_alive(it->second.element, element))
+    {
+        auto& watcher = it->second;
+        watcher.value = value;
+        for (auto& p : watcher.props)
+        {
+            if (p.get() == prop) return XAML_S_OK;
+        }
+        watcher.props.emplace_back(prop);
+        return XAML_S_OK;
+    }
+    // A watcher of a dead element at the same address is replaced.
+    if (it != m_watchers.end()) m_watchers.erase(it);
+    xaml_ptr<xaml_weak_reference> weak;
+    XAML_RETURN_IF_FAILED(element->get_weak_reference(&weak));
+    m_watchers.emplace(xaml_resource_key{ element, key_view }, xaml_resource_watcher{ weak, key, { prop }, value });
+    return XAML_S_OK;
+}
+XAML_CATCH_RETURN()
+
+xaml_result xaml_resource_resolver::invalidate(xaml_string* key) noexcept
+{
+    m_generation++;
+    if (m_watchers.empty()) return XAML_S_OK;
+    // A property set while updating may change the resources again.
+    if (m_updating)
+    {
+        m_pending = true;
+        return XAML_S_OK;
+    }
+    // Setting a property may release the last element, and this with it.
+    auto self = shared_from_this();
+    m_updating = true;
+    xaml_result hr = update(key);
+    while (XAML_SUCCEEDED(hr) && m_pending)
+    {
+        m_pending = false;
+        hr = update(nullptr);
+    }
+    m_pending = false;
+    m_updating = false;
+    return hr;
+}
+
+xaml_result xaml_resource_resolver::subscribe(xaml_element_base* element) noexcept
+try
+{
+    auto it = m_watched.find(element);
+    if (it != m_watched.end() && is_alive(it->second.element, element)) return XAML_S_OK;
+    xaml_resource_subscription subscription{};
+    XAML_RETURN_IF_FAILED(element->get_weak_reference(&subscription.element));
+    // The handlers keep the resolver alive while the element is subscribed.
+    auto self = shared_from_this();
+    xaml_ptr<xaml_delegate<xaml_object, xaml_element_base>> parent_callback;
+    XAML_RETURN_IF_FAILED((xaml_delegate_new(
+        [self](xaml_object*, xaml_element_base*) noexcept -> xaml_result { return self->invalidate(); },
+        &parent_callback)));
+    XAML_RETURN_IF_FAILED(element->add_parent_changed(parent_callback, &subscription.parent_token));
+    xaml_ptr<xaml_delegate<xaml_object, xaml_string>> resource_callback;
+    XAML_RETURN_IF_FAILED((xaml_delegate_new(
+        [self](xaml_object*, xaml_string* key) noexcept -> xaml_result { return self->invalidate(key); },
+        &resource_callback)));
+    xaml_result hr = element->add_resource_changed(resource_callback, &subscription.resource_token);
+    if (XAML_FAILED(hr))
+    {
+        element->remove_parent_changed(subscription.parent_token);
+        return hr;
+    }
+    m_watched[element] = move(subscription);
+    return XAML_S_OK;
+}
+XAML_CATCH_RETURN()
+
+xaml_result xaml_resource_resolver::update(xaml_string* key) noexcept
+try
+{
+    string_view key_view;
+    if (key)
+    {
+        XAML_RETURN_IF_FAILED(to_string_view(key, &key_view));
+    }
+    // The watchers to resolve are collected first,
+    // because setting a property may watch another one.
+    vector<pair<xaml_element_base*, xaml_ptr<xaml_string>>> keys;
+    keys.reserve(m_watchers.size());
+    for (auto& [k, watcher] : m_watchers)
+    {
+        if (!key || k.key == key_view) keys.emplace_back(k.element, watcher.key);
+    }
+    for (auto& [element_ptr, watcher_key] : keys)
+    {
+        string_view watcher_key_view;
+        XAML_RETURN_IF_FAILED(to_string_view(watcher_key, &watcher_key_view));
+        auto it = m_watchers.find({ element_ptr, watcher_key_view });
+        if (it == m_watchers.end()) continue;
+        xaml_ptr<xaml_element_base> element;
+        XAML_RETURN_IF_FAILED(it->second.element->resolve(&element));
+        if (!element)
+        {
+            m_watchers.erase(it);
+            continue;
+        }
+        xaml_ptr<xaml_object> value;
+        // A resource no longer found leaves the property as it is.
+        if (XAML_FAILED(find(element, watcher_key, &value))) continue;
+        // The cache may have been pruned.
+        it = m_watchers.find({ element_ptr, watcher_key_view });
+        if (it == m_watchers.end() || value.get() == it->second.value.get()) continue;
+        it->second.value = value;
+        auto props = it->second.props;
+        for (auto& prop : props)
+        {
+            XAML_RETURN_IF_FAILED(prop->set(element, value));
+        }
+    }
+    return XAML_S_OK;
+}
+XAML_CATCH_RETURN()
+
+void xaml_resource_resolver::prune() noexcept
+{
+    erase_if(m_cache, [this](auto const& p) {
+        return p.second.generation != m_generation || !is_alive(p.second.element, p.first.element);
+    });
+    erase_if(m_watchers, [](auto const& p) { return !is_alive(p.second.element, p.first.element); });
+    // The handlers cannot be removed while one of them is being invoked.
+    if (!m_updating)
+    {
+        try
+        {
+            unordered_set<xaml_element_base*> used;
+            for (auto& p : m_cache) used.insert(p.first.element);
+            for (auto& p : m_watchers) used.insert(p.first.element);
+            erase_if(m_watched, [&used](auto const& p) {
+                if (!is_alive(p.second.element, p.first)) return true;
+                if (used.count(p.first)) return false;
+                p.first->remove_parent_changed(p.second.parent_token);
+                p.first->remove_resource_changed(p.second.resource_token);
+                return true;
+            });
+        }
+        catch (...)
+        {
+            // The elements stay subscribed, which is only a waste.
+        }
+    }
+    else
+    {
+        erase_if(m_watched, [](auto const& p) { return !is_alive(p.second.element, p.first); });
+    }
+    m_prune_size = (max)(size_t{ 256 }, m_cache.size() * 2);
+}
+
+xaml_result xaml_resource_resolver_current(shared_ptr<xaml_resource_resolver>* ptr) noexcept
+try
+{
+    // Only a weak reference is kept, so that nothing is held until the exit.
+    static weak_ptr<xaml_resource_resolver> current{};
+    *ptr = current.lock();
+    if (!*ptr)
+    {
+        *ptr = make_shared<xaml_resource_resolver>();
+        current = *ptr;
+    }
+    return XAML_S_OK;
+}
+XAML_CATCH_RETURN()
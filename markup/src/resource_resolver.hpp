@@ -0,0 +1,132 @@
+#ifndef XAML_MARKUP_RESOURCE_RESOLVER_HPP
+#define XAML_MARKUP_RESOURCE_RESOLVER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <xaml/markup/element_base.h>
+#include <xaml/meta/meta_context.h>
+
+// The keys view the strings kept alive by the values of the maps,
+// so that a lookup needs neither a copy nor a heterogeneous find.
+struct xaml_resource_key
+{
+    xaml_element_base* element;
+    std::string_view key;
+};
+
+struct xaml_resource_key_hash
+{
+    std::size_t operator()(xaml_resource_key const& key) const noexcept
+    {
+        std::size_t seed = std::hash<std::string_view>{}(key.key);
+        return seed ^ (std::hash<xaml_element_base*>{}(key.element) + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+    }
+};
+
+struct xaml_resource_key_equal
+{
+    bool operator()(xaml_resource_key const& lhs, xaml_resource_key const& rhs) const noexcept
+    {
+        return lhs.element == rhs.element && lhs.key == rhs.key;
+    }
+};
+
+struct xaml_property_key
+{
+    xaml_guid type;
+    std::string_view name;
+};
+
+struct xaml_property_key_hash
+{
+    std::size_t operator()(xaml_property_key const& key) const noexcept
+    {
+        std::size_t seed = std::hash<std::string_view>{}(key.name);
+        return seed ^ (std::hash<xaml_guid>{}(key.type) + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+    }
+};
+
+struct xaml_property_key_equal
+{
+    bool operator()(xaml_property_key const& lhs, xaml_property_key const& rhs) const noexcept
+    {
+        return lhs.type == rhs.type && lhs.name == rhs.name;
+    }
+};
+
+// A resolved lookup, valid while its generation is the current one.
+struct xaml_resource_entry
+{
+    std::uint64_t generation;
+    // Tells whether the element is still the one the entry was made for.
+    xaml_ptr<xaml_weak_reference> element;
+    // The key viewed by the map.
+    xaml_ptr<xaml_string> key;
+    // The resource, or null if no element in the chain defines the key.
+    xaml_ptr<xaml_object> value;
+};
+
+struct xaml_property_entry
+{
+    // The name viewed by the map.
+    xaml_ptr<xaml_string> name;
+    xaml_ptr<xaml_property_info> prop;
+};
+
+// The properties of an element set to a dynamic resource of a key,
+// which are set again when the resource changes.
+struct xaml_resource_watcher
+{
+    xaml_ptr<xaml_weak_reference> element;
+    // The key viewed by the map.
+    xaml_ptr<xaml_string> key;
+    std::vector<xaml_ptr<xaml_property_info>> props;
+    xaml_ptr<xaml_object> value;
+};
+
+// An element whose changes are subscribed, with the tokens to unsubscribe.
+struct xaml_resource_subscription
+{
+    xaml_ptr<xaml_weak_reference> element;
+    std::int32_t parent_token;
+    std::int32_t resource_token;
+};
+
+// Resolves resources along the parent chains of the elements on the UI thread.
+// The lookups are cached, and the whole cache is made stale by bumping the generation
+// whenever a resource or a parent of a visited element changes.
+// The subscribed elements keep the resolver alive, and an element is unsubscribed
+// once neither a lookup nor a watcher refers to it.
+struct xaml_resource_resolver : std::enable_shared_from_this<xaml_resource_resolver>
+{
+    std::uint64_t m_generation{ 0 };
+    std::unordered_map<xaml_resource_key, xaml_resource_entry, xaml_resource_key_hash, xaml_resource_key_equal> m_cache{};
+    // The size of the cache at which the dead and stale entries are dropped.
+    std::size_t m_prune_size{ 256 };
+    std::unordered_map<xaml_element_base*, xaml_resource_subscription> m_watched{};
+    std::unordered_map<xaml_resource_key, xaml_resource_watcher, xaml_resource_key_hash, xaml_resource_key_equal> m_watchers{};
+    std::unordered_map<xaml_property_key, xaml_property_entry, xaml_property_key_hash, xaml_property_key_equal> m_properties{};
+    bool m_updating{ false };
+    bool m_pending{ false };
+
+    xaml_result find(xaml_element_base* element, xaml_string* key, xaml_object** ptr) noexcept;
+    // Finds a property of the type of the object, resolved by name only once.
+    xaml_result find_property(xaml_meta_context* ctx, xaml_object* obj, xaml_string* name, xaml_property_info** ptr) noexcept;
+    xaml_result watch(xaml_element_base* element, xaml_string* key, xaml_property_info* prop, xaml_object* value) noexcept;
+    // Makes the cache stale, and sets the watched properties whose resources changed.
+    // Only the watchers of the key are resolved again if it is given.
+    xaml_result invalidate(xaml_string* key = nullptr) noexcept;
+
+private:
+    xaml_result subscribe(xaml_element_base* element) noexcept;
+    xaml_result update(xaml_string* key) noexcept;
+    void prune() noexcept;
+};
+
+// The resolver shared by the living elements, or a new one if there is none.
+xaml_result xaml_resource_resolver_current(std::shared_ptr<xaml_resource_resolver>* ptr) noexcept;
+
+#endif // !XAML_MARKUP_RESOURCE_RESOLVER_HPP
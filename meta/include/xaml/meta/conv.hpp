@@ -1,6 +1,14 @@
 #ifndef XAML_CONV_HPP
 #define XAML_CONV_HPP
 
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <system_error>
 #include <xaml/box.h>
 #include <xaml/object.h>
 #include <xaml/ptr.hpp>
@@ -35,7 +43,7 @@ struct __xaml_converter<xaml_ptr<T>, std::enable_if_t<std::is_base_of_v<xaml_obj
     }
 };
 
-template <typename T, T (*func)(std::string_view) noexcept>
+template <typename T, xaml_result (*func)(std::string_view, T*) noexcept>
 struct __xaml_converter_helper
 {
     xaml_result operator()(xaml_ptr<xaml_object> const& obj, T* value) const noexcept
@@ -50,81 +58,133 @@ struct __xaml_converter_helper
             {
                 std::string_view view;
                 XAML_RETURN_IF_FAILED(to_string_view(str, &view));
-                *value = func(view);
-                return XAML_S_OK;
+                return func(view, value);
             }
         }
         return XAML_E_INVALIDARG;
     }
 };
 
-template <typename TInt>
-struct __stoi_helper
+constexpr bool __xaml_is_space(char c) noexcept
 {
-    using return_type = TInt;
-    return_type operator()(std::string_view str) const noexcept
-    {
-        long value = std::strtol(str.data(), nullptr, 10);
-        return static_cast<return_type>(value);
-    }
-};
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
 
-template <>
-struct __stoi_helper<unsigned long>
+constexpr std::string_view __xaml_trim(std::string_view str) noexcept
 {
-    using return_type = unsigned long;
-    return_type operator()(std::string_view str) const noexcept
-    {
-        return std::strtoul(str.data(), nullptr, 10);
-    }
-};
+    while (!str.empty() && __xaml_is_space(str.front())) str.remove_prefix(1);
+    while (!str.empty() && __xaml_is_space(str.back())) str.remove_suffix(1);
+    return str;
+}
 
-template <>
-struct __stoi_helper<long long>
+constexpr xaml_result __xaml_from_chars_result(std::errc ec) noexcept
 {
-    using return_type = long long;
-    return_type operator()(std::string_view str) const noexcept
+    if (ec == std::errc{})
+        return XAML_S_OK;
+    else if (ec == std::errc::result_out_of_range)
+        return XAML_E_OUTOFBOUNDS;
+    else
+        return XAML_E_INVALIDARG;
+}
+
+// Parses a whole literal, rejecting trailing characters.
+// Unlike strtol and strtod, it is locale independent,
+// and never reads beyond the view.
+// A malformed literal is an expected failure, so it is returned without raising.
+template <typename TInt>
+inline xaml_result __stoi_impl(std::string_view str, TInt* value) noexcept
+{
+    str = __xaml_trim(str);
+    if (!str.empty() && str.front() == '+')
     {
-        return std::strtoll(str.data(), nullptr, 10);
+        str.remove_prefix(1);
+        if (!str.empty() && str.front() == '-') return XAML_E_INVALIDARG;
     }
-};
+    if (str.empty()) return XAML_E_INVALIDARG;
+    // Fast path for short decimal literals, like "10".
+    if constexpr (sizeof(TInt) >= sizeof(std::int32_t))
+    {
+        if (str.length() <= 9)
+        {
+            std::size_t i = 0;
+            bool neg = false;
+            if constexpr (std::is_signed_v<TInt>)
+            {
+                if (str[0] == '-')
+                {
+                    neg = true;
+                    i++;
+                }
+            }
+            if (i < str.length())
+            {
+                std::uint32_t result = 0;
+                for (; i < str.length(); i++)
+                {
+                    unsigned d = (unsigned)(str[i] - '0');
+                    if (d > 9) break;
+                    result = result * 10 + d;
+                }
+                if (i == str.length())
+                {
+                    *value = neg ? -(TInt)result : (TInt)result;
+                    return XAML_S_OK;
+                }
+            }
+        }
+    }
+    TInt result;
+    auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.length(), result, 10);
+    if (ec != std::errc{}) return __xaml_from_chars_result(ec);
+    if (ptr != str.data() + str.length()) return XAML_E_INVALIDARG;
+    *value = result;
+    return XAML_S_OK;
+}
 
-template <>
-struct __stoi_helper<unsigned long long>
+template <typename TInt>
+struct __stoi_helper
 {
-    using return_type = unsigned long long;
-    return_type operator()(std::string_view str) const noexcept
+    xaml_result operator()(std::string_view str, TInt* value) const noexcept
     {
-        return std::strtoull(str.data(), nullptr, 10);
+        return __stoi_impl<TInt>(str, value);
     }
 };
 
 template <>
 struct __stoi_helper<bool>
 {
-    using return_type = bool;
-    return_type operator()(std::string_view str) const noexcept
+    xaml_result operator()(std::string_view str, bool* value) const noexcept
     {
-        constexpr const char __true_str[] = "true";
-        if (str.length() != 4) return false;
-        for (std::size_t i = 0; i < 4; i++)
+        constexpr auto equals_ignore_case = [](std::string_view lhs, std::string_view rhs) noexcept {
+            if (lhs.length() != rhs.length()) return false;
+            for (std::size_t i = 0; i < lhs.length(); i++)
+            {
+                if (std::tolower((unsigned char)lhs[i]) != rhs[i]) return false;
+            }
+            return true;
+        };
+        str = __xaml_trim(str);
+        if (equals_ignore_case(str, "true"))
+        {
+            *value = true;
+            return XAML_S_OK;
+        }
+        else if (equals_ignore_case(str, "false"))
         {
-            if (std::tolower(str[i]) != __true_str[i]) return false;
+            *value = false;
+            return XAML_S_OK;
         }
-        return true;
+        return XAML_E_INVALIDARG;
     }
 };
 
 template <>
 struct __stoi_helper<char>
 {
-    using return_type = char;
-    return_type operator()(std::string_view str) const noexcept
+    xaml_result operator()(std::string_view str, char* value) const noexcept
     {
-        if (str.empty())
-            return 0;
-        else
-            return str[0];
+        *value = str.empty() ? 0 : str[0];
+        return XAML_S_OK;
     }
 };
 
@@ -132,9 +192,9 @@ template <typename T>
 constexpr bool __can_stoi_v = std::is_integral_v<T>;
 
 template <typename TInt>
-inline TInt __stoi(std::string_view str) noexcept
+inline xaml_result __stoi(std::string_view str, TInt* value) noexcept
 {
-    return __stoi_helper<TInt>{}(str);
+    return __stoi_helper<TInt>{}(str, value);
 }
 
 template <typename T>
@@ -142,44 +202,89 @@ struct __xaml_converter<T, std::enable_if_t<__can_stoi_v<T>>> : __xaml_converter
 {
 };
 
-template <typename TFloat>
-struct __stof_helper
+// Exact fast path for literals like "0.5" or "-12.25":
+// when both the mantissa and the power of ten are exactly representable,
+// a single division is correctly rounded.
+inline bool __stof_fast(std::string_view str, double* value) noexcept
 {
-    using return_type = TFloat;
-    return_type operator()(std::string_view str) const noexcept
+    constexpr double __pow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15 };
+    if (str.empty() || str.length() > 16) return false;
+    std::size_t i = 0;
+    bool neg = false;
+    if (str[0] == '-')
     {
-        float value = std::strtold(str.data(), nullptr);
-        return static_cast<return_type>(value);
+        neg = true;
+        i++;
     }
-};
-
-template <>
-struct __stof_helper<float>
-{
-    using return_type = float;
-    return_type operator()(std::string_view str) const noexcept
+    std::uint64_t mantissa = 0;
+    std::size_t digits = 0;
+    std::size_t frac = 0;
+    bool dot = false;
+    for (; i < str.length(); i++)
     {
-        return std::strtof(str.data(), nullptr);
+        char c = str[i];
+        if (c == '.' && !dot)
+        {
+            dot = true;
+            continue;
+        }
+        unsigned d = (unsigned)(c - '0');
+        if (d > 9) return false;
+        mantissa = mantissa * 10 + d;
+        digits++;
+        if (dot) frac++;
     }
-};
+    if (!digits || digits > 15) return false;
+    double result = (double)mantissa / __pow10[frac];
+    *value = neg ? -result : result;
+    return true;
+}
 
-template <>
-struct __stof_helper<double>
+template <typename TFloat>
+inline xaml_result __stof_impl(std::string_view str, TFloat* value) noexcept
 {
-    using return_type = double;
-    return_type operator()(std::string_view str) const noexcept
+    str = __xaml_trim(str);
+    if (!str.empty() && str.front() == '+')
     {
-        return std::strtod(str.data(), nullptr);
+        str.remove_prefix(1);
+        if (!str.empty() && str.front() == '-') return XAML_E_INVALIDARG;
     }
-};
+    if (str.empty()) return XAML_E_INVALIDARG;
+    if constexpr (std::is_same_v<TFloat, double>)
+    {
+        if (__stof_fast(str, value)) return XAML_S_OK;
+    }
+#ifdef __cpp_lib_to_chars
+    TFloat result;
+    auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.length(), result);
+    if (ec != std::errc{}) return __xaml_from_chars_result(ec);
+    if (ptr != str.data() + str.length()) return XAML_E_INVALIDARG;
+    *value = result;
+    return XAML_S_OK;
+#else
+    // The standard library doesn't support floating-point from_chars.
+    // Copy the literal to make it NUL-terminated.
+    char buffer[64];
+    if (str.length() >= sizeof(buffer)) return XAML_E_INVALIDARG;
+    std::memcpy(buffer, str.data(), str.length());
+    buffer[str.length()] = '\0';
+    char* end;
+    errno = 0;
+    long double result = std::strtold(buffer, &end);
+    if (end != buffer + str.length()) return XAML_E_INVALIDARG;
+    if (errno == ERANGE) return XAML_E_OUTOFBOUNDS;
+    *value = static_cast<TFloat>(result);
+    return XAML_S_OK;
+#endif // __cpp_lib_to_chars
+}
 
 template <typename T>
 constexpr bool __can_stof_v = std::is_floating_point_v<T>;
 
 template <typename TFloat>
-inline TFloat __stof(std::string_view str) noexcept
+inline xaml_result __stof(std::string_view str, TFloat* value) noexcept
 {
-    return __stof_helper<TFloat>{}(str);
+    return __stof_impl<TFloat>(str, value);
 }
 
 template <typename T>
@@ -187,4 +292,36 @@ struct __xaml_converter<T, std::enable_if_t<__can_stof_v<T>>> : __xaml_converter
 {
 };
 
+// Splits a list like "1,2,3,4" or "1 2", separated by whitespaces or commas,
+// and calls the function with each item until it fails.
+template <typename F>
+inline xaml_result __xaml_split_list(std::string_view str, F&& f) noexcept
+{
+    std::size_t i = 0;
+    while (true)
+    {
+        while (i < str.length() && (__xaml_is_space(str[i]) || str[i] == ',')) i++;
+        if (i == str.length()) break;
+        std::size_t start = i;
+        while (i < str.length() && !__xaml_is_space(str[i]) && str[i] != ',') i++;
+        xaml_result hr = f(str.substr(start, i - start));
+        if (XAML_FAILED(hr)) return hr;
+    }
+    return XAML_S_OK;
+}
+
+// Parses at most N numbers of a list.
+template <std::size_t N>
+inline xaml_result __stof_list(std::string_view str, double (&values)[N], std::size_t* pcount) noexcept
+{
+    std::size_t count = 0;
+    xaml_result hr = __xaml_split_list(str, [&](std::string_view item) noexcept -> xaml_result {
+        if (count == N) return XAML_E_INVALIDARG;
+        return __stof<double>(item, &values[count++]);
+    });
+    if (XAML_FAILED(hr)) return hr;
+    *pcount = count;
+    return XAML_S_OK;
+}
+
 #endif // !XAML_CONV_HPP
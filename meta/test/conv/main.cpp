@@ -0,0 +1,183 @@
+#include <cerrno>
+#include <chrono>
+#include <clocale>
+#include <cstdlib>
+#include <cstring>
+#include <nowide/iostream.hpp>
+#include <random>
+#include <sf/format.hpp>
+#include <string>
+#include <test_check.hpp>
+#include <xaml/meta/conv.hpp>
+
+using namespace std;
+using nowide::cout;
+
+// The reference implementation: the old strtoll/strtod behavior,
+// but with a NUL-terminated copy and a full-match requirement.
+static bool ref_stoll(string_view str, long long* value)
+{
+    str = __xaml_trim(str);
+    if (str.empty() || __xaml_is_space(str.front())) return false;
+    string s{ str };
+    char* end;
+    errno = 0;
+    *value = strtoll(s.c_str(), &end, 10);
+    return errno == 0 && end == s.c_str() + s.length();
+}
+
+static bool ref_stod(string_view str, double* value, bool* range)
+{
+    str = __xaml_trim(str);
+    if (str.empty()) return false;
+    string s{ str };
+    char* end;
+    errno = 0;
+    *value = strtod(s.c_str(), &end);
+    *range = errno == ERANGE;
+    return end == s.c_str() + s.length();
+}
+
+static string random_literal(mt19937_64& rnd)
+{
+    constexpr char alphabet[] = "0123456789+-.eE ,\t";
+    uniform_int_distribution<size_t> len_dist{ 0, 24 };
+    uniform_int_distribution<size_t> char_dist{ 0, sizeof(alphabet) - 2 };
+    string s(len_dist(rnd), '\0');
+    for (char& c : s) c = alphabet[char_dist(rnd)];
+    return s;
+}
+
+static string random_number(mt19937_64& rnd)
+{
+    switch (rnd() % 4)
+    {
+    case 0:
+        return to_string((int64_t)rnd() >> (rnd() % 64));
+    case 1:
+        return to_string((int32_t)(rnd() % 2001) - 1000);
+    case 2:
+        return sf::sprint(U("{}.{}"), (int32_t)(rnd() % 2001) - 1000, rnd() % 100000);
+    default:
+    {
+        uniform_real_distribution<double> dist{ -1e6, 1e6 };
+        char buffer[64];
+        auto [ptr, ec] = to_chars(buffer, buffer + sizeof(buffer), dist(rnd));
+        return string(buffer, ptr);
+    }
+    }
+}
+
+static void test_fixed()
+{
+    int32_t i;
+    CHECK(XAML_SUCCEEDED(__stoi<int32_t>("10", &i)) && i == 10);
+    CHECK(XAML_SUCCEEDED(__stoi<int32_t>(" -42 ", &i)) && i == -42);
+    CHECK(XAML_SUCCEEDED(__stoi<int32_t>("+7", &i)) && i == 7);
+    CHECK(XAML_SUCCEEDED(__stoi<int32_t>("-2147483648", &i)) && i == INT32_MIN);
+    CHECK(__stoi<int32_t>("2147483648", &i) == (xaml_result)XAML_E_OUTOFBOUNDS);
+    CHECK(XAML_FAILED(__stoi<int32_t>("", &i)));
+    CHECK(XAML_FAILED(__stoi<int32_t>("-", &i)));
+    CHECK(XAML_FAILED(__stoi<int32_t>("12px", &i)));
+    CHECK(XAML_FAILED(__stoi<int32_t>("1 2", &i)));
+    uint32_t u;
+    CHECK(XAML_FAILED(__stoi<uint32_t>("-1", &u)));
+    CHECK(XAML_SUCCEEDED(__stoi<uint32_t>("4294967295", &u)) && u == UINT32_MAX);
+    // The view is not NUL-terminated.
+    CHECK(XAML_SUCCEEDED(__stoi<int32_t>(string_view{ "123456", 3 }, &i)) && i == 123);
+
+    bool b;
+    CHECK(XAML_SUCCEEDED(__stoi<bool>("True", &b)) && b);
+    CHECK(XAML_SUCCEEDED(__stoi<bool>("false", &b)) && !b);
+    CHECK(XAML_FAILED(__stoi<bool>("yes", &b)));
+
+    double d;
+    CHECK(XAML_SUCCEEDED(__stof<double>("0.5", &d)) && d == 0.5);
+    CHECK(XAML_SUCCEEDED(__stof<double>("-12.25", &d)) && d == -12.25);
+    CHECK(XAML_SUCCEEDED(__stof<double>("1e3", &d)) && d == 1000);
+    CHECK(XAML_SUCCEEDED(__stof<double>("0.1", &d)) && d == 0.1);
+    CHECK(XAML_FAILED(__stof<double>("0.5.1", &d)));
+    CHECK(XAML_FAILED(__stof<double>(".", &d)));
+    CHECK(XAML_SUCCEEDED(__stof<double>(string_view{ "2.5e10", 3 }, &d)) && d == 2.5);
+    float f;
+    CHECK(XAML_SUCCEEDED(__stof<float>("0.1", &f)) && f == 0.1f);
+
+    double list[4];
+    size_t count;
+    CHECK(XAML_SUCCEEDED(__stof_list("1,2,3,4", list, &count)) && count == 4 && list[0] == 1 && list[3] == 4);
+    CHECK(XAML_SUCCEEDED(__stof_list(" 1 , 2 ", list, &count)) && count == 2 && list[1] == 2);
+    CHECK(XAML_FAILED(__stof_list("1,2,3,4,5", list, &count)));
+}
+
+static void test_random(size_t iterations)
+{
+    mt19937_64 rnd{ 20201019 };
+    for (size_t n = 0; n < iterations; n++)
+    {
+        string s = (n % 2) ? random_literal(rnd) : random_number(rnd);
+        {
+            long long expected;
+            bool ok = ref_stoll(s, &expected);
+            int64_t value;
+            xaml_result hr = __stoi<int64_t>(s, &value);
+            CHECK(ok == XAML_SUCCEEDED(hr));
+            if (ok && XAML_SUCCEEDED(hr)) CHECK(value == expected);
+        }
+        {
+            double expected;
+            bool range = false;
+            bool ok = ref_stod(s, &expected, &range);
+            double value;
+            xaml_result hr = __stof<double>(s, &value);
+            if (!range)
+            {
+                CHECK(ok == XAML_SUCCEEDED(hr));
+                if (ok && XAML_SUCCEEDED(hr)) CHECK(value == expected);
+            }
+        }
+        {
+            double list[4];
+            size_t count;
+            (void)__stof_list(s, list, &count);
+        }
+    }
+}
+
+template <typename F>
+static double measure(F&& f)
+{
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+static void bench()
+{
+    constexpr const char* literals[] = { "10", "0.5", "120", "-3.25", "1", "0", "24.5", "300" };
+    constexpr size_t count = 1000000;
+    double sum = 0;
+    double old_ms = measure([&]() {
+        for (size_t i = 0; i < count; i++)
+        {
+            string_view s = literals[i % size(literals)];
+            sum += strtod(s.data(), nullptr);
+        }
+    });
+    double new_ms = measure([&]() {
+        for (size_t i = 0; i < count; i++)
+        {
+            double d;
+            if (XAML_SUCCEEDED(__stof<double>(literals[i % size(literals)], &d))) sum += d;
+        }
+    });
+    sf::println(cout, U("strtod: {} ms, __stof: {} ms ({})"), old_ms, new_ms, sum);
+}
+
+int main(int argc, char** argv)
+{
+    setlocale(LC_ALL, "C");
+    test_fixed();
+    test_random(argc > 1 ? strtoul(argv[1], nullptr, 10) : 100000);
+    bench();
+    return report_failures();
+}
@@ -8,4 +8,20 @@
 EXTERN_C XAML_PARSER_API xaml_result XAML_CALL xaml_parser_deserialize(xaml_meta_context*, xaml_node*, xaml_object**) XAML_NOEXCEPT;
 EXTERN_C XAML_PARSER_API xaml_result XAML_CALL xaml_parser_deserialize_inplace(xaml_meta_context*, xaml_node*, xaml_object*) XAML_NOEXCEPT;
 
+XAML_CLASS(xaml_prepared_template, { 0x7df7a209, 0xea0e, 0x4c30, { 0xa5, 0x6b, 0x95, 0x61, 0x65, 0x36, 0xb1, 0xfa } })
+
+#define XAML_PREPARED_TEMPLATE_VTBL(type)          \
+    XAML_VTBL_INHERIT(XAML_OBJECT_VTBL(type));     \
+    XAML_METHOD(instantiate, type, xaml_object**); \
+    XAML_METHOD(instantiate_inplace, type, xaml_object*)
+
+XAML_DECL_INTERFACE_(xaml_prepared_template, xaml_object)
+{
+    XAML_DECL_VTBL(xaml_prepared_template, XAML_PREPARED_TEMPLATE_VTBL);
+};
+
+// Resolves a node tree once into a plan, which constructs and sets up the objects
+// each time it is instantiated, without the lookups and conversions of deserialization.
+EXTERN_C XAML_PARSER_API xaml_result XAML_CALL xaml_parser_prepare(xaml_meta_context*, xaml_node*, xaml_prepared_template**) XAML_NOEXCEPT;
+
 #endif // !XAML_PARSER_DESERIALIZER_H
@@ -1,7 +1,9 @@
 #define XAML_RAISE_LEVEL xaml_result_raise_warning
 
+#include <node.hpp>
 #include <xaml/markup/element_base.h>
 #include <xaml/markup/markup_extension.h>
+#include <xaml/meta/conv.hpp>
 #include <xaml/parser/deserializer.h>
 #include <xaml/parser/parser.h>
 
@@ -45,24 +47,26 @@ static xaml_result XAML_CALL xaml_method_info_bind(xaml_method_info* func, xaml_
         npts, ptr);
 }
 
+// One context is shared by all extensions provided in an instance,
+// and it is valid only during the calls to provide.
 struct xaml_deserializer_context_impl : xaml_implement<xaml_deserializer_context_impl, xaml_markup_context>
 {
-    xaml_object* m_current;
+    xaml_object* m_current{ nullptr };
     xaml_result XAML_CALL get_current_element(xaml_object** ptr) noexcept override
     {
         return m_current->query(ptr);
     }
 
-    xaml_object* m_object;
+    xaml_object* m_object{ nullptr };
     xaml_result XAML_CALL get_current_object(xaml_object** ptr) noexcept override
     {
         return m_object->query(ptr);
     }
 
-    xaml_ptr<xaml_string> m_prop;
+    xaml_string* m_prop{ nullptr };
     xaml_result XAML_CALL get_current_property(xaml_string** ptr) noexcept override
     {
-        return m_prop.query(ptr);
+        return m_prop->query(ptr);
     }
 
     xaml_ptr<xaml_map<xaml_string, xaml_object>> m_symbols;
@@ -71,322 +75,438 @@ struct xaml_deserializer_context_impl : xaml_implement<xaml_deserializer_context
         return m_symbols->lookup(key, ptr);
     }
 
-    xaml_deserializer_context_impl(xaml_object* current, xaml_object* current_obj, xaml_ptr<xaml_string> const& prop, xaml_ptr<xaml_map<xaml_string, xaml_object>> const& symbols) noexcept
-        : m_current(current), m_object(current_obj), m_prop(prop), m_symbols(symbols) {}
+    xaml_deserializer_context_impl(xaml_ptr<xaml_map<xaml_string, xaml_object>> const& symbols) noexcept : m_symbols(symbols) {}
+
+    void set(xaml_object* current, xaml_object* current_obj, xaml_string* prop) noexcept
+    {
+        m_current = current;
+        m_object = current_obj;
+        m_prop = prop;
+    }
 };
 
-struct deserializer_impl
+// A deserialization resolved into operations, which could be executed many times.
+// The objects of an instance are kept in slots, to which the operations refer by index.
+// The root is in the slot 0, and the first operation constructs it.
+enum class plan_op_kind
 {
-    xaml_ptr<xaml_meta_context> m_ctx;
-    xaml_ptr<xaml_map<xaml_string, xaml_object>> symbols;
-
-    deserializer_impl(xaml_ptr<xaml_meta_context> const& ctx) noexcept : m_ctx(ctx) {}
+    // Constructs an object of the type into the slot.
+    construct,
+    // Registers the object in the slot by the name in the string.
+    name,
+    // Adds the object in the value slot as a resource of the object in the slot.
+    add_resource,
+    // Sets the converted value to the property of the object in the slot.
+    set_value,
+    // Sets the object in the value slot to the property, or provides it if it is an extension.
+    set_object,
+    // Adds the object in the value slot to the collection property.
+    add_item,
+    // Binds the method of the root to the event of the object in the slot.
+    hook_event,
+    // Provides the extension in the value slot for the property named by the string,
+    // of the object in the slot, with the element in the element slot.
+    provide
+};
 
-    xaml_result init() noexcept
-    {
-        xaml_ptr<xaml_hasher<xaml_string>> hasher;
-        XAML_RETURN_IF_FAILED(xaml_hasher_string_default(&hasher));
-        XAML_RETURN_IF_FAILED(xaml_map_new(hasher.get(), &symbols));
-        return XAML_S_OK;
-    }
+struct plan_op
+{
+    plan_op_kind kind;
+    int32_t slot{ 0 };
+    int32_t value_slot{ 0 };
+    int32_t element_slot{ 0 };
+    xaml_type_info* type{ nullptr };
+    xaml_property_info* prop{ nullptr };
+    xaml_collection_property_info* cprop{ nullptr };
+    xaml_event_info* event{ nullptr };
+    xaml_ptr<xaml_method_info> method{};
+    xaml_ptr<xaml_object> value{};
+    xaml_ptr<xaml_string> str{};
+    // Boxes the converted value again for each instance, as a box could be changed by its holder.
+    xaml_result (*rebox)(xaml_object*, xaml_object**) noexcept {};
+};
 
-    xaml_result construct_impl(xaml_ptr<xaml_node> const& node, xaml_ptr<xaml_object> const& root, xaml_ptr<xaml_type_info> const& root_type, xaml_object** ptr) noexcept;
+struct deserialize_plan
+{
+    xaml_ptr<xaml_meta_context> m_ctx;
+    // Keeps the infos referred by the operations alive.
+    shared_ptr<compact_tree> m_tree;
+    vector<plan_op> m_ops{};
+    int32_t m_slots{ 0 };
 
-    xaml_result deserialize_impl(xaml_ptr<xaml_object> const& mc, xaml_ptr<xaml_node> const& node, xaml_ptr<xaml_object> const& root, xaml_ptr<xaml_type_info> const& root_type) noexcept;
+    xaml_result execute(xaml_object* root, xaml_object** ptr) const noexcept;
+};
 
-    xaml_result deserialize_extensions(xaml_ptr<xaml_node> const& node) noexcept;
+struct plan_builder
+{
+    deserialize_plan& m_plan;
+    unordered_map<compact_node*, int32_t> m_node_slots{};
 
-    xaml_result deserialize(xaml_ptr<xaml_node> const& node, xaml_ptr<xaml_object> const& mc, xaml_ptr<xaml_type_info> const& root_type) noexcept;
+    xaml_result string_value(xaml_property_info* info, string_view value, plan_op& op) noexcept;
 
-    xaml_result deserialize(xaml_ptr<xaml_node> const& node, xaml_object** ptr) noexcept;
+    xaml_result emit_tree(compact_node* node, int32_t slot, xaml_type_info* root_type) noexcept;
+    xaml_result emit_object(compact_node* node, int32_t slot, int32_t root_slot, xaml_type_info* root_type) noexcept;
+    xaml_result emit_extensions(compact_node* node) noexcept;
+    xaml_result emit_markup(compact_markup_node* node, int32_t element_slot, int32_t* pslot) noexcept;
 
-    xaml_result deserialize(xaml_ptr<xaml_object> const& mc, xaml_ptr<xaml_markup_node> const& node, xaml_markup_extension** ptr) noexcept;
+    int32_t new_slot() noexcept { return m_plan.m_slots++; }
 };
 
-xaml_result deserializer_impl::construct_impl(xaml_ptr<xaml_node> const& node, xaml_ptr<xaml_object> const& root, xaml_ptr<xaml_type_info> const& root_type, xaml_object** ptr) noexcept
+template <typename T>
+static xaml_result rebox(xaml_object* value, xaml_object** ptr) noexcept
 {
-    xaml_ptr<xaml_type_info> t;
-    XAML_RETURN_IF_FAILED(node->get_type(&t));
-    xaml_ptr<xaml_object> c;
-    XAML_RETURN_IF_FAILED(t->construct(&c));
-    XAML_RETURN_IF_FAILED(deserialize_impl(c, node, root ? root : c, root_type));
-    return c->query(ptr);
+    T unboxed;
+    XAML_RETURN_IF_FAILED(xaml_unbox_value(value, &unboxed));
+    return xaml_box_value(unboxed, ptr);
 }
 
-xaml_result deserializer_impl::deserialize_impl(xaml_ptr<xaml_object> const& mc, xaml_ptr<xaml_node> const& node, xaml_ptr<xaml_object> const& root, xaml_ptr<xaml_type_info> const& root_type) noexcept
+template <typename T, typename... Ts>
+static bool box_primitive(xaml_guid const& type, xaml_string* str, plan_op& op) noexcept
 {
+    if (type == xaml_type_guid_v<T>)
     {
-        xaml_ptr<xaml_string> node_name;
-        XAML_RETURN_IF_FAILED(node->get_name(&node_name));
-        bool replaced;
-        XAML_RETURN_IF_FAILED(symbols->insert(node_name, mc, &replaced));
+        T value;
+        if (XAML_FAILED(__xaml_converter<T>{}(str, &value)) || XAML_FAILED(xaml_box_value(value, &op.value))) return false;
+        op.rebox = rebox<T>;
+        return true;
     }
+    if constexpr (sizeof...(Ts) > 0)
+        return box_primitive<Ts...>(type, str, op);
+    else
+        return false;
+}
+
+// The value a string is converted to, once for all instances.
+// Enums and primitives are parsed, so that the setters need not parse them,
+// and only boxed again for each instance; other values are left to the converters of the properties.
+// A string failed to convert is also left to the setter, which reports the error.
+xaml_result plan_builder::string_value(xaml_property_info* info, string_view value, plan_op& op) noexcept
+{
+    xaml_ptr<xaml_string> str;
+    XAML_RETURN_IF_FAILED(m_plan.m_tree->get_string(value, &str));
+    xaml_guid type;
+    XAML_RETURN_IF_FAILED(info->get_type(&type));
+    if (box_primitive<bool, int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t, int64_t, uint64_t, float, double>(type, str, op))
+        return XAML_S_OK;
+    xaml_ptr<xaml_reflection_info> type_info;
+    if (XAML_SUCCEEDED(m_plan.m_ctx->get_type(type, &type_info)))
     {
-        xaml_ptr<xaml_element_base> mce;
-        if (XAML_SUCCEEDED(mc->query(&mce)))
+        if (auto enum_info = type_info.query<xaml_enum_info>())
         {
-            xaml_ptr<xaml_map<xaml_string, xaml_node>> node_resources;
-            XAML_RETURN_IF_FAILED(node->get_resources(&node_resources));
-            XAML_FOREACH_START(xaml_key_value_pair_2__xaml_string__xaml_node, pair, node_resources);
-            {
-                xaml_ptr<xaml_string> key_str;
-                XAML_RETURN_IF_FAILED(pair->get_key(&key_str));
-                xaml_ptr<xaml_node> value_node;
-                XAML_RETURN_IF_FAILED(pair->get_value(&value_node));
-                xaml_ptr<xaml_object> value_obj;
-                XAML_RETURN_IF_FAILED(deserialize(value_node, &value_obj));
-                XAML_RETURN_IF_FAILED(mce->add_resource(key_str, value_obj));
-            }
-            XAML_FOREACH_END();
+            int32_t evalue;
+            XAML_RETURN_IF_FAILED(enum_info->get_value(str, &evalue));
+            xaml_ptr<xaml_box<int32_t>> box;
+            XAML_RETURN_IF_FAILED(xaml_box_new(evalue, &box));
+            op.rebox = rebox<int32_t>;
+            return box->query(&op.value);
         }
     }
+    // A string is immutable, so it is shared.
+    return str->query(&op.value);
+}
+
+xaml_result plan_builder::emit_tree(compact_node* node, int32_t slot, xaml_type_info* root_type) noexcept
+try
+{
+    m_plan.m_ops.push_back({ plan_op_kind::construct, slot });
+    m_plan.m_ops.back().type = node->type;
+    XAML_RETURN_IF_FAILED(emit_object(node, slot, slot, root_type));
+    return emit_extensions(node);
+}
+XAML_CATCH_RETURN()
+
+xaml_result plan_builder::emit_object(compact_node* node, int32_t slot, int32_t root_slot, xaml_type_info* root_type) noexcept
+try
+{
+    m_node_slots[node] = slot;
     {
-        xaml_ptr<xaml_vector<xaml_attribute_property>> node_properties;
-        XAML_RETURN_IF_FAILED(node->get_properties(&node_properties));
-        XAML_FOREACH_START(xaml_attribute_property, prop, node_properties);
-        {
-            xaml_ptr<xaml_node_base> value;
-            XAML_RETURN_IF_FAILED(prop->get_value(&value));
-            xaml_ptr<xaml_property_info> info;
-            XAML_RETURN_IF_FAILED(prop->get_info(&info));
-            if (auto s = value.query<xaml_string_node>())
-            {
-                xaml_ptr<xaml_string> str;
-                XAML_RETURN_IF_FAILED(s->get_value(&str));
-                xaml_guid type;
-                XAML_RETURN_IF_FAILED(info->get_type(&type));
-                xaml_ptr<xaml_reflection_info> type_info;
-                if (XAML_SUCCEEDED(m_ctx->get_type(type, &type_info)))
-                {
-                    if (auto enum_info = type_info.query<xaml_enum_info>())
-                    {
-                        int32_t evalue;
-                        XAML_RETURN_IF_FAILED(enum_info->get_value(str, &evalue));
-                        xaml_ptr<xaml_box<int32_t>> box;
-                        XAML_RETURN_IF_FAILED(xaml_box_new(evalue, &box));
-                        XAML_RETURN_IF_FAILED(info->set(mc, box));
-                    }
-                    else
-                    {
-                        XAML_RETURN_IF_FAILED(info->set(mc, str));
-                    }
-                }
-                else
-                {
-                    XAML_RETURN_IF_FAILED(info->set(mc, str));
-                }
-            }
-            else if (auto cnode = value.query<xaml_node>())
-            {
-                xaml_ptr<xaml_object> c;
-                XAML_RETURN_IF_FAILED(construct_impl(cnode, root, root_type, &c));
-                xaml_ptr<xaml_markup_extension> e;
-                if (XAML_SUCCEEDED(c->query(&e)))
-                {
-                    xaml_ptr<xaml_string> info_name;
-                    XAML_RETURN_IF_FAILED(info->get_name(&info_name));
-                    xaml_ptr<xaml_markup_context> context;
-                    XAML_RETURN_IF_FAILED(xaml_object_new<xaml_deserializer_context_impl>(&context, mc, mc, info_name, symbols));
-                    XAML_RETURN_IF_FAILED(e->provide(m_ctx, context));
-                }
-                else
-                {
-                    XAML_RETURN_IF_FAILED(info->set(mc, c));
-                }
-            }
-        }
-        XAML_FOREACH_END();
+        plan_op op{ plan_op_kind::name, slot };
+        XAML_RETURN_IF_FAILED(m_plan.m_tree->get_string(node->name, &op.str));
+        m_plan.m_ops.push_back(move(op));
+    }
+    for (auto& res : node->resources)
+    {
+        // A resource is deserialized as a tree of its own.
+        int32_t res_slot = new_slot();
+        XAML_RETURN_IF_FAILED(emit_tree(res.node, res_slot, res.node->type));
+        plan_op op{ plan_op_kind::add_resource, slot, res_slot };
+        XAML_RETURN_IF_FAILED(m_plan.m_tree->get_string(res.key, &op.str));
+        m_plan.m_ops.push_back(move(op));
     }
+    for (auto& prop : node->properties)
     {
-        xaml_ptr<xaml_map<xaml_string, xaml_attribute_collection_property>> node_cprops;
-        XAML_RETURN_IF_FAILED(node->get_collection_properties(&node_cprops));
-        XAML_FOREACH_START(xaml_key_value_pair_2__xaml_string__xaml_attribute_collection_property, prop, node_cprops);
+        switch (prop.value->kind)
         {
-            xaml_ptr<xaml_attribute_collection_property> cp;
-            XAML_RETURN_IF_FAILED(prop->get_value(&cp));
-            xaml_ptr<xaml_vector<xaml_node>> values;
-            XAML_RETURN_IF_FAILED(cp->get_values(&values));
-            xaml_ptr<xaml_collection_property_info> info;
-            XAML_RETURN_IF_FAILED(cp->get_info(&info));
-            XAML_FOREACH_START(xaml_node, n, values);
-            {
-                xaml_ptr<xaml_object> c;
-                XAML_RETURN_IF_FAILED(construct_impl(n, root, root_type, &c));
-                XAML_RETURN_IF_FAILED(info->add(mc, c));
-            }
-            XAML_FOREACH_END();
+        case compact_node_kind::string:
+        {
+            plan_op op{ plan_op_kind::set_value, slot };
+            op.prop = prop.info;
+            XAML_RETURN_IF_FAILED(string_value(prop.info, static_cast<compact_string_node*>(prop.value)->value, op));
+            m_plan.m_ops.push_back(move(op));
+            break;
+        }
+        case compact_node_kind::node:
+        {
+            auto child = static_cast<compact_node*>(prop.value);
+            int32_t child_slot = new_slot();
+            m_plan.m_ops.push_back({ plan_op_kind::construct, child_slot });
+            m_plan.m_ops.back().type = child->type;
+            XAML_RETURN_IF_FAILED(emit_object(child, child_slot, root_slot, root_type));
+            plan_op op{ plan_op_kind::set_object, slot, child_slot };
+            op.prop = prop.info;
+            XAML_RETURN_IF_FAILED(prop.info->get_name(&op.str));
+            m_plan.m_ops.push_back(move(op));
+            break;
+        }
+        default:
+            break;
         }
-        XAML_FOREACH_END();
     }
+    for (auto& cprop : node->collection_properties)
     {
-        xaml_ptr<xaml_vector<xaml_attribute_event>> node_events;
-        XAML_RETURN_IF_FAILED(node->get_events(&node_events));
-        XAML_FOREACH_START(xaml_attribute_event, ev, node_events);
+        for (auto& item : cprop.values)
         {
-            xaml_ptr<xaml_string> ev_value;
-            XAML_RETURN_IF_FAILED(ev->get_value(&ev_value));
-            xaml_ptr<xaml_method_info> method;
-            XAML_RETURN_IF_FAILED(root_type->get_method(ev_value, &method));
-            xaml_ptr<xaml_vector_view<xaml_object>> bind_args;
-            XAML_RETURN_IF_FAILED(xaml_method_info_pack_args(&bind_args, root));
-            xaml_ptr<xaml_method_info> binded_method;
-            XAML_RETURN_IF_FAILED(xaml_method_info_bind(method, bind_args, &binded_method));
-            xaml_ptr<xaml_event_info> info;
-            XAML_RETURN_IF_FAILED(ev->get_info(&info));
-            int32_t token;
-            XAML_RETURN_IF_FAILED(info->add(mc, binded_method, &token));
+            int32_t item_slot = new_slot();
+            m_plan.m_ops.push_back({ plan_op_kind::construct, item_slot });
+            m_plan.m_ops.back().type = item.node->type;
+            XAML_RETURN_IF_FAILED(emit_object(item.node, item_slot, root_slot, root_type));
+            plan_op op{ plan_op_kind::add_item, slot, item_slot };
+            op.cprop = cprop.info;
+            m_plan.m_ops.push_back(move(op));
         }
-        XAML_FOREACH_END();
+    }
+    for (auto& ev : node->events)
+    {
+        xaml_ptr<xaml_string> ev_value;
+        XAML_RETURN_IF_FAILED(m_plan.m_tree->get_string(ev.value, &ev_value));
+        plan_op op{ plan_op_kind::hook_event, slot, root_slot };
+        op.event = ev.info;
+        XAML_RETURN_IF_FAILED(root_type->get_method(ev_value, &op.method));
+        m_plan.m_ops.push_back(move(op));
     }
     return XAML_S_OK;
 }
+XAML_CATCH_RETURN()
 
-xaml_result deserializer_impl::deserialize_extensions(xaml_ptr<xaml_node> const& node) noexcept
+xaml_result plan_builder::emit_extensions(compact_node* node) noexcept
+try
 {
-    xaml_ptr<xaml_string> node_name;
-    XAML_RETURN_IF_FAILED(node->get_name(&node_name));
-    xaml_ptr<xaml_object> mc;
-    XAML_RETURN_IF_FAILED(symbols->lookup(node_name, &mc));
+    int32_t slot = m_node_slots[node];
+    for (auto& prop : node->properties)
     {
-        xaml_ptr<xaml_vector<xaml_attribute_property>> node_properties;
-        XAML_RETURN_IF_FAILED(node->get_properties(&node_properties));
-        XAML_FOREACH_START(xaml_attribute_property, prop, node_properties);
+        switch (prop.value->kind)
         {
-            xaml_ptr<xaml_node_base> value;
-            XAML_RETURN_IF_FAILED(prop->get_value(&value));
-            xaml_ptr<xaml_property_info> info;
-            XAML_RETURN_IF_FAILED(prop->get_info(&info));
-            if (auto n = value.query<xaml_markup_node>())
-            {
-                xaml_ptr<xaml_string> info_name;
-                XAML_RETURN_IF_FAILED(info->get_name(&info_name));
-                xaml_ptr<xaml_markup_context> context;
-                XAML_RETURN_IF_FAILED(xaml_object_new<xaml_deserializer_context_impl>(&context, mc, mc, info_name, symbols));
-                xaml_ptr<xaml_markup_extension> ex;
-                XAML_RETURN_IF_FAILED(deserialize(mc, n, &ex));
-                XAML_RETURN_IF_FAILED(ex->provide(m_ctx, context));
-            }
-            else if (auto cnode = value.query<xaml_node>())
-            {
-                XAML_RETURN_IF_FAILED(deserialize_extensions(cnode));
-            }
+        case compact_node_kind::markup:
+        {
+            int32_t ex_slot;
+            XAML_RETURN_IF_FAILED(emit_markup(static_cast<compact_markup_node*>(prop.value), slot, &ex_slot));
+            plan_op op{ plan_op_kind::provide, slot, ex_slot, slot };
+            XAML_RETURN_IF_FAILED(prop.info->get_name(&op.str));
+            m_plan.m_ops.push_back(move(op));
+            break;
+        }
+        case compact_node_kind::node:
+            XAML_RETURN_IF_FAILED(emit_extensions(static_cast<compact_node*>(prop.value)));
+            break;
+        default:
+            break;
         }
-        XAML_FOREACH_END();
     }
+    for (auto& cprop : node->collection_properties)
     {
-        xaml_ptr<xaml_map<xaml_string, xaml_attribute_collection_property>> node_cprops;
-        XAML_RETURN_IF_FAILED(node->get_collection_properties(&node_cprops));
-        XAML_FOREACH_START(xaml_key_value_pair_2__xaml_string__xaml_attribute_collection_property, prop, node_cprops);
+        for (auto& item : cprop.values)
         {
-            xaml_ptr<xaml_attribute_collection_property> cp;
-            XAML_RETURN_IF_FAILED(prop->get_value(&cp));
-            xaml_ptr<xaml_vector<xaml_node>> values;
-            XAML_RETURN_IF_FAILED(cp->get_values(&values));
-            XAML_FOREACH_START(xaml_node, n, values);
-            {
-                XAML_RETURN_IF_FAILED(deserialize_extensions(n));
-            }
-            XAML_FOREACH_END();
+            XAML_RETURN_IF_FAILED(emit_extensions(item.node));
         }
-        XAML_FOREACH_END();
     }
     return XAML_S_OK;
 }
+XAML_CATCH_RETURN()
 
-xaml_result deserializer_impl::deserialize(xaml_ptr<xaml_node> const& node, xaml_ptr<xaml_object> const& mc, xaml_ptr<xaml_type_info> const& t) noexcept
+xaml_result plan_builder::emit_markup(compact_markup_node* node, int32_t element_slot, int32_t* pslot) noexcept
+try
 {
-    if (mc)
+    int32_t slot = new_slot();
+    m_plan.m_ops.push_back({ plan_op_kind::construct, slot });
+    m_plan.m_ops.back().type = node->type;
+    for (auto& prop : node->properties)
     {
-        XAML_RETURN_IF_FAILED(deserialize_impl(mc, node, mc, t));
-        XAML_RETURN_IF_FAILED(deserialize_extensions(node));
+        switch (prop.value->kind)
+        {
+        case compact_node_kind::string:
+        {
+            plan_op op{ plan_op_kind::set_value, slot };
+            op.prop = prop.info;
+            XAML_RETURN_IF_FAILED(string_value(prop.info, static_cast<compact_string_node*>(prop.value)->value, op));
+            m_plan.m_ops.push_back(move(op));
+            break;
+        }
+        case compact_node_kind::markup:
+        {
+            int32_t ex_slot;
+            XAML_RETURN_IF_FAILED(emit_markup(static_cast<compact_markup_node*>(prop.value), element_slot, &ex_slot));
+            plan_op op{ plan_op_kind::provide, slot, ex_slot, element_slot };
+            XAML_RETURN_IF_FAILED(prop.info->get_name(&op.str));
+            m_plan.m_ops.push_back(move(op));
+            break;
+        }
+        default:
+            break;
+        }
     }
+    *pslot = slot;
     return XAML_S_OK;
 }
+XAML_CATCH_RETURN()
 
-xaml_result deserializer_impl::deserialize(xaml_ptr<xaml_node> const& node, xaml_object** ptr) noexcept
+xaml_result deserialize_plan::execute(xaml_object* root, xaml_object** ptr) const noexcept
+try
 {
-    xaml_ptr<xaml_type_info> t;
-    XAML_RETURN_IF_FAILED(node->get_type(&t));
-    xaml_ptr<xaml_object> c;
-    XAML_RETURN_IF_FAILED(construct_impl(node, nullptr, t, &c));
-    XAML_RETURN_IF_FAILED(deserialize(node, c, t));
-    return c->query(ptr);
-}
-
-xaml_result deserializer_impl::deserialize(xaml_ptr<xaml_object> const& mc, xaml_ptr<xaml_markup_node> const& node, xaml_markup_extension** ptr) noexcept
-{
-    xaml_ptr<xaml_type_info> type;
-    XAML_RETURN_IF_FAILED(node->get_type(&type));
-    xaml_ptr<xaml_object> ex;
-    XAML_RETURN_IF_FAILED(type->construct(&ex));
+    vector<xaml_ptr<xaml_object>> objects(m_slots);
+    xaml_ptr<xaml_hasher<xaml_string>> hasher;
+    XAML_RETURN_IF_FAILED(xaml_hasher_string_default(&hasher));
+    xaml_ptr<xaml_map<xaml_string, xaml_object>> symbols;
+    XAML_RETURN_IF_FAILED(xaml_map_new(hasher.get(), &symbols));
+    xaml_ptr<xaml_deserializer_context_impl> context;
+    XAML_RETURN_IF_FAILED(xaml_object_new<xaml_deserializer_context_impl>(&context, symbols));
+    auto it = m_ops.begin();
+    // The root given is not constructed.
+    if (root)
+    {
+        objects[0] = root;
+        ++it;
+    }
+    for (; it != m_ops.end(); ++it)
     {
-        xaml_ptr<xaml_vector<xaml_attribute_property>> node_properties;
-        XAML_RETURN_IF_FAILED(node->get_properties(&node_properties));
-        XAML_FOREACH_START(xaml_attribute_property, prop, node_properties);
+        auto& op = *it;
+        auto& obj = objects[op.slot];
+        switch (op.kind)
+        {
+        case plan_op_kind::construct:
+            XAML_RETURN_IF_FAILED(op.type->construct(&obj));
+            break;
+        case plan_op_kind::name:
+        {
+            bool replaced;
+            XAML_RETURN_IF_FAILED(symbols->insert(op.str, obj, &replaced));
+            break;
+        }
+        case plan_op_kind::add_resource:
+        {
+            xaml_ptr<xaml_element_base> element;
+            if (XAML_SUCCEEDED(obj->query(&element)))
+            {
+                XAML_RETURN_IF_FAILED(element->add_resource(op.str, objects[op.value_slot]));
+            }
+            break;
+        }
+        case plan_op_kind::set_value:
+            if (op.rebox)
+            {
+                xaml_ptr<xaml_object> value;
+                XAML_RETURN_IF_FAILED(op.rebox(op.value, &value));
+                XAML_RETURN_IF_FAILED(op.prop->set(obj, value));
+            }
+            else
+            {
+                XAML_RETURN_IF_FAILED(op.prop->set(obj, op.value));
+            }
+            break;
+        case plan_op_kind::set_object:
         {
-            xaml_ptr<xaml_node_base> value;
-            XAML_RETURN_IF_FAILED(prop->get_value(&value));
-            xaml_ptr<xaml_property_info> info;
-            XAML_RETURN_IF_FAILED(prop->get_info(&info));
-            if (auto s = value.query<xaml_string_node>())
+            auto& value = objects[op.value_slot];
+            // The type is only known by the objects, so each is queried.
+            xaml_ptr<xaml_markup_extension> e;
+            if (XAML_SUCCEEDED(value->query(&e)))
             {
-                xaml_ptr<xaml_string> str;
-                XAML_RETURN_IF_FAILED(s->get_value(&str));
-                xaml_guid t;
-                XAML_RETURN_IF_FAILED(info->get_type(&t));
-                xaml_ptr<xaml_reflection_info> type_info;
-                if (XAML_SUCCEEDED(m_ctx->get_type(t, &type_info)))
-                {
-                    if (auto enum_info = type_info.query<xaml_enum_info>())
-                    {
-                        int32_t evalue;
-                        XAML_RETURN_IF_FAILED(enum_info->get_value(str, &evalue));
-                        xaml_ptr<xaml_box<int32_t>> box;
-                        XAML_RETURN_IF_FAILED(xaml_box_new(evalue, &box));
-                        XAML_RETURN_IF_FAILED(info->set(ex, box));
-                    }
-                    else
-                    {
-                        XAML_RETURN_IF_FAILED(info->set(ex, str));
-                    }
-                }
-                else
-                {
-                    XAML_RETURN_IF_FAILED(info->set(ex, str));
-                }
+                context->set(obj, obj, op.str);
+                XAML_RETURN_IF_FAILED(e->provide(m_ctx, context));
             }
-            else if (auto n = value.query<xaml_markup_node>())
+            else
             {
-                xaml_ptr<xaml_string> info_name;
-                XAML_RETURN_IF_FAILED(info->get_name(&info_name));
-                xaml_ptr<xaml_markup_context> context;
-                XAML_RETURN_IF_FAILED(xaml_object_new<xaml_deserializer_context_impl>(&context, mc, ex, info_name, symbols));
-                xaml_ptr<xaml_markup_extension> obj;
-                XAML_RETURN_IF_FAILED(deserialize(mc, n, &obj));
-                XAML_RETURN_IF_FAILED(obj->provide(m_ctx, context));
+                XAML_RETURN_IF_FAILED(op.prop->set(obj, value));
             }
+            break;
+        }
+        case plan_op_kind::add_item:
+            XAML_RETURN_IF_FAILED(op.cprop->add(obj, objects[op.value_slot]));
+            break;
+        case plan_op_kind::hook_event:
+        {
+            xaml_ptr<xaml_vector_view<xaml_object>> bind_args;
+            XAML_RETURN_IF_FAILED(xaml_method_info_pack_args(&bind_args, objects[op.value_slot]));
+            xaml_ptr<xaml_method_info> binded_method;
+            XAML_RETURN_IF_FAILED(xaml_method_info_bind(op.method, bind_args, &binded_method));
+            int32_t token;
+            XAML_RETURN_IF_FAILED(op.event->add(obj, binded_method, &token));
+            break;
+        }
+        case plan_op_kind::provide:
+        {
+            xaml_ptr<xaml_markup_extension> ex;
+            XAML_RETURN_IF_FAILED(objects[op.value_slot]->query(&ex));
+            context->set(objects[op.element_slot], obj, op.str);
+            XAML_RETURN_IF_FAILED(ex->provide(m_ctx, context));
+            break;
+        }
         }
-        XAML_FOREACH_END();
     }
-    return ex->query(ptr);
+    if (ptr) return objects[0].query(ptr);
+    return XAML_S_OK;
+}
+XAML_CATCH_RETURN()
+
+struct xaml_prepared_template_impl : xaml_implement<xaml_prepared_template_impl, xaml_prepared_template>
+{
+    deserialize_plan m_plan;
+
+    xaml_prepared_template_impl(deserialize_plan&& plan) noexcept : m_plan(move(plan)) {}
+
+    xaml_result XAML_CALL instantiate(xaml_object** ptr) noexcept override
+    {
+        return m_plan.execute(nullptr, ptr);
+    }
+
+    xaml_result XAML_CALL instantiate_inplace(xaml_object* mc) noexcept override
+    {
+        return m_plan.execute(mc, nullptr);
+    }
+};
+
+static xaml_result prepare(xaml_meta_context* ctx, xaml_node* node, xaml_type_info* root_type, deserialize_plan* plan) noexcept
+{
+    plan->m_ctx = ctx;
+    compact_node* root;
+    XAML_RETURN_IF_FAILED(xaml_node_get_compact(node, &plan->m_tree, &root));
+    plan_builder builder{ *plan };
+    return builder.emit_tree(root, builder.new_slot(), root_type ? root_type : root->type);
+}
+
+xaml_result XAML_CALL xaml_parser_prepare(xaml_meta_context* ctx, xaml_node* node, xaml_prepared_template** ptr) noexcept
+{
+    deserialize_plan plan{};
+    XAML_RETURN_IF_FAILED(prepare(ctx, node, nullptr, &plan));
+    return xaml_object_new<xaml_prepared_template_impl>(ptr, move(plan));
 }
 
+// The plans here are executed only once, but they still save the conversions
+// and the lookups repeated for the same properties.
 xaml_result XAML_CALL xaml_parser_deserialize(xaml_meta_context* ctx, xaml_node* node, xaml_object** ptr) noexcept
 {
-    deserializer_impl des{ ctx };
-    XAML_RETURN_IF_FAILED(des.init());
-    return des.deserialize(node, ptr);
+    deserialize_plan plan{};
+    XAML_RETURN_IF_FAILED(prepare(ctx, node, nullptr, &plan));
+    return plan.execute(nullptr, ptr);
 }
 
 xaml_result XAML_CALL xaml_parser_deserialize_inplace(xaml_meta_context* ctx, xaml_node* node, xaml_object* mc) noexcept
 {
-    deserializer_impl des{ ctx };
-    XAML_RETURN_IF_FAILED(des.init());
     xaml_guid type;
     XAML_RETURN_IF_FAILED(mc->get_guid(&type));
     xaml_ptr<xaml_reflection_info> info;
     XAML_RETURN_IF_FAILED(ctx->get_type(type, &info));
     xaml_ptr<xaml_type_info> t;
     XAML_RETURN_IF_FAILED(info->query(&t));
-    return des.deserialize(node, mc, t);
+    deserialize_plan plan{};
+    XAML_RETURN_IF_FAILED(prepare(ctx, node, t, &plan));
+    return plan.execute(mc, nullptr);
 }
@@ -1,4 +1,7 @@
-#include <xaml/parser/node.h>
+#include <algorithm>
+#include <node.hpp>
+
+using namespace std;
 
 struct xaml_node_base_internal
 {
@@ -119,3 +122,503 @@ xaml_result XAML_CALL xaml_attribute_collection_property_new(xaml_type_info* typ
 {
     return xaml_object_new<xaml_attribute_collection_property_impl>(ptr, type, info, values);
 }
+
+void* compact_arena::allocate(size_t size, size_t align)
+{
+    size_t padding = (align - reinterpret_cast<uintptr_t>(m_current) % align) % align;
+    if (padding + size > m_remain)
+    {
+        size_t new_size = (max)(block_size, size + align);
+        m_blocks.push_back(make_unique<byte[]>(new_size));
+        m_current = m_blocks.back().get();
+        m_remain = new_size;
+        padding = (align - reinterpret_cast<uintptr_t>(m_current) % align) % align;
+    }
+    byte* result = m_current + padding;
+    m_current = result + size;
+    m_remain -= padding + size;
+    return result;
+}
+
+void compact_node::add_resource(compact_resource* res) noexcept
+{
+    for (auto& r : resources)
+    {
+        if (r.key.data() == res->key.data())
+        {
+            r.node = res->node;
+            return;
+        }
+    }
+    resources.append(res);
+}
+
+compact_collection_property* compact_node::find_collection_property(string_view name) const noexcept
+{
+    for (auto& cprop : collection_properties)
+    {
+        if (cprop.name.data() == name.data()) return &cprop;
+    }
+    return nullptr;
+}
+
+string_view compact_tree::intern(string_view str)
+{
+    // The empty string is not allocated, to keep the pointers unique.
+    if (str.empty()) return str.data() ? string_view{ "" } : string_view{};
+    auto it = names.find(str);
+    if (it != names.end()) return *it;
+    char* data = static_cast<char*>(arena.allocate(str.size(), 1));
+    copy(str.begin(), str.end(), data);
+    return *names.emplace(data, str.size()).first;
+}
+
+xaml_result compact_tree::get_string(string_view interned, xaml_string** ptr) noexcept
+try
+{
+    if (!interned.data())
+    {
+        *ptr = nullptr;
+        return XAML_S_OK;
+    }
+    auto& str = strings[interned.data()];
+    if (!str) XAML_RETURN_IF_FAILED(xaml_string_new(interned, &str));
+    return str.query(ptr);
+}
+XAML_CATCH_RETURN()
+
+static xaml_result create_node_base(shared_ptr<compact_tree> const& tree, compact_node_base* node, xaml_node_base** ptr) noexcept;
+
+static xaml_result create_markup_node(shared_ptr<compact_tree> const& tree, compact_markup_node* node, xaml_markup_node** ptr) noexcept
+{
+    xaml_ptr<xaml_markup_node> result;
+    XAML_RETURN_IF_FAILED(xaml_markup_node_new(&result));
+    XAML_RETURN_IF_FAILED(result->set_type(node->type));
+    xaml_ptr<xaml_string> name;
+    XAML_RETURN_IF_FAILED(tree->get_string(node->name, &name));
+    XAML_RETURN_IF_FAILED(result->set_name(name));
+    xaml_ptr<xaml_vector<xaml_attribute_property>> props;
+    XAML_RETURN_IF_FAILED(xaml_vector_new(&props));
+    for (auto& prop : node->properties)
+    {
+        xaml_ptr<xaml_node_base> value;
+        XAML_RETURN_IF_FAILED(create_node_base(tree, prop.value, &value));
+        xaml_ptr<xaml_attribute_property> prop_item;
+        XAML_RETURN_IF_FAILED(xaml_attribute_property_new(prop.type, prop.info, value, &prop_item));
+        XAML_RETURN_IF_FAILED(props->append(prop_item));
+    }
+    XAML_RETURN_IF_FAILED(result->set_properties(props));
+    return result->query(ptr);
+}
+
+static xaml_result create_node_base(shared_ptr<compact_tree> const& tree, compact_node_base* node, xaml_node_base** ptr) noexcept
+{
+    switch (node->kind)
+    {
+    case compact_node_kind::string:
+    {
+        xaml_ptr<xaml_string_node> result;
+        XAML_RETURN_IF_FAILED(xaml_string_node_new(&result));
+        xaml_ptr<xaml_string> value;
+        XAML_RETURN_IF_FAILED(tree->get_string(static_cast<compact_string_node*>(node)->value, &value));
+        XAML_RETURN_IF_FAILED(result->set_value(value));
+        return result->query(ptr);
+    }
+    case compact_node_kind::markup:
+    {
+        xaml_ptr<xaml_markup_node> result;
+        XAML_RETURN_IF_FAILED(create_markup_node(tree, static_cast<compact_markup_node*>(node), &result));
+        return result->query(ptr);
+    }
+    default:
+    {
+        xaml_ptr<xaml_node> result;
+        XAML_RETURN_IF_FAILED(xaml_compact_node_new(tree, static_cast<compact_node*>(node), &result));
+        return result->query(ptr);
+    }
+    }
+}
+
+struct xaml_compact_node_impl : xaml_implement<xaml_compact_node_impl, xaml_compact_node>
+{
+    shared_ptr<compact_tree> m_tree;
+    compact_node* m_node;
+    // Created on the first access to the members, or any change.
+    // After that, the compact node is stale.
+    xaml_ptr<xaml_node> m_com{ nullptr };
+
+    xaml_compact_node_impl(shared_ptr<compact_tree> const& tree, compact_node* node) noexcept : m_tree(tree), m_node(node) {}
+
+    xaml_result materialize() noexcept;
+
+    xaml_result XAML_CALL get_compact(shared_ptr<compact_tree>* ptree, compact_node** ptr) noexcept override
+    {
+        if (m_com) return XAML_E_NOTIMPL;
+        *ptree = m_tree;
+        *ptr = m_node;
+        return XAML_S_OK;
+    }
+
+    xaml_result XAML_CALL get_type(xaml_type_info** ptr) noexcept override
+    {
+        if (m_com) return m_com->get_type(ptr);
+        return m_node->type->query(ptr);
+    }
+
+    xaml_result XAML_CALL get_name(xaml_string** ptr) noexcept override
+    {
+        if (m_com) return m_com->get_name(ptr);
+        return m_tree->get_string(m_node->name, ptr);
+    }
+
+    xaml_result XAML_CALL get_key(xaml_string** ptr) noexcept override
+    {
+        if (m_com) return m_com->get_key(ptr);
+        return m_tree->get_string(m_node->key, ptr);
+    }
+
+#define XAML_COMPACT_NODE_FORWARD(name, type)                      \
+    xaml_result XAML_CALL get_##name(type** ptr) noexcept override \
+    {                                                              \
+        XAML_RETURN_IF_FAILED(materialize());                      \
+        return m_com->get_##name(ptr);                             \
+    }                                                              \
+    xaml_result XAML_CALL set_##name(type* value) noexcept override \
+    {                                                              \
+        XAML_RETURN_IF_FAILED(materialize());                      \
+        return m_com->set_##name(value);                           \
+    }
+
+    xaml_result XAML_CALL set_type(xaml_type_info* value) noexcept override
+    {
+        XAML_RETURN_IF_FAILED(materialize());
+        return m_com->set_type(value);
+    }
+
+    xaml_result XAML_CALL set_name(xaml_string* value) noexcept override
+    {
+        XAML_RETURN_IF_FAILED(materialize());
+        return m_com->set_name(value);
+    }
+
+    xaml_result XAML_CALL set_key(xaml_string* value) noexcept override
+    {
+        XAML_RETURN_IF_FAILED(materialize());
+        return m_com->set_key(value);
+    }
+
+    XAML_COMPACT_NODE_FORWARD(resources, xaml_map_2__xaml_string__xaml_node)
+    XAML_COMPACT_NODE_FORWARD(properties, xaml_vector_1__xaml_attribute_property)
+    XAML_COMPACT_NODE_FORWARD(collection_properties, xaml_map_2__xaml_string__xaml_attribute_collection_property)
+    XAML_COMPACT_NODE_FORWARD(events, xaml_vector_1__xaml_attribute_event)
+
+#undef XAML_COMPACT_NODE_FORWARD
+};
+
+xaml_result xaml_compact_node_impl::materialize() noexcept
+{
+    if (m_com) return XAML_S_OK;
+    xaml_ptr<xaml_node> node;
+    XAML_RETURN_IF_FAILED(xaml_node_new(&node));
+    XAML_RETURN_IF_FAILED(node->set_type(m_node->type));
+    {
+        xaml_ptr<xaml_string> name;
+        XAML_RETURN_IF_FAILED(m_tree->get_string(m_node->name, &name));
+        XAML_RETURN_IF_FAILED(node->set_name(name));
+        xaml_ptr<xaml_string> key;
+        XAML_RETURN_IF_FAILED(m_tree->get_string(m_node->key, &key));
+        XAML_RETURN_IF_FAILED(node->set_key(key));
+    }
+    {
+        xaml_ptr<xaml_hasher<xaml_string>> hasher;
+        XAML_RETURN_IF_FAILED(xaml_hasher_string_default(&hasher));
+        xaml_ptr<xaml_map<xaml_string, xaml_node>> reses;
+        XAML_RETURN_IF_FAILED(xaml_map_new(hasher.get(), &reses));
+        for (auto& res : m_node->resources)
+        {
+            xaml_ptr<xaml_string> key;
+            XAML_RETURN_IF_FAILED(m_tree->get_string(res.key, &key));
+            xaml_ptr<xaml_node> value;
+            XAML_RETURN_IF_FAILED(xaml_compact_node_new(m_tree, res.node, &value));
+            bool replaced;
+            XAML_RETURN_IF_FAILED(reses->insert(key, value, &replaced));
+        }
+        XAML_RETURN_IF_FAILED(node->set_resources(reses));
+    }
+    {
+        xaml_ptr<xaml_vector<xaml_attribute_property>> props;
+        XAML_RETURN_IF_FAILED(xaml_vector_new(&props));
+        for (auto& prop : m_node->properties)
+        {
+            xaml_ptr<xaml_node_base> value;
+            XAML_RETURN_IF_FAILED(create_node_base(m_tree, prop.value, &value));
+            xaml_ptr<xaml_attribute_property> prop_item;
+            XAML_RETURN_IF_FAILED(xaml_attribute_property_new(prop.type, prop.info, value, &prop_item));
+            XAML_RETURN_IF_FAILED(props->append(prop_item));
+        }
+        XAML_RETURN_IF_FAILED(node->set_properties(props));
+    }
+    {
+        xaml_ptr<xaml_hasher<xaml_string>> hasher;
+        XAML_RETURN_IF_FAILED(xaml_hasher_string_default(&hasher));
+        xaml_ptr<xaml_map<xaml_string, xaml_attribute_collection_property>> cprops;
+        XAML_RETURN_IF_FAILED(xaml_map_new(hasher.get(), &cprops));
+        for (auto& cprop : m_node->collection_properties)
+        {
+            xaml_ptr<xaml_vector<xaml_node>> values;
+            XAML_RETURN_IF_FAILED(xaml_vector_new(&values));
+            for (auto& item : cprop.values)
+            {
+                xaml_ptr<xaml_node> value;
+                XAML_RETURN_IF_FAILED(xaml_compact_node_new(m_tree, item.node, &value));
+                XAML_RETURN_IF_FAILED(values->append(value));
+            }
+            xaml_ptr<xaml_attribute_collection_property> cprop_item;
+            XAML_RETURN_IF_FAILED(xaml_attribute_collection_property_new(cprop.type, cprop.info, values, &cprop_item));
+            xaml_ptr<xaml_string> name;
+            XAML_RETURN_IF_FAILED(m_tree->get_string(cprop.name, &name));
+            XAML_RETURN_IF_FAILED(cprops->insert(name, cprop_item, nullptr));
+        }
+        XAML_RETURN_IF_FAILED(node->set_collection_properties(cprops));
+    }
+    {
+        xaml_ptr<xaml_vector<xaml_attribute_event>> events;
+        XAML_RETURN_IF_FAILED(xaml_vector_new(&events));
+        for (auto& ev : m_node->events)
+        {
+            xaml_ptr<xaml_string> value;
+            XAML_RETURN_IF_FAILED(m_tree->get_string(ev.value, &value));
+            xaml_ptr<xaml_attribute_event> ev_item;
+            XAML_RETURN_IF_FAILED(xaml_attribute_event_new(ev.info, value, &ev_item));
+            XAML_RETURN_IF_FAILED(events->append(ev_item));
+        }
+        XAML_RETURN_IF_FAILED(node->set_events(events));
+    }
+    m_com = node;
+    return XAML_S_OK;
+}
+
+xaml_result XAML_CALL xaml_compact_node_new(shared_ptr<compact_tree> const& tree, compact_node* node, xaml_node** ptr) noexcept
+{
+    return xaml_object_new<xaml_compact_node_impl>(ptr, tree, node);
+}
+
+// Converts the COM nodes to the compact form.
+struct compact_converter
+{
+    shared_ptr<compact_tree> m_tree;
+
+    xaml_result intern(xaml_ptr<xaml_string> const& str, string_view* ptr) noexcept
+    try
+    {
+        string_view view;
+        XAML_RETURN_IF_FAILED(to_string_view(str, &view));
+        *ptr = m_tree->intern(str ? view : string_view{});
+        return XAML_S_OK;
+    }
+    XAML_CATCH_RETURN()
+
+    template <typename T>
+    xaml_result make(compact_node_kind kind, T** ptr) noexcept
+    try
+    {
+        *ptr = m_tree->make<T>(kind);
+        return XAML_S_OK;
+    }
+    XAML_CATCH_RETURN()
+
+    template <typename T>
+    xaml_result make(T** ptr) noexcept
+    try
+    {
+        *ptr = m_tree->make<T>();
+        return XAML_S_OK;
+    }
+    XAML_CATCH_RETURN()
+
+    xaml_result convert_base(xaml_ptr<xaml_node_base> const& node, compact_node_base* result) noexcept
+    {
+        {
+            xaml_ptr<xaml_type_info> type;
+            XAML_RETURN_IF_FAILED(node->get_type(&type));
+            result->type = type.get();
+        }
+        {
+            xaml_ptr<xaml_string> name;
+            XAML_RETURN_IF_FAILED(node->get_name(&name));
+            XAML_RETURN_IF_FAILED(intern(name, &result->name));
+        }
+        {
+            xaml_ptr<xaml_string> key;
+            XAML_RETURN_IF_FAILED(node->get_key(&key));
+            XAML_RETURN_IF_FAILED(intern(key, &result->key));
+        }
+        return XAML_S_OK;
+    }
+
+    xaml_result convert_properties(xaml_ptr<xaml_vector<xaml_attribute_property>> const& props, compact_list<compact_property>& result) noexcept
+    {
+        if (!props) return XAML_S_OK;
+        for (auto prop : props)
+        {
+            compact_property* item;
+            XAML_RETURN_IF_FAILED(make(&item));
+            xaml_ptr<xaml_type_info> type;
+            XAML_RETURN_IF_FAILED(prop->get_type(&type));
+            item->type = type.get();
+            xaml_ptr<xaml_property_info> info;
+            XAML_RETURN_IF_FAILED(prop->get_info(&info));
+            item->info = info.get();
+            xaml_ptr<xaml_node_base> value;
+            XAML_RETURN_IF_FAILED(prop->get_value(&value));
+            XAML_RETURN_IF_FAILED(convert_value(value, &item->value));
+            result.append(item);
+        }
+        return XAML_S_OK;
+    }
+
+    xaml_result convert_value(xaml_ptr<xaml_node_base> const& value, compact_node_base** ptr) noexcept
+    {
+        if (auto s = value.query<xaml_string_node>())
+        {
+            compact_string_node* result;
+            XAML_RETURN_IF_FAILED(make(compact_node_kind::string, &result));
+            XAML_RETURN_IF_FAILED(convert_base(value, result));
+            xaml_ptr<xaml_string> str;
+            XAML_RETURN_IF_FAILED(s->get_value(&str));
+            XAML_RETURN_IF_FAILED(intern(str, &result->value));
+            *ptr = result;
+        }
+        else if (auto m = value.query<xaml_markup_node>())
+        {
+            compact_markup_node* result;
+            XAML_RETURN_IF_FAILED(make(compact_node_kind::markup, &result));
+            XAML_RETURN_IF_FAILED(convert_base(value, result));
+            xaml_ptr<xaml_vector<xaml_attribute_property>> props;
+            XAML_RETURN_IF_FAILED(m->get_properties(&props));
+            XAML_RETURN_IF_FAILED(convert_properties(props, result->properties));
+            *ptr = result;
+        }
+        else if (auto n = value.query<xaml_node>())
+        {
+            compact_node* result;
+            XAML_RETURN_IF_FAILED(convert(n, &result));
+            *ptr = result;
+        }
+        else
+        {
+            return XAML_E_NOINTERFACE;
+        }
+        return XAML_S_OK;
+    }
+
+    xaml_result convert(xaml_ptr<xaml_node> const& node, compact_node** ptr) noexcept
+    try
+    {
+        // Link the unchanged compact nodes directly.
+        if (auto c = node.query<xaml_compact_node>())
+        {
+            shared_ptr<compact_tree> tree;
+            if (XAML_SUCCEEDED(c->get_compact(&tree, ptr)))
+            {
+                if (tree != m_tree && find(m_tree->dependencies.begin(), m_tree->dependencies.end(), tree) == m_tree->dependencies.end())
+                    m_tree->dependencies.push_back(tree);
+                return XAML_S_OK;
+            }
+        }
+        compact_node* result = m_tree->make<compact_node>(compact_node_kind::node);
+        XAML_RETURN_IF_FAILED(convert_base(node, result));
+        {
+            xaml_ptr<xaml_map<xaml_string, xaml_node>> reses;
+            XAML_RETURN_IF_FAILED(node->get_resources(&reses));
+            if (reses)
+            {
+                for (auto pair : reses)
+                {
+                    compact_resource* res = m_tree->make<compact_resource>();
+                    xaml_ptr<xaml_string> key;
+                    XAML_RETURN_IF_FAILED(pair->get_key(&key));
+                    XAML_RETURN_IF_FAILED(intern(key, &res->key));
+                    xaml_ptr<xaml_node> value;
+                    XAML_RETURN_IF_FAILED(pair->get_value(&value));
+                    XAML_RETURN_IF_FAILED(convert(value, &res->node));
+                    result->resources.append(res);
+                }
+            }
+        }
+        {
+            xaml_ptr<xaml_vector<xaml_attribute_property>> props;
+            XAML_RETURN_IF_FAILED(node->get_properties(&props));
+            XAML_RETURN_IF_FAILED(convert_properties(props, result->properties));
+        }
+        {
+            xaml_ptr<xaml_map<xaml_string, xaml_attribute_collection_property>> cprops;
+            XAML_RETURN_IF_FAILED(node->get_collection_properties(&cprops));
+            if (cprops)
+            {
+                for (auto pair : cprops)
+                {
+                    compact_collection_property* cprop = m_tree->make<compact_collection_property>();
+                    xaml_ptr<xaml_string> name;
+                    XAML_RETURN_IF_FAILED(pair->get_key(&name));
+                    XAML_RETURN_IF_FAILED(intern(name, &cprop->name));
+                    xaml_ptr<xaml_attribute_collection_property> cp;
+                    XAML_RETURN_IF_FAILED(pair->get_value(&cp));
+                    xaml_ptr<xaml_type_info> type;
+                    XAML_RETURN_IF_FAILED(cp->get_type(&type));
+                    cprop->type = type.get();
+                    xaml_ptr<xaml_collection_property_info> info;
+                    XAML_RETURN_IF_FAILED(cp->get_info(&info));
+                    cprop->info = info.get();
+                    xaml_ptr<xaml_vector<xaml_node>> values;
+                    XAML_RETURN_IF_FAILED(cp->get_values(&values));
+                    for (auto n : values)
+                    {
+                        compact_node_item* item = m_tree->make<compact_node_item>();
+                        XAML_RETURN_IF_FAILED(convert(n, &item->node));
+                        cprop->values.append(item);
+                    }
+                    result->collection_properties.append(cprop);
+                }
+            }
+        }
+        {
+            xaml_ptr<xaml_vector<xaml_attribute_event>> events;
+            XAML_RETURN_IF_FAILED(node->get_events(&events));
+            if (events)
+            {
+                for (auto ev : events)
+                {
+                    compact_event* item = m_tree->make<compact_event>();
+                    xaml_ptr<xaml_event_info> info;
+                    XAML_RETURN_IF_FAILED(ev->get_info(&info));
+                    item->info = info.get();
+                    xaml_ptr<xaml_string> value;
+                    XAML_RETURN_IF_FAILED(ev->get_value(&value));
+                    XAML_RETURN_IF_FAILED(intern(value, &item->value));
+                    result->events.append(item);
+                }
+            }
+        }
+        *ptr = result;
+        return XAML_S_OK;
+    }
+    XAML_CATCH_RETURN()
+};
+
+xaml_result XAML_CALL xaml_node_get_compact(xaml_node* node, shared_ptr<compact_tree>* ptree, compact_node** ptr) noexcept
+try
+{
+    if (auto c = xaml_ptr<xaml_node>(node).query<xaml_compact_node>())
+    {
+        if (XAML_SUCCEEDED(c->get_compact(ptree, ptr))) return XAML_S_OK;
+    }
+    // The infos are kept alive by the COM nodes.
+    compact_converter converter{ make_shared<compact_tree>() };
+    converter.m_tree->owner = node;
+    XAML_RETURN_IF_FAILED(converter.convert(node, &converter.m_tree->root));
+    *ptree = converter.m_tree;
+    *ptr = converter.m_tree->root;
+    return XAML_S_OK;
+}
+XAML_CATCH_RETURN()
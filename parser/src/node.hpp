@@ -0,0 +1,204 @@
+#ifndef XAML_PARSER_NODE_HPP
+#define XAML_PARSER_NODE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <xaml/parser/node.h>
+
+// The nodes built by the parser.
+// They are plain structs allocated from the arena of a tree,
+// and the COM nodes are only created when required.
+// Strings are interned in the tree, so that the same strings share one copy,
+// and could be compared by the pointer.
+
+// A bump allocator; the memory is freed all at once with the arena.
+class compact_arena
+{
+private:
+    static constexpr std::size_t block_size = 16 * 1024;
+
+    std::vector<std::unique_ptr<std::byte[]>> m_blocks{};
+    std::byte* m_current{ nullptr };
+    std::size_t m_remain{ 0 };
+
+public:
+    void* allocate(std::size_t size, std::size_t align);
+};
+
+// A singly linked list of arena allocated items.
+template <typename T>
+struct compact_list
+{
+    T* first{ nullptr };
+    T* last{ nullptr };
+
+    void append(T* item) noexcept
+    {
+        if (last)
+            last->next = item;
+        else
+            first = item;
+        last = item;
+    }
+
+    struct iterator
+    {
+        T* current;
+
+        T& operator*() const noexcept { return *current; }
+        T* operator->() const noexcept { return current; }
+
+        iterator& operator++() noexcept
+        {
+            current = current->next;
+            return *this;
+        }
+
+        bool operator==(iterator const& other) const noexcept { return current == other.current; }
+        bool operator!=(iterator const& other) const noexcept { return current != other.current; }
+    };
+
+    iterator begin() const noexcept { return { first }; }
+    iterator end() const noexcept { return { nullptr }; }
+};
+
+enum class compact_node_kind
+{
+    string,
+    markup,
+    node
+};
+
+struct compact_node_base
+{
+    compact_node_kind kind;
+    xaml_type_info* type{ nullptr };
+    std::string_view name{};
+    // Null if no key.
+    std::string_view key{};
+};
+
+struct compact_string_node : compact_node_base
+{
+    std::string_view value{};
+};
+
+struct compact_property
+{
+    xaml_type_info* type{ nullptr };
+    xaml_property_info* info{ nullptr };
+    compact_node_base* value{ nullptr };
+    compact_property* next{ nullptr };
+};
+
+struct compact_markup_node : compact_node_base
+{
+    compact_list<compact_property> properties{};
+};
+
+struct compact_node;
+
+struct compact_node_item
+{
+    compact_node* node{ nullptr };
+    compact_node_item* next{ nullptr };
+};
+
+struct compact_collection_property
+{
+    xaml_type_info* type{ nullptr };
+    xaml_collection_property_info* info{ nullptr };
+    std::string_view name{};
+    compact_list<compact_node_item> values{};
+    compact_collection_property* next{ nullptr };
+};
+
+struct compact_event
+{
+    xaml_event_info* info{ nullptr };
+    std::string_view value{};
+    compact_event* next{ nullptr };
+};
+
+struct compact_resource
+{
+    std::string_view key{};
+    compact_node* node{ nullptr };
+    compact_resource* next{ nullptr };
+};
+
+struct compact_node : compact_node_base
+{
+    compact_list<compact_resource> resources{};
+    compact_list<compact_property> properties{};
+    compact_list<compact_collection_property> collection_properties{};
+    compact_list<compact_event> events{};
+
+    // Adds a resource, or replaces the one with the same key.
+    void add_resource(compact_resource* res) noexcept;
+    // The collection property with the interned name, or null.
+    compact_collection_property* find_collection_property(std::string_view name) const noexcept;
+};
+
+struct compact_tree
+{
+    compact_arena arena{};
+    std::unordered_set<std::string_view> names{};
+    std::unordered_map<char const*, xaml_ptr<xaml_string>> strings{};
+    // Keeps the infos referred by the nodes alive.
+    xaml_ptr<xaml_object> owner{};
+    // Trees of the nodes which are linked from this one.
+    std::vector<std::shared_ptr<compact_tree>> dependencies{};
+    compact_node* root{ nullptr };
+
+    template <typename T>
+    T* make(compact_node_kind kind)
+    {
+        static_assert(std::is_trivially_destructible_v<T>);
+        T* node = new (arena.allocate(sizeof(T), alignof(T))) T{};
+        node->kind = kind;
+        return node;
+    }
+
+    template <typename T>
+    T* make()
+    {
+        static_assert(std::is_trivially_destructible_v<T>);
+        return new (arena.allocate(sizeof(T), alignof(T))) T{};
+    }
+
+    // Copies the string into the arena once.
+    // Null string is kept null.
+    std::string_view intern(std::string_view str);
+
+    // Gets a shared xaml_string of an interned string;
+    // null string gets a null pointer.
+    xaml_result get_string(std::string_view interned, xaml_string** ptr) noexcept;
+};
+
+// An xaml_node backed by a compact node.
+// The COM members are created on the first access.
+XAML_CLASS(xaml_compact_node, { 0x4cf2a0e6, 0x3d5b, 0x4f0f, { 0x8d, 0x2a, 0x91, 0x6b, 0x0e, 0x57, 0xc3, 0x1d } })
+
+#define XAML_COMPACT_NODE_VTBL(type)          \
+    XAML_VTBL_INHERIT(XAML_NODE_VTBL(type)); \
+    XAML_METHOD(get_compact, type, std::shared_ptr<compact_tree>*, compact_node**)
+
+XAML_DECL_INTERFACE_(xaml_compact_node, xaml_node)
+{
+    XAML_DECL_VTBL(xaml_compact_node, XAML_COMPACT_NODE_VTBL);
+};
+
+xaml_result XAML_CALL xaml_compact_node_new(std::shared_ptr<compact_tree> const&, compact_node*, xaml_node**) noexcept;
+
+// Gets the compact form of any xaml_node.
+// Nodes not created by the parser, or changed through COM interfaces, are converted.
+xaml_result XAML_CALL xaml_node_get_compact(xaml_node*, std::shared_ptr<compact_tree>*, compact_node**) noexcept;
+
+#endif // !XAML_PARSER_NODE_HPP
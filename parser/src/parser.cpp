@@ -1,27 +1,16 @@
 #define XAML_RAISE_LEVEL xaml_result_raise_warning
 
-#include <rapidxml/xml_attribute.hpp>
-#include <rapidxml/xml_document.hpp>
+#include <node.hpp>
+#include <rapidxml/xml_reader.hpp>
 #include <sf/sformat.hpp>
-#include <sstream>
+#include <unordered_map>
+#include <vector>
 #include <xaml/internal/stream.hpp>
 #include <xaml/parser/parser.h>
 
 using namespace std;
 using namespace rapidxml;
 
-static xaml_result get_random_name(xaml_ptr<xaml_type_info> const& ref, xaml_string** ptr) noexcept
-{
-    static size_t index = 0;
-    xaml_ptr<xaml_string> name;
-    XAML_RETURN_IF_FAILED(ref->get_name(&name));
-    try
-    {
-        return xaml_string_new(sf::sprint(U("__{}__{}"), name, index++), ptr);
-    }
-    XAML_CATCH_RETURN()
-}
-
 static xaml_result to_xaml_result() noexcept
 try
 {
@@ -35,61 +24,104 @@ catch (rapidxml::parse_error const& e)
 }
 XAML_CATCH_RETURN()
 
-struct parser_impl
+// Hashes a pair of pointers, which identify interned strings or infos.
+struct pointer_pair_hash
 {
-    xaml_ptr<xaml_meta_context> ctx{ nullptr };
-    xaml_ptr<xaml_vector<xaml_string>> headers{};
-    xml_document doc{};
-
-    xaml_result load_string(string_view s) noexcept
-    try
+    size_t operator()(pair<void const*, void const*> const& p) const noexcept
     {
-        doc.load_string(s);
-        return XAML_S_OK;
+        size_t h1 = hash<void const*>{}(p.first);
+        size_t h2 = hash<void const*>{}(p.second);
+        return h1 ^ (h2 + 0x9e3779b9 + (h1 << 6) + (h1 >> 2));
     }
-    catch (...)
+};
+
+struct parser_impl
+{
+    enum class frame_kind
     {
-        return to_xaml_result();
-    }
+        // An element creating a node.
+        node,
+        // A property element, `cls.prop`.
+        property,
+        // A property element of a collection property.
+        collection,
+        // A property element `cls.resources`.
+        resources,
+        // An element which is not parsed.
+        ignored
+    };
 
-    xaml_result load_buffer(xaml_ptr<xaml_buffer> const& buffer) noexcept
+    // The state of an open element.
+    // The infos are kept alive by the meta context.
+    struct frame
     {
-        uint8_t* data;
-        XAML_RETURN_IF_FAILED(buffer->get_data(&data));
-        int32_t size;
-        XAML_RETURN_IF_FAILED(buffer->get_size(&size));
-        return load_string(string_view((char const*)data, (size_t)size));
-    }
+        frame_kind kind;
+        // The node.
+        // For property elements, it is the parent node.
+        compact_node* node{ nullptr };
+        xaml_type_info* type{ nullptr };
+        string_view ns{};
+        // For property frames, only the first child is assigned.
+        xaml_property_info* prop{ nullptr };
+        bool assigned{ false };
+        // For collection frames.
+        compact_collection_property* values{ nullptr };
+    };
+
+    // The result of a lookup, cached by the interned names.
+    template <typename T>
+    struct lookup_result
+    {
+        xaml_result hr = XAML_E_FAIL;
+        xaml_ptr<T> info{};
+    };
+
+    xaml_ptr<xaml_meta_context> ctx{ nullptr };
+    xaml_ptr<xaml_vector<xaml_string>> headers{};
+    xml_reader reader{};
+    vector<frame> frames{};
+    shared_ptr<compact_tree> tree{};
+    compact_node* root{ nullptr };
+    unordered_map<pair<void const*, void const*>, lookup_result<xaml_type_info>, pointer_pair_hash> types{};
+    unordered_map<pair<void const*, void const*>, lookup_result<xaml_property_info>, pointer_pair_hash> props{};
 
-    xaml_result load_stream(istream& stream) noexcept
+    xaml_result init(xaml_meta_context* context) noexcept
     try
     {
-        doc.load_stream(stream);
+        ctx = context;
+        XAML_RETURN_IF_FAILED(xaml_vector_new(&headers));
+        tree = make_shared<compact_tree>();
+        tree->owner = ctx;
         return XAML_S_OK;
     }
-    catch (...)
-    {
-        return to_xaml_result();
-    }
+    XAML_CATCH_RETURN()
 
-    xaml_result load_stream(FILE* stream) noexcept
+    // Lookup keys are never null strings.
+    string_view intern_key(string_view str)
     {
-        return cfile_istream_invoke<char>([this](istream& stream) noexcept -> xaml_result { return load_stream(stream); }, stream);
+        str = tree->intern(str);
+        return str.data() ? str : string_view{ "" };
     }
 
-    xaml_result init() noexcept
-    {
-        XAML_RETURN_IF_FAILED(xaml_vector_new(&headers));
-        return XAML_S_OK;
-    }
+    xaml_result parse_markup(string_view value, compact_markup_node** ptr);
+    xaml_result get_random_name(xaml_type_info* t, string_view* ptr);
+    xaml_result get_type(string_view ns, string_view name, xaml_type_info** ptr);
+    xaml_result get_property(xaml_type_info* t, string_view name, xaml_property_info** ptr);
+    compact_string_node* make_string_node(string_view value);
+    void add_property(compact_node* node, xaml_type_info* t, xaml_property_info* prop, compact_node_base* value);
+    xaml_result begin_node(xaml_type_info* t, string_view ns);
+    xaml_result begin_child_node(xml_event const& ev);
+    xaml_result start_element(xml_event const& ev) noexcept;
+    xaml_result attribute(xml_event const& attr) noexcept;
+    xaml_result text(string_view value) noexcept;
+    xaml_result end_element() noexcept;
 
-    xaml_result parse_markup(string_view value, xaml_markup_node** ptr) noexcept;
-    xaml_result parse_members(xaml_ptr<xaml_node> const& mc, xml_node& node) noexcept;
-    xaml_result parse_impl(xml_node& node, xaml_node** ptr) noexcept;
-    xaml_result parse_impl(xml_node& node, xaml_ptr<xaml_type_info> const& t, xaml_node** ptr) noexcept;
-    xaml_result parse(xaml_node** ptr) noexcept;
+    // Builds the nodes from the events of the reader;
+    // `feed` is called when the reader needs more input.
+    template <typename F>
+    xaml_result parse(F&& feed, xaml_node** ptr) noexcept;
 
-    xaml_result add_include_file(xaml_reflection_info* info) noexcept
+    xaml_result add_include_file(xaml_type_info* info)
     {
         xaml_ptr<xaml_string> include_file;
         XAML_RETURN_IF_FAILED(info->get_include_file(&include_file));
@@ -99,7 +131,73 @@ struct parser_impl
     }
 };
 
-xaml_result parser_impl::parse_markup(string_view value, xaml_markup_node** ptr) noexcept
+// The pointers returned by the lookups below are borrowed:
+// they are kept alive by the caches or the meta context.
+// These methods may throw, and the callers catch the exceptions.
+
+xaml_result parser_impl::get_random_name(xaml_type_info* t, string_view* ptr)
+{
+    // Give it a random name, because it won't have real name.
+    static size_t index = 0;
+    xaml_ptr<xaml_string> name;
+    XAML_RETURN_IF_FAILED(t->get_name(&name));
+    *ptr = tree->intern(sf::sprint(U("__{}__{}"), name, index++));
+    return XAML_S_OK;
+}
+
+xaml_result parser_impl::get_type(string_view ns, string_view name, xaml_type_info** ptr)
+{
+    ns = intern_key(ns);
+    name = intern_key(name);
+    auto [it, inserted] = types.try_emplace({ ns.data(), name.data() });
+    lookup_result<xaml_type_info>& result = it->second;
+    if (inserted)
+    {
+        xaml_ptr<xaml_string> ns_str;
+        XAML_RETURN_IF_FAILED(tree->get_string(ns, &ns_str));
+        xaml_ptr<xaml_string> name_str;
+        XAML_RETURN_IF_FAILED(tree->get_string(name, &name_str));
+        xaml_ptr<xaml_reflection_info> info;
+        result.hr = ctx->get_type_by_namespace_name(ns_str, name_str, &info);
+        if (XAML_SUCCEEDED(result.hr))
+            result.hr = info->query(&result.info);
+    }
+    *ptr = result.info.get();
+    return result.hr;
+}
+
+xaml_result parser_impl::get_property(xaml_type_info* t, string_view name, xaml_property_info** ptr)
+{
+    name = intern_key(name);
+    auto [it, inserted] = props.try_emplace({ t, name.data() });
+    lookup_result<xaml_property_info>& result = it->second;
+    if (inserted)
+    {
+        xaml_ptr<xaml_string> name_str;
+        XAML_RETURN_IF_FAILED(tree->get_string(name, &name_str));
+        result.hr = t->get_property(name_str, &result.info);
+    }
+    *ptr = result.info.get();
+    return result.hr;
+}
+
+compact_string_node* parser_impl::make_string_node(string_view value)
+{
+    compact_string_node* node = tree->make<compact_string_node>(compact_node_kind::string);
+    node->value = tree->intern(value);
+    return node;
+}
+
+void parser_impl::add_property(compact_node* node, xaml_type_info* t, xaml_property_info* prop, compact_node_base* value)
+{
+    compact_property* item = tree->make<compact_property>();
+    item->type = t;
+    item->info = prop;
+    item->value = value;
+    node->properties.append(item);
+}
+
+xaml_result parser_impl::parse_markup(string_view value, compact_markup_node** ptr)
 {
     string_view ns, name;
     size_t sep_index = 0;
@@ -123,28 +221,13 @@ xaml_result parser_impl::parse_markup(string_view value, xaml_markup_node** ptr)
     if (ns.empty()) ns = "xaml";
     if (name.empty()) name = value.substr(sep_index);
     // Find the type
-    xaml_ptr<xaml_reflection_info> info;
-    {
-        xaml_ptr<xaml_string> ns_str;
-        XAML_RETURN_IF_FAILED(xaml_string_new(ns, &ns_str));
-        xaml_ptr<xaml_string> name_str;
-        XAML_RETURN_IF_FAILED(xaml_string_new(name, &name_str));
-        XAML_RETURN_IF_FAILED(ctx->get_type_by_namespace_name(ns_str, name_str, &info));
-    }
-    XAML_RETURN_IF_FAILED(add_include_file(info));
-    xaml_ptr<xaml_type_info> t;
-    XAML_RETURN_IF_FAILED(info->query(&t));
-    // Give it a random name, because it won't have real name.
-    xaml_ptr<xaml_string> node_name;
-    XAML_RETURN_IF_FAILED(get_random_name(t, &node_name));
+    xaml_type_info* t;
+    XAML_RETURN_IF_FAILED(get_type(ns, name, &t));
+    XAML_RETURN_IF_FAILED(add_include_file(t));
     // Initialize the markup node.
-    xaml_ptr<xaml_markup_node> node;
-    XAML_RETURN_IF_FAILED(xaml_markup_node_new(&node));
-    XAML_RETURN_IF_FAILED(node->set_type(t));
-    XAML_RETURN_IF_FAILED(node->set_name(node_name));
-    // The properties of the node, assign at last.
-    xaml_ptr<xaml_vector<xaml_attribute_property>> props;
-    XAML_RETURN_IF_FAILED(xaml_vector_new(&props));
+    compact_markup_node* node = tree->make<compact_markup_node>(compact_node_kind::markup);
+    node->type = t;
+    XAML_RETURN_IF_FAILED(get_random_name(t, &node->name));
     while (i < value.length())
     {
         // Skip spaces
@@ -176,482 +259,466 @@ xaml_result parser_impl::parse_markup(string_view value, xaml_markup_node** ptr)
         string_view prop_value = value.substr(start_index, i - start_index);
         // Bump i for next loop
         while (i < value.length() && value[i] == ',') i++;
-        // Get property name, especially for default one
-        xaml_ptr<xaml_string> prop_name_str;
+        // Find the property, especially for default one
+        xaml_property_info* prop;
         if (prop_name.empty())
         {
             xaml_ptr<xaml_default_property> def_attr;
             XAML_RETURN_IF_FAILED(t->get_attribute(&def_attr));
+            xaml_ptr<xaml_string> prop_name_str;
             XAML_RETURN_IF_FAILED(def_attr->get_default_property(&prop_name_str));
+            XAML_RETURN_IF_FAILED(get_property(t, to_string_view(prop_name_str), &prop));
         }
         else
         {
-            XAML_RETURN_IF_FAILED(xaml_string_new(prop_name, &prop_name_str));
+            XAML_RETURN_IF_FAILED(get_property(t, prop_name, &prop));
         }
-        // Find the property
-        xaml_ptr<xaml_property_info> prop;
-        XAML_RETURN_IF_FAILED(t->get_property(prop_name_str, &prop));
         bool can_write;
         XAML_RETURN_IF_FAILED(prop->get_can_write(&can_write));
         if (can_write)
         {
-            xaml_ptr<xaml_node_base> node_value;
+            compact_property* item = tree->make<compact_property>();
+            item->type = t;
+            item->info = prop;
             // The value maybe another markup node
             if (prop_value.starts_with('{') && prop_value.ends_with('}'))
             {
-                xaml_ptr<xaml_markup_node> ex;
+                compact_markup_node* ex;
                 XAML_RETURN_IF_FAILED(parse_markup(prop_value.substr(1, prop_value.length() - 2), &ex));
-                node_value = ex;
+                item->value = ex;
             }
             // or a string
             else
             {
-                xaml_ptr<xaml_string> prop_value_str;
-                XAML_RETURN_IF_FAILED(xaml_string_new(prop_value, &prop_value_str));
-                xaml_ptr<xaml_string_node> node_str_value;
-                XAML_RETURN_IF_FAILED(xaml_string_node_new(&node_str_value));
-                XAML_RETURN_IF_FAILED(node_str_value->set_value(prop_value_str));
-                node_value = node_str_value;
+                item->value = make_string_node(prop_value);
             }
-            xaml_ptr<xaml_attribute_property> prop_item;
-            XAML_RETURN_IF_FAILED(xaml_attribute_property_new(t, prop, node_value, &prop_item));
-            XAML_RETURN_IF_FAILED(props->append(prop_item));
+            node->properties.append(item);
         }
     }
-    XAML_RETURN_IF_FAILED(node->set_properties(props));
-    return node->query(ptr);
+    *ptr = node;
+    return XAML_S_OK;
 }
 
-static constexpr string_view x_ns{ "https://github.com/Berrysoft/XamlCpp/xaml/" };
+xaml_result parser_impl::begin_node(xaml_type_info* t, string_view ns)
+{
+    XAML_RETURN_IF_FAILED(add_include_file(t));
+    frame f{ frame_kind::node };
+    f.node = tree->make<compact_node>(compact_node_kind::node);
+    f.node->type = t;
+    f.type = t;
+    f.ns = tree->intern(ns);
+    frames.push_back(f);
+    return XAML_S_OK;
+}
 
-// Add string node to properties vector
-static xaml_result props_add_string_property(xaml_ptr<xaml_vector<xaml_attribute_property>> const& props, xaml_ptr<xaml_type_info> const& t, xaml_ptr<xaml_property_info> const& prop, string_view value) noexcept
+xaml_result parser_impl::begin_child_node(xml_event const& ev)
 {
-    xaml_ptr<xaml_string> attr_value_str;
-    XAML_RETURN_IF_FAILED(xaml_string_new(value, &attr_value_str));
-    xaml_ptr<xaml_string_node> node_value;
-    XAML_RETURN_IF_FAILED(xaml_string_node_new(&node_value));
-    XAML_RETURN_IF_FAILED(node_value->set_value(attr_value_str));
-    xaml_ptr<xaml_attribute_property> prop_item;
-    XAML_RETURN_IF_FAILED(xaml_attribute_property_new(t, prop, node_value, &prop_item));
-    return props->append(prop_item);
+    xaml_type_info* t;
+    XAML_RETURN_IF_FAILED(get_type(ev.namespace_uri(), ev.local_name(), &t));
+    return begin_node(t, ev.namespace_uri());
 }
 
-// Get values vector from a collection proeperty
-static xaml_result get_cprop_values(xaml_ptr<xaml_map<xaml_string, xaml_attribute_collection_property>> const& cprops, xaml_ptr<xaml_collection_property_info> const& cprop, xaml_ptr<xaml_type_info> const& type, xaml_vector<xaml_node>** pvalues) noexcept
+static constexpr string_view x_ns{ "https://github.com/Berrysoft/XamlCpp/xaml/" };
+
+// Get values of a collection proeperty
+static compact_collection_property* get_cprop_values(compact_tree& tree, compact_node* node, xaml_collection_property_info* cprop, string_view prop_name, xaml_type_info* type)
 {
-    xaml_ptr<xaml_attribute_collection_property> cprop_item;
-    xaml_ptr<xaml_vector<xaml_node>> values;
-    xaml_ptr<xaml_string> prop_name_str;
-    XAML_RETURN_IF_FAILED(cprop->get_name(&prop_name_str));
-    if (XAML_SUCCEEDED(cprops->lookup(prop_name_str, &cprop_item)))
+    prop_name = tree.intern(prop_name);
+    compact_collection_property* values = node->find_collection_property(prop_name);
+    if (!values)
     {
-        XAML_RETURN_IF_FAILED(cprop_item->get_values(&values));
+        values = tree.make<compact_collection_property>();
+        values->type = type;
+        values->info = cprop;
+        values->name = prop_name;
+        node->collection_properties.append(values);
     }
-    else
-    {
-        XAML_RETURN_IF_FAILED(xaml_vector_new(&values));
-        XAML_RETURN_IF_FAILED(xaml_attribute_collection_property_new(type, cprop, values, &cprop_item));
-        XAML_RETURN_IF_FAILED(cprops->insert(prop_name_str, cprop_item, nullptr));
-    }
-    return values.query(pvalues);
+    return values;
 }
 
-xaml_result parser_impl::parse_members(xaml_ptr<xaml_node> const& mc, xml_node& node) noexcept
+xaml_result parser_impl::start_element(xml_event const& ev) noexcept
+try
 {
-    xaml_ptr<xaml_map<xaml_string, xaml_node>> reses;
-    XAML_RETURN_IF_FAILED(mc->get_resources(&reses));
-    if (!reses)
+    // Only the first root element is parsed.
+    if (frames.empty())
     {
-        xaml_ptr<xaml_hasher<xaml_string>> hasher;
-        XAML_RETURN_IF_FAILED(xaml_hasher_string_default(&hasher));
-        XAML_RETURN_IF_FAILED(xaml_map_new(hasher.get(), &reses));
-        XAML_RETURN_IF_FAILED(mc->set_resources(reses));
+        if (root)
+        {
+            frames.push_back({ frame_kind::ignored });
+            return XAML_S_OK;
+        }
+        return begin_child_node(ev);
     }
-    xaml_ptr<xaml_vector<xaml_attribute_property>> props;
-    XAML_RETURN_IF_FAILED(mc->get_properties(&props));
-    if (!props)
+    frame& parent = frames.back();
+    switch (parent.kind)
     {
-        XAML_RETURN_IF_FAILED(xaml_vector_new(&props));
-        XAML_RETURN_IF_FAILED(mc->set_properties(props));
+    case frame_kind::ignored:
+        frames.push_back({ frame_kind::ignored });
+        return XAML_S_OK;
+    // Only the first child is the value of a property.
+    case frame_kind::property:
+        if (parent.assigned)
+        {
+            frames.push_back({ frame_kind::ignored });
+            return XAML_S_OK;
+        }
+        return begin_child_node(ev);
+    case frame_kind::collection:
+    case frame_kind::resources:
+        return begin_child_node(ev);
+    default:
+        break;
     }
-    xaml_ptr<xaml_map<xaml_string, xaml_attribute_collection_property>> cprops;
-    XAML_RETURN_IF_FAILED(mc->get_collection_properties(&cprops));
-    if (!cprops)
+    auto name = ev.local_name();
+    size_t dm_index = name.find_first_of('.');
+    // A new node
+    if (dm_index == string_view::npos)
+        return begin_child_node(ev);
+    // This is a property
+    string_view class_name = name.substr(0, dm_index);
+    string_view prop_name = name.substr(dm_index + 1);
+    xaml_type_info* t;
+    XAML_RETURN_IF_FAILED(get_type(ev.namespace_uri(), class_name, &t));
+    XAML_RETURN_IF_FAILED(add_include_file(t));
+    // The node is the parent node.
+    frame f = parent;
+    f.kind = frame_kind::ignored;
+    // Deal with resources
+    if (prop_name == "resources")
     {
-        xaml_ptr<xaml_hasher<xaml_string>> hasher;
-        XAML_RETURN_IF_FAILED(xaml_hasher_string_default(&hasher));
-        XAML_RETURN_IF_FAILED(xaml_map_new(hasher.get(), &cprops));
-        XAML_RETURN_IF_FAILED(mc->set_collection_properties(cprops));
+        f.kind = frame_kind::resources;
     }
-    xaml_ptr<xaml_vector<xaml_attribute_event>> events;
-    XAML_RETURN_IF_FAILED(mc->get_events(&events));
-    if (!events)
+    else
     {
-        XAML_RETURN_IF_FAILED(xaml_vector_new(&events));
-        XAML_RETURN_IF_FAILED(mc->set_events(events));
+        // If it is a property, the child node is the value
+        xaml_property_info* prop;
+        if (XAML_SUCCEEDED(get_property(t, prop_name, &prop)))
+        {
+            bool can_write;
+            XAML_RETURN_IF_FAILED(prop->get_can_write(&can_write));
+            if (can_write)
+            {
+                f.kind = frame_kind::property;
+                f.prop = prop;
+            }
+        }
+        else
+        {
+            // Or it is a collection property
+            xaml_ptr<xaml_string> prop_name_str;
+            XAML_RETURN_IF_FAILED(tree->get_string(intern_key(prop_name), &prop_name_str));
+            xaml_ptr<xaml_collection_property_info> cprop;
+            if (XAML_SUCCEEDED(t->get_collection_property(prop_name_str, &cprop)))
+            {
+                bool can_add;
+                XAML_RETURN_IF_FAILED(cprop->get_can_add(&can_add));
+                if (can_add)
+                {
+                    f.kind = frame_kind::collection;
+                    f.values = get_cprop_values(*tree, f.node, cprop, prop_name, f.type);
+                }
+            }
+        }
     }
+    frames.push_back(f);
+    return XAML_S_OK;
+}
+XAML_CATCH_RETURN()
 
-    switch (node.type())
+xaml_result parser_impl::attribute(xml_event const& attr) noexcept
+try
+{
+    frame& f = frames.back();
+    // Attributes of property elements are ignored.
+    if (f.kind != frame_kind::node) return XAML_S_OK;
+    auto attr_ns = attr.namespace_uri();
+    auto attr_name = attr.local_name();
+    // xmlns is not property
+    if ((attr_ns == xml_namespace::uri && attr_name == "xmlns") || (attr_ns == xmlns_namespace::uri))
+        return XAML_S_OK;
+    // When the namespace of property is empty, use default one.
+    // There's a case, when using attached properties,
+    // the name of the class should be specified.
+    // And now the default namespace of the specified class
+    // is the same as the namespace of the node.
+    else if (attr_ns.empty())
+        attr_ns = f.ns;
+    // Special namespace: x
+    if (attr_ns == x_ns)
     {
-    case node_type::element:
+        if (attr_name == "name")
+        {
+            f.node->name = tree->intern(attr.value());
+        }
+        else if (attr_name == "key")
+        {
+            f.node->key = tree->intern(attr.value());
+        }
+        return XAML_S_OK;
+    }
+    // Determine if it is attached property.
+    size_t dm_index = attr_name.find_first_of('.');
+    if (dm_index != string_view::npos)
     {
-        auto ns = node.namespace_uri();
-        // There's a case, when using attached properties,
-        // the name of the class should be specified.
-        // And now the default namespace of the specified class
-        // is the same as the namespace of the node.
-        for (auto& attr : node.attributes())
+        // Find class
+        string_view class_name = attr_name.substr(0, dm_index);
+        string_view attach_prop_name = attr_name.substr(dm_index + 1);
+        xaml_type_info* t;
+        XAML_RETURN_IF_FAILED(get_type(attr_ns, class_name, &t));
+        XAML_RETURN_IF_FAILED(add_include_file(t));
+        // Find property
+        xaml_property_info* prop;
+        XAML_RETURN_IF_FAILED(get_property(t, attach_prop_name, &prop));
+        bool can_write;
+        XAML_RETURN_IF_FAILED(prop->get_can_write(&can_write));
+        if (can_write)
         {
-            auto attr_ns = attr.namespace_uri();
-            auto attr_name = attr.local_name();
-            // xmlns is not property
-            if ((attr_ns == xml_namespace::uri && attr_name == "xmlns") || (attr_ns == xmlns_namespace::uri))
-                continue;
-            // When the namespace of property is empty, use default one
-            else if (attr_ns.empty())
-                attr_ns = ns;
-            // Special namespace: x
-            if (attr_ns == x_ns)
+            // Support string value only for attached proeprty up to now
+            add_property(f.node, t, prop, make_string_node(attr.value()));
+        }
+        return XAML_S_OK;
+    }
+    // Find property from type of node
+    xaml_property_info* prop;
+    if (XAML_SUCCEEDED(get_property(f.type, attr_name, &prop)))
+    {
+        bool can_write;
+        XAML_RETURN_IF_FAILED(prop->get_can_write(&can_write));
+        if (can_write)
+        {
+            string_view attr_value = attr.value();
+            // Support markup extensions
+            if (attr_value.starts_with('{') && attr_value.ends_with('}'))
             {
-                string_view attr_value = attr.value();
-                xaml_ptr<xaml_string> attr_value_str;
-                XAML_RETURN_IF_FAILED(xaml_string_new(attr_value, &attr_value_str));
-                if (attr_name == "name")
-                {
-                    XAML_RETURN_IF_FAILED(mc->set_name(attr_value_str));
-                }
-                else if (attr_name == "key")
-                {
-                    XAML_RETURN_IF_FAILED(mc->set_key(attr_value_str));
-                }
+                compact_markup_node* ex;
+                XAML_RETURN_IF_FAILED(parse_markup(attr_value.substr(1, attr_value.length() - 2), &ex));
+                add_property(f.node, f.type, prop, ex);
             }
             else
             {
-                // Determine if it is attached property.
-                size_t dm_index = attr_name.find_first_of('.');
-                if (dm_index != string_view::npos)
-                {
-                    // Find class
-                    string_view class_name = attr_name.substr(0, dm_index);
-                    string_view attach_prop_name = attr_name.substr(dm_index + 1);
-                    xaml_ptr<xaml_reflection_info> info;
-                    {
-                        xaml_ptr<xaml_string> attr_ns_str;
-                        XAML_RETURN_IF_FAILED(xaml_string_new(attr_ns, &attr_ns_str));
-                        xaml_ptr<xaml_string> class_name_str;
-                        XAML_RETURN_IF_FAILED(xaml_string_new(class_name, &class_name_str));
-                        XAML_RETURN_IF_FAILED(ctx->get_type_by_namespace_name(attr_ns_str, class_name_str, &info));
-                    }
-                    XAML_RETURN_IF_FAILED(add_include_file(info));
-                    xaml_ptr<xaml_type_info> t;
-                    XAML_RETURN_IF_FAILED(info->query(&t));
-                    // Find property
-                    xaml_ptr<xaml_property_info> prop;
-                    {
-                        xaml_ptr<xaml_string> aprop_name_str;
-                        XAML_RETURN_IF_FAILED(xaml_string_new(attach_prop_name, &aprop_name_str));
-                        XAML_RETURN_IF_FAILED(t->get_property(aprop_name_str, &prop));
-                    }
-                    bool can_write;
-                    XAML_RETURN_IF_FAILED(prop->get_can_write(&can_write));
-                    if (can_write)
-                    {
-                        // Support string value only for attached proeprty up to now
-                        XAML_RETURN_IF_FAILED(props_add_string_property(props, t, prop, attr.value()));
-                    }
-                }
-                else
-                {
-                    // Find property from type of node
-                    xaml_ptr<xaml_type_info> type;
-                    XAML_RETURN_IF_FAILED(mc->get_type(&type));
-                    xaml_ptr<xaml_property_info> prop;
-                    xaml_ptr<xaml_string> attr_name_str;
-                    XAML_RETURN_IF_FAILED(xaml_string_new(attr_name, &attr_name_str));
-                    if (XAML_SUCCEEDED(type->get_property(attr_name_str, &prop)))
-                    {
-                        bool can_write;
-                        XAML_RETURN_IF_FAILED(prop->get_can_write(&can_write));
-                        if (can_write)
-                        {
-                            string_view attr_value = attr.value();
-                            // Support markup extensions
-                            if (attr_value.starts_with('{') && attr_value.ends_with('}'))
-                            {
-                                xaml_ptr<xaml_markup_node> ex;
-                                XAML_RETURN_IF_FAILED(parse_markup(attr_value.substr(1, attr_value.length() - 2), &ex));
-                                xaml_ptr<xaml_attribute_property> prop_item;
-                                XAML_RETURN_IF_FAILED(xaml_attribute_property_new(type, prop, ex, &prop_item));
-                                XAML_RETURN_IF_FAILED(props->append(prop_item));
-                            }
-                            else
-                            {
-                                XAML_RETURN_IF_FAILED(props_add_string_property(props, type, prop, attr_value));
-                            }
-                        }
-                    }
-                    else
-                    {
-                        // If it is not a property, it should be an event
-                        xaml_ptr<xaml_event_info> ev;
-                        XAML_RETURN_IF_FAILED(type->get_event(attr_name_str, &ev));
-                        xaml_ptr<xaml_string> attr_value_str;
-                        XAML_RETURN_IF_FAILED(xaml_string_new(attr.value(), &attr_value_str));
-                        xaml_ptr<xaml_attribute_event> ev_item;
-                        XAML_RETURN_IF_FAILED(xaml_attribute_event_new(ev, attr_value_str, &ev_item));
-                        XAML_RETURN_IF_FAILED(events->append(ev_item));
-                    }
-                }
+                add_property(f.node, f.type, prop, make_string_node(attr_value));
             }
         }
-        break;
     }
-    // Text nodes
-    case node_type::data:
-    case node_type::cdata:
+    else
+    {
+        // If it is not a property, it should be an event
+        xaml_ptr<xaml_string> attr_name_str;
+        XAML_RETURN_IF_FAILED(tree->get_string(intern_key(attr_name), &attr_name_str));
+        xaml_ptr<xaml_event_info> ev;
+        XAML_RETURN_IF_FAILED(f.type->get_event(attr_name_str, &ev));
+        compact_event* item = tree->make<compact_event>();
+        item->info = ev.get();
+        item->value = tree->intern(attr.value());
+        f.node->events.append(item);
+    }
+    return XAML_S_OK;
+}
+XAML_CATCH_RETURN()
+
+xaml_result parser_impl::text(string_view value) noexcept
+try
+{
+    // Text out of the root element is ignored.
+    if (frames.empty()) return XAML_S_OK;
+    frame& f = frames.back();
+    switch (f.kind)
     {
-        xaml_ptr<xaml_type_info> type;
-        XAML_RETURN_IF_FAILED(mc->get_type(&type));
+    case frame_kind::node:
+    {
+        // Text is the value of the default property.
         xaml_ptr<xaml_default_property> def_attr;
-        if (XAML_SUCCEEDED(type->get_attribute(&def_attr)))
+        if (XAML_SUCCEEDED(f.type->get_attribute(&def_attr)))
         {
             xaml_ptr<xaml_string> prop_name;
             XAML_RETURN_IF_FAILED(def_attr->get_default_property(&prop_name));
-            xaml_ptr<xaml_property_info> prop;
-            XAML_RETURN_IF_FAILED(type->get_property(prop_name, &prop));
+            xaml_property_info* prop;
+            XAML_RETURN_IF_FAILED(get_property(f.type, to_string_view(prop_name), &prop));
             bool can_write;
             XAML_RETURN_IF_FAILED(prop->get_can_write(&can_write));
             if (can_write)
             {
-                XAML_RETURN_IF_FAILED(props_add_string_property(props, type, prop, node.value()));
+                add_property(f.node, f.type, prop, make_string_node(value));
             }
         }
-        break;
+        return XAML_S_OK;
     }
+    case frame_kind::property:
+        if (f.assigned) return XAML_S_OK;
+        [[fallthrough]];
+    case frame_kind::collection:
+    case frame_kind::resources:
+        // Only nodes are allowed in property elements.
+        return XAML_E_INVALIDARG;
     default:
-        break;
+        return XAML_S_OK;
+    }
+}
+XAML_CATCH_RETURN()
+
+xaml_result parser_impl::end_element() noexcept
+try
+{
+    frame f = frames.back();
+    frames.pop_back();
+    if (f.kind != frame_kind::node) return XAML_S_OK;
+    // Check if it already has a name
+    if (!f.node->name.data())
+    {
+        XAML_RETURN_IF_FAILED(get_random_name(f.type, &f.node->name));
     }
-    xaml_ptr<xaml_type_info> type;
-    XAML_RETURN_IF_FAILED(mc->get_type(&type));
-    for (auto& c : node.nodes())
+    if (frames.empty())
     {
-        // If the child node is a new element, construct it and parse its members;
-        // otherwise, parse members for the current node
-        if (c.type() == node_type::element)
+        root = f.node;
+        return XAML_S_OK;
+    }
+    frame& parent = frames.back();
+    switch (parent.kind)
+    {
+    case frame_kind::node:
+    {
+        // A child node is the value of the default property.
+        xaml_ptr<xaml_default_property> def_attr;
+        if (XAML_SUCCEEDED(parent.type->get_attribute(&def_attr)))
         {
-            auto ns = c.namespace_uri();
-            xaml_ptr<xaml_string> ns_str;
-            XAML_RETURN_IF_FAILED(xaml_string_new(ns, &ns_str));
-            auto name = c.local_name();
-            size_t dm_index = name.find_first_of('.');
-            // This is a property
-            if (dm_index != string_view::npos)
+            xaml_ptr<xaml_string> prop_name;
+            XAML_RETURN_IF_FAILED(def_attr->get_default_property(&prop_name));
+            xaml_property_info* prop;
+            if (XAML_SUCCEEDED(get_property(parent.type, to_string_view(prop_name), &prop)))
             {
-                string_view class_name = name.substr(0, dm_index);
-                string_view prop_name = name.substr(dm_index + 1);
-                xaml_ptr<xaml_reflection_info> info;
+                bool can_write;
+                XAML_RETURN_IF_FAILED(prop->get_can_write(&can_write));
+                if (can_write)
                 {
-                    xaml_ptr<xaml_string> class_name_str;
-                    XAML_RETURN_IF_FAILED(xaml_string_new(class_name, &class_name_str));
-                    XAML_RETURN_IF_FAILED(ctx->get_type_by_namespace_name(ns_str, class_name_str, &info));
-                }
-                XAML_RETURN_IF_FAILED(add_include_file(info));
-                xaml_ptr<xaml_type_info> t;
-                XAML_RETURN_IF_FAILED(info->query(&t));
-                // Deal with resources
-                if (prop_name == "resources")
-                {
-                    for (auto& cnode : c.nodes())
-                    {
-                        xaml_ptr<xaml_node> child;
-                        XAML_RETURN_IF_FAILED(parse_impl(cnode, &child));
-                        xaml_ptr<xaml_string> key;
-                        XAML_RETURN_IF_FAILED(child->get_key(&key));
-                        bool replaced;
-                        XAML_RETURN_IF_FAILED(reses->insert(key, child, &replaced));
-                    }
-                }
-                else
-                {
-                    xaml_ptr<xaml_string> prop_name_str;
-                    XAML_RETURN_IF_FAILED(xaml_string_new(prop_name, &prop_name_str));
-                    // If it is a property, add child node
-                    xaml_ptr<xaml_property_info> prop;
-                    if (XAML_SUCCEEDED(t->get_property(prop_name_str, &prop)))
-                    {
-                        bool can_write;
-                        XAML_RETURN_IF_FAILED(prop->get_can_write(&can_write));
-                        if (can_write)
-                        {
-                            xml_node& cnode = c.nodes().front();
-                            xaml_ptr<xaml_node> child;
-                            XAML_RETURN_IF_FAILED(parse_impl(cnode, &child));
-                            xaml_ptr<xaml_attribute_property> prop_item;
-                            XAML_RETURN_IF_FAILED(xaml_attribute_property_new(type, prop, child, &prop_item));
-                            XAML_RETURN_IF_FAILED(props->append(prop_item));
-                        }
-                    }
-                    else
-                    {
-                        // Or it is a collection property
-                        xaml_ptr<xaml_collection_property_info> cprop;
-                        if (XAML_SUCCEEDED(t->get_collection_property(prop_name_str, &cprop)))
-                        {
-                            bool can_add;
-                            XAML_RETURN_IF_FAILED(cprop->get_can_add(&can_add));
-                            if (can_add)
-                            {
-                                xaml_ptr<xaml_vector<xaml_node>> values;
-                                XAML_RETURN_IF_FAILED(get_cprop_values(cprops, cprop, type, &values));
-                                for (auto& cnode : c.nodes())
-                                {
-                                    xaml_ptr<xaml_node> child;
-                                    XAML_RETURN_IF_FAILED(parse_impl(cnode, &child));
-                                    XAML_RETURN_IF_FAILED(values->append(child));
-                                }
-                            }
-                        }
-                    }
+                    add_property(parent.node, parent.type, prop, f.node);
                 }
             }
-            // A new node
             else
             {
-                xaml_ptr<xaml_reflection_info> info;
+                xaml_ptr<xaml_collection_property_info> info2;
+                XAML_RETURN_IF_FAILED(parent.type->get_collection_property(prop_name, &info2));
+                bool can_add;
+                XAML_RETURN_IF_FAILED(info2->get_can_add(&can_add));
+                if (can_add)
                 {
-                    xaml_ptr<xaml_string> name_str;
-                    XAML_RETURN_IF_FAILED(xaml_string_new(name, &name_str));
-                    XAML_RETURN_IF_FAILED(ctx->get_type_by_namespace_name(ns_str, name_str, &info));
-                }
-                xaml_ptr<xaml_type_info> t;
-                XAML_RETURN_IF_FAILED(info->query(&t));
-                // Parse the child
-                xaml_ptr<xaml_node> child;
-                XAML_RETURN_IF_FAILED(parse_impl(c, t, &child));
-                xaml_ptr<xaml_default_property> def_attr;
-                if (XAML_SUCCEEDED(type->get_attribute(&def_attr)))
-                {
-                    xaml_ptr<xaml_string> prop_name;
-                    XAML_RETURN_IF_FAILED(def_attr->get_default_property(&prop_name));
-                    xaml_ptr<xaml_property_info> prop;
-                    if (XAML_SUCCEEDED(type->get_property(prop_name, &prop)))
-                    {
-                        bool can_write;
-                        XAML_RETURN_IF_FAILED(prop->get_can_write(&can_write));
-                        if (can_write)
-                        {
-                            xaml_ptr<xaml_attribute_property> prop_item;
-                            XAML_RETURN_IF_FAILED(xaml_attribute_property_new(type, prop, child, &prop_item));
-                            XAML_RETURN_IF_FAILED(props->append(prop_item));
-                        }
-                    }
-                    else
-                    {
-                        xaml_ptr<xaml_collection_property_info> info2;
-                        XAML_RETURN_IF_FAILED(type->get_collection_property(prop_name, &info2));
-                        bool can_add;
-                        XAML_RETURN_IF_FAILED(info2->get_can_add(&can_add));
-                        if (can_add)
-                        {
-                            xaml_ptr<xaml_vector<xaml_node>> values;
-                            XAML_RETURN_IF_FAILED(get_cprop_values(cprops, info2, type, &values));
-                            XAML_RETURN_IF_FAILED(values->append(child));
-                        }
-                    }
+                    compact_collection_property* values = get_cprop_values(*tree, parent.node, info2, to_string_view(prop_name), parent.type);
+                    compact_node_item* item = tree->make<compact_node_item>();
+                    item->node = f.node;
+                    values->values.append(item);
                 }
             }
         }
-        // So it is a child node
-        else
-        {
-            XAML_RETURN_IF_FAILED(parse_members(mc, c));
-        }
+        break;
     }
-    // Check if it already has a name
-    xaml_ptr<xaml_string> name;
-    XAML_RETURN_IF_FAILED(mc->get_name(&name));
-    if (!name)
+    case frame_kind::property:
+        add_property(parent.node, parent.type, parent.prop, f.node);
+        parent.assigned = true;
+        break;
+    case frame_kind::collection:
     {
-        XAML_RETURN_IF_FAILED(get_random_name(type, &name));
-        XAML_RETURN_IF_FAILED(mc->set_name(name));
+        compact_node_item* item = tree->make<compact_node_item>();
+        item->node = f.node;
+        parent.values->values.append(item);
+        break;
+    }
+    case frame_kind::resources:
+    {
+        compact_resource* res = tree->make<compact_resource>();
+        res->key = f.node->key;
+        res->node = f.node;
+        parent.node->add_resource(res);
+        break;
+    }
+    default:
+        break;
     }
     return XAML_S_OK;
 }
+XAML_CATCH_RETURN()
 
-xaml_result parser_impl::parse_impl(xml_node& node, xaml_node** ptr) noexcept
+template <typename F>
+xaml_result parser_impl::parse(F&& feed, xaml_node** ptr) noexcept
 {
-    auto ns = node.namespace_uri();
-    auto name = node.local_name();
-    xaml_ptr<xaml_reflection_info> info;
+    try
     {
-        xaml_ptr<xaml_string> ns_str;
-        XAML_RETURN_IF_FAILED(xaml_string_new(ns, &ns_str));
-        xaml_ptr<xaml_string> name_str;
-        XAML_RETURN_IF_FAILED(xaml_string_new(name, &name_str));
-        XAML_RETURN_IF_FAILED(ctx->get_type_by_namespace_name(ns_str, name_str, &info));
+        xml_event e;
+        while (true)
+        {
+            while (reader.next(e))
+            {
+                switch (e.type())
+                {
+                case xml_event_type::start_element:
+                    XAML_RETURN_IF_FAILED(start_element(e));
+                    break;
+                case xml_event_type::attribute:
+                    XAML_RETURN_IF_FAILED(attribute(e));
+                    break;
+                case xml_event_type::text:
+                    XAML_RETURN_IF_FAILED(text(e.value()));
+                    break;
+                case xml_event_type::end_element:
+                    XAML_RETURN_IF_FAILED(end_element());
+                    break;
+                default:
+                    break;
+                }
+            }
+            if (reader.finished()) break;
+            feed(reader);
+        }
     }
-    xaml_ptr<xaml_type_info> t;
-    XAML_RETURN_IF_FAILED(info->query(&t));
-    return parse_impl(node, t, ptr);
-}
-
-xaml_result parser_impl::parse_impl(xml_node& node, xaml_ptr<xaml_type_info> const& t, xaml_node** ptr) noexcept
-{
-    XAML_RETURN_IF_FAILED(add_include_file(t));
-    xaml_ptr<xaml_node> mc;
-    XAML_RETURN_IF_FAILED(xaml_node_new(&mc));
-    XAML_RETURN_IF_FAILED(mc->set_type(t));
-    XAML_RETURN_IF_FAILED(parse_members(mc, node));
-    return mc->query(ptr);
-}
-
-xaml_result parser_impl::parse(xaml_node** ptr) noexcept
-{
-    auto& root_nodes = doc.node().nodes();
-    auto it = find_if(root_nodes.begin(), root_nodes.end(), [](xml_node& node) noexcept { return node.type() == node_type::element; });
-    if (it == root_nodes.end()) return {};
-    auto& root_node = *it;
-    return parse_impl(root_node, ptr);
+    catch (...)
+    {
+        return to_xaml_result();
+    }
+    if (!root) return {};
+    tree->root = root;
+    return xaml_compact_node_new(tree, root, ptr);
 }
 
-static xaml_result XAML_CALL xaml_parse_parse_impl(parser_impl& parser, xaml_meta_context* ctx, xaml_node** ptr, xaml_vector_view<xaml_string>** pheaders) noexcept
+template <typename F>
+static xaml_result xaml_parser_parse_impl(xaml_meta_context* ctx, F&& feed, xaml_node** ptr, xaml_vector_view<xaml_string>** pheaders) noexcept
 {
-    parser.ctx = ctx;
-    XAML_RETURN_IF_FAILED(parser.parse(ptr));
+    parser_impl parser{};
+    XAML_RETURN_IF_FAILED(parser.init(ctx));
+    XAML_RETURN_IF_FAILED(parser.parse(forward<F>(feed), ptr));
     return parser.headers->query(pheaders);
 }
 
 xaml_result XAML_CALL xaml_parser_parse_string(xaml_meta_context* ctx, xaml_string* str, xaml_node** ptr, xaml_vector_view<xaml_string>** pheaders) noexcept
 {
-    parser_impl parser{};
-    XAML_RETURN_IF_FAILED(parser.init());
     string_view data;
     XAML_RETURN_IF_FAILED(to_string_view(str, &data));
-    XAML_RETURN_IF_FAILED(parser.load_string(data));
-    return xaml_parse_parse_impl(parser, ctx, ptr, pheaders);
+    return xaml_parser_parse_impl(
+        ctx, [data](xml_reader& reader) {
+            reader.load_view(data);
+        },
+        ptr, pheaders);
 }
 
 xaml_result XAML_CALL xaml_parser_parse_buffer(xaml_meta_context* ctx, xaml_buffer* buffer, xaml_node** ptr, xaml_vector_view<xaml_string>** pheaders) noexcept
 {
-    parser_impl parser{};
-    XAML_RETURN_IF_FAILED(parser.init());
-    XAML_RETURN_IF_FAILED(parser.load_buffer(buffer));
-    return xaml_parse_parse_impl(parser, ctx, ptr, pheaders);
+    uint8_t* data;
+    XAML_RETURN_IF_FAILED(buffer->get_data(&data));
+    int32_t size;
+    XAML_RETURN_IF_FAILED(buffer->get_size(&size));
+    return xaml_parser_parse_impl(
+        ctx, [data = string_view((char const*)data, (size_t)size)](xml_reader& reader) {
+            reader.load_view(data);
+        },
+        ptr, pheaders);
 }
 
 xaml_result XAML_CALL xaml_parser_parse_stream(xaml_meta_context* ctx, FILE* stream, xaml_node** ptr, xaml_vector_view<xaml_string>** pheaders) noexcept
 {
-    parser_impl parser{};
-    XAML_RETURN_IF_FAILED(parser.init());
-    XAML_RETURN_IF_FAILED(parser.load_stream(stream));
-    return xaml_parse_parse_impl(parser, ctx, ptr, pheaders);
+    return cfile_istream_invoke<char>([=](istream& stream) noexcept -> xaml_result { return xaml_parser_parse_stream(ctx, stream, ptr, pheaders); }, stream);
 }
 
+// The stream is read in chunks while parsing,
+// instead of being read into memory at once.
 xaml_result XAML_CALL xaml_parser_parse_stream(xaml_meta_context* ctx, istream& stream, xaml_node** ptr, xaml_vector_view<xaml_string>** pheaders) noexcept
 {
-    parser_impl parser{};
-    XAML_RETURN_IF_FAILED(parser.init());
-    XAML_RETURN_IF_FAILED(parser.load_stream(stream));
-    return xaml_parse_parse_impl(parser, ctx, ptr, pheaders);
+    return xaml_parser_parse_impl(
+        ctx, [&stream](xml_reader& reader) { reader.feed(stream); }, ptr, pheaders);
 }
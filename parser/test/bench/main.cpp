@@ -0,0 +1,125 @@
+#include <chrono>
+#include <iostream>
+#include <test_check.hpp>
+#include <xaml/meta/meta_context.h>
+#include <xaml/parser/deserializer.h>
+#include <xaml/parser/parser.h>
+#include <xaml/ui/application.h>
+#include <xaml/ui/container.h>
+
+using namespace std;
+
+// Creates a form many times, by deserializing the parsed nodes each time,
+// and by instantiating a template prepared once.
+// Checks the two ways create the same tree.
+
+static constexpr char const form[] = R"(<grid xmlns="https://github.com/Berrysoft/XamlCpp/"
+      xmlns:x="https://github.com/Berrysoft/XamlCpp/xaml/"
+      margin="10" columns="1*, 1*, 0.8*" rows="auto, auto, 0.5*, 0.8*">
+  <label margin="10" text_halignment="right" valignment="center">Username:</label>
+  <entry grid.column="1" margin="0, 5" valignment="center">John</entry>
+  <label grid.row="1" margin="10" text_halignment="right" valignment="center">Password:</label>
+  <password_entry grid.column="1" grid.row="1" margin="0, 5" valignment="center">123456</password_entry>
+  <stack_panel grid.column="2" grid.row="0" grid.row_span="3" margin="5" orientation="vertical">
+    <radio_box margin="5, 0" group="a">Radio 1</radio_box>
+    <radio_box margin="5, 0" group="a" is_checked="true">Radio 2</radio_box>
+    <radio_box margin="5, 0" group="a">Radio 3</radio_box>
+    <radio_box margin="5, 0" group="b" is_checked="true">Radio 4 in group b</radio_box>
+    <radio_box margin="5, 0" group="b">Radio 5 in group b</radio_box>
+  </stack_panel>
+  <label x:name="mylabel" grid.column="0" grid.row="2" margin="5, 0" text_halignment="center" valignment="center">Label</label>
+  <uniform_grid grid.column="1" grid.row="3" margin="5" valignment="top">
+    <check_box margin="5">Check 1</check_box>
+    <check_box margin="5">Check 2</check_box>
+    <check_box margin="5">Check 3</check_box>
+    <check_box margin="5">Check 4</check_box>
+    <check_box margin="5">Check 5</check_box>
+  </uniform_grid>
+</grid>)";
+
+static constexpr int rounds = 1000;
+
+// Counts the controls in the tree.
+static int32_t count_controls(xaml_object* obj) noexcept
+{
+    int32_t count = 1;
+    xaml_ptr<xaml_multicontainer> mc;
+    if (XAML_SUCCEEDED(obj->query(&mc)))
+    {
+        xaml_ptr<xaml_vector_view<xaml_control>> children;
+        XAML_ASSERT_SUCCEEDED(mc->get_children(&children));
+        for (auto c : children)
+        {
+            count += count_controls(c);
+        }
+    }
+    return count;
+}
+
+static xaml_result bench_deserialize(xaml_meta_context* ctx, xaml_string* str, xaml_object** ptr) noexcept
+{
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++)
+    {
+        xaml_ptr<xaml_node> node;
+        xaml_ptr<xaml_vector_view<xaml_string>> headers;
+        XAML_RETURN_IF_FAILED(xaml_parser_parse_string(ctx, str, &node, &headers));
+        XAML_RETURN_IF_FAILED(xaml_parser_deserialize(ctx, node, ptr));
+        if (i + 1 < rounds) (*ptr)->release();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "parse and deserialize: " << seconds / rounds * 1e6 << " us/form" << endl;
+    return XAML_S_OK;
+}
+
+static xaml_result bench_prepared(xaml_meta_context* ctx, xaml_string* str, xaml_object** ptr) noexcept
+{
+    auto start = chrono::steady_clock::now();
+    xaml_ptr<xaml_node> node;
+    xaml_ptr<xaml_vector_view<xaml_string>> headers;
+    XAML_RETURN_IF_FAILED(xaml_parser_parse_string(ctx, str, &node, &headers));
+    xaml_ptr<xaml_prepared_template> t;
+    XAML_RETURN_IF_FAILED(xaml_parser_prepare(ctx, node, &t));
+    double prepare_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++)
+    {
+        XAML_RETURN_IF_FAILED(t->instantiate(ptr));
+        if (i + 1 < rounds) (*ptr)->release();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "prepare: " << prepare_seconds * 1e6 << " us, instantiate: " << seconds / rounds * 1e6 << " us/form" << endl;
+    return XAML_S_OK;
+}
+
+int main()
+{
+    xaml_ptr<xaml_application> app;
+    XAML_ASSERT_SUCCEEDED(xaml_application_init(&app));
+    xaml_ptr<xaml_meta_context> ctx;
+    XAML_ASSERT_SUCCEEDED(xaml_meta_context_new(&ctx));
+    XAML_ASSERT_SUCCEEDED(ctx->add_module_recursive(U("xaml_ui_controls")));
+    xaml_ptr<xaml_string> str;
+    XAML_ASSERT_SUCCEEDED(xaml_string_new_view(form, &str));
+
+    xaml_ptr<xaml_object> deserialized, instantiated;
+    XAML_ASSERT_SUCCEEDED(bench_deserialize(ctx, str, &deserialized));
+    XAML_ASSERT_SUCCEEDED(bench_prepared(ctx, str, &instantiated));
+    CHECK(count_controls(deserialized) == 18);
+    CHECK(count_controls(instantiated) == count_controls(deserialized));
+
+    // A template prepared for a type could also fill an existing object.
+    xaml_ptr<xaml_node> node;
+    xaml_ptr<xaml_vector_view<xaml_string>> headers;
+    XAML_ASSERT_SUCCEEDED(xaml_parser_parse_string(ctx, str, &node, &headers));
+    xaml_ptr<xaml_prepared_template> t;
+    XAML_ASSERT_SUCCEEDED(xaml_parser_prepare(ctx, node, &t));
+    xaml_ptr<xaml_type_info> type;
+    XAML_ASSERT_SUCCEEDED(node->get_type(&type));
+    xaml_ptr<xaml_object> inplace;
+    XAML_ASSERT_SUCCEEDED(type->construct(&inplace));
+    CHECK(XAML_SUCCEEDED(t->instantiate_inplace(inplace)));
+    CHECK(count_controls(inplace) == count_controls(deserialized));
+
+    return report_failures();
+}
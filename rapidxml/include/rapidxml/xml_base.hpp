@@ -65,7 +65,7 @@ namespace rapidxml
 
         constexpr std::size_t row() const noexcept { return m_row; }
 
-        constexpr std::size_t col() const noexcept { return m_row; }
+        constexpr std::size_t col() const noexcept { return m_col; }
     };
 
     //! Enumeration listing all node types produced by the parser.
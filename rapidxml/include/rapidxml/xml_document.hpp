@@ -132,9 +132,26 @@ namespace rapidxml
     constexpr parse_flag& operator^=(parse_flag& lhs, parse_flag rhs) { return lhs = lhs ^ rhs; }
     constexpr parse_flag operator~(parse_flag f) { return (parse_flag)(~(int)f); }
 
+    //! Instruction sets used to scan the source text.
+    enum class scan_isa
+    {
+        scalar,
+        sse2,
+        avx2
+    };
+
+    //! Gets the instruction set used by the parser.
+    //! It is detected at startup; the best supported one is selected.
+    RAPIDXML_API scan_isa get_scan_isa() noexcept;
+
+    //! Sets the instruction set used by the parser, mainly for testing and benchmarking.
+    //! If the requested one is not supported, the best supported one below it is used.
+    //! \return The instruction set actually selected.
+    RAPIDXML_API scan_isa set_scan_isa(scan_isa isa) noexcept;
+
     //! This class represents root of the DOM hierarchy.
     //! It is also an xml_node and a memory_pool through public inheritance.
-    //! Use parse() function to build a DOM tree from a zero-terminated XML text string.
+    //! Use parse() function to build a DOM tree from an XML text string.
     //! parse() function allocates memory for nodes and attributes by using functions of xml_document,
     //! which are inherited from memory_pool.
     //! To access root node of the document, use the document itself, as if it was an xml_node.
@@ -167,20 +184,29 @@ namespace rapidxml
         }
 
         RAPIDXML_API void load_string(std::string_view str, parse_flag flags = parse_flag::default_flag);
+
+        //! Parses the text in place, without copying it.
+        //! The text is never modified, so it may be read-only memory, e.g. a mapped file.
+        //! Names and values point into the text, except the ones with character references
+        //! or normalized whitespace, which are expanded into the memory pool of the document.
+        //! The text must persist for the lifetime of the document.
+        //! It needs no terminating zero; nothing beyond str is read.
+        RAPIDXML_API void load_view(std::string_view str, parse_flag flags = parse_flag::default_flag);
+
         RAPIDXML_API void load_stream(std::istream& stream, parse_flag flags = parse_flag::default_flag);
 
     private:
-        //! Parses zero-terminated XML string according to given flags.
+        //! Parses XML string according to given flags.
         //! The string must persist for the lifetime of the document.
         //! In case of error, rapidxml::parse_error exception will be thrown.
         //! <br><br>
         //! If you want to parse contents of a file, you must first load the file into the memory, and pass pointer to its beginning.
-        //! Make sure that data is zero-terminated.
-        //! <br><br>
         //! Document can be parsed into multiple times.
         //! Each new call to parse removes previous nodes and attributes (if any), but does not clear memory pool.
         //! \param text XML data to parse; pointer is non-const to denote fact that this data may be modified by the parser.
-        RAPIDXML_API void parse(char* text, parse_flag flags);
+        //! \param length Length of the text; nothing beyond it is read.
+        //! \param arena If not null, the text is not modified, and the expanded values are allocated from it.
+        RAPIDXML_API void parse(char* text, std::size_t length, parse_flag flags, pmr::memory_resource* arena);
     };
 } // namespace rapidxml
 
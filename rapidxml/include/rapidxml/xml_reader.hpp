@@ -0,0 +1,153 @@
+#ifndef RAPID_XML_READER_HPP
+#define RAPID_XML_READER_HPP
+
+#include <deque>
+#include <iosfwd>
+#include <rapidxml/xml_attribute.hpp>
+#include <rapidxml/xml_document.hpp>
+#include <string>
+#include <vector>
+
+namespace rapidxml
+{
+    //! Enumeration listing all event types produced by xml_reader.
+    enum class xml_event_type
+    {
+        none, //!< No event. Name and value are empty.
+        start_element, //!< An element starts. Name and namespace URI are those of the element.
+        attribute, //!< An attribute of the last started element. Name, value and namespace URI are those of the attribute.
+        text, //!< A data or CDATA section. Value contains the text.
+        end_element //!< An element ends. Name and namespace URI are those of the element.
+    };
+
+    //! Class representing an event produced by xml_reader.
+    //! The name and the value point into the internal buffer of the reader,
+    //! thus they are only valid until the next call to xml_reader::next() or xml_reader::feed().
+    //! The namespace URI of an element stays valid until the element ends.
+    class xml_event : public xml_base
+    {
+    private:
+        xml_event_type m_type{ xml_event_type::none };
+
+    public:
+        constexpr xml_event() noexcept : xml_base() {}
+        constexpr xml_event(xml_event&& e) noexcept : xml_base(std::move(e)), m_type(e.m_type) {}
+        constexpr xml_event& operator=(xml_event&& e) noexcept
+        {
+            xml_base::operator=(std::move(e));
+            m_type = e.m_type;
+            return *this;
+        }
+
+        ~xml_event() override {}
+
+        constexpr xml_event_type type() const noexcept { return m_type; }
+
+        void type(xml_event_type type) noexcept { m_type = type; }
+    };
+
+    //! A streaming XML reader, using the same tokenizer as xml_document.
+    //! The input is fed in chunks by feed(), and the events are pulled by next().
+    //! Only the unconsumed input and the open elements are kept,
+    //! so the memory used is bounded by the largest token and the depth of the document,
+    //! rather than the size of the whole document.
+    //! <br><br>
+    //! Declarations, comments, DOCTYPE and PI are skipped;
+    //! the flags controlling their creation are ignored.
+    class xml_reader
+    {
+    private:
+        struct xml_namespace_binding
+        {
+            std::string prefix;
+            std::string uri;
+        };
+
+        struct xml_open_element
+        {
+            std::string name;
+            std::size_t local_name;
+            std::string_view namespace_uri;
+            std::size_t bindings;
+        };
+
+        parse_flag m_flags;
+
+        std::string m_buffer{};
+        // The whole input borrowed by load_view(), used instead of m_buffer.
+        std::string_view m_view{};
+        bool m_borrowed{ false };
+        // Values expanded from the borrowed input; released on each token.
+        char m_scratch_buffer[1024];
+        pmr::monotonic_buffer_resource m_scratch{ m_scratch_buffer, sizeof(m_scratch_buffer) };
+        std::size_t m_position{ 0 };
+        // Data before it contains no '<'; used when the data is split into chunks.
+        std::size_t m_scanned{ 0 };
+        bool m_finished{ false };
+        bool m_bom_checked{ false };
+
+        // Offset, row and column of the start of m_buffer in the whole input.
+        std::size_t m_offset{ 0 };
+        std::size_t m_row{ 0 };
+        std::size_t m_col{ 0 };
+
+        std::vector<xml_attribute> m_attributes{};
+        std::size_t m_next_attribute{ 0 };
+        bool m_end_pending{ false };
+        bool m_pop_pending{ false };
+
+        std::vector<xml_open_element> m_elements{};
+        std::deque<xml_namespace_binding> m_bindings{};
+
+    public:
+        RAPIDXML_API xml_reader(parse_flag flags = parse_flag::default_flag);
+
+        //! Appends a chunk of input.
+        //! Events got before are invalidated.
+        RAPIDXML_API void feed(std::string_view chunk);
+
+        //! Reads a chunk from the stream and appends it.
+        //! finish() is called when the end of the stream is reached.
+        //! \return true if there may be more input to read.
+        RAPIDXML_API bool feed(std::istream& stream, std::size_t chunk_size = 64 * 1024);
+
+        //! Uses the whole input without copying it, and marks the end of the input.
+        //! The text is never modified, and it needn't be zero-terminated.
+        //! It must persist until all events are pulled.
+        //! Names and values point into the text, except the ones with character references
+        //! or normalized whitespace, which are expanded into a scratch buffer.
+        RAPIDXML_API void load_view(std::string_view text);
+
+        //! Marks the end of the input.
+        RAPIDXML_API void finish() noexcept;
+
+        //! Gets whether the end of the input has been marked.
+        constexpr bool finished() const noexcept { return m_finished; }
+
+        //! Gets the count of open elements.
+        std::size_t depth() const noexcept { return m_elements.size(); }
+
+        //! Pulls the next event.
+        //! In case of error, rapidxml::parse_error exception will be thrown.
+        //! \return false if more input is needed, or all input has been consumed.
+        RAPIDXML_API bool next(xml_event& e);
+
+    private:
+        // The parser never writes the borrowed input.
+        char* data() const noexcept { return const_cast<char*>(m_borrowed ? m_view.data() : m_buffer.data()); }
+        std::size_t size() const noexcept { return m_borrowed ? m_view.size() : m_buffer.size(); }
+        void compact();
+        bool next_token(xml_event& e);
+        static std::size_t find_start_tag_end(std::string_view token) noexcept;
+        static std::size_t find_declaration_end(std::string_view token, bool doctype) noexcept;
+        void start_tag(xml_event& e, std::size_t end);
+        void end_tag(xml_event& e, std::size_t end);
+        void end_element(xml_event& e) noexcept;
+        void process_namespaces(xml_open_element& element, std::string_view prefix, std::size_t position);
+        std::string_view find_namespace_uri(std::string_view prefix, bool required, std::size_t position) const;
+        void pop_element() noexcept;
+        [[noreturn]] void throw_error(char const* message, std::size_t position) const;
+    };
+} // namespace rapidxml
+
+#endif // !RAPID_XML_READER_HPP
@@ -3,6 +3,7 @@
 #include <rapidxml/xml_document.hpp>
 #include <sstream>
 #include <vector>
+#include <xml_parse.hpp>
 
 using namespace std;
 
@@ -125,374 +126,28 @@ namespace rapidxml
     void xml_document::load_string(string_view str, parse_flag flags)
     {
         m_buffer.assign(str.begin(), str.end());
-        parse(m_buffer.data(), flags);
+        parse(m_buffer.data(), m_buffer.size(), flags, nullptr);
     }
 
-    void xml_document::load_stream(istream& stream, parse_flag flags)
+    void xml_document::load_view(string_view str, parse_flag flags)
     {
-        m_buffer.assign(istreambuf_iterator<char>(stream), istreambuf_iterator<char>{});
-        parse(m_buffer.data(), flags);
+        m_buffer.clear();
+        // The text is never written in this mode.
+        parse(const_cast<char*>(str.data()), str.size(), flags, &m_pool);
     }
 
-    ///////////////////////////////////////////////////////////////////////
-    // Internal character utility functions
-
-    // Detect whitespace character
-    struct whitespace_pred
-    {
-        static constexpr bool test(char ch) noexcept
-        {
-            return ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t';
-        }
-    };
-
-    // Detect node name character
-    struct node_name_pred
-    {
-        static constexpr bool test(char ch) noexcept
-        {
-            return ch && !whitespace_pred::test(ch) && ch != '/' && ch != '>' && ch != '?';
-        }
-    };
-
-    // Detect node name character without ':' (NCName) - namespace prefix or local name
-    struct node_ncname_pred
-    {
-        static constexpr bool test(char ch) noexcept
-        {
-            return node_name_pred::test(ch) && ch != ':';
-        }
-    };
-
-    // Detect attribute name character
-    struct attribute_name_pred
-    {
-        static constexpr bool test(char ch) noexcept
-        {
-            return node_name_pred::test(ch) && ch != '<' && ch != '!' && ch != '=';
-        }
-    };
-
-    // Detect attribute name character without ':' (NCName) - namespace prefix or local name
-    struct attribute_ncname_pred
-    {
-        static constexpr bool test(char ch) noexcept
-        {
-            return attribute_name_pred::test(ch) && ch != ':';
-        }
-    };
-
-    // Detectbuffercharacter (PCDATA)
-    struct text_pred
-    {
-        static constexpr bool test(char ch) noexcept
-        {
-            return ch && ch != '<';
-        }
-    };
-
-    // Detectbuffercharacter (PCDATA) that does not require processing
-    struct text_pure_no_ws_pred
-    {
-        static constexpr bool test(char ch) noexcept
-        {
-            return text_pred::test(ch) && ch != '&';
-        }
-    };
-
-    // Detectbuffercharacter (PCDATA) that does not require processing
-    struct text_pure_with_ws_pred
-    {
-        static constexpr bool test(char ch) noexcept
-        {
-            return text_pure_no_ws_pred::test(ch) && whitespace_pred::test(ch);
-        }
-    };
-
-    // Detect attribute value character
-    template <char Quote>
-    struct attribute_value_pred
-    {
-        static_assert(Quote == '\"' || Quote == '\'');
-
-        static constexpr bool test(char ch) noexcept
-        {
-            return ch && ch != Quote;
-        }
-    };
-
-    // Detect attribute value character
-    template <char Quote>
-    struct attribute_value_pure_pred
-    {
-        static_assert(Quote == '\"' || Quote == '\'');
-
-        static constexpr bool test(char ch) noexcept
-        {
-            return attribute_value_pred<Quote>::test(ch) && ch != '&';
-        }
-    };
-
-    struct parse_buffer
-    {
-        char* const begin;
-        char* current;
-
-        constexpr char& operator[](intptr_t index) noexcept { return current[index]; }
-        constexpr char const& operator[](intptr_t index) const noexcept { return current[index]; }
-
-        constexpr parse_buffer& operator++()
-        {
-            current++;
-            return *this;
-        }
-
-        constexpr parse_buffer operator++(int)
-        {
-            parse_buffer result = *this;
-            operator++();
-            return result;
-        }
-
-        constexpr parse_buffer& operator+=(intptr_t offset)
-        {
-            current += offset;
-            return *this;
-        }
-
-        constexpr operator size_t() const noexcept { return current - begin; }
-
-        constexpr tuple<size_t, size_t> get_row_col() const noexcept
-        {
-            size_t row = 0, col = current - begin;
-            size_t line = 0;
-            char* tmp = begin;
-            while (tmp < current)
-            {
-                line++;
-                if (*tmp == '\n')
-                {
-                    row++;
-                    col -= line;
-                    line = 0;
-                }
-            }
-            return make_tuple(row, col);
-        }
-
-        parse_error construct_error(char const* message) const noexcept
-        {
-            auto [row, col] = get_row_col();
-            return parse_error(message, current - begin, col, row);
-        }
-    };
-
-    // Skip characters until predicate evaluates to true
-    template <class StopPred>
-    static constexpr void skip(parse_buffer& buffer) noexcept
-    {
-        char* tmp = buffer.current;
-        while (StopPred::test(*tmp))
-            ++tmp;
-        buffer.current = tmp;
-    }
-
-    // Insert coded character, using UTF8
-    static constexpr void insert_coded_character(parse_buffer& buffer, int32_t code)
-    {
-        // Insert UTF8 sequence
-        if (code < 0x80) // 1 byte sequence
-        {
-            buffer[0] = static_cast<char>(code);
-            buffer += 1;
-        }
-        else if (code < 0x800) // 2 byte sequence
-        {
-            buffer[1] = static_cast<char>((code | 0x80) & 0xBF);
-            code >>= 6;
-            buffer[0] = static_cast<char>(code | 0xC0);
-            buffer += 2;
-        }
-        else if (code < 0x10000) // 3 byte sequence
-        {
-            buffer[2] = static_cast<char>((code | 0x80) & 0xBF);
-            code >>= 6;
-            buffer[1] = static_cast<char>((code | 0x80) & 0xBF);
-            code >>= 6;
-            buffer[0] = static_cast<char>(code | 0xE0);
-            buffer += 3;
-        }
-        else if (code < 0x110000) // 4 byte sequence
-        {
-            buffer[3] = static_cast<char>((code | 0x80) & 0xBF);
-            code >>= 6;
-            buffer[2] = static_cast<char>((code | 0x80) & 0xBF);
-            code >>= 6;
-            buffer[1] = static_cast<char>((code | 0x80) & 0xBF);
-            code >>= 6;
-            buffer[0] = static_cast<char>(code | 0xF0);
-            buffer += 4;
-        }
-        else // Invalid, only codes up to 0x10FFFF are allowed in Unicode
-        {
-            throw buffer.construct_error("invalid numeric character entity");
-        }
-    }
-
-    // Skip characters until predicate evaluates to true while doing the following:
-    // - replacing XML character entity references with proper characters (&apos; &amp; &quot; &lt; &gt; &#...;)
-    // - condensing whitespace sequences to single space character
-    template <class StopPred, class StopPredPure>
-    static char* skip_and_expand_character_refs(parse_buffer& buffer, parse_flag flags)
+    void xml_document::load_stream(istream& stream, parse_flag flags)
     {
-        // Use simple skip until first modification is detected
-        skip<StopPredPure>(buffer);
-
-        // Use translation skip
-        parse_buffer src = buffer;
-        parse_buffer dest = src;
-        while (StopPred::test(src[0]))
-        {
-            // Test if replacement is needed
-            if (src[0] == '&')
-            {
-                switch (src[1])
-                {
-
-                // &amp; &apos;
-                case 'a':
-                    if (src[2] == 'm' && src[3] == 'p' && src[4] == ';')
-                    {
-                        dest[0] = '&';
-                        ++dest;
-                        src += 5;
-                        continue;
-                    }
-                    if (src[2] == 'p' && src[3] == 'o' && src[4] == 's' && src[5] == ';')
-                    {
-                        dest[0] = '\'';
-                        ++dest;
-                        src += 6;
-                        continue;
-                    }
-                    break;
-
-                // &quot;
-                case 'q':
-                    if (src[2] == 'u' && src[3] == 'o' && src[4] == 't' && src[5] == ';')
-                    {
-                        dest[0] = '"';
-                        ++dest;
-                        src += 6;
-                        continue;
-                    }
-                    break;
-
-                // &gt;
-                case 'g':
-                    if (src[2] == 't' && src[3] == ';')
-                    {
-                        dest[0] = '>';
-                        ++dest;
-                        src += 4;
-                        continue;
-                    }
-                    break;
-
-                // &lt;
-                case 'l':
-                    if (src[2] == 't' && src[3] == ';')
-                    {
-                        dest[0] = '<';
-                        ++dest;
-                        src += 4;
-                        continue;
-                    }
-                    break;
-
-                // &#...; - assumes ASCII
-                case '#':
-                    if (src[2] == 'x')
-                    {
-                        int32_t code = 0;
-                        src += 3; // Skip &#x
-                        while (1)
-                        {
-                            if (!isxdigit(src[0]))
-                                break;
-                            int32_t digit = isdigit(src[0]) ? ((src[0]) - '0') : (isupper(src[0]) ? ((src[0]) - 'A' + 10) : ((src[0]) - 'a' + 10));
-                            code = code * 16 + digit;
-                            ++src;
-                        }
-                        insert_coded_character(dest, code); // Put character in output
-                    }
-                    else
-                    {
-                        int32_t code = 0;
-                        src += 2; // Skip &#
-                        while (1)
-                        {
-                            if (!isdigit(src[0]))
-                                break;
-                            int32_t digit = ((src[0]) - '0');
-                            code = code * 10 + digit;
-                            ++src;
-                        }
-                        insert_coded_character(dest, code); // Put character in output
-                    }
-                    if (src[0] == ';')
-                        ++src;
-                    else
-                        throw src.construct_error("expected ;");
-                    continue;
-
-                // Something else
-                default:
-                    // Ignore, just copy '&' verbatim
-                    break;
-                }
-            }
-
-            // If whitespace condensing is enabled
-            if ((int)(flags & parse_flag::normalize_whitespace))
-            {
-                // Test if condensing is needed
-                if (whitespace_pred::test(src[0]))
-                {
-                    dest[0] = ' ';
-                    ++dest; // Put single space in dest
-                    ++src; // Skip first whitespace char
-                    // Skip remaining whitespace chars
-                    while (whitespace_pred::test(src[0]))
-                        ++src;
-                    continue;
-                }
-            }
-
-            // No replacement, only copy character
-            (dest++)[0] = (src++)[0];
-        }
-
-        // Return new end
-        buffer.current = src.current;
-        return dest.current;
+        m_buffer.assign(istreambuf_iterator<char>(stream), istreambuf_iterator<char>{});
+        parse(m_buffer.data(), m_buffer.size(), flags, nullptr);
     }
 
-    // Parse BOM, if any
-    static void parse_bom(parse_buffer& buffer)
-    {
-        // UTF-8?
-        if (static_cast<unsigned char>(buffer[0]) == 0xEF &&
-            static_cast<unsigned char>(buffer[1]) == 0xBB &&
-            static_cast<unsigned char>(buffer[2]) == 0xBF)
-        {
-            buffer += 3; // Skup utf-8 bom
-        }
-    }
 
     struct parse_context
     {
         parse_flag flags;
+        // Where the expanded values are stored; null to expand in place.
+        pmr::memory_resource* arena;
         pmr::polymorphic_allocator<xml_node> const& node_allocator;
         pmr::polymorphic_allocator<xml_attribute> const& attr_allocator;
     };
@@ -529,11 +184,11 @@ namespace rapidxml
     // Parse XML attributes of the node
     static void parse_node_attributes(parse_buffer& buffer, xml_node& node, parse_context const& context);
 
-    void xml_document::parse(char* text, parse_flag flags)
+    void xml_document::parse(char* text, size_t length, parse_flag flags, pmr::memory_resource* arena)
     {
         if (text)
         {
-            parse_buffer buffer{ text, text };
+            parse_buffer buffer{ text, text, text + length };
 
             xml_namespace_processor namespace_processor{ pmr::polymorphic_allocator<pmr::list<xml_attribute>::iterator>{ &m_pool } };
             // Creating topmost namespace scope that actually won't be used
@@ -554,7 +209,7 @@ namespace rapidxml
                 if (buffer[0] == '<')
                 {
                     ++buffer; // Skip '<'
-                    if (auto node = parse_node(buffer, namespace_scope, { flags, m_node_allocator, m_attribute_allocator }))
+                    if (auto node = parse_node(buffer, namespace_scope, { flags, arena, m_node_allocator, m_attribute_allocator }))
                         m_root_node.nodes().emplace_back(move(*node));
                 }
                 else
@@ -745,47 +400,21 @@ namespace rapidxml
 
     char parse_and_append_data(xml_node& node, parse_buffer& buffer, char* contents_start, parse_context const& context)
     {
-        // Backup to contents start if whitespace trimming is disabled
-        if (!(int)(context.flags & parse_flag::trim_whitespace))
-            buffer.current = contents_start;
-
-        // Skip until end of data
-        char *value = buffer.current, *end;
-        if ((int)(context.flags & parse_flag::normalize_whitespace))
-            end = skip_and_expand_character_refs<text_pred, text_pure_with_ws_pred>(buffer, context.flags);
-        else
-            end = skip_and_expand_character_refs<text_pred, text_pure_no_ws_pred>(buffer, context.flags);
-
-        // Trim trailing whitespace if flag is set; leading was already trimmed by whitespace skip after >
-        if ((int)(context.flags & parse_flag::trim_whitespace))
-        {
-            if ((int)(context.flags & parse_flag::normalize_whitespace))
-            {
-                // Whitespace is already condensed to single space characters by skipping function, so just trim 1 char off the end
-                if (*(end - 1) == ' ')
-                    --end;
-            }
-            else
-            {
-                // Backup until non-whitespace character is found
-                while (whitespace_pred::test(*(end - 1)))
-                    --end;
-            }
-        }
+        string_view value = parse_data(buffer, contents_start, context.flags, context.arena);
 
         // If characters are still left between end and value (this test is only necessary if normalization is enabled)
         // Create new data node
         if (!(int)(context.flags & parse_flag::no_data_nodes))
         {
             xml_node data{ node_type::data, context.node_allocator, context.attr_allocator };
-            data.value(string_view(value, end - value));
+            data.value(value);
             node.nodes().emplace_back(move(data));
         }
 
         // Add data to parent node if no data exists yet
         if (!(int)(context.flags & parse_flag::no_element_values))
             if (node.value().empty())
-                node.value(string_view(value, end - value));
+                node.value(value);
 
         // Return character that ends data
         return buffer[0];
@@ -830,24 +459,7 @@ namespace rapidxml
         xml_node element{ node_type::element, context.node_allocator, context.attr_allocator };
 
         // Extract element name
-        char* name = buffer.current;
-        skip<node_ncname_pred>(buffer);
-        if (buffer.current == name)
-            throw buffer.construct_error("expected element name");
-        if (buffer[0] == ':')
-        {
-            // Namespace prefix found
-            ++buffer;
-            char* local_name = buffer.current;
-            skip<node_ncname_pred>(buffer);
-            if (buffer[0] == ':')
-                throw buffer.construct_error("second colon in element name");
-            if (buffer.current == local_name)
-                throw buffer.construct_error("expected local part of element name");
-            element.qname(string_view(name, buffer.current - name), local_name - name);
-        }
-        else
-            element.qname(string_view(name, buffer.current - name));
+        parse_element_name(buffer, element);
 
         // Skip whitespace between element name and attributes or >
         skip<whitespace_pred>(buffer);
@@ -1031,67 +643,6 @@ namespace rapidxml
 
     void parse_node_attributes(parse_buffer& buffer, xml_node& node, parse_context const& context)
     {
-        // For all attributes
-        while (attribute_ncname_pred::test(buffer[0]))
-        {
-            // Extract attribute name
-            parse_buffer name = buffer;
-            ++buffer; // Skip first character of attribute name
-            skip<attribute_ncname_pred>(buffer);
-            if (buffer.current == name.current)
-                throw name.construct_error("expected attribute name");
-            // Create new attribute
-            xml_attribute attribute{};
-            if (buffer[0] == ':')
-            {
-                // Namespace prefix found
-                ++buffer;
-                parse_buffer local_name = buffer;
-                skip<attribute_ncname_pred>(buffer);
-                if (buffer.current == local_name.current)
-                    throw local_name.construct_error("expected local part of attribute name");
-                attribute.qname(string_view(name.current, buffer.current - name.current), local_name.current - name.current);
-            }
-            else
-                attribute.qname(string_view(name.current, buffer.current - name.current));
-
-            // Skip whitespace after attribute name
-            skip<whitespace_pred>(buffer);
-
-            // Skip =
-            if (buffer[0] != '=')
-                throw buffer.construct_error("expected =");
-            ++buffer;
-
-            // Skip whitespace after =
-            skip<whitespace_pred>(buffer);
-
-            // Skip quote and remember if it was ' or "
-            char quote = buffer[0];
-            if (quote != '\'' && quote != '"')
-                throw buffer.construct_error("expected ' or \"");
-            ++buffer;
-
-            // Extract attribute value and expand char refs in it
-            char *value = buffer.current, *end;
-            parse_flag AttFlags{ context.flags & ~parse_flag::normalize_whitespace }; // No whitespace normalization in attributes
-            if (quote == '\'')
-                end = skip_and_expand_character_refs<attribute_value_pred<'\''>, attribute_value_pure_pred<'\''>>(buffer, AttFlags);
-            else
-                end = skip_and_expand_character_refs<attribute_value_pred<'"'>, attribute_value_pure_pred<'"'>>(buffer, AttFlags);
-
-            // Set attribute value
-            attribute.value(string_view(value, end - value));
-
-            // Make sure that end quote is present
-            if (buffer[0] != quote)
-                throw buffer.construct_error("expected ' or \"");
-            ++buffer; // Skip quote
-
-            // Skip whitespace after attribute value
-            skip<whitespace_pred>(buffer);
-
-            node.attributes().emplace_back(move(attribute));
-        }
+        parse_attributes(buffer, context.flags, context.arena, [&node](xml_attribute&& attribute) { node.attributes().emplace_back(move(attribute)); });
     }
 } // namespace rapidxml
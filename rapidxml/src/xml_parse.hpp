@@ -0,0 +1,493 @@
+#ifndef RAPID_XML_PARSE_HPP
+#define RAPID_XML_PARSE_HPP
+
+#include <cctype>
+#include <cstring>
+#include <tuple>
+#include <xml_scan.hpp>
+
+namespace rapidxml
+{
+    ///////////////////////////////////////////////////////////////////////
+    // Internal character utility functions
+
+    // Detect whitespace character
+    struct whitespace_pred : char_set<false, ' ', '\n', '\r', '\t'>
+    {
+    };
+
+    // Detect node name character
+    struct node_name_pred : char_set<true, ' ', '\n', '\r', '\t', '/', '>', '?'>
+    {
+    };
+
+    // Detect node name character without ':' (NCName) - namespace prefix or local name
+    struct node_ncname_pred : char_set<true, ' ', '\n', '\r', '\t', '/', '>', '?', ':'>
+    {
+    };
+
+    // Detect attribute name character
+    struct attribute_name_pred : char_set<true, ' ', '\n', '\r', '\t', '/', '>', '?', '<', '!', '='>
+    {
+    };
+
+    // Detect attribute name character without ':' (NCName) - namespace prefix or local name
+    struct attribute_ncname_pred : char_set<true, ' ', '\n', '\r', '\t', '/', '>', '?', '<', '!', '=', ':'>
+    {
+    };
+
+    // Detect text character (PCDATA)
+    struct text_pred : char_set<true, '<'>
+    {
+    };
+
+    // Detect text character (PCDATA) that does not require processing, when whitespace is not normalized
+    struct text_pure_no_ws_pred : char_set<true, '<', '&'>
+    {
+    };
+
+    // Detect text character (PCDATA) that does not require processing, when whitespace is normalized
+    struct text_pure_with_ws_pred : char_set<true, '<', '&', ' ', '\n', '\r', '\t'>
+    {
+    };
+
+    // Detect attribute value character
+    template <char Quote>
+    struct attribute_value_pred : char_set<true, Quote>
+    {
+        static_assert(Quote == '\"' || Quote == '\'');
+    };
+
+    // Detect attribute value character that does not require processing
+    template <char Quote>
+    struct attribute_value_pure_pred : char_set<true, Quote, '&'>
+    {
+        static_assert(Quote == '\"' || Quote == '\'');
+    };
+
+    struct parse_buffer
+    {
+        char* const begin;
+        char* current;
+        char* const end;
+
+        // Reads zero beyond the end, which stops the parser like a terminating zero,
+        // so that the text needs none.
+        constexpr char operator[](std::intptr_t index) const noexcept { return current + index < end ? current[index] : '\0'; }
+
+        constexpr parse_buffer& operator++()
+        {
+            current++;
+            return *this;
+        }
+
+        constexpr parse_buffer operator++(int)
+        {
+            parse_buffer result = *this;
+            operator++();
+            return result;
+        }
+
+        constexpr parse_buffer& operator+=(std::intptr_t offset)
+        {
+            current += offset;
+            return *this;
+        }
+
+        constexpr operator std::size_t() const noexcept { return current - begin; }
+
+        constexpr std::tuple<std::size_t, std::size_t> get_row_col() const noexcept
+        {
+            std::size_t row = 0, col = current - begin;
+            std::size_t line = 0;
+            char* tmp = begin;
+            while (tmp < current)
+            {
+                line++;
+                if (*tmp == '\n')
+                {
+                    row++;
+                    col -= line;
+                    line = 0;
+                }
+                tmp++;
+            }
+            return std::make_tuple(row, col);
+        }
+
+        parse_error construct_error(char const* message) const noexcept
+        {
+            auto [row, col] = get_row_col();
+            return parse_error(message, current - begin, row, col);
+        }
+    };
+
+    // Skip characters until predicate evaluates to false
+    template <class StopPred>
+    inline void skip(parse_buffer& buffer) noexcept
+    {
+        buffer.current = char_set_scanner<typename StopPred::set_type>::scan(buffer.current, buffer.end);
+    }
+
+    // Insert coded character, using UTF8
+    // Only codes up to 0x10FFFF are allowed in Unicode, and the caller should check it.
+    constexpr void insert_coded_character(char*& dest, std::int32_t code) noexcept
+    {
+        // Insert UTF8 sequence
+        if (code < 0x80) // 1 byte sequence
+        {
+            dest[0] = static_cast<char>(code);
+            dest += 1;
+        }
+        else if (code < 0x800) // 2 byte sequence
+        {
+            dest[1] = static_cast<char>((code | 0x80) & 0xBF);
+            code >>= 6;
+            dest[0] = static_cast<char>(code | 0xC0);
+            dest += 2;
+        }
+        else if (code < 0x10000) // 3 byte sequence
+        {
+            dest[2] = static_cast<char>((code | 0x80) & 0xBF);
+            code >>= 6;
+            dest[1] = static_cast<char>((code | 0x80) & 0xBF);
+            code >>= 6;
+            dest[0] = static_cast<char>(code | 0xE0);
+            dest += 3;
+        }
+        else // 4 byte sequence
+        {
+            dest[3] = static_cast<char>((code | 0x80) & 0xBF);
+            code >>= 6;
+            dest[2] = static_cast<char>((code | 0x80) & 0xBF);
+            code >>= 6;
+            dest[1] = static_cast<char>((code | 0x80) & 0xBF);
+            code >>= 6;
+            dest[0] = static_cast<char>(code | 0xF0);
+            dest += 4;
+        }
+    }
+
+    // Skip characters until predicate evaluates to true while doing the following:
+    // - replacing XML character entity references with proper characters (&apos; &amp; &quot; &lt; &gt; &#...;)
+    // - condensing whitespace sequences to single space character
+    // The result is written to dest, which may be the source itself, as the result is never longer.
+    // Return the end of the result.
+    template <class StopPred, class StopPredPure>
+    char* expand_character_refs(parse_buffer& buffer, char* dest, parse_flag flags)
+    {
+        parse_buffer src = buffer;
+        while (StopPred::test(src[0]))
+        {
+            // Move the run which needs no processing at once
+            char* run_end = char_set_scanner<typename StopPredPure::set_type>::scan(src.current, src.end);
+            if (run_end != src.current)
+            {
+                std::size_t run_length = run_end - src.current;
+                std::memmove(dest, src.current, run_length);
+                dest += run_length;
+                src += run_length;
+                continue;
+            }
+
+            // Test if replacement is needed
+            if (src[0] == '&')
+            {
+                switch (src[1])
+                {
+
+                // &amp; &apos;
+                case 'a':
+                    if (src[2] == 'm' && src[3] == 'p' && src[4] == ';')
+                    {
+                        dest[0] = '&';
+                        ++dest;
+                        src += 5;
+                        continue;
+                    }
+                    if (src[2] == 'p' && src[3] == 'o' && src[4] == 's' && src[5] == ';')
+                    {
+                        dest[0] = '\'';
+                        ++dest;
+                        src += 6;
+                        continue;
+                    }
+                    break;
+
+                // &quot;
+                case 'q':
+                    if (src[2] == 'u' && src[3] == 'o' && src[4] == 't' && src[5] == ';')
+                    {
+                        dest[0] = '"';
+                        ++dest;
+                        src += 6;
+                        continue;
+                    }
+                    break;
+
+                // &gt;
+                case 'g':
+                    if (src[2] == 't' && src[3] == ';')
+                    {
+                        dest[0] = '>';
+                        ++dest;
+                        src += 4;
+                        continue;
+                    }
+                    break;
+
+                // &lt;
+                case 'l':
+                    if (src[2] == 't' && src[3] == ';')
+                    {
+                        dest[0] = '<';
+                        ++dest;
+                        src += 4;
+                        continue;
+                    }
+                    break;
+
+                // &#...; - assumes ASCII
+                case '#':
+                    if (src[2] == 'x')
+                    {
+                        std::int32_t code = 0;
+                        src += 3; // Skip &#x
+                        while (1)
+                        {
+                            if (!std::isxdigit(src[0]))
+                                break;
+                            std::int32_t digit = std::isdigit(src[0]) ? ((src[0]) - '0') : (std::isupper(src[0]) ? ((src[0]) - 'A' + 10) : ((src[0]) - 'a' + 10));
+                            code = code * 16 + digit;
+                            ++src;
+                        }
+                        if (code >= 0x110000)
+                            throw src.construct_error("invalid numeric character entity");
+                        insert_coded_character(dest, code); // Put character in output
+                    }
+                    else
+                    {
+                        std::int32_t code = 0;
+                        src += 2; // Skip &#
+                        while (1)
+                        {
+                            if (!std::isdigit(src[0]))
+                                break;
+                            std::int32_t digit = ((src[0]) - '0');
+                            code = code * 10 + digit;
+                            ++src;
+                        }
+                        if (code >= 0x110000)
+                            throw src.construct_error("invalid numeric character entity");
+                        insert_coded_character(dest, code); // Put character in output
+                    }
+                    if (src[0] == ';')
+                        ++src;
+                    else
+                        throw src.construct_error("expected ;");
+                    continue;
+
+                // Something else
+                default:
+                    // Ignore, just copy '&' verbatim
+                    break;
+                }
+            }
+
+            // If whitespace condensing is enabled
+            if ((int)(flags & parse_flag::normalize_whitespace))
+            {
+                // Test if condensing is needed
+                if (whitespace_pred::test(src[0]))
+                {
+                    dest[0] = ' ';
+                    ++dest; // Put single space in dest
+                    ++src; // Skip first whitespace char
+                    // Skip remaining whitespace chars
+                    while (whitespace_pred::test(src[0]))
+                        ++src;
+                    continue;
+                }
+            }
+
+            // No replacement, only copy character
+            (dest++)[0] = (src++)[0];
+        }
+
+        // Return new end
+        buffer.current = src.current;
+        return dest;
+    }
+
+    // Skip a value until predicate evaluates to true, and expand the character references in it.
+    // If arena is null, the value is expanded in place.
+    // Otherwise the source is never modified: a value which needs no processing
+    // is returned as a view into the source, and only the others are copied into the arena.
+    template <class StopPred, class StopPredPure>
+    std::string_view skip_and_expand_character_refs(parse_buffer& buffer, parse_flag flags, pmr::memory_resource* arena)
+    {
+        // Use simple skip until first modification is detected
+        char* value = buffer.current;
+        skip<StopPredPure>(buffer);
+        if (!StopPred::test(buffer[0]))
+            return std::string_view(value, buffer.current - value);
+
+        // Use translation skip
+        char* dest;
+        char* result;
+        if (arena)
+        {
+            // The result is never longer than the source.
+            char* end = char_set_scanner<typename StopPred::set_type>::scan(buffer.current, buffer.end);
+            result = static_cast<char*>(arena->allocate(end - value, 1));
+            std::size_t pure_length = buffer.current - value;
+            std::memcpy(result, value, pure_length);
+            dest = result + pure_length;
+        }
+        else
+        {
+            result = value;
+            dest = buffer.current;
+        }
+        dest = expand_character_refs<StopPred, StopPredPure>(buffer, dest, flags);
+        return std::string_view(result, dest - result);
+    }
+
+    // Parse BOM, if any
+    inline void parse_bom(parse_buffer& buffer)
+    {
+        // UTF-8?
+        if (static_cast<unsigned char>(buffer[0]) == 0xEF &&
+            static_cast<unsigned char>(buffer[1]) == 0xBB &&
+            static_cast<unsigned char>(buffer[2]) == 0xBF)
+        {
+            buffer += 3; // Skup utf-8 bom
+        }
+    }
+    // Parse element QName into the node
+    inline void parse_element_name(parse_buffer& buffer, xml_base& element)
+    {
+        char* name = buffer.current;
+        skip<node_ncname_pred>(buffer);
+        if (buffer.current == name)
+            throw buffer.construct_error("expected element name");
+        if (buffer[0] == ':')
+        {
+            // Namespace prefix found
+            ++buffer;
+            char* local_name = buffer.current;
+            skip<node_ncname_pred>(buffer);
+            if (buffer[0] == ':')
+                throw buffer.construct_error("second colon in element name");
+            if (buffer.current == local_name)
+                throw buffer.construct_error("expected local part of element name");
+            element.qname(std::string_view(name, buffer.current - name), local_name - name);
+        }
+        else
+            element.qname(std::string_view(name, buffer.current - name));
+    }
+
+    // Parse XML attributes, and pass each of them to the callback
+    template <typename F>
+    void parse_attributes(parse_buffer& buffer, parse_flag flags, pmr::memory_resource* arena, F&& append)
+    {
+        // For all attributes
+        while (attribute_ncname_pred::test(buffer[0]))
+        {
+            // Extract attribute name
+            parse_buffer name = buffer;
+            ++buffer; // Skip first character of attribute name
+            skip<attribute_ncname_pred>(buffer);
+            if (buffer.current == name.current)
+                throw name.construct_error("expected attribute name");
+            // Create new attribute
+            xml_attribute attribute{};
+            if (buffer[0] == ':')
+            {
+                // Namespace prefix found
+                ++buffer;
+                parse_buffer local_name = buffer;
+                skip<attribute_ncname_pred>(buffer);
+                if (buffer.current == local_name.current)
+                    throw local_name.construct_error("expected local part of attribute name");
+                attribute.qname(std::string_view(name.current, buffer.current - name.current), local_name.current - name.current);
+            }
+            else
+                attribute.qname(std::string_view(name.current, buffer.current - name.current));
+
+            // Skip whitespace after attribute name
+            skip<whitespace_pred>(buffer);
+
+            // Skip =
+            if (buffer[0] != '=')
+                throw buffer.construct_error("expected =");
+            ++buffer;
+
+            // Skip whitespace after =
+            skip<whitespace_pred>(buffer);
+
+            // Skip quote and remember if it was ' or "
+            char quote = buffer[0];
+            if (quote != '\'' && quote != '"')
+                throw buffer.construct_error("expected ' or \"");
+            ++buffer;
+
+            // Extract attribute value and expand char refs in it
+            std::string_view value;
+            parse_flag AttFlags{ flags & ~parse_flag::normalize_whitespace }; // No whitespace normalization in attributes
+            if (quote == '\'')
+                value = skip_and_expand_character_refs<attribute_value_pred<'\''>, attribute_value_pure_pred<'\''>>(buffer, AttFlags, arena);
+            else
+                value = skip_and_expand_character_refs<attribute_value_pred<'"'>, attribute_value_pure_pred<'"'>>(buffer, AttFlags, arena);
+
+            // Set attribute value
+            attribute.value(value);
+
+            // Make sure that end quote is present
+            if (buffer[0] != quote)
+                throw buffer.construct_error("expected ' or \"");
+            ++buffer; // Skip quote
+
+            // Skip whitespace after attribute value
+            skip<whitespace_pred>(buffer);
+
+            append(std::move(attribute));
+        }
+    }
+
+    // Parse data (PCDATA), and return its value with character references expanded
+    inline std::string_view parse_data(parse_buffer& buffer, char* contents_start, parse_flag flags, pmr::memory_resource* arena)
+    {
+        // Backup to contents start if whitespace trimming is disabled
+        if (!(int)(flags & parse_flag::trim_whitespace))
+            buffer.current = contents_start;
+
+        // Skip until end of data
+        std::string_view value;
+        if ((int)(flags & parse_flag::normalize_whitespace))
+            value = skip_and_expand_character_refs<text_pred, text_pure_with_ws_pred>(buffer, flags, arena);
+        else
+            value = skip_and_expand_character_refs<text_pred, text_pure_no_ws_pred>(buffer, flags, arena);
+
+        // Trim trailing whitespace if flag is set; leading was already trimmed by whitespace skip after >
+        if ((int)(flags & parse_flag::trim_whitespace))
+        {
+            if ((int)(flags & parse_flag::normalize_whitespace))
+            {
+                // Whitespace is already condensed to single space characters by skipping function, so just trim 1 char off the end
+                if (value.ends_with(' '))
+                    value.remove_suffix(1);
+            }
+            else
+            {
+                // Backup until non-whitespace character is found
+                while (!value.empty() && whitespace_pred::test(value.back()))
+                    value.remove_suffix(1);
+            }
+        }
+
+        return value;
+    }
+} // namespace rapidxml
+
+#endif // !RAPID_XML_PARSE_HPP
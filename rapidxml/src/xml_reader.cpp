@@ -0,0 +1,429 @@
+#include <istream>
+#include <rapidxml/xml_reader.hpp>
+#include <xml_parse.hpp>
+
+using namespace std;
+
+namespace rapidxml
+{
+    xml_reader::xml_reader(parse_flag flags) : m_flags(flags)
+    {
+    }
+
+    void xml_reader::load_view(string_view text)
+    {
+        compact();
+        if (m_buffer.empty())
+        {
+            m_view = text;
+            m_borrowed = true;
+        }
+        else
+        {
+            m_buffer.append(text);
+        }
+        finish();
+    }
+
+    void xml_reader::feed(string_view chunk)
+    {
+        compact();
+        m_buffer.append(chunk);
+    }
+
+    bool xml_reader::feed(istream& stream, size_t chunk_size)
+    {
+        compact();
+        size_t old_size = m_buffer.size();
+        m_buffer.resize(old_size + chunk_size);
+        stream.read(m_buffer.data() + old_size, chunk_size);
+        m_buffer.resize(old_size + (size_t)stream.gcount());
+        if (!stream)
+        {
+            finish();
+            return false;
+        }
+        return true;
+    }
+
+    void xml_reader::finish() noexcept
+    {
+        m_finished = true;
+    }
+
+    // Drop the consumed input, so that the buffer only holds the current token.
+    void xml_reader::compact()
+    {
+        if (m_borrowed)
+        {
+            // Any more input is appended to the rest of the borrowed one.
+            m_buffer.assign(m_view);
+            m_view = {};
+            m_borrowed = false;
+        }
+        if (!m_position) return;
+        char const* p = m_buffer.data();
+        char const* end = p + m_position;
+        while (char const* line = (char const*)memchr(p, '\n', end - p))
+        {
+            m_row++;
+            m_col = 0;
+            p = line + 1;
+        }
+        m_col += end - p;
+        m_offset += m_position;
+        m_buffer.erase(0, m_position);
+        m_scanned = m_scanned > m_position ? m_scanned - m_position : 0;
+        m_position = 0;
+    }
+
+    bool xml_reader::next(xml_event& e)
+    {
+        if (m_pop_pending)
+        {
+            pop_element();
+            m_pop_pending = false;
+        }
+        if (m_next_attribute < m_attributes.size())
+        {
+            xml_attribute const& attr = m_attributes[m_next_attribute++];
+            e.type(xml_event_type::attribute);
+            e.qname(attr.name(), attr.local_offset());
+            e.value(attr.value());
+            e.namespace_uri(attr.namespace_uri());
+            return true;
+        }
+        if (m_end_pending)
+        {
+            m_end_pending = false;
+            end_element(e);
+            return true;
+        }
+        try
+        {
+            return next_token(e);
+        }
+        catch (parse_error const& err)
+        {
+            // Errors are relative to the buffer; make them relative to the whole input.
+            size_t row = err.row() + m_row;
+            size_t col = err.row() ? err.col() : err.col() + m_col;
+            throw parse_error(err.what(), err.where() + m_offset, row, col);
+        }
+    }
+
+    bool xml_reader::next_token(xml_event& e)
+    {
+        while (true)
+        {
+            char* data = this->data();
+            size_t size = this->size();
+            m_scratch.release();
+
+            // Parse BOM, if any
+            if (!m_bom_checked)
+            {
+                if (size < 3 && !m_finished) return false;
+                parse_buffer buffer{ data, data + m_position, data + size };
+                if (size >= 3) parse_bom(buffer);
+                m_position = buffer.current - data;
+                m_bom_checked = true;
+            }
+
+            if (m_position >= size)
+            {
+                if (m_finished && !m_elements.empty())
+                    throw_error("unexpected end of data", size);
+                return false;
+            }
+
+            // Data
+            if (data[m_position] != '<')
+            {
+                size_t data_end = string_view{ data, size }.find('<', (max)(m_position, m_scanned));
+                if (data_end == string::npos)
+                {
+                    m_scanned = size;
+                    if (!m_finished) return false;
+                    data_end = size;
+                }
+                parse_buffer buffer{ data, data + m_position, data + data_end };
+                char* contents_start = buffer.current;
+                skip<whitespace_pred>(buffer);
+                if (buffer.current == buffer.end)
+                {
+                    // Whitespace only
+                    m_position = data_end;
+                    continue;
+                }
+                if (m_elements.empty())
+                    throw buffer.construct_error("expected <");
+                if (data_end == size)
+                    throw_error("unexpected end of data", size);
+                string_view value = parse_data(buffer, contents_start, m_flags, m_borrowed ? &m_scratch : nullptr);
+                m_position = buffer.current - data;
+                if ((int)(m_flags & parse_flag::no_data_nodes))
+                    continue;
+                e.type(xml_event_type::text);
+                e.qname({});
+                e.value(value);
+                e.namespace_uri({});
+                return true;
+            }
+
+            // Before determining the type of the token,
+            // wait for enough characters to recognize "<![CDATA[" and "<!DOCTYPE".
+            if (size - m_position < 9 && !m_finished) return false;
+            string_view token{ data + m_position, size - m_position };
+            size_t token_end;
+            if (token.starts_with("</"))
+            {
+                if ((token_end = token.find('>', 2)) != string_view::npos)
+                {
+                    end_tag(e, m_position + token_end);
+                    return true;
+                }
+            }
+            else if (token.starts_with("<?"))
+            {
+                if ((token_end = token.find("?>", 2)) != string_view::npos)
+                {
+                    m_position += token_end + 2;
+                    continue;
+                }
+            }
+            else if (token.starts_with("<!--"))
+            {
+                if ((token_end = token.find("-->", 4)) != string_view::npos)
+                {
+                    m_position += token_end + 3;
+                    continue;
+                }
+            }
+            else if (token.starts_with("<![CDATA["))
+            {
+                if ((token_end = token.find("]]>", 9)) != string_view::npos)
+                {
+                    string_view value = token.substr(9, token_end - 9);
+                    m_position += token_end + 3;
+                    if ((int)(m_flags & parse_flag::no_data_nodes))
+                        continue;
+                    e.type(xml_event_type::text);
+                    e.qname({});
+                    e.value(value);
+                    e.namespace_uri({});
+                    return true;
+                }
+            }
+            else if (token.starts_with("<!"))
+            {
+                if ((token_end = find_declaration_end(token, token.size() > 9 && token.starts_with("<!DOCTYPE") && whitespace_pred::test(token[9]))) != string_view::npos)
+                {
+                    m_position += token_end + 1;
+                    continue;
+                }
+            }
+            else
+            {
+                if ((token_end = find_start_tag_end(token)) != string_view::npos)
+                {
+                    start_tag(e, m_position + token_end);
+                    return true;
+                }
+            }
+
+            // The token is incomplete
+            if (!m_finished) return false;
+            throw_error("unexpected end of data", size);
+        }
+    }
+
+    // Find the '>' which ends a start tag, skipping quoted attribute values.
+    // As the attribute parser, only a quote after '=' starts a value.
+    size_t xml_reader::find_start_tag_end(string_view token) noexcept
+    {
+        size_t index = 1;
+        while ((index = token.find_first_of("=>", index)) != string_view::npos)
+        {
+            if (token[index] == '>') return index;
+            index = token.find_first_not_of(" \n\r\t", index + 1);
+            if (index == string_view::npos) break;
+            if (token[index] == '"' || token[index] == '\'')
+            {
+                index = token.find(token[index], index + 1);
+                if (index == string_view::npos) break;
+                index++;
+            }
+        }
+        return string_view::npos;
+    }
+
+    // Find the '>' which ends a <! node.
+    // The internal subset of DOCTYPE in brackets is skipped.
+    size_t xml_reader::find_declaration_end(string_view token, bool doctype) noexcept
+    {
+        if (!doctype) return token.find('>', 2);
+        int depth = 0;
+        for (size_t index = 2; index < token.size(); index++)
+        {
+            switch (token[index])
+            {
+            case '[':
+                depth++;
+                break;
+            case ']':
+                depth--;
+                break;
+            case '>':
+                if (depth <= 0) return index;
+                break;
+            }
+        }
+        return string_view::npos;
+    }
+
+    void xml_reader::start_tag(xml_event& e, size_t end)
+    {
+        char* data = this->data();
+        parse_buffer buffer{ data, data + m_position + 1, data + end + 1 };
+
+        // Extract element name
+        xml_base name{};
+        parse_element_name(buffer, name);
+
+        // Skip whitespace between element name and attributes or >
+        skip<whitespace_pred>(buffer);
+
+        // Parse attributes, if any
+        m_attributes.clear();
+        m_next_attribute = 0;
+        parse_attributes(buffer, m_flags, m_borrowed ? &m_scratch : nullptr, [this](xml_attribute&& attribute) { m_attributes.push_back(move(attribute)); });
+
+        // Determine ending type
+        if (buffer[0] == '/')
+        {
+            ++buffer;
+            m_end_pending = true;
+        }
+        if (buffer[0] != '>')
+            throw buffer.construct_error("expected >");
+        ++buffer;
+
+        xml_open_element element{ string{ name.name() }, name.local_offset(), {}, m_bindings.size() };
+        process_namespaces(element, name.prefix(), m_position);
+        m_elements.push_back(move(element));
+        m_position = buffer.current - data;
+
+        e.type(xml_event_type::start_element);
+        e.qname(name.name(), name.local_offset());
+        e.value({});
+        e.namespace_uri(m_elements.back().namespace_uri);
+    }
+
+    void xml_reader::end_tag(xml_event& e, size_t end)
+    {
+        char* data = this->data();
+        parse_buffer buffer{ data, data + m_position + 2, data + end + 1 };
+        if (m_elements.empty())
+            throw buffer.construct_error("unexpected closing tag");
+        if ((int)(m_flags & parse_flag::validate_closing_tags))
+        {
+            // Skip and validate closing tag name
+            char* closing_name = buffer.current;
+            skip<node_name_pred>(buffer);
+            if (m_elements.back().name != string_view(closing_name, buffer.current - closing_name))
+                throw buffer.construct_error("invalid closing tag name");
+        }
+        else
+        {
+            // No validation, just skip name
+            skip<node_name_pred>(buffer);
+        }
+        // Skip remaining whitespace after node name
+        skip<whitespace_pred>(buffer);
+        if (buffer[0] != '>')
+            throw buffer.construct_error("expected >");
+        m_position = end + 1;
+        end_element(e);
+    }
+
+    void xml_reader::end_element(xml_event& e) noexcept
+    {
+        xml_open_element const& element = m_elements.back();
+        e.type(xml_event_type::end_element);
+        e.qname(element.name, element.local_name);
+        e.value({});
+        e.namespace_uri(element.namespace_uri);
+        // The element is popped on the next call,
+        // so that the strings of the event remain valid.
+        m_pop_pending = true;
+    }
+
+    // Same as the namespace processing of xml_document,
+    // but the bindings are copied, because the buffer is reused.
+    void xml_reader::process_namespaces(xml_open_element& element, string_view prefix, size_t position)
+    {
+        bool has_prefixed_attribute = false;
+        for (xml_attribute& attr : m_attributes)
+        {
+            switch (attr.prefix().size())
+            {
+            case 0:
+                if (attr.name() == xmlns_namespace::prefix)
+                {
+                    attr.namespace_uri(xmlns_namespace::uri);
+                    m_bindings.push_back({ {}, string{ attr.value() } });
+                }
+                continue;
+            case xml_namespace::prefix.size():
+                if (attr.prefix() == xml_namespace::prefix)
+                {
+                    attr.namespace_uri(xml_namespace::uri);
+                    continue;
+                }
+                break;
+            case xmlns_namespace::prefix.size():
+                if (attr.prefix() == xmlns_namespace::prefix)
+                {
+                    attr.namespace_uri(xmlns_namespace::uri);
+                    m_bindings.push_back({ string{ attr.local_name() }, string{ attr.value() } });
+                    continue;
+                }
+                break;
+            } // switch
+            has_prefixed_attribute = true;
+        }
+        element.namespace_uri = find_namespace_uri(prefix, !prefix.empty(), position);
+        if (has_prefixed_attribute)
+        {
+            for (xml_attribute& attr : m_attributes)
+                if (attr.prefix().size() > 0 && attr.namespace_uri().empty())
+                    attr.namespace_uri(find_namespace_uri(attr.prefix(), true, position));
+        }
+    }
+
+    // The default namespace is bound to an empty prefix.
+    string_view xml_reader::find_namespace_uri(string_view prefix, bool required, size_t position) const
+    {
+        for (auto it = m_bindings.rbegin(); it != m_bindings.rend(); ++it)
+        {
+            if (it->prefix == prefix) return it->uri;
+        }
+        if (required)
+            throw_error("No namespace definition found", position);
+        return {};
+    }
+
+    void xml_reader::pop_element() noexcept
+    {
+        size_t bindings = m_elements.back().bindings;
+        while (m_bindings.size() > bindings) m_bindings.pop_back();
+        m_elements.pop_back();
+    }
+
+    void xml_reader::throw_error(char const* message, size_t position) const
+    {
+        char* data = this->data();
+        throw parse_buffer{ data, data + position, data + size() }.construct_error(message);
+    }
+} // namespace rapidxml
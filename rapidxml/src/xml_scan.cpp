@@ -0,0 +1,52 @@
+#include <algorithm>
+#include <xml_scan.hpp>
+
+using namespace std;
+
+namespace rapidxml
+{
+    static scan_isa detect_scan_isa() noexcept
+    {
+#ifdef RAPIDXML_AVX2
+    #ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] >= 7)
+        {
+            __cpuid(info, 1);
+            bool osxsave = (info[2] & (1 << 27)) != 0;
+            bool avx = (info[2] & (1 << 28)) != 0;
+            if (osxsave && avx && (_xgetbv(0) & 0x6) == 0x6)
+            {
+                __cpuidex(info, 7, 0);
+                if (info[1] & (1 << 5)) return scan_isa::avx2;
+            }
+        }
+    #else
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return scan_isa::avx2;
+    #endif // _MSC_VER
+#endif // RAPIDXML_AVX2
+#ifdef RAPIDXML_SSE2
+        return scan_isa::sse2;
+#else
+        return scan_isa::scalar;
+#endif // RAPIDXML_SSE2
+    }
+
+    static scan_isa const s_supported_scan_isa = detect_scan_isa();
+
+    atomic<scan_isa> s_scan_isa{ s_supported_scan_isa };
+
+    scan_isa get_scan_isa() noexcept
+    {
+        return current_scan_isa();
+    }
+
+    scan_isa set_scan_isa(scan_isa isa) noexcept
+    {
+        scan_isa result = (min)(isa, s_supported_scan_isa);
+        s_scan_isa.store(result, memory_order_relaxed);
+        return result;
+    }
+} // namespace rapidxml
@@ -0,0 +1,132 @@
+#ifndef RAPID_XML_SCAN_HPP
+#define RAPID_XML_SCAN_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <rapidxml/xml_attribute.hpp>
+#include <rapidxml/xml_document.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define RAPIDXML_SSE2
+    #include <emmintrin.h>
+    #if defined(__GNUC__) || defined(__clang__)
+        #define RAPIDXML_AVX2
+        #define RAPIDXML_TARGET_AVX2 __attribute__((target("avx2")))
+        #include <immintrin.h>
+    #elif defined(_MSC_VER)
+        #define RAPIDXML_AVX2
+        #define RAPIDXML_TARGET_AVX2
+        #include <immintrin.h>
+        #include <intrin.h>
+    #endif
+#endif
+
+#ifdef RAPIDXML_NO_SIMD
+    #undef RAPIDXML_SSE2
+    #undef RAPIDXML_AVX2
+#endif // RAPIDXML_NO_SIMD
+
+namespace rapidxml
+{
+    // A set of characters to be tested by the scanners.
+    // The scanners stop at the first character which is in the set (Stop = true),
+    // or which is not in the set (Stop = false).
+    // The terminating zero is always treated as a stop character.
+    template <bool Stop, char... Chars>
+    struct char_set
+    {
+        using set_type = char_set;
+
+        static constexpr bool test(char ch) noexcept
+        {
+            return Stop ? (ch && ((ch != Chars) && ...)) : (ch && ((ch == Chars) || ...));
+        }
+    };
+
+    extern std::atomic<scan_isa> s_scan_isa;
+
+    inline scan_isa current_scan_isa() noexcept
+    {
+        return s_scan_isa.load(std::memory_order_relaxed);
+    }
+
+    template <typename Set>
+    struct char_set_scanner;
+
+    template <bool Stop, char... Chars>
+    struct char_set_scanner<char_set<Stop, Chars...>>
+    {
+        using set_type = char_set<Stop, Chars...>;
+
+        static char* scalar(char* p, char* end) noexcept
+        {
+            while (p < end && set_type::test(*p)) ++p;
+            return p;
+        }
+
+#ifdef RAPIDXML_SSE2
+        static char* sse2(char* p, char* end) noexcept
+        {
+            __m128i const zero = _mm_setzero_si128();
+            while (end - p >= 16)
+            {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+                __m128i eq = _mm_setzero_si128();
+                ((eq = _mm_or_si128(eq, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(Chars)))), ...);
+                unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(eq));
+                if constexpr (!Stop) mask = ~mask & 0xFFFF;
+                mask |= static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, zero)));
+                if (mask) return p + count_zeros(mask);
+                p += 16;
+            }
+            return scalar(p, end);
+        }
+#endif // RAPIDXML_SSE2
+
+#ifdef RAPIDXML_AVX2
+        RAPIDXML_TARGET_AVX2 static char* avx2(char* p, char* end) noexcept
+        {
+            __m256i const zero = _mm256_setzero_si256();
+            while (end - p >= 32)
+            {
+                __m256i chunk = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+                __m256i eq = _mm256_setzero_si256();
+                ((eq = _mm256_or_si256(eq, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(Chars)))), ...);
+                std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(eq));
+                if constexpr (!Stop) mask = ~mask;
+                mask |= static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, zero)));
+                if (mask) return p + count_zeros(mask);
+                p += 32;
+            }
+            return sse2(p, end);
+        }
+#endif // RAPIDXML_AVX2
+
+        static char* scan(char* p, char* end) noexcept
+        {
+            // Most runs are short; test the first character before vectorizing.
+            if (p == end || !set_type::test(*p)) return p;
+#ifdef RAPIDXML_AVX2
+            if (current_scan_isa() == scan_isa::avx2) return avx2(p, end);
+#endif // RAPIDXML_AVX2
+#ifdef RAPIDXML_SSE2
+            if (current_scan_isa() != scan_isa::scalar) return sse2(p, end);
+#endif // RAPIDXML_SSE2
+            return scalar(p, end);
+        }
+
+    private:
+        static int count_zeros(std::uint32_t mask) noexcept
+        {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return static_cast<int>(index);
+#else
+            return __builtin_ctz(mask);
+#endif // _MSC_VER
+        }
+    };
+} // namespace rapidxml
+
+#endif // !RAPID_XML_SCAN_HPP
@@ -0,0 +1,389 @@
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <rapidxml/xml_attribute.hpp>
+#include <rapidxml/xml_document.hpp>
+#include <rapidxml/xml_reader.hpp>
+#include <sstream>
+#include <string>
+#include <test_check.hpp>
+
+using namespace std;
+using namespace rapidxml;
+
+static char const* isa_name(scan_isa isa)
+{
+    switch (isa)
+    {
+    case scan_isa::avx2:
+        return "avx2";
+    case scan_isa::sse2:
+        return "sse2";
+    default:
+        return "scalar";
+    }
+}
+
+// Generates a XAML-like document, with deep nesting, long attribute values,
+// indentation, entities and text nodes.
+static string generate_xaml(mt19937& rnd, size_t target_size)
+{
+    constexpr char const* names[] = { "grid", "label", "button", "stack_panel", "entry", "check_box", "x:Name", "canvas" };
+    constexpr char const* texts[] = { "Hello", "Username:", "a &amp; b", "&lt;tag&gt;", "&#x1f923; &#65;", "  spaced   text  ", "Radio 1 in group b" };
+    string result = "<?xml version=\"1.0\"?>\n<window xmlns=\"https://github.com/Berrysoft/XamlCpp/\" xmlns:x=\"https://github.com/Berrysoft/XamlCpp/xaml/\">\n";
+    vector<string> stack{ "window" };
+    while (result.size() < target_size || stack.size() > 1)
+    {
+        string indent(stack.size() * 2, ' ');
+        unsigned action = rnd() % 8;
+        if ((action < 3 && stack.size() < 24) && result.size() < target_size)
+        {
+            string name = names[rnd() % 6];
+            result += indent + "<" + name;
+            unsigned attrs = rnd() % 5;
+            for (unsigned i = 0; i < attrs; i++)
+            {
+                char quote = (rnd() % 4) ? '"' : '\'';
+                result += " ";
+                if (rnd() % 3 == 0) result += "x:";
+                result += "attr" + to_string(i) + " = " + quote;
+                size_t len = rnd() % 80;
+                for (size_t j = 0; j < len; j++) result += "abcdefghij, 0123456789.*"[rnd() % 24];
+                if (rnd() % 8 == 0) result += "&quot;&apos;&amp;";
+                result += quote;
+            }
+            if (rnd() % 3 == 0)
+            {
+                result += "/>\n";
+            }
+            else
+            {
+                result += ">\n";
+                stack.push_back(name);
+            }
+        }
+        else if (action < 5 && result.size() < target_size)
+        {
+            result += indent + texts[rnd() % size(texts)] + "\n";
+        }
+        else if (action == 5 && result.size() < target_size)
+        {
+            result += indent + ((rnd() % 2) ? "<!-- a comment -->\n" : "<![CDATA[ <raw> & ]]>\n");
+        }
+        else if (stack.size() > 1)
+        {
+            string name = stack.back();
+            stack.pop_back();
+            result += string(stack.size() * 2, ' ') + "</" + name + ">\n";
+        }
+    }
+    result += "</window>\n";
+    return result;
+}
+
+static bool equals(xml_base const& lhs, xml_base const& rhs)
+{
+    return lhs.name() == rhs.name() && lhs.local_offset() == rhs.local_offset() && lhs.value() == rhs.value() && lhs.namespace_uri() == rhs.namespace_uri();
+}
+
+static bool equals(xml_node const& lhs, xml_node const& rhs)
+{
+    if (lhs.type() != rhs.type() || !equals(static_cast<xml_base const&>(lhs), static_cast<xml_base const&>(rhs))) return false;
+    if (lhs.attributes().size() != rhs.attributes().size() || lhs.nodes().size() != rhs.nodes().size()) return false;
+    for (auto l = lhs.attributes().begin(), r = rhs.attributes().begin(); l != lhs.attributes().end(); ++l, ++r)
+    {
+        if (!equals(*l, *r)) return false;
+    }
+    for (auto l = lhs.nodes().begin(), r = rhs.nodes().begin(); l != lhs.nodes().end(); ++l, ++r)
+    {
+        if (!equals(*l, *r)) return false;
+    }
+    return true;
+}
+
+// Parses with the given instruction set,
+// and returns the error position, or npos if succeeded.
+static size_t parse_with(xml_document& doc, scan_isa isa, string_view text, parse_flag flags)
+{
+    set_scan_isa(isa);
+    try
+    {
+        doc.load_string(text, flags);
+        return string::npos;
+    }
+    catch (parse_error const& e)
+    {
+        return e.where();
+    }
+}
+
+static void test_equivalence(scan_isa best)
+{
+    mt19937 rnd{ 20201019 };
+    constexpr parse_flag flag_sets[] = { parse_flag::default_flag, parse_flag::full, parse_flag::trim_whitespace | parse_flag::normalize_whitespace, parse_flag::fastest };
+    for (int n = 0; n < 200; n++)
+    {
+        string text = generate_xaml(rnd, 512 + rnd() % 8192);
+        // Corrupt some of the documents to compare the error positions.
+        if (n % 4 == 3)
+        {
+            text[rnd() % text.size()] = "<>&\"'/="[rnd() % 7];
+        }
+        for (parse_flag flags : flag_sets)
+        {
+            xml_document scalar_doc;
+            size_t scalar_error = parse_with(scalar_doc, scan_isa::scalar, text, flags);
+            for (int isa = (int)scan_isa::sse2; isa <= (int)best; isa++)
+            {
+                xml_document simd_doc;
+                size_t simd_error = parse_with(simd_doc, (scan_isa)isa, text, flags);
+                if (scalar_error != simd_error || (scalar_error == string::npos && !equals(scalar_doc.node(), simd_doc.node())))
+                {
+                    cout << "Mismatch with " << isa_name((scan_isa)isa) << " in document " << n << endl;
+                    failures++;
+                }
+            }
+        }
+    }
+}
+
+// Flattens the DOM to the events which xml_reader should produce.
+static void flatten(xml_node const& node, vector<string>& events)
+{
+    switch (node.type())
+    {
+    case node_type::document:
+        for (auto& c : node.nodes()) flatten(c, events);
+        break;
+    case node_type::element:
+        events.push_back("S" + string(node.name()) + "|" + string(node.namespace_uri()));
+        for (auto& attr : node.attributes())
+            events.push_back("A" + string(attr.name()) + "|" + string(attr.namespace_uri()) + "|" + string(attr.value()));
+        for (auto& c : node.nodes()) flatten(c, events);
+        events.push_back("E" + string(node.name()) + "|" + string(node.namespace_uri()));
+        break;
+    case node_type::data:
+    case node_type::cdata:
+        events.push_back("T" + string(node.value()));
+        break;
+    default:
+        break;
+    }
+}
+
+// Feeds the text to a reader in random chunks, or as a whole view, and records the events.
+static bool read_events(mt19937& rnd, string_view text, parse_flag flags, vector<string>& events, bool view = false)
+{
+    xml_reader reader{ flags };
+    xml_event e;
+    size_t offset = 0;
+    if (view) reader.load_view(text);
+    try
+    {
+        while (true)
+        {
+            while (reader.next(e))
+            {
+                switch (e.type())
+                {
+                case xml_event_type::start_element:
+                    events.push_back("S" + string(e.name()) + "|" + string(e.namespace_uri()));
+                    break;
+                case xml_event_type::attribute:
+                    events.push_back("A" + string(e.name()) + "|" + string(e.namespace_uri()) + "|" + string(e.value()));
+                    break;
+                case xml_event_type::text:
+                    events.push_back("T" + string(e.value()));
+                    break;
+                case xml_event_type::end_element:
+                    events.push_back("E" + string(e.name()) + "|" + string(e.namespace_uri()));
+                    break;
+                default:
+                    break;
+                }
+            }
+            if (reader.finished()) return true;
+            // Mostly large chunks, sometimes tiny ones splitting every token.
+            size_t length = (min)(text.size() - offset, (size_t)(1 + rnd() % ((rnd() % 4) ? 4096 : 8)));
+            reader.feed(text.substr(offset, length));
+            offset += length;
+            if (offset == text.size()) reader.finish();
+        }
+    }
+    catch (parse_error const&)
+    {
+        return false;
+    }
+}
+
+static void test_reader()
+{
+    mt19937 rnd{ 20201020 };
+    constexpr parse_flag flag_sets[] = { parse_flag::default_flag, parse_flag::validate_closing_tags, parse_flag::trim_whitespace | parse_flag::normalize_whitespace };
+    for (int n = 0; n < 200; n++)
+    {
+        string text = generate_xaml(rnd, 512 + rnd() % 8192);
+        if (n % 4 == 3)
+        {
+            text[rnd() % text.size()] = "<>&\"'/="[rnd() % 7];
+        }
+        for (parse_flag flags : flag_sets)
+        {
+            xml_document doc;
+            bool doc_succeeded = parse_with(doc, get_scan_isa(), text, flags) == string::npos;
+            vector<string> doc_events;
+            if (doc_succeeded) flatten(doc.node(), doc_events);
+            vector<string> reader_events;
+            bool reader_succeeded = read_events(rnd, text, flags, reader_events);
+            if (doc_succeeded != reader_succeeded || (doc_succeeded && doc_events != reader_events))
+            {
+                cout << "Reader mismatch in document " << n << endl;
+                failures++;
+            }
+            // The borrowed input is not zero-terminated here.
+            unique_ptr<char[]> copy{ new char[text.size()] };
+            memcpy(copy.get(), text.data(), text.size());
+            string_view unterminated{ copy.get(), text.size() };
+            vector<string> view_events;
+            bool view_succeeded = read_events(rnd, unterminated, flags, view_events, true);
+            vector<string> copy_events;
+            bool copy_succeeded = read_events(rnd, unterminated, flags, copy_events);
+            if (view_succeeded != copy_succeeded || view_events != copy_events)
+            {
+                cout << "Borrowed reader mismatch in document " << n << endl;
+                failures++;
+            }
+        }
+    }
+    // The input ends right after a declaration name.
+    for (string_view text : { "<!DOCTYPE", "<a/><!DOCTYPE" })
+    {
+        unique_ptr<char[]> copy{ new char[text.size()] };
+        memcpy(copy.get(), text.data(), text.size());
+        vector<string> events;
+        CHECK(!read_events(rnd, { copy.get(), text.size() }, parse_flag::default_flag, events, true));
+    }
+}
+
+static void test_view()
+{
+    mt19937 rnd{ 20201021 };
+    constexpr parse_flag flag_sets[] = { parse_flag::default_flag, parse_flag::full, parse_flag::trim_whitespace | parse_flag::normalize_whitespace, parse_flag::fastest };
+    for (int n = 0; n < 200; n++)
+    {
+        string text = generate_xaml(rnd, 512 + rnd() % 8192);
+        if (n % 4 == 3)
+        {
+            text[rnd() % text.size()] = "<>&\"'/="[rnd() % 7];
+        }
+        // Every other document is cut, so that the input ends in the middle of a token.
+        if (n % 2) text.resize(rnd() % text.size());
+        for (parse_flag flags : flag_sets)
+        {
+            xml_document copy_doc;
+            size_t copy_error = parse_with(copy_doc, get_scan_isa(), text, flags);
+            // The borrowed input is not zero-terminated here.
+            unique_ptr<char[]> copy{ new char[text.size()] };
+            memcpy(copy.get(), text.data(), text.size());
+            string_view unterminated{ copy.get(), text.size() };
+            xml_document view_doc;
+            size_t view_error = string::npos;
+            try
+            {
+                view_doc.load_view(unterminated, flags);
+            }
+            catch (parse_error const& e)
+            {
+                view_error = e.where();
+            }
+            if (copy_error != view_error || (copy_error == string::npos && !equals(copy_doc.node(), view_doc.node())))
+            {
+                cout << "View mismatch in document " << n << endl;
+                failures++;
+            }
+            if (unterminated != text)
+            {
+                cout << "Source modified in document " << n << endl;
+                failures++;
+            }
+        }
+    }
+}
+
+static void bench(scan_isa best)
+{
+    mt19937 rnd{ 42 };
+    string text = generate_xaml(rnd, 16 * 1024 * 1024);
+    for (int isa = (int)scan_isa::scalar; isa <= (int)best; isa++)
+    {
+        set_scan_isa((scan_isa)isa);
+        constexpr int rounds = 5;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < rounds; i++)
+        {
+            xml_document doc;
+            doc.load_string(text);
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << isa_name((scan_isa)isa) << ": " << (text.size() * rounds / seconds / 1024 / 1024) << " MiB/s" << endl;
+    }
+    {
+        constexpr int rounds = 5;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < rounds; i++)
+        {
+            xml_document doc;
+            doc.load_view(text);
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << "view: " << (text.size() * rounds / seconds / 1024 / 1024) << " MiB/s" << endl;
+    }
+    {
+        constexpr int rounds = 5;
+        auto start = chrono::steady_clock::now();
+        size_t count = 0;
+        for (int i = 0; i < rounds; i++)
+        {
+            istringstream stream{ text };
+            xml_reader reader;
+            xml_event e;
+            bool more = true;
+            while (more)
+            {
+                more = reader.feed(stream);
+                while (reader.next(e)) count++;
+            }
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << "reader: " << (text.size() * rounds / seconds / 1024 / 1024) << " MiB/s, " << count / rounds << " events" << endl;
+    }
+    {
+        constexpr int rounds = 5;
+        auto start = chrono::steady_clock::now();
+        size_t count = 0;
+        for (int i = 0; i < rounds; i++)
+        {
+            xml_reader reader;
+            reader.load_view(text);
+            xml_event e;
+            while (reader.next(e)) count++;
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << "reader view: " << (text.size() * rounds / seconds / 1024 / 1024) << " MiB/s, " << count / rounds << " events" << endl;
+    }
+}
+
+int main()
+{
+    scan_isa best = get_scan_isa();
+    cout << "Best instruction set: " << isa_name(best) << endl;
+    test_equivalence(best);
+    set_scan_isa(best);
+    test_reader();
+    test_view();
+    bench(best);
+    set_scan_isa(best);
+    return report_failures();
+}
@@ -0,0 +1,28 @@
+#ifndef XAML_RESOURCE_PACK_H
+#define XAML_RESOURCE_PACK_H
+
+#include <xaml/buffer.h>
+#include <xaml/string.h>
+
+XAML_CLASS(xaml_resource_pack, { 0x0e81ac12, 0xac16, 0x4e66, { 0x8c, 0x7c, 0x12, 0x41, 0xd5, 0x1e, 0xcb, 0xa9 } })
+
+// The entries are decompressed on the first access, and the buffers are cached.
+// A stored entry refers to the memory of the pack, which should not be written.
+#define XAML_RESOURCE_PACK_VTBL(type)                    \
+    XAML_VTBL_INHERIT(XAML_OBJECT_VTBL(type));           \
+    XAML_METHOD(get, type, xaml_string*, xaml_buffer**); \
+    XAML_METHOD(get_hashed, type, xaml_string*, XAML_STD uint64_t, xaml_buffer**)
+
+XAML_DECL_INTERFACE_(xaml_resource_pack, xaml_object)
+{
+    XAML_DECL_VTBL(xaml_resource_pack, XAML_RESOURCE_PACK_VTBL);
+};
+
+// Opens a pack in the memory, which should outlive the pack and the buffers from it.
+EXTERN_C XAML_RESOURCE_API xaml_result XAML_CALL xaml_resource_pack_open(void const*, XAML_STD int64_t, xaml_resource_pack**) XAML_NOEXCEPT;
+// Maps a pack file into the memory.
+EXTERN_C XAML_RESOURCE_API xaml_result XAML_CALL xaml_resource_pack_open_file(xaml_string*, xaml_resource_pack**) XAML_NOEXCEPT;
+// Maps a pack file in the directory of the executable, whatever the current directory is.
+EXTERN_C XAML_RESOURCE_API xaml_result XAML_CALL xaml_resource_pack_open_app_file(xaml_string*, xaml_resource_pack**) XAML_NOEXCEPT;
+
+#endif // !XAML_RESOURCE_PACK_H
@@ -4,6 +4,42 @@
 #include <xaml/buffer.h>
 #include <xaml/string.h>
 
+// The hash of a resource path, FNV-1a over the UTF-8 bytes.
+// The table generated by xamlrc is indexed by it, so that a path known ahead
+// could be hashed at compile time and passed to xaml_resource_get_hashed.
+XAML_CONSTEXPR XAML_STD uint64_t xaml_resource_hash(char const* str, XAML_STD size_t length) XAML_NOEXCEPT
+{
+    XAML_STD uint64_t hash = 0xcbf29ce484222325;
+    for (XAML_STD size_t i = 0; i < length; i++)
+    {
+        hash ^= (XAML_STD uint8_t)str[i];
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+// Mixes a hash with a displacement of the table generated by xamlrc.
+XAML_CONSTEXPR XAML_STD uint64_t xaml_resource_hash_mix(XAML_STD uint64_t hash, XAML_STD uint32_t d) XAML_NOEXCEPT
+{
+    XAML_STD uint64_t x = hash + (d + 1) * 0x9e3779b97f4a7c15;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+    return x ^ (x >> 31);
+}
+
+// The functions below without XAML_RESOURCE_API are defined by the code generated by xamlrc.
 EXTERN_C xaml_result XAML_CALL xaml_resource_get(xaml_string*, void const**, XAML_STD int32_t*) XAML_NOEXCEPT;
+EXTERN_C xaml_result XAML_CALL xaml_resource_get_hashed(xaml_string*, XAML_STD uint64_t, void const**, XAML_STD int64_t*) XAML_NOEXCEPT;
+// Gets the resource as a buffer, which keeps it alive if it is decompressed from a pack.
+EXTERN_C xaml_result XAML_CALL xaml_resource_get_buffer(xaml_string*, xaml_buffer**) XAML_NOEXCEPT;
+
+typedef xaml_result(XAML_CALL* xaml_resource_getter)(xaml_string*, XAML_STD uint64_t, void const**, XAML_STD int64_t*) XAML_NOEXCEPT;
+
+// Registers the lookup of the resources, like xaml_resource_get_hashed.
+// The code generated by xamlrc registers its own when it is loaded,
+// so that the libraries could find the resources of the application without linking to them.
+EXTERN_C XAML_RESOURCE_API void XAML_CALL xaml_resource_register(xaml_resource_getter) XAML_NOEXCEPT;
+// Finds a resource with the registered lookup, or returns XAML_E_KEYNOTFOUND if none is registered.
+EXTERN_C XAML_RESOURCE_API xaml_result XAML_CALL xaml_resource_find_hashed(xaml_string*, XAML_STD uint64_t, void const**, XAML_STD int64_t*) XAML_NOEXCEPT;
 
 #endif // !XAML_RESOURCE_RESOURCE_H
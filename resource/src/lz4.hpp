@@ -0,0 +1,18 @@
+#ifndef XAML_RESOURCE_LZ4_HPP
+#define XAML_RESOURCE_LZ4_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The LZ4 block format, without the frame.
+// A block is a list of sequences: a token with the lengths of the literals and the match,
+// the literals, and the 2-byte offset of the match. The last sequence has only literals.
+
+// Compresses greedily with a table of 4-byte hashes; fast, but not the best ratio.
+std::vector<std::uint8_t> lz4_compress(std::uint8_t const* src, std::size_t size);
+
+// Returns false if the block is malformed, or does not decompress to exactly size bytes.
+bool lz4_decompress(std::uint8_t const* src, std::size_t src_size, std::uint8_t* dst, std::size_t size) noexcept;
+
+#endif // !XAML_RESOURCE_LZ4_HPP
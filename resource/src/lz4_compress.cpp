@@ -0,0 +1,75 @@
+#include <cstring>
+#include <lz4.hpp>
+
+using namespace std;
+
+// A match is at least 4 bytes; the last 5 bytes are literals,
+// and the last match starts at least 12 bytes before the end.
+static constexpr size_t min_match = 4;
+static constexpr size_t last_literals = 5;
+static constexpr size_t match_limit = 12;
+static constexpr size_t max_offset = 65535;
+static constexpr int hash_bits = 16;
+
+static uint32_t read32(uint8_t const* p) noexcept
+{
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static void write_length(vector<uint8_t>& out, size_t length)
+{
+    for (; length >= 255; length -= 255) out.push_back(255);
+    out.push_back(static_cast<uint8_t>(length));
+}
+
+// Writes a sequence; a match of 0 length ends the block.
+static void write_sequence(vector<uint8_t>& out, uint8_t const* literals, size_t literal_length, size_t offset, size_t match_length)
+{
+    size_t match_code = match_length ? match_length - min_match : 0;
+    out.push_back(static_cast<uint8_t>(((literal_length < 15 ? literal_length : 15) << 4) | (match_code < 15 ? match_code : 15)));
+    if (literal_length >= 15) write_length(out, literal_length - 15);
+    out.insert(out.end(), literals, literals + literal_length);
+    if (match_length)
+    {
+        out.push_back(static_cast<uint8_t>(offset & 0xFF));
+        out.push_back(static_cast<uint8_t>(offset >> 8));
+        if (match_code >= 15) write_length(out, match_code - 15);
+    }
+}
+
+vector<uint8_t> lz4_compress(uint8_t const* src, size_t size)
+{
+    vector<uint8_t> out;
+    out.reserve(size + size / 255 + 16);
+    size_t anchor = 0;
+    if (size > match_limit)
+    {
+        constexpr size_t npos = static_cast<size_t>(-1);
+        vector<size_t> table(size_t{ 1 } << hash_bits, npos);
+        size_t limit = size - match_limit;
+        for (size_t i = 0; i < limit;)
+        {
+            uint32_t seq = read32(src + i);
+            uint32_t h = (seq * 2654435761u) >> (32 - hash_bits);
+            size_t candidate = table[h];
+            table[h] = i;
+            if (candidate != npos && i - candidate <= max_offset && read32(src + candidate) == seq)
+            {
+                size_t length = min_match;
+                size_t max_length = size - last_literals - i;
+                while (length < max_length && src[candidate + length] == src[i + length]) length++;
+                write_sequence(out, src + anchor, i - anchor, i - candidate, length);
+                i += length;
+                anchor = i;
+            }
+            else
+            {
+                i++;
+            }
+        }
+    }
+    write_sequence(out, src + anchor, size - anchor, 0, 0);
+    return out;
+}
@@ -0,0 +1,53 @@
+#include <cstring>
+#include <lz4.hpp>
+
+using namespace std;
+
+static bool read_length(uint8_t const* src, size_t src_size, size_t& ip, size_t& length) noexcept
+{
+    uint8_t b;
+    do
+    {
+        if (ip >= src_size) return false;
+        b = src[ip++];
+        length += b;
+    } while (b == 255);
+    return true;
+}
+
+bool lz4_decompress(uint8_t const* src, size_t src_size, uint8_t* dst, size_t size) noexcept
+{
+    size_t ip = 0, op = 0;
+    while (ip < src_size)
+    {
+        uint8_t token = src[ip++];
+        size_t literal_length = token >> 4;
+        if (literal_length == 15 && !read_length(src, src_size, ip, literal_length)) return false;
+        if (literal_length > src_size - ip || literal_length > size - op) return false;
+        if (literal_length) memcpy(dst + op, src + ip, literal_length);
+        ip += literal_length;
+        op += literal_length;
+        // The last sequence has no match.
+        if (ip == src_size) break;
+        if (src_size - ip < 2) return false;
+        size_t offset = src[ip] | (src[ip + 1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > op) return false;
+        size_t match_length = token & 15;
+        if (match_length == 15 && !read_length(src, src_size, ip, match_length)) return false;
+        match_length += 4;
+        if (match_length > size - op) return false;
+        uint8_t* match = dst + op - offset;
+        if (offset >= match_length)
+        {
+            memcpy(dst + op, match, match_length);
+        }
+        else
+        {
+            // The match overlaps the output, and repeats the last offset bytes.
+            for (size_t i = 0; i < match_length; i++) dst[op + i] = match[i];
+        }
+        op += match_length;
+    }
+    return op == size;
+}
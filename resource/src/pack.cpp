@@ -0,0 +1,284 @@
+#include <algorithm>
+#include <cstring>
+#include <lz4.hpp>
+#include <memory>
+#include <mutex>
+#include <pack_format.hpp>
+#include <vector>
+#include <xaml/resource/pack.h>
+#include <xaml/resource/resource.h>
+
+#ifdef XAML_WIN32
+    #include <nowide/convert.hpp>
+    #include <xaml/result_win32.h>
+#else
+    #ifdef XAML_APPLE
+        #include <mach-o/dyld.h>
+    #endif // XAML_APPLE
+    #include <climits>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #include <xaml/result_posix.h>
+#endif // XAML_WIN32
+
+using namespace std;
+
+// A read-only mapping of a whole file.
+struct mapped_file
+{
+#ifdef XAML_WIN32
+    HANDLE m_mapping{ nullptr };
+#endif // XAML_WIN32
+    void* m_data{ nullptr };
+    uint64_t m_size{ 0 };
+
+    ~mapped_file()
+    {
+#ifdef XAML_WIN32
+        if (m_data) UnmapViewOfFile(m_data);
+        if (m_mapping) CloseHandle(m_mapping);
+#else
+        if (m_data) munmap(m_data, m_size);
+#endif // XAML_WIN32
+    }
+
+    xaml_result open(string_view path) noexcept;
+};
+
+#ifdef XAML_WIN32
+xaml_result mapped_file::open(string_view path) noexcept
+try
+{
+    wstring wpath = nowide::widen(path);
+    HANDLE file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return HRESULT_FROM_WIN32(GetLastError());
+    LARGE_INTEGER size;
+    BOOL res = GetFileSizeEx(file, &size);
+    if (res && size.QuadPart) m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    xaml_result hr = res ? XAML_S_OK : HRESULT_FROM_WIN32(GetLastError());
+    CloseHandle(file);
+    if (XAML_FAILED(hr)) return hr;
+    m_size = static_cast<uint64_t>(size.QuadPart);
+    if (!m_size) return XAML_S_OK;
+    if (!m_mapping) return HRESULT_FROM_WIN32(GetLastError());
+    m_data = MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!m_data) return HRESULT_FROM_WIN32(GetLastError());
+    return XAML_S_OK;
+}
+XAML_CATCH_RETURN()
+#else
+xaml_result mapped_file::open(string_view path) noexcept
+try
+{
+    string spath{ path };
+    // A missing file is expected by the callers trying it, so it is returned without raising.
+    int fd = ::open(spath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) return xaml_result_from_errno(errno);
+    struct stat st;
+    int res = fstat(fd, &st);
+    if (res != -1 && st.st_size)
+    {
+        m_data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (m_data == MAP_FAILED)
+        {
+            m_data = nullptr;
+            res = -1;
+        }
+    }
+    int err = errno;
+    close(fd);
+    if (res == -1) return xaml_result_from_errno(err);
+    m_size = static_cast<uint64_t>(st.st_size);
+    return XAML_S_OK;
+}
+XAML_CATCH_RETURN()
+#endif // XAML_WIN32
+
+// Refers to a stored entry, and keeps the pack alive.
+struct xaml_resource_pack_buffer_impl : xaml_implement<xaml_resource_pack_buffer_impl, xaml_buffer>
+{
+    xaml_ptr<xaml_resource_pack> m_pack;
+    uint8_t* m_data;
+    int32_t m_size;
+
+    xaml_resource_pack_buffer_impl(xaml_ptr<xaml_resource_pack> const& pack, uint8_t* data, int32_t size) noexcept
+        : m_pack(pack), m_data(data), m_size(size) {}
+
+    xaml_result XAML_CALL get_size(int32_t* psize) noexcept override
+    {
+        *psize = m_size;
+        return XAML_S_OK;
+    }
+
+    xaml_result XAML_CALL get_data(uint8_t** pdata) noexcept override
+    {
+        *pdata = m_data;
+        return XAML_S_OK;
+    }
+};
+
+struct xaml_resource_pack_impl : xaml_implement<xaml_resource_pack_impl, xaml_resource_pack>
+{
+    // Null if the memory is not owned.
+    unique_ptr<mapped_file> m_file{};
+    uint8_t const* m_data{ nullptr };
+    uint64_t m_size{ 0 };
+    vector<pack_entry> m_entries{};
+    // The decompressed entries; the stored ones are not cached,
+    // because their buffers hold the pack.
+    vector<xaml_ptr<xaml_buffer>> m_buffers{};
+    mutex m_mutex{};
+
+    xaml_resource_pack_impl(uint8_t const* data, uint64_t size, unique_ptr<mapped_file>&& file = {}) noexcept
+        : m_file(move(file)), m_data(data), m_size(size) {}
+
+    xaml_result init() noexcept
+    try
+    {
+        uint8_t const* data = m_data;
+        uint64_t size = m_size;
+        pack_header header;
+        if (size < sizeof(header)) return XAML_E_INVALIDARG;
+        memcpy(&header, data, sizeof(header));
+        if (memcmp(header.magic, pack_magic, sizeof(pack_magic)) || header.version != pack_version) return XAML_E_INVALIDARG;
+        if (header.count > (size - sizeof(header)) / sizeof(pack_entry)) return XAML_E_INVALIDARG;
+        m_entries.resize(header.count);
+        memcpy(m_entries.data(), data + sizeof(header), sizeof(pack_entry) * header.count);
+        for (auto& e : m_entries)
+        {
+            if (e.path_offset > size || e.path_length > size - e.path_offset) return XAML_E_INVALIDARG;
+            if (e.offset > size || e.packed_size > size - e.offset) return XAML_E_INVALIDARG;
+            if (e.codec == pack_codec::stored && e.packed_size != e.size) return XAML_E_INVALIDARG;
+        }
+        m_buffers.resize(header.count);
+        return XAML_S_OK;
+    }
+    XAML_CATCH_RETURN()
+
+    xaml_result XAML_CALL get(xaml_string* path, xaml_buffer** ptr) noexcept override
+    {
+        string_view view;
+        XAML_RETURN_IF_FAILED(to_string_view(path, &view));
+        return get_hashed(path, xaml_resource_hash(view.data(), view.size()), ptr);
+    }
+
+    xaml_result XAML_CALL get_hashed(xaml_string* path, uint64_t hash, xaml_buffer** ptr) noexcept override
+    {
+        string_view view;
+        XAML_RETURN_IF_FAILED(to_string_view(path, &view));
+        auto it = lower_bound(m_entries.begin(), m_entries.end(), hash, [](pack_entry const& e, uint64_t hash) { return e.hash < hash; });
+        if (it == m_entries.end() || it->hash != hash) return XAML_E_KEYNOTFOUND;
+        if (view != string_view{ reinterpret_cast<char const*>(m_data + it->path_offset), it->path_length }) return XAML_E_KEYNOTFOUND;
+        if (it->size > static_cast<uint64_t>(INT32_MAX)) return XAML_E_OUTOFBOUNDS;
+        int32_t size = static_cast<int32_t>(it->size);
+        uint8_t const* data = m_data + it->offset;
+        switch (it->codec)
+        {
+        case pack_codec::stored:
+            return xaml_object_new<xaml_resource_pack_buffer_impl>(ptr, this, const_cast<uint8_t*>(data), size);
+        case pack_codec::lz4:
+        {
+            lock_guard<mutex> lock{ m_mutex };
+            auto& buffer = m_buffers[it - m_entries.begin()];
+            if (!buffer)
+            {
+                xaml_ptr<xaml_buffer> decompressed;
+                XAML_RETURN_IF_FAILED(xaml_buffer_new(size, &decompressed));
+                uint8_t* dst;
+                XAML_RETURN_IF_FAILED(decompressed->get_data(&dst));
+                if (!lz4_decompress(data, static_cast<size_t>(it->packed_size), dst, static_cast<size_t>(size))) return XAML_E_FAIL;
+                buffer = decompressed;
+            }
+            return buffer.query(ptr);
+        }
+        default:
+            return XAML_E_NOTIMPL;
+        }
+    }
+};
+
+xaml_result XAML_CALL xaml_resource_pack_open(void const* data, int64_t size, xaml_resource_pack** ptr) noexcept
+{
+    if (size < 0) return XAML_E_INVALIDARG;
+    return xaml_object_new_and_init<xaml_resource_pack_impl>(ptr, static_cast<uint8_t const*>(data), static_cast<uint64_t>(size));
+}
+
+xaml_result XAML_CALL xaml_resource_pack_open_file(xaml_string* path, xaml_resource_pack** ptr) noexcept
+try
+{
+    string_view view;
+    XAML_RETURN_IF_FAILED(to_string_view(path, &view));
+    auto file = make_unique<mapped_file>();
+    xaml_result hr = file->open(view);
+    if (XAML_FAILED(hr)) return hr;
+    auto data = static_cast<uint8_t const*>(file->m_data);
+    uint64_t size = file->m_size;
+    return xaml_object_new_and_init<xaml_resource_pack_impl>(ptr, data, size, move(file));
+}
+XAML_CATCH_RETURN()
+
+// Gets the directory of the executable, with a trailing separator.
+static xaml_result get_app_dir(string* pdir) noexcept
+try
+{
+#ifdef XAML_WIN32
+    wstring wpath(MAX_PATH, L'\0');
+    while (true)
+    {
+        DWORD size = GetModuleFileNameW(nullptr, wpath.data(), static_cast<DWORD>(wpath.size()));
+        if (!size) return HRESULT_FROM_WIN32(GetLastError());
+        if (size < wpath.size())
+        {
+            wpath.resize(size);
+            break;
+        }
+        wpath.resize(wpath.size() * 2);
+    }
+    string path = nowide::narrow(wpath);
+#elif defined(XAML_APPLE)
+    uint32_t size = 0;
+    _NSGetExecutablePath(nullptr, &size);
+    string path(size, '\0');
+    if (_NSGetExecutablePath(path.data(), &size)) return XAML_E_FAIL;
+    path.resize(strlen(path.c_str()));
+#else
+    string path(PATH_MAX, '\0');
+    while (true)
+    {
+        ssize_t size = readlink("/proc/self/exe", path.data(), path.size());
+        if (size == -1) return xaml_result_from_errno(errno);
+        // The link is truncated silently if the buffer is not large enough.
+        if (static_cast<size_t>(size) < path.size())
+        {
+            path.resize(static_cast<size_t>(size));
+            break;
+        }
+        path.resize(path.size() * 2);
+    }
+#endif // XAML_WIN32
+#ifdef XAML_WIN32
+    size_t index = path.find_last_of("\\/");
+#else
+    size_t index = path.rfind('/');
+#endif // XAML_WIN32
+    path.resize(index == string::npos ? 0 : index + 1);
+    *pdir = move(path);
+    return XAML_S_OK;
+}
+XAML_CATCH_RETURN()
+
+xaml_result XAML_CALL xaml_resource_pack_open_app_file(xaml_string* name, xaml_resource_pack** ptr) noexcept
+try
+{
+    string_view view;
+    XAML_RETURN_IF_FAILED(to_string_view(name, &view));
+    string path;
+    XAML_RETURN_IF_FAILED(get_app_dir(&path));
+    path += view;
+    xaml_ptr<xaml_string> path_str;
+    XAML_RETURN_IF_FAILED(xaml_string_new(move(path), &path_str));
+    return xaml_resource_pack_open_file(path_str, ptr);
+}
+XAML_CATCH_RETURN()
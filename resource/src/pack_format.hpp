@@ -0,0 +1,44 @@
+#ifndef XAML_RESOURCE_PACK_FORMAT_HPP
+#define XAML_RESOURCE_PACK_FORMAT_HPP
+
+#include <cstdint>
+
+// The layout of a resource pack, in little endian:
+// the header, the entries sorted by the hashes of the paths,
+// the paths, and the data of the entries, each aligned to 8 bytes.
+// The offsets are from the start of the pack.
+
+inline constexpr char pack_magic[4] = { 'X', 'R', 'P', 'K' };
+inline constexpr std::uint32_t pack_version = 1;
+
+enum class pack_codec : std::uint32_t
+{
+    stored,
+    lz4
+};
+
+struct pack_header
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t count;
+    std::uint32_t reserved;
+};
+
+struct pack_entry
+{
+    // The hash by xaml_resource_hash.
+    std::uint64_t hash;
+    std::uint64_t offset;
+    std::uint64_t packed_size;
+    std::uint64_t size;
+    std::uint32_t path_offset;
+    std::uint32_t path_length;
+    pack_codec codec;
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(pack_header) == 16);
+static_assert(sizeof(pack_entry) == 48);
+
+#endif // !XAML_RESOURCE_PACK_FORMAT_HPP
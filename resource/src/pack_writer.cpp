@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <cstring>
+#include <lz4.hpp>
+#include <pack_format.hpp>
+#include <pack_writer.hpp>
+#include <stdexcept>
+#include <xaml/resource/resource.h>
+
+using namespace std;
+
+static size_t align8(size_t offset) noexcept
+{
+    return (offset + 7) & ~size_t{ 7 };
+}
+
+template <typename T>
+static void write_at(vector<uint8_t>& out, size_t offset, T const& value) noexcept
+{
+    memcpy(out.data() + offset, &value, sizeof(T));
+}
+
+vector<uint8_t> pack_write(vector<pack_writer_item> const& items, bool compress)
+{
+    struct item_ref
+    {
+        pack_writer_item const* item;
+        uint64_t hash;
+    };
+    vector<item_ref> refs;
+    for (auto& item : items)
+    {
+        refs.push_back({ &item, xaml_resource_hash(item.path.data(), item.path.size()) });
+    }
+    sort(refs.begin(), refs.end(), [](item_ref const& lhs, item_ref const& rhs) { return lhs.hash < rhs.hash; });
+    for (size_t i = 1; i < refs.size(); i++)
+    {
+        if (refs[i].hash == refs[i - 1].hash)
+            throw runtime_error{ "Resource paths " + refs[i - 1].item->path + " and " + refs[i].item->path + " have the same hash." };
+    }
+
+    size_t offset = sizeof(pack_header) + sizeof(pack_entry) * refs.size();
+    vector<pack_entry> entries(refs.size());
+    for (size_t i = 0; i < refs.size(); i++)
+    {
+        auto& path = refs[i].item->path;
+        entries[i].hash = refs[i].hash;
+        entries[i].path_offset = static_cast<uint32_t>(offset);
+        entries[i].path_length = static_cast<uint32_t>(path.size());
+        offset += path.size();
+    }
+
+    vector<uint8_t> out(offset);
+    pack_header header{};
+    memcpy(header.magic, pack_magic, sizeof(pack_magic));
+    header.version = pack_version;
+    header.count = static_cast<uint32_t>(refs.size());
+    write_at(out, 0, header);
+    for (size_t i = 0; i < refs.size(); i++)
+    {
+        auto& data = refs[i].item->data;
+        auto& entry = entries[i];
+        vector<uint8_t> packed;
+        if (compress) packed = lz4_compress(data.data(), data.size());
+        bool stored = !compress || packed.size() >= data.size();
+        auto& written = stored ? data : packed;
+        entry.codec = stored ? pack_codec::stored : pack_codec::lz4;
+        entry.size = data.size();
+        entry.packed_size = written.size();
+        entry.offset = align8(out.size());
+        out.resize(entry.offset);
+        out.insert(out.end(), written.begin(), written.end());
+        memcpy(out.data() + entry.path_offset, refs[i].item->path.data(), entry.path_length);
+    }
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        write_at(out, sizeof(pack_header) + sizeof(pack_entry) * i, entries[i]);
+    }
+    return out;
+}
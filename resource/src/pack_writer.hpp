@@ -0,0 +1,18 @@
+#ifndef XAML_RESOURCE_PACK_WRITER_HPP
+#define XAML_RESOURCE_PACK_WRITER_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct pack_writer_item
+{
+    std::string path;
+    std::vector<std::uint8_t> data;
+};
+
+// Writes the items into a pack, compressing each of them unless it does not get smaller.
+// Throws if two paths have the same hash.
+std::vector<std::uint8_t> pack_write(std::vector<pack_writer_item> const& items, bool compress);
+
+#endif // !XAML_RESOURCE_PACK_WRITER_HPP
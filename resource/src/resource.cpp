@@ -0,0 +1,18 @@
+#include <atomic>
+#include <xaml/resource/resource.h>
+
+using namespace std;
+
+static atomic<xaml_resource_getter> s_getter{ nullptr };
+
+void XAML_CALL xaml_resource_register(xaml_resource_getter getter) noexcept
+{
+    s_getter.store(getter, memory_order_release);
+}
+
+xaml_result XAML_CALL xaml_resource_find_hashed(xaml_string* path, uint64_t hash, void const** pdata, int64_t* psize) noexcept
+{
+    xaml_resource_getter getter = s_getter.load(memory_order_acquire);
+    if (!getter) return XAML_E_KEYNOTFOUND;
+    return getter(path, hash, pdata, psize);
+}
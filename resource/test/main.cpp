@@ -0,0 +1,175 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <pack_writer.hpp>
+#include <random>
+#include <test_check.hpp>
+#include <xaml/resource/pack.h>
+#include <xaml/resource/resource.h>
+
+using namespace std;
+
+// Round trips a pack through the memory and a file,
+// and prints the ratio and the latencies of the first and the cached access.
+
+static vector<pack_writer_item> make_items()
+{
+    vector<pack_writer_item> items;
+    // Text compresses well.
+    string text;
+    for (int i = 0; i < 20000; i++) text += "<label margin=\"10\" text=\"item " + to_string(i % 100) + "\"/>\n";
+    items.push_back({ "view/large.xaml", { text.begin(), text.end() } });
+    // Random bytes do not, and are stored.
+    mt19937 rng{ 42 };
+    vector<uint8_t> noise(100000);
+    for (auto& b : noise) b = static_cast<uint8_t>(rng());
+    items.push_back({ "images/noise.bin", noise });
+    items.push_back({ "empty.txt", {} });
+    items.push_back({ U("中文/路径.txt"), { 'a', 'b', 'c' } });
+    return items;
+}
+
+static bool buffer_is(xaml_buffer* buffer, vector<uint8_t> const& expected)
+{
+    int32_t size;
+    XAML_ASSERT_SUCCEEDED(buffer->get_size(&size));
+    uint8_t* data;
+    XAML_ASSERT_SUCCEEDED(buffer->get_data(&data));
+    return static_cast<size_t>(size) == expected.size() && (expected.empty() || memcmp(data, expected.data(), expected.size()) == 0);
+}
+
+static xaml_ptr<xaml_string> make_string(string const& str)
+{
+    xaml_ptr<xaml_string> result;
+    XAML_ASSERT_SUCCEEDED(xaml_string_new(str, &result));
+    return result;
+}
+
+static void check_pack(xaml_resource_pack* pack, vector<pack_writer_item> const& items)
+{
+    for (auto& item : items)
+    {
+        xaml_ptr<xaml_buffer> buffer;
+        CHECK_OK(pack->get(make_string(item.path), &buffer));
+        CHECK(buffer && buffer_is(buffer, item.data));
+    }
+    xaml_ptr<xaml_buffer> missing, mismatched;
+    CHECK(pack->get(make_string("missing.txt"), &missing) == (xaml_result)XAML_E_KEYNOTFOUND);
+    // The hash matches, but the path does not.
+    auto& path = items[0].path;
+    CHECK(pack->get_hashed(make_string("other"), xaml_resource_hash(path.data(), path.size()), &mismatched) == (xaml_result)XAML_E_KEYNOTFOUND);
+}
+
+static void test_memory(vector<pack_writer_item> const& items, vector<uint8_t> const& packed, bool compressed)
+{
+    xaml_ptr<xaml_resource_pack> pack;
+    XAML_ASSERT_SUCCEEDED(xaml_resource_pack_open(packed.data(), static_cast<int64_t>(packed.size()), &pack));
+    check_pack(pack, items);
+
+    // The decompressed buffer is cached, and the stored one refers to the pack.
+    auto path = make_string(items[0].path);
+    xaml_ptr<xaml_buffer> first, second;
+    CHECK_OK(pack->get(path, &first));
+    CHECK_OK(pack->get(path, &second));
+    CHECK((first.get() == second.get()) == compressed);
+
+    // Malformed packs are rejected.
+    xaml_ptr<xaml_resource_pack> short_pack;
+    CHECK(XAML_FAILED(xaml_resource_pack_open(packed.data(), 8, &short_pack)));
+    vector<uint8_t> bad = packed;
+    bad[0] = 'Y';
+    xaml_ptr<xaml_resource_pack> bad_pack;
+    CHECK(XAML_FAILED(xaml_resource_pack_open(bad.data(), static_cast<int64_t>(bad.size()), &bad_pack)));
+}
+
+static void test_file(vector<pack_writer_item> const& items, vector<uint8_t> const& packed)
+{
+    char const* name = "resource_test.xrpk";
+    {
+        ofstream stream{ name, ios_base::binary };
+        stream.write(reinterpret_cast<char const*>(packed.data()), packed.size());
+    }
+    xaml_ptr<xaml_resource_pack> pack;
+    CHECK_OK(xaml_resource_pack_open_file(make_string(name), &pack));
+    if (pack) check_pack(pack, items);
+    pack = nullptr;
+    remove(name);
+    xaml_ptr<xaml_resource_pack> missing;
+    CHECK(XAML_FAILED(xaml_resource_pack_open_file(make_string(name), &missing)));
+}
+
+// The test is run from the build directory, not the directory of the executable.
+static void test_app_file(vector<pack_writer_item> const& items, vector<uint8_t> const& packed, char const* argv0)
+{
+    string file = argv0;
+    size_t index = file.find_last_of("\\/");
+    if (index == string::npos) return;
+    char const* name = "resource_test_app.xrpk";
+    file = file.substr(0, index + 1) + name;
+    {
+        ofstream stream{ file, ios_base::binary };
+        stream.write(reinterpret_cast<char const*>(packed.data()), packed.size());
+    }
+    xaml_ptr<xaml_resource_pack> pack;
+    CHECK_OK(xaml_resource_pack_open_app_file(make_string(name), &pack));
+    if (pack) check_pack(pack, items);
+    pack = nullptr;
+    remove(file.c_str());
+    xaml_ptr<xaml_resource_pack> missing;
+    CHECK(XAML_FAILED(xaml_resource_pack_open_app_file(make_string(name), &missing)));
+}
+
+static void bench(vector<pack_writer_item> const& items)
+{
+    size_t raw = 0;
+    for (auto& item : items) raw += item.data.size();
+    auto packed = pack_write(items, true);
+    cout << "packed " << raw << " bytes to " << packed.size() << " bytes" << endl;
+
+    constexpr int rounds = 100;
+    auto path = make_string(items[0].path);
+    double first_time = 0, cached_time = 0;
+    for (int i = 0; i < rounds; i++)
+    {
+        xaml_ptr<xaml_resource_pack> pack;
+        XAML_ASSERT_SUCCEEDED(xaml_resource_pack_open(packed.data(), static_cast<int64_t>(packed.size()), &pack));
+        xaml_ptr<xaml_buffer> first, second;
+        auto start = chrono::steady_clock::now();
+        XAML_ASSERT_SUCCEEDED(pack->get(path, &first));
+        auto middle = chrono::steady_clock::now();
+        XAML_ASSERT_SUCCEEDED(pack->get(path, &second));
+        auto end = chrono::steady_clock::now();
+        first_time += chrono::duration<double>(middle - start).count();
+        cached_time += chrono::duration<double>(end - middle).count();
+    }
+    cout << items[0].data.size() << " bytes text, first access: " << first_time / rounds * 1e6 << " us, cached: " << cached_time / rounds * 1e6 << " us" << endl;
+}
+
+int main(int, char** argv)
+{
+    auto items = make_items();
+    for (bool compress : { false, true })
+    {
+        auto packed = pack_write(items, compress);
+        test_memory(items, packed, compress);
+        test_file(items, packed);
+        test_app_file(items, packed, argv[0]);
+    }
+    // Paths with the same hash could not be told apart.
+    auto same = items;
+    same.push_back(same[0]);
+    bool thrown = false;
+    try
+    {
+        pack_write(same, true);
+    }
+    catch (runtime_error const&)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+    bench(items);
+    return report_failures();
+}
@@ -21,7 +21,11 @@ XAML_CLASS(xaml_rc_options, { 0x50dd3e88, 0x5d41, 0x4418, { 0x90, 0x96, 0x7f, 0x
     XAML_VTBL_INHERIT(XAML_CMDLINE_OPTIONS_BASE_VTBL(type));               \
     XAML_METHOD(get_inputs, type, XAML_VECTOR_VIEW_1_NAME(xaml_string)**); \
     XAML_CPROP(input, type, xaml_string*, xaml_string*);                   \
-    XAML_PROP(output, type, xaml_string**, xaml_string*)
+    XAML_PROP(output, type, xaml_string**, xaml_string*);                  \
+    XAML_PROP(pack, type, bool*, bool);                                    \
+    XAML_PROP(pack_file, type, xaml_string**, xaml_string*);               \
+    XAML_PROP(stats, type, bool*, bool);                                   \
+    XAML_PROP(binary, type, xaml_string**, xaml_string*)
 
 XAML_DECL_INTERFACE_(xaml_rc_options, xaml_cmdline_options_base)
 {
@@ -1,14 +1,21 @@
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
+#include <iterator>
 #include <map>
 #include <nowide/args.hpp>
 #include <nowide/filesystem.hpp>
 #include <nowide/fstream.hpp>
 #include <nowide/iostream.hpp>
+#include <optional>
 #include <options.h>
+#include <pack_writer.hpp>
 #include <sf/format.hpp>
 #include <sstream>
+#include <stdexcept>
 #include <tuple>
+#include <vector>
+#include <xaml/resource/resource.h>
 
 using namespace std;
 using nowide::filesystem::path;
@@ -28,23 +35,157 @@ string get_valid_name(string_view str, size_t index)
     return stream.str();
 }
 
+// A narrow literal with the exact bytes of the string,
+// so that it does not depend on the execution character set.
+string get_literal(string_view str)
+{
+    ostringstream stream;
+    stream << '"';
+    for (char c : str)
+    {
+        unsigned char b = (unsigned char)c;
+        if (c == '"' || c == '\\')
+            stream << '\\' << c;
+        else if (b >= 0x20 && b < 0x7F)
+            stream << c;
+        else
+            stream << '\\' << oct << setw(3) << setfill('0') << (int)b << dec;
+    }
+    stream << '"';
+    return stream.str();
+}
+
+struct rc_entry
+{
+    string key;
+    string name;
+    uint64_t hash;
+};
+
+// A table indexed by a perfect hash, built by hash and displace:
+// a key is in the bucket hash % buckets, and all keys of a bucket are placed
+// with the displacement of the bucket, which is searched until none of them collides.
+struct rc_table
+{
+    vector<uint32_t> displacements;
+    // The index of the entry in each slot, or -1 if empty.
+    vector<ptrdiff_t> slots;
+};
+
+rc_table build_table(vector<rc_entry> const& entries)
+{
+    size_t buckets = entries.size() / 4 + 1;
+    vector<vector<size_t>> bucket_keys(buckets);
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        bucket_keys[entries[i].hash % buckets].push_back(i);
+    }
+    vector<size_t> order(buckets);
+    for (size_t i = 0; i < buckets; i++) order[i] = i;
+    // The larger buckets are harder to place, so place them first.
+    stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) { return bucket_keys[lhs].size() > bucket_keys[rhs].size(); });
+    // Some room keeps the search short; the table grows if it fails.
+    for (size_t size = entries.size() + entries.size() / 4 + 1;; size += size / 4 + 1)
+    {
+        rc_table table{ vector<uint32_t>(buckets), vector<ptrdiff_t>(size, -1) };
+        bool placed = true;
+        for (size_t b : order)
+        {
+            auto& keys = bucket_keys[b];
+            if (keys.empty()) break;
+            placed = false;
+            for (uint32_t d = 0; d < 0x10000 && !placed; d++)
+            {
+                vector<size_t> slots;
+                for (size_t k : keys)
+                {
+                    size_t slot = xaml_resource_hash_mix(entries[k].hash, d) % size;
+                    if (table.slots[slot] >= 0 || find(slots.begin(), slots.end(), slot) != slots.end()) break;
+                    slots.push_back(slot);
+                }
+                if (slots.size() == keys.size())
+                {
+                    for (size_t i = 0; i < keys.size(); i++) table.slots[slots[i]] = (ptrdiff_t)keys[i];
+                    table.displacements[b] = d;
+                    placed = true;
+                }
+            }
+            if (!placed) break;
+        }
+        if (placed) return table;
+    }
+}
+
 constexpr string_view tab = "    ";
 constexpr string_view text_extensions[] = { ".txt", ".xml", ".xaml", ".md" };
 
-void compile(ostream& stream, xaml_ptr<xaml_vector_view<xaml_string>> const& inputs)
+struct rc_resource
 {
-    sf::println(stream, "#include <xaml/resource/resource.h>");
+    string key;
+    string name;
+    // The absolute path, referred by the generated code when not embedded as hex.
+    path file;
+    bool text;
+    // The bytes as embedded, with a terminating zero for a text file.
+    vector<uint8_t> data;
+    // The hash of the data, which tells whether the file changed.
+    uint64_t hash;
+};
 
+// How the binary files are embedded.
+// The text files are always string literals, which compile fast enough.
+enum class rc_binary
+{
+    // An array initialized by hex literals, which any compiler accepts but parses slowly.
+    hex,
+    // The .incbin directive of the GNU assembler, in a top level asm statement.
+    incbin,
+    // The #embed directive of C23, supported by newer compilers in C++ too.
+    embed
+};
+
+struct rc_options
+{
+    bool pack;
+    optional<string> pack_file;
+    bool stats;
+    rc_binary binary;
+};
+
+optional<rc_binary> get_binary(string_view str)
+{
+    if (str.empty() || str == "hex") return rc_binary::hex;
+    if (str == "incbin") return rc_binary::incbin;
+    if (str == "embed") return rc_binary::embed;
+    return nullopt;
+}
+
+string_view get_binary_name(rc_binary binary)
+{
+    switch (binary)
+    {
+    case rc_binary::incbin:
+        return "incbin";
+    case rc_binary::embed:
+        return "embed";
+    default:
+        return "hex";
+    }
+}
+
+vector<rc_resource> read_resources(xaml_ptr<xaml_vector_view<xaml_string>> const& inputs)
+{
     size_t index{ 0 };
-    map<path, string> rc_map{};
+    map<path, size_t> rc_map{};
+    vector<rc_resource> resources;
 
     for (auto item : inputs)
     {
         path file = to_string_view(item);
 #ifndef XAML_APPLE
-        if (!rc_map.contains(file))
+        if (!rc_map.contains(file.relative_path()))
 #else
-        auto it = rc_map.find(file);
+        auto it = rc_map.find(file.relative_path());
         if (it == rc_map.end())
 #endif // !XAML_APPLE
         {
@@ -55,67 +196,367 @@ void compile(ostream& stream, xaml_ptr<xaml_vector_view<xaml_string>> const& inp
             nowide::ifstream input{ file, mode };
             if (input.is_open())
             {
-                string name = get_valid_name(file.string(), index++);
-                rc_map.emplace(file.relative_path(), name);
-                if (text)
-                {
-                    sf::println(stream, "inline static constexpr char const {}[] = ", name);
-                    sf::print(stream, "u8");
-                    string line;
-                    while (getline(input, line))
-                    {
-                        sf::print(stream, quoted(line));
-                        if (!input.eof())
-                        {
-                            sf::println(stream, "\"\\n\"");
-                        }
-                    }
-                }
-                else
-                {
-                    sf::print(stream, "inline static constexpr ::std::uint8_t const {}[] = {{", name);
-                    size_t i = 0;
-                    while (input.peek() != char_traits<char>::eof())
-                    {
-                        i %= 16;
-                        if (i++ == 0) sf::println(stream);
-                        int b = input.get();
-                        sf::print(stream, "{:x,s}", b);
-                        if (input.peek() != char_traits<char>::eof()) sf::print(stream, ", ");
-                    }
-                }
-                sf::println(stream, ';');
+                string content{ istreambuf_iterator<char>{ input }, istreambuf_iterator<char>{} };
+                vector<uint8_t> data{ content.begin(), content.end() };
+                if (text) data.push_back(0);
+                uint64_t hash = xaml_resource_hash(reinterpret_cast<char const*>(data.data()), data.size());
+                rc_map.emplace(file.relative_path(), resources.size());
+                resources.push_back({ file.relative_path().string(), get_valid_name(file.string(), index++), absolute(file), text, move(data), hash });
             }
         }
     }
+    return resources;
+}
 
-    sf::println(stream, "xaml_result XAML_CALL xaml_resource_get(xaml_string* path, void const** pdata, std::int32_t* psize) noexcept\n{");
+// Writes the bytes as the elements of an array, 16 in a line.
+// It is the most of the output, so the digits are not formatted one by one.
+void write_bytes(ostream& stream, uint8_t const* data, size_t size)
+{
+    static constexpr char digits[] = "0123456789abcdef";
+    string line;
+    for (size_t i = 0; i < size; i += 16)
+    {
+        line.clear();
+        for (size_t j = i; j < size && j < i + 16; j++)
+        {
+            line += "0x";
+            line += digits[data[j] >> 4];
+            line += digits[data[j] & 0xF];
+            if (j + 1 < size) line += ", ";
+        }
+        stream << '\n'
+               << line;
+    }
+}
 
-    sf::println(stream, "{}std::string_view file;", tab);
-    sf::println(stream, "{}XAML_RETURN_IF_FAILED(to_string_view(path, &file));", tab);
+string get_hash_string(uint64_t hash)
+{
+    static constexpr char digits[] = "0123456789abcdef";
+    string str(16, '0');
+    for (size_t i = 0; i < 16; i++) str[15 - i] = digits[(hash >> (i * 4)) & 0xF];
+    return str;
+}
+
+// The path as the generated code refers to it.
+string get_binary_path(rc_resource const& res)
+{
+    string file = res.file.generic_string();
+    if (file.find_first_of("\"\n") != string::npos) throw runtime_error{ sf::sprint(U("Cannot refer to {} from the generated code."), file) };
+    return file;
+}
+
+// The symbols are defined by the assembler, so the directives depend on the object format.
+// The section is pushed and popped, as the compiler expects it unchanged after the asm.
+constexpr string_view incbin_prologue = R"(#if defined(_MSC_VER) && !defined(__clang__)
+    #error "The incbin output needs the GNU assembler syntax; generate it with --binary hex or embed."
+#elif defined(__APPLE__)
+    #define __XAML_RC_SECTION ".pushsection __DATA,__const\n"
+    #define __XAML_RC_SYMBOL(name) ".globl _" #name "\n.private_extern _" #name "\n_" #name ":\n"
+#elif defined(_WIN32)
+    #define __XAML_RC_SECTION ".pushsection .rdata,\"dr\"\n"
+    #if defined(_WIN64)
+        #define __XAML_RC_SYMBOL(name) ".globl " #name "\n" #name ":\n"
+    #else
+        #define __XAML_RC_SYMBOL(name) ".globl _" #name "\n_" #name ":\n"
+    #endif
+#else
+    #define __XAML_RC_SECTION ".pushsection .rodata\n"
+    #define __XAML_RC_SYMBOL(name) ".globl " #name "\n.hidden " #name "\n" #name ":\n"
+#endif)";
+
+constexpr string_view embed_prologue = R"(#ifndef __has_embed
+    #error "The compiler does not support #embed; generate the output with --binary hex or incbin."
+#endif)";
 
-    size_t i = 0;
-    for (auto pair : rc_map)
+void write_resource(ostream& stream, rc_resource const& res, rc_binary binary)
+{
+    if (res.text)
+    {
+        sf::println(stream, "inline static constexpr char const {}[] = ", res.name);
+        sf::print(stream, "u8");
+        string_view content{ reinterpret_cast<char const*>(res.data.data()), res.data.size() - 1 };
+        if (content.empty()) sf::print(stream, "\"\"");
+        while (!content.empty())
+        {
+            size_t end = content.find('\n');
+            sf::print(stream, quoted(content.substr(0, end)));
+            if (end == string_view::npos) break;
+            content.remove_prefix(end + 1);
+            sf::println(stream, "\"\\n\"");
+        }
+    }
+    else if (binary == rc_binary::incbin)
+    {
+        // The hash changes the source when the file changes,
+        // as the compiler does not know that the object depends on the file.
+        sf::println(stream, "// {}", get_hash_string(res.hash));
+        sf::println(stream, "extern \"C\" ::std::uint8_t const {}[{}];", res.name, res.data.size());
+        string directive = ".incbin \"" + get_binary_path(res) + "\"\n.popsection";
+        sf::print(stream, "__asm__(__XAML_RC_SECTION \".balign 8\\n\" __XAML_RC_SYMBOL({}) {})", res.name, get_literal(directive));
+    }
+    else if (binary == rc_binary::embed)
+    {
+        sf::println(stream, "// {}", get_hash_string(res.hash));
+        sf::println(stream, "inline static constexpr ::std::uint8_t const {}[] = {{", res.name);
+        // The path is not unescaped, like that of #include.
+        sf::println(stream, "#embed \"{}\"", get_binary_path(res));
+        sf::print(stream, "}");
+    }
+    else
+    {
+        sf::print(stream, "inline static constexpr ::std::uint8_t const {}[] = {{", res.name);
+        write_bytes(stream, res.data.data(), res.data.size());
+        sf::print(stream, " }");
+    }
+    sf::println(stream, ';');
+}
+
+void write_table(ostream& stream, vector<rc_resource> const& resources)
+{
+    vector<rc_entry> entries;
+    for (auto& res : resources)
+    {
+        uint64_t hash = xaml_resource_hash(res.key.data(), res.key.size());
+        for (auto& e : entries)
+        {
+            if (e.hash == hash) throw runtime_error{ sf::sprint(U("Resource paths {} and {} have the same hash."), e.key, res.key) };
+        }
+        entries.push_back({ res.key, res.name, hash });
+    }
+
+    sf::println(stream, "xaml_result XAML_CALL xaml_resource_get_hashed(xaml_string* path, std::uint64_t hash, void const** pdata, std::int64_t* psize) noexcept\n{");
+    if (entries.empty())
+    {
+        sf::println(stream, "{}return XAML_E_KEYNOTFOUND;", tab);
+    }
+    else
     {
-        sf::println(stream, "{}{}if (file == U({}))", tab, i++ ? "else " : "", pair.first);
+        rc_table table = build_table(entries);
+        sf::println(stream, "{}struct entry_t", tab);
         sf::println(stream, "{}{{", tab);
+        sf::println(stream, "{0}{0}std::uint64_t hash;", tab);
+        sf::println(stream, "{0}{0}char const* path;", tab);
+        sf::println(stream, "{0}{0}std::size_t length;", tab);
+        sf::println(stream, "{0}{0}void const* data;", tab);
+        sf::println(stream, "{0}{0}std::int64_t size;", tab);
+        sf::println(stream, "{}}};", tab);
+
+        sf::print(stream, "{}static constexpr std::uint32_t displacements[] = {{ ", tab);
+        for (size_t i = 0; i < table.displacements.size(); i++)
+        {
+            sf::print(stream, "{}{}", i ? ", " : "", table.displacements[i]);
+        }
+        sf::println(stream, " };");
 
-        sf::println(stream, "{0}{0}*pdata = reinterpret_cast<void const*>({});", tab, pair.second);
-        sf::println(stream, "{0}{0}*psize = static_cast<std::int32_t>(sizeof({}));", tab, pair.second);
+        sf::println(stream, "{}static constexpr entry_t entries[] = {{", tab);
+        for (ptrdiff_t index : table.slots)
+        {
+            if (index < 0)
+            {
+                sf::println(stream, "{0}{0}{{}},", tab);
+            }
+            else
+            {
+                auto& e = entries[index];
+                sf::println(stream, "{0}{0}{{ {1}u, {2}, {3}, {4}, static_cast<std::int64_t>(sizeof({4})) }},", tab, e.hash, get_literal(e.key), e.key.size(), e.name);
+            }
+        }
+        sf::println(stream, "{}}};", tab);
 
-        sf::println(stream, "{}}}", tab);
+        sf::println(stream, "{}std::string_view file;", tab);
+        sf::println(stream, "{}XAML_RETURN_IF_FAILED(to_string_view(path, &file));", tab);
+        sf::println(stream, "{}entry_t const& e = entries[xaml_resource_hash_mix(hash, displacements[hash % {}]) % {}];", tab, table.displacements.size(), table.slots.size());
+        sf::println(stream, "{}if (!e.data || e.hash != hash || std::string_view{{ e.path, e.length }} != file) return XAML_E_KEYNOTFOUND;", tab);
+        sf::println(stream, "{}*pdata = e.data;", tab);
+        sf::println(stream, "{}*psize = e.size;", tab);
+        sf::println(stream, "{}return XAML_S_OK;", tab);
+    }
+    sf::println(stream, '}');
+
+    sf::println(stream, "xaml_result XAML_CALL xaml_resource_get_buffer(xaml_string* path, xaml_buffer** ptr) noexcept\n{");
+    sf::println(stream, "{}std::string_view file;", tab);
+    sf::println(stream, "{}XAML_RETURN_IF_FAILED(to_string_view(path, &file));", tab);
+    sf::println(stream, "{}void const* data;", tab);
+    sf::println(stream, "{}std::int64_t size;", tab);
+    // A missing resource is an expected result, so the lookups return it without raising.
+    sf::println(stream, "{}xaml_result hr = xaml_resource_get_hashed(path, xaml_resource_hash(file.data(), file.size()), &data, &size);", tab);
+    sf::println(stream, "{}if (XAML_FAILED(hr)) return hr;", tab);
+    sf::println(stream, "{}if (size > INT32_MAX) return XAML_E_OUTOFBOUNDS;", tab);
+    sf::println(stream, "{}return xaml_buffer_new_reference(static_cast<std::uint8_t*>(const_cast<void*>(data)), static_cast<std::int32_t>(size), ptr);", tab);
+    sf::println(stream, '}');
+}
+
+// The generated functions load the pack on the first access, and keep it till the exit.
+void write_pack(ostream& stream, vector<uint8_t> const& pack, optional<string> const& pack_file)
+{
+    sf::println(stream, "static xaml_result load_pack(xaml_resource_pack** ptr) noexcept\n{");
+    if (pack_file)
+    {
+        sf::println(stream, "{}xaml_ptr<xaml_string> file;", tab);
+        // The pack is expected beside the executable, rather than where it is written,
+        // so that neither the current directory nor the installation moves it.
+        sf::println(stream, "{}XAML_RETURN_IF_FAILED(xaml_string_new_view({}, &file));", tab, get_literal(path(*pack_file).filename().string()));
+        sf::println(stream, "{}return xaml_resource_pack_open_app_file(file, ptr);", tab);
     }
+    else
+    {
+        sf::println(stream, "{}alignas(8) static constexpr std::uint8_t data[] = {{", tab);
+        write_bytes(stream, pack.data(), pack.size());
+        sf::println(stream, " };");
+        sf::println(stream, "{}return xaml_resource_pack_open(data, static_cast<std::int64_t>(sizeof(data)), ptr);", tab);
+    }
+    sf::println(stream, '}');
 
-    if (!rc_map.empty()) sf::println(stream, "{}else", tab);
-    sf::println(stream, "{}{{", tab);
-    sf::println(stream, "{0}{0}return XAML_E_KEYNOTFOUND;", tab);
-    sf::println(stream, "{}}}", tab);
+    sf::println(stream, "static xaml_result current_pack(xaml_resource_pack** ptr) noexcept\n{");
+    sf::println(stream, "{}static xaml_ptr<xaml_resource_pack> pack;", tab);
+    sf::println(stream, "{}static xaml_result loaded = load_pack(&pack);", tab);
+    sf::println(stream, "{}if (XAML_FAILED(loaded)) return loaded;", tab);
+    sf::println(stream, "{}return pack.query(ptr);", tab);
+    sf::println(stream, '}');
 
+    sf::println(stream, "xaml_result XAML_CALL xaml_resource_get_hashed(xaml_string* path, std::uint64_t hash, void const** pdata, std::int64_t* psize) noexcept\n{");
+    sf::println(stream, "{}xaml_ptr<xaml_resource_pack> pack;", tab);
+    sf::println(stream, "{}XAML_RETURN_IF_FAILED(current_pack(&pack));", tab);
+    sf::println(stream, "{}xaml_ptr<xaml_buffer> buffer;", tab);
+    sf::println(stream, "{}xaml_result hr = pack->get_hashed(path, hash, &buffer);", tab);
+    sf::println(stream, "{}if (XAML_FAILED(hr)) return hr;", tab);
+    sf::println(stream, "{}std::uint8_t* data;", tab);
+    sf::println(stream, "{}XAML_RETURN_IF_FAILED(buffer->get_data(&data));", tab);
+    sf::println(stream, "{}std::int32_t size;", tab);
+    sf::println(stream, "{}XAML_RETURN_IF_FAILED(buffer->get_size(&size));", tab);
+    sf::println(stream, "{}// The bytes are owned by the pack, which is never released.", tab);
+    sf::println(stream, "{}*pdata = data;", tab);
+    sf::println(stream, "{}*psize = size;", tab);
     sf::println(stream, "{}return XAML_S_OK;", tab);
+    sf::println(stream, '}');
 
+    sf::println(stream, "xaml_result XAML_CALL xaml_resource_get_buffer(xaml_string* path, xaml_buffer** ptr) noexcept\n{");
+    sf::println(stream, "{}xaml_ptr<xaml_resource_pack> pack;", tab);
+    sf::println(stream, "{}XAML_RETURN_IF_FAILED(current_pack(&pack));", tab);
+    sf::println(stream, "{}return pack->get(path, ptr);", tab);
     sf::println(stream, '}');
 }
 
+string read_file(path const& file)
+{
+    nowide::ifstream input{ file, ios_base::in | ios_base::binary };
+    if (!input.is_open()) return {};
+    return { istreambuf_iterator<char>{ input }, istreambuf_iterator<char>{} };
+}
+
+// Writes the file only if the content changes, so that the build system does not rebuild the dependents.
+void write_file(path const& file, string_view content)
+{
+    if (exists(file) && read_file(file) == content) return;
+    nowide::ofstream output{ file, ios_base::out | ios_base::binary };
+    if (!output.is_open()) throw runtime_error{ sf::sprint(U("Cannot open {}."), file.string()) };
+    output.write(content.data(), (streamsize)content.size());
+}
+
+path get_manifest_path(path const& output)
+{
+    path file = output;
+    file += ".manifest";
+    return file;
+}
+
+// Bumped whenever the generated code changes for the same inputs.
+constexpr int manifest_format = 2;
+
+// Everything the output depends on: the generator, the options, and the hashes of the files,
+// with the paths of those the output refers to.
+string get_manifest(vector<rc_resource> const& resources, rc_options const& options)
+{
+    ostringstream stream;
+    sf::println(stream, "xamlrc {} {}", XAML_VERSION, manifest_format);
+    sf::println(stream, "binary {}", get_binary_name(options.binary));
+    sf::println(stream, "pack {}", options.pack ? 1 : 0);
+    if (options.pack_file) sf::println(stream, "pack_file {}", *options.pack_file);
+    for (auto& res : resources)
+    {
+        sf::println(stream, "{} {} {} {}", get_hash_string(res.hash), res.data.size(), res.text ? 't' : 'b', res.key);
+        if (!res.text && !options.pack && options.binary != rc_binary::hex) sf::println(stream, "file {}", get_binary_path(res));
+    }
+    return move(stream).str();
+}
+
+// The first line of a manifest is the hash of the output, so that a modified output is generated again.
+bool is_up_to_date(path const& output, string_view manifest, optional<string> const& pack_file)
+{
+    string saved = read_file(get_manifest_path(output));
+    size_t end = saved.find('\n');
+    if (end == string::npos || string_view{ saved }.substr(end + 1) != manifest) return false;
+    if (pack_file && !exists(path(*pack_file))) return false;
+    if (!exists(output)) return false;
+    string source = read_file(output);
+    return saved.substr(0, end) == get_hash_string(xaml_resource_hash(source.data(), source.size()));
+}
+
+string compile(vector<rc_resource> const& resources, rc_options const& options)
+{
+    ostringstream output;
+    sf::println(output, "#include <xaml/resource/resource.h>");
+    size_t packed_size = 0;
+    if (options.pack)
+    {
+        vector<pack_writer_item> items;
+        for (auto& res : resources)
+        {
+            items.push_back({ res.key, res.data });
+        }
+        vector<uint8_t> pack = pack_write(items, true);
+        packed_size = pack.size();
+        if (options.pack_file)
+        {
+            write_file(path(*options.pack_file), string_view{ reinterpret_cast<char const*>(pack.data()), pack.size() });
+        }
+        sf::println(output, "#include <xaml/resource/pack.h>");
+        write_pack(output, pack, options.pack_file);
+    }
+    else
+    {
+        bool has_binary = any_of(resources.begin(), resources.end(), [](rc_resource const& res) { return !res.text; });
+        if (has_binary && options.binary == rc_binary::incbin)
+        {
+            sf::println(output, incbin_prologue);
+        }
+        else if (has_binary && options.binary == rc_binary::embed)
+        {
+            sf::println(output, embed_prologue);
+        }
+        for (auto& res : resources)
+        {
+            write_resource(output, res, options.binary);
+        }
+        write_table(output, resources);
+    }
+
+    sf::println(output, "xaml_result XAML_CALL xaml_resource_get(xaml_string* path, void const** pdata, std::int32_t* psize) noexcept\n{");
+    sf::println(output, "{}std::string_view file;", tab);
+    sf::println(output, "{}XAML_RETURN_IF_FAILED(to_string_view(path, &file));", tab);
+    sf::println(output, "{}std::int64_t size;", tab);
+    sf::println(output, "{}xaml_result hr = xaml_resource_get_hashed(path, xaml_resource_hash(file.data(), file.size()), pdata, &size);", tab);
+    sf::println(output, "{}if (XAML_FAILED(hr)) return hr;", tab);
+    sf::println(output, "{}if (size > INT32_MAX) return XAML_E_OUTOFBOUNDS;", tab);
+    sf::println(output, "{}*psize = static_cast<std::int32_t>(size);", tab);
+    sf::println(output, "{}return XAML_S_OK;", tab);
+    sf::println(output, '}');
+
+    // Registered when loaded, so that the libraries like the webview could find the resources.
+    sf::println(output, "static bool const xaml_resource_registered = (xaml_resource_register(xaml_resource_get_hashed), true);");
+
+    string source = move(output).str();
+    if (options.stats)
+    {
+        size_t raw_size = 0;
+        for (auto& res : resources) raw_size += res.data.size();
+        sf::println(nowide::cerr, U("{} resources, {} bytes"), resources.size(), raw_size);
+        if (options.pack) sf::println(nowide::cerr, U("Packed into {} bytes"), packed_size);
+        sf::println(nowide::cerr, U("Generated {} bytes of source"), source.size());
+    }
+    return source;
+}
+
 int main(int argc, char** argv)
 {
     nowide::args _(argc, argv);
@@ -132,14 +573,55 @@ int main(int argc, char** argv)
     xaml_ptr<xaml_string> output;
     XAML_THROW_IF_FAILED(options->get_output(&output));
 
-    if (output)
+    rc_options rc_opts{};
+    XAML_THROW_IF_FAILED(options->get_pack(&rc_opts.pack));
+    xaml_ptr<xaml_string> pack_file;
+    XAML_THROW_IF_FAILED(options->get_pack_file(&pack_file));
+    if (pack_file)
     {
-        nowide::ofstream stream{ path(to_string_view(output)) };
-        compile(stream, inputs);
+        rc_opts.pack = true;
+        rc_opts.pack_file = to_string(pack_file);
     }
-    else
+    XAML_THROW_IF_FAILED(options->get_stats(&rc_opts.stats));
+    xaml_ptr<xaml_string> binary;
+    XAML_THROW_IF_FAILED(options->get_binary(&binary));
+    auto binary_mode = get_binary(to_string_view(binary));
+    if (!binary_mode)
+    {
+        sf::println(nowide::cerr, U("Command line parse error: Unknown binary mode {}."), to_string_view(binary));
+        return 1;
+    }
+    rc_opts.binary = *binary_mode;
+
+    try
+    {
+        vector<rc_resource> resources = read_resources(inputs);
+        if (output)
+        {
+            path output_file = to_string_view(output);
+            string manifest = get_manifest(resources, rc_opts);
+            if (is_up_to_date(output_file, manifest, rc_opts.pack_file))
+            {
+                if (rc_opts.stats) sf::println(nowide::cerr, U("Up to date"));
+            }
+            else
+            {
+                string source = compile(resources, rc_opts);
+                write_file(output_file, source);
+                write_file(get_manifest_path(output_file), get_hash_string(xaml_resource_hash(source.data(), source.size())) + "\n" + manifest);
+            }
+        }
+        else
+        {
+            string source = compile(resources, rc_opts);
+            nowide::cout.write(source.data(), (streamsize)source.size());
+        }
+    }
+    catch (runtime_error const& e)
     {
-        compile(nowide::cout, inputs);
+        // The files could not be read or written.
+        sf::println(nowide::cerr, U("Error: {}"), e.what());
+        return 1;
     }
 
     return 0;
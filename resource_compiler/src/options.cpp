@@ -35,6 +35,10 @@ struct xaml_rc_options_impl : xaml_cmdline_options_base_implement<xaml_rc_option
     }
 
     XAML_PROP_PTR_IMPL(output, xaml_string)
+    XAML_PROP_IMPL(pack, bool, bool*, bool)
+    XAML_PROP_PTR_IMPL(pack_file, xaml_string)
+    XAML_PROP_IMPL(stats, bool, bool*, bool)
+    XAML_PROP_PTR_IMPL(binary, xaml_string)
 
     xaml_result XAML_CALL init() noexcept
     {
@@ -55,6 +59,10 @@ xaml_result XAML_CALL xaml_rc_options_register(xaml_meta_context* ctx) noexcept
     XAML_RETURN_IF_FAILED(xaml_cmdline_options_base_members(__info));
     XAML_TYPE_INFO_ADD_CPROP(input, xaml_string);
     XAML_TYPE_INFO_ADD_PROP(output, xaml_string);
+    XAML_TYPE_INFO_ADD_PROP(pack, bool);
+    XAML_TYPE_INFO_ADD_PROP(pack_file, xaml_string);
+    XAML_TYPE_INFO_ADD_PROP(stats, bool);
+    XAML_TYPE_INFO_ADD_PROP(binary, xaml_string);
     XAML_TYPE_INFO_ADD_DEF_PROP(path);
     xaml_ptr<xaml_cmdline_option> opt;
     XAML_RETURN_IF_FAILED(xaml_cmdline_option_new(&opt));
@@ -62,6 +70,10 @@ xaml_result XAML_CALL xaml_rc_options_register(xaml_meta_context* ctx) noexcept
     XAML_RETURN_IF_FAILED(opt->add_arg(0, U("version"), U("version"), U("Print version info")));
     XAML_RETURN_IF_FAILED(opt->add_arg(0, U("no-logo"), U("no_logo"), U("Cancellation to show copyright information")));
     XAML_RETURN_IF_FAILED(opt->add_arg('o', U("output"), U("output"), U("Output file")));
+    XAML_RETURN_IF_FAILED(opt->add_arg('p', U("pack"), U("pack"), U("Pack the resources into one compressed blob")));
+    XAML_RETURN_IF_FAILED(opt->add_arg(0, U("pack-file"), U("pack_file"), U("Write the pack to a file, mapped from the directory of the executable when loaded, instead of embedding it")));
+    XAML_RETURN_IF_FAILED(opt->add_arg(0, U("stats"), U("stats"), U("Print the sizes of the resources and the output")));
+    XAML_RETURN_IF_FAILED(opt->add_arg(0, U("binary"), U("binary"), U("How to embed the binary files: hex (default), incbin or embed")));
     XAML_RETURN_IF_FAILED(opt->add_arg(0, {}, U("input"), U("Input files")));
     XAML_RETURN_IF_FAILED(__info->add_attribute(opt.get()));
     return ctx->add_type(__info);
@@ -0,0 +1,138 @@
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <test_check.hpp>
+
+#ifndef XAML_WIN32
+    #include <sys/wait.h>
+#endif // !XAML_WIN32
+
+using namespace std;
+using namespace std::filesystem;
+
+// Runs xamlrc in a scratch directory, and checks that an output up to date is not written again.
+
+static int run(string const& args)
+{
+    string command = "\"" XAMLRC_PATH "\" --no-logo " + args;
+#ifdef XAML_WIN32
+    // The whole command is quoted again by cmd.
+    return system(("\"" + command + "\"").c_str());
+#else
+    command += " 2>/dev/null";
+    int res = system(command.c_str());
+    return WIFEXITED(res) ? WEXITSTATUS(res) : -1;
+#endif // XAML_WIN32
+}
+
+static string read_file(path const& file)
+{
+    ifstream stream{ file, ios_base::binary };
+    return { istreambuf_iterator<char>{ stream }, istreambuf_iterator<char>{} };
+}
+
+static void write_file(path const& file, string const& content)
+{
+    ofstream stream{ file, ios_base::binary };
+    stream << content;
+}
+
+// Moves the time of the file back, so that a rewrite is seen whatever the resolution of the clock is.
+static file_time_type age(path const& file)
+{
+    auto time = last_write_time(file) - chrono::hours{ 1 };
+    last_write_time(file, time);
+    return time;
+}
+
+static void test_up_to_date()
+{
+    CHECK(run("a.txt -o out.cpp") == 0);
+    CHECK(exists("out.cpp") && exists("out.cpp.manifest"));
+    string source = read_file("out.cpp");
+    CHECK(source.find("xaml_resource_get_hashed") != string::npos);
+
+    // The manifest matches, so nothing is written.
+    auto time = age("out.cpp");
+    auto manifest_time = age("out.cpp.manifest");
+    CHECK(run("a.txt -o out.cpp") == 0);
+    CHECK(last_write_time("out.cpp") == time);
+    CHECK(last_write_time("out.cpp.manifest") == manifest_time);
+
+    // A modified output is generated again.
+    write_file("out.cpp", source + "// modified\n");
+    CHECK(run("a.txt -o out.cpp") == 0);
+    CHECK(read_file("out.cpp") == source);
+
+    // So is one of a changed input.
+    write_file("a.txt", "changed\n");
+    CHECK(run("a.txt -o out.cpp") == 0);
+    CHECK(read_file("out.cpp") != source);
+}
+
+static void test_binary()
+{
+    CHECK(run("b.bin --binary incbin -o incbin.cpp") == 0);
+    CHECK(read_file("incbin.cpp").find(".incbin \\\"") != string::npos);
+    auto time = age("incbin.cpp");
+    CHECK(run("b.bin --binary incbin -o incbin.cpp") == 0);
+    CHECK(last_write_time("incbin.cpp") == time);
+    // The section is restored after the data.
+    CHECK(read_file("incbin.cpp").find(".popsection") != string::npos);
+
+    // The same file elsewhere is another path referred to by the output.
+    create_directories("other");
+    copy_file("b.bin", "other/b.bin");
+    current_path("other");
+    CHECK(run("b.bin --binary incbin -o ../incbin.cpp") == 0);
+    current_path("..");
+    CHECK(last_write_time("incbin.cpp") != time);
+    CHECK(read_file("incbin.cpp").find("other/b.bin") != string::npos);
+
+    CHECK(run("b.bin --binary embed -o embed.cpp") == 0);
+    CHECK(read_file("embed.cpp").find("#embed") != string::npos);
+
+    // Another mode is another output.
+    CHECK(run("b.bin --binary hex -o incbin.cpp") == 0);
+    CHECK(read_file("incbin.cpp").find(".incbin") == string::npos);
+
+    // An unknown mode is an error of the command line, and nothing is written.
+    CHECK(run("b.bin --binary bogus -o bogus.cpp") == 1);
+    CHECK(!exists("bogus.cpp"));
+}
+
+static void test_pack()
+{
+    CHECK(run("a.txt b.bin --pack-file res.xrpk -o pack.cpp") == 0);
+    CHECK(exists("res.xrpk"));
+    auto time = age("pack.cpp");
+    auto pack_time = age("res.xrpk");
+    CHECK(run("a.txt b.bin --pack-file res.xrpk -o pack.cpp") == 0);
+    CHECK(last_write_time("pack.cpp") == time);
+    CHECK(last_write_time("res.xrpk") == pack_time);
+
+    // A missing pack is written again.
+    remove("res.xrpk");
+    CHECK(run("a.txt b.bin --pack-file res.xrpk -o pack.cpp") == 0);
+    CHECK(exists("res.xrpk"));
+}
+
+int main()
+{
+    path dir = temp_directory_path() / "xamlrc_test";
+    remove_all(dir);
+    create_directories(dir);
+    current_path(dir);
+    write_file("a.txt", "hello\n");
+    write_file("b.bin", string("\0\1\2\3\xff", 5));
+    test_up_to_date();
+    test_binary();
+    test_pack();
+    current_path(temp_directory_path());
+    remove_all(dir);
+    return report_failures();
+}
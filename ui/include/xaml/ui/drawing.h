@@ -25,7 +25,7 @@ T __initialize_from_tuple(TTuple&& t) noexcept
     return __intialize_from_tuple_impl<T>(std::forward<TTuple>(t), std::make_index_sequence<std::tuple_size_v<TTuple>>{});
 }
 
-template <typename T, typename TTuple, TTuple (*func)(std::string_view) noexcept>
+template <typename T, typename TTuple, xaml_result (*func)(std::string_view, TTuple*) noexcept>
 struct __xaml_tuple_converter_helper
 {
     xaml_result __convert(xaml_ptr<xaml_object> const& obj, TTuple* value) const noexcept
@@ -34,8 +34,7 @@ struct __xaml_tuple_converter_helper
         {
             std::string_view view;
             XAML_RETURN_IF_FAILED(to_string_view(str, &view));
-            *value = func(view);
-            return XAML_S_OK;
+            return func(view, value);
         }
         return XAML_E_INVALIDARG;
     }
@@ -114,17 +113,24 @@ constexpr xaml_point operator/(xaml_point lhs, double rhs) { return lhs * (1 / r
 XAML_TYPE(xaml_point, { 0xd529263c, 0x9ea7, 0x4be9, { 0xa0, 0x81, 0x9a, 0xc1, 0x1e, 0x39, 0x38, 0x9f } })
 
 #ifdef __cplusplus
-inline std::tuple<double, double> __stot2d(std::string_view str) noexcept
+inline xaml_result __stot2d(std::string_view str, std::tuple<double, double>* value) noexcept
 {
-    constexpr const char __delimeter[] = " ,\t\r\n";
-    std::size_t index = str.find_first_of(__delimeter);
-    if (index == std::string_view::npos)
+    double d[2];
+    std::size_t count;
+    // A malformed literal is expected, so it is returned without raising.
+    xaml_result hr = __stof_list(str, d, &count);
+    if (XAML_FAILED(hr)) return hr;
+    switch (count)
     {
-        double d = __stof<double>(str);
-        return std::make_tuple(d, d);
+    case 1:
+        *value = std::make_tuple(d[0], d[0]);
+        return XAML_S_OK;
+    case 2:
+        *value = std::make_tuple(d[0], d[1]);
+        return XAML_S_OK;
+    default:
+        return XAML_E_INVALIDARG;
     }
-    std::size_t index2 = str.find_first_not_of(__delimeter, index);
-    return std::make_tuple(__stof<double>(str.substr(0, index)), __stof<double>(str.substr(index2)));
 }
 
 template <typename T>
@@ -205,27 +211,27 @@ constexpr xaml_margin operator/(xaml_margin const& lhs, double rhs) { return lhs
 XAML_TYPE(xaml_margin, { 0xb31a5b36, 0x30c3, 0x408f, { 0xae, 0x44, 0xaf, 0xc2, 0xb6, 0x65, 0xc7, 0x3e } })
 
 #ifdef __cplusplus
-inline std::tuple<double, double, double, double> __stot4d(std::string_view str) noexcept
+inline xaml_result __stot4d(std::string_view str, std::tuple<double, double, double, double>* value) noexcept
 {
-    constexpr const char __delimeter[] = " ,\t\r\n";
-    std::size_t len1 = str.find_first_of(__delimeter);
-    if (len1 == std::string_view::npos)
-    {
-        double d = __stof<double>(str);
-        return std::make_tuple(d, d, d, d);
-    }
-    std::size_t index2 = str.find_first_not_of(__delimeter, len1);
-    std::size_t len2 = str.find_first_of(__delimeter, index2);
-    if (len2 == std::string_view::npos)
+    double d[4];
+    std::size_t count;
+    // A malformed literal is expected, so it is returned without raising.
+    xaml_result hr = __stof_list(str, d, &count);
+    if (XAML_FAILED(hr)) return hr;
+    switch (count)
     {
-        double d1 = __stof<double>(str.substr(0, len1));
-        double d2 = __stof<double>(str.substr(index2));
-        return std::make_tuple(d1, d2, d1, d2);
+    case 1:
+        *value = std::make_tuple(d[0], d[0], d[0], d[0]);
+        return XAML_S_OK;
+    case 2:
+        *value = std::make_tuple(d[0], d[1], d[0], d[1]);
+        return XAML_S_OK;
+    case 4:
+        *value = std::make_tuple(d[0], d[1], d[2], d[3]);
+        return XAML_S_OK;
+    default:
+        return XAML_E_INVALIDARG;
     }
-    std::size_t index3 = str.find_first_not_of(__delimeter, len2);
-    std::size_t len3 = str.find_first_of(__delimeter, index3);
-    std::size_t index4 = str.find_first_not_of(__delimeter, len3);
-    return std::make_tuple(__stof<double>(str.substr(0, len1)), __stof<double>(str.substr(index2, len2 - index2)), __stof<double>(str.substr(index3, len3 - index3)), __stof<double>(str.substr(index4)));
 }
 
 template <typename T>
@@ -0,0 +1,17 @@
+#ifndef XAML_UI_HEADLESS_APPLICATION_H
+#define XAML_UI_HEADLESS_APPLICATION_H
+
+#include <xaml/result.h>
+#include <xaml/utility.h>
+
+// The headless backend runs the posted work on a virtual clock,
+// so that tests do not depend on the time they take.
+
+// Runs the work due in the next milliseconds of the virtual clock, then advances it.
+// Zero runs the work which is already due, such as the pending layout.
+EXTERN_C XAML_UI_API xaml_result XAML_CALL xaml_headless_process_events(int32_t) XAML_NOEXCEPT;
+
+// The milliseconds elapsed on the virtual clock.
+EXTERN_C XAML_UI_API xaml_result XAML_CALL xaml_headless_get_clock(int64_t*) XAML_NOEXCEPT;
+
+#endif // !XAML_UI_HEADLESS_APPLICATION_H
@@ -0,0 +1,30 @@
+#ifndef XAML_UI_HEADLESS_CONTROL_H
+#define XAML_UI_HEADLESS_CONTROL_H
+
+#include <xaml/ui/control.h>
+
+typedef struct xaml_headless_widget xaml_headless_widget;
+
+// The native state of a control without display.
+// It records what a real backend would have been asked to draw.
+struct xaml_headless_widget
+{
+    // The region assigned by the parent, relative to the window.
+    xaml_rectangle rect;
+    bool visible;
+    // Times the parent positioned the control.
+    int32_t arrange_count;
+};
+
+XAML_CLASS(xaml_headless_control, { 0xdf17a602, 0xff83, 0x402c, { 0x86, 0x2d, 0x71, 0x86, 0x99, 0x47, 0xd2, 0xdb } })
+
+#define XAML_HEADLESS_CONTROL_VTBL(type)       \
+    XAML_VTBL_INHERIT(XAML_OBJECT_VTBL(type)); \
+    XAML_PROP(handle, type, xaml_headless_widget**, xaml_headless_widget*)
+
+XAML_DECL_INTERFACE_(xaml_headless_control, xaml_object)
+{
+    XAML_DECL_VTBL(xaml_headless_control, XAML_HEADLESS_CONTROL_VTBL);
+};
+
+#endif // !XAML_UI_HEADLESS_CONTROL_H
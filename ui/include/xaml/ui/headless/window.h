@@ -0,0 +1,16 @@
+#ifndef XAML_UI_HEADLESS_WINDOW_H
+#define XAML_UI_HEADLESS_WINDOW_H
+
+#include <xaml/ui/headless/control.h>
+
+XAML_CLASS(xaml_headless_window, { 0x782796f1, 0xca05, 0x439b, { 0xbc, 0xba, 0xec, 0x39, 0x35, 0xf5, 0x9e, 0x27 } })
+
+#define XAML_HEADLESS_WINDOW_VTBL(type) \
+    XAML_VTBL_INHERIT(XAML_HEADLESS_CONTROL_VTBL(type))
+
+XAML_DECL_INTERFACE_(xaml_headless_window, xaml_headless_control)
+{
+    XAML_DECL_VTBL(xaml_headless_window, XAML_HEADLESS_WINDOW_VTBL);
+};
+
+#endif // !XAML_UI_HEADLESS_WINDOW_H
@@ -23,9 +23,7 @@ using namespace std;
 
 void xaml_timer_impl::on_tick() noexcept
 {
-    xaml_ptr<xaml_event_args> args;
-    XAML_ASSERT_SUCCEEDED(xaml_event_args_empty(&args));
-    XAML_ASSERT_SUCCEEDED(m_tick->invoke(this, args));
+    XAML_ASSERT_SUCCEEDED(m_tick->invoke(this, m_tick_args));
 }
 
 xaml_result xaml_timer_impl::start() noexcept
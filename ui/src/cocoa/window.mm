@@ -88,6 +88,18 @@ xaml_result xaml_window_internal::draw(xaml_rectangle const& region) noexcept
     return XAML_S_OK;
 }
 
+xaml_result xaml_window_internal::post_layout() noexcept
+{
+    xaml_ptr<xaml_weak_reference> weak_outer;
+    XAML_RETURN_IF_FAILED(static_cast<xaml_weak_reference_source*>(m_outer_this)->get_weak_reference(&weak_outer));
+    dispatch_async(dispatch_get_main_queue(), ^{
+        xaml_ptr<xaml_window> window;
+        XAML_ASSERT_SUCCEEDED(weak_outer->resolve(&window));
+        if (window) XAML_ASSERT_SUCCEEDED(update_layout());
+    });
+    return XAML_S_OK;
+}
+
 xaml_result xaml_window_internal::draw_visible() noexcept
 {
     [m_window_handle setIsVisible:m_is_visible];
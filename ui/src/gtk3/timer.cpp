@@ -4,25 +4,27 @@
 
 using namespace std;
 
-gboolean xaml_timer_impl::on_timeout(xaml_timer_impl* self) noexcept
+static gboolean on_timer_source_dispatch(GSource*, GSourceFunc, gpointer) noexcept
 {
-    xaml_ptr<xaml_event_args> args;
-    XAML_ASSERT_SUCCEEDED(xaml_event_args_empty(&args));
-    XAML_ASSERT_SUCCEEDED(self->m_tick->invoke(self, args));
-    return self->m_is_enabled;
+    xaml_timer_service_current().on_wake();
+    return G_SOURCE_CONTINUE;
 }
 
-xaml_result xaml_timer_impl::start() noexcept
+// The source has no file descriptors, and is ready only at its ready time.
+static GSourceFuncs timer_source_funcs{ nullptr, nullptr, on_timer_source_dispatch, nullptr };
+
+int64_t xaml_timer_service::now() noexcept
 {
-    if (!m_is_enabled.exchange(true))
-    {
-        g_timeout_add((guint)m_interval, (GSourceFunc)xaml_timer_impl::on_timeout, this);
-    }
-    return XAML_S_OK;
+    return g_get_monotonic_time() / 1000;
 }
 
-xaml_result xaml_timer_impl::stop() noexcept
+void xaml_timer_service::arm(int64_t deadline) noexcept
 {
-    m_is_enabled = false;
-    return XAML_S_OK;
+    if (!m_source)
+    {
+        if (deadline < 0) return;
+        m_source = g_source_new(&timer_source_funcs, sizeof(GSource));
+        g_source_attach(m_source, nullptr);
+    }
+    g_source_set_ready_time(m_source, deadline < 0 ? -1 : deadline * 1000);
 }
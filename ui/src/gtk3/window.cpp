@@ -12,6 +12,7 @@ using namespace std;
 
 xaml_window_internal::~xaml_window_internal()
 {
+    if (m_layout_source) g_source_remove(m_layout_source);
     if (m_handle && !gtk_widget_in_destruction(m_window_handle))
     {
 #if GTK_CHECK_VERSION(4, 0, 0)
@@ -50,6 +51,20 @@ xaml_result xaml_window_internal::draw(xaml_rectangle const&) noexcept
     return XAML_S_OK;
 }
 
+xaml_result xaml_window_internal::post_layout() noexcept
+{
+    // Same priority as the GTK resize, so that the layout is done before redrawing.
+    m_layout_source = g_idle_add_full(G_PRIORITY_HIGH_IDLE + 10, (GSourceFunc)xaml_window_internal::on_layout_idle, this, nullptr);
+    return XAML_S_OK;
+}
+
+gboolean xaml_window_internal::on_layout_idle(xaml_window_internal* self) noexcept
+{
+    self->m_layout_source = 0;
+    XAML_ASSERT_SUCCEEDED(self->update_layout());
+    return G_SOURCE_REMOVE;
+}
+
 xaml_result xaml_window_internal::draw_size() noexcept
 {
     xaml_atomic_guard guard{ m_resizing };
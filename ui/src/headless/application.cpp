@@ -0,0 +1,42 @@
+#include <headless/dispatcher.hpp>
+#include <shared/application.hpp>
+#include <xaml/ui/application.h>
+
+using namespace std;
+
+xaml_result xaml_application_impl::init(int argc, char** argv) noexcept
+{
+    XAML_RETURN_IF_FAILED(xaml_event_new(&m_activate));
+    XAML_RETURN_IF_FAILED(xaml_vector_new(&m_cmd_lines));
+    for (int i = 0; i < argc; i++)
+    {
+        xaml_ptr<xaml_string> arg;
+        XAML_RETURN_IF_FAILED(xaml_string_new_view(argv[i], &arg));
+        XAML_RETURN_IF_FAILED(m_cmd_lines->append(arg));
+    }
+    return XAML_S_OK;
+}
+
+xaml_result xaml_application_impl::run(int* pres) noexcept
+{
+    xaml_ptr<xaml_event_args> args;
+    XAML_RETURN_IF_FAILED(xaml_event_args_empty(&args));
+    XAML_RETURN_IF_FAILED(m_activate->invoke(this, args));
+    // Returns when quit is called, or nothing is left to do.
+    xaml_headless_run();
+    *pres = m_quit_value;
+    return XAML_S_OK;
+}
+
+xaml_result xaml_application_impl::quit(int value) noexcept
+{
+    m_quit_value = value;
+    xaml_headless_quit();
+    return XAML_S_OK;
+}
+
+xaml_result xaml_application_impl::get_theme(xaml_application_theme* ptheme) noexcept
+{
+    *ptheme = xaml_application_theme_light;
+    return XAML_S_OK;
+}
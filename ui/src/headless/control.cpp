@@ -0,0 +1,58 @@
+#include <shared/control.hpp>
+#include <xaml/ui/control.h>
+
+using namespace std;
+
+xaml_result xaml_control_internal::set_rect(xaml_rectangle const& region) noexcept
+{
+    xaml_rectangle real = region - m_margin;
+    m_handle->rect = real;
+    m_handle->arrange_count++;
+    XAML_RETURN_IF_FAILED(set_size_noevent({ real.width, real.height }));
+    XAML_RETURN_IF_FAILED(draw_size());
+    return XAML_S_OK;
+}
+
+xaml_result xaml_control_internal::size_to_fit() noexcept
+{
+    // There is no content to fit without a display.
+    return XAML_S_OK;
+}
+
+xaml_result xaml_control_internal::draw_size() noexcept
+{
+    m_handle->rect.width = m_size.width;
+    m_handle->rect.height = m_size.height;
+    return XAML_S_OK;
+}
+
+xaml_result xaml_control_internal::draw_visible() noexcept
+{
+    m_handle->visible = m_is_visible;
+    return XAML_S_OK;
+}
+
+// Every code point is 7 wide and 16 high, as a monospace font at 96 DPI.
+static constexpr double char_width = 7;
+static constexpr double char_height = 16;
+
+xaml_result xaml_control_internal::measure_string(xaml_ptr<xaml_string> const& str, xaml_size const& offset, xaml_size* pvalue) noexcept
+{
+    int32_t count = 0;
+    if (str)
+    {
+        char const* data;
+        XAML_RETURN_IF_FAILED(str->get_data(&data));
+        int32_t length;
+        XAML_RETURN_IF_FAILED(str->get_length(&length));
+        for (int32_t i = 0; i < length; i++)
+        {
+            // Skips the bytes continuing a UTF-8 sequence.
+            if (((unsigned char)data[i] & 0xC0) != 0x80) count++;
+        }
+    }
+    xaml_size real_value{};
+    if (count) real_value = { count * char_width, char_height };
+    *pvalue = real_value + offset;
+    return XAML_S_OK;
+}
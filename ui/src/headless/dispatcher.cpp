@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <headless/dispatcher.hpp>
+#include <vector>
+#include <xaml/ui/headless/application.h>
+
+using namespace std;
+
+namespace
+{
+    struct task
+    {
+        int64_t time;
+        uint64_t id;
+        function<void()> func;
+    };
+
+    // The earliest task is on the top; tasks at the same time run in the posted order.
+    struct task_later
+    {
+        bool operator()(task const& lhs, task const& rhs) const noexcept
+        {
+            return lhs.time != rhs.time ? lhs.time > rhs.time : lhs.id > rhs.id;
+        }
+    };
+
+    struct dispatcher
+    {
+        vector<task> queue{};
+        int64_t clock{ 0 };
+        uint64_t last_id{ 0 };
+        bool quitting{ false };
+
+        // Runs the earliest task if it is due before the time.
+        bool run_one(int64_t until)
+        {
+            if (queue.empty() || queue.front().time > until) return false;
+            pop_heap(queue.begin(), queue.end(), task_later{});
+            task t = move(queue.back());
+            queue.pop_back();
+            clock = (max)(clock, t.time);
+            t.func();
+            return true;
+        }
+    };
+
+    dispatcher& current() noexcept
+    {
+        static dispatcher instance{};
+        return instance;
+    }
+} // namespace
+
+uint64_t xaml_headless_post(int32_t delay, function<void()> func) noexcept
+try
+{
+    auto& d = current();
+    uint64_t id = ++d.last_id;
+    d.queue.push_back({ d.clock + (max)(delay, 0), id, move(func) });
+    push_heap(d.queue.begin(), d.queue.end(), task_later{});
+    return id;
+}
+catch (...)
+{
+    return 0;
+}
+
+void xaml_headless_cancel(uint64_t id) noexcept
+{
+    auto& d = current();
+    auto it = find_if(d.queue.begin(), d.queue.end(), [id](task const& t) { return t.id == id; });
+    if (it != d.queue.end())
+    {
+        d.queue.erase(it);
+        make_heap(d.queue.begin(), d.queue.end(), task_later{});
+    }
+}
+
+void xaml_headless_run() noexcept
+{
+    auto& d = current();
+    d.quitting = false;
+    while (!d.quitting && d.run_one(INT64_MAX))
+    {
+    }
+}
+
+void xaml_headless_quit() noexcept
+{
+    current().quitting = true;
+}
+
+xaml_result XAML_CALL xaml_headless_process_events(int32_t elapsed) noexcept
+{
+    auto& d = current();
+    int64_t until = d.clock + (max)(elapsed, 0);
+    while (d.run_one(until))
+    {
+    }
+    d.clock = until;
+    return XAML_S_OK;
+}
+
+xaml_result XAML_CALL xaml_headless_get_clock(int64_t* pvalue) noexcept
+{
+    *pvalue = current().clock;
+    return XAML_S_OK;
+}
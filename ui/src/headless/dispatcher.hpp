@@ -0,0 +1,24 @@
+#ifndef XAML_UI_HEADLESS_DISPATCHER_HPP
+#define XAML_UI_HEADLESS_DISPATCHER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <xaml/utility.h>
+
+// The message loop of the headless backend.
+// The work is ordered by a virtual clock, which only advances when asked,
+// so a run never waits for real time.
+
+// Posts the work after the delay in milliseconds, and returns its id,
+// or zero if the work cannot be queued.
+XAML_UI_API std::uint64_t xaml_headless_post(std::int32_t delay, std::function<void()> func) noexcept;
+
+// Removes the work if it has not run.
+XAML_UI_API void xaml_headless_cancel(std::uint64_t id) noexcept;
+
+// Runs all the work until the queue is empty or quit is called.
+XAML_UI_API void xaml_headless_run() noexcept;
+
+XAML_UI_API void xaml_headless_quit() noexcept;
+
+#endif // !XAML_UI_HEADLESS_DISPATCHER_HPP
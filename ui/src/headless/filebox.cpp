@@ -0,0 +1,14 @@
+#include <shared/filebox.hpp>
+#include <xaml/ui/filebox.h>
+
+using namespace std;
+
+template <typename I>
+xaml_result xaml_filebox_impl<I>::show(xaml_window*) noexcept
+{
+    // Nobody is there to choose, as if the dialog were canceled.
+    return XAML_E_FAIL;
+}
+
+template struct xaml_filebox_impl<xaml_open_filebox>;
+template struct xaml_filebox_impl<xaml_save_filebox>;
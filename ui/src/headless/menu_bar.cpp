@@ -0,0 +1,26 @@
+#include <shared/menu_bar.hpp>
+#include <xaml/ui/menu_bar.h>
+
+using namespace std;
+
+xaml_result xaml_menu_bar_internal::draw(xaml_rectangle const&) noexcept
+{
+    if (!m_handle)
+    {
+        m_handle = new (nothrow) xaml_headless_widget{};
+        if (!m_handle) return XAML_E_OUTOFMEMORY;
+        XAML_RETURN_IF_FAILED(draw_visible());
+        XAML_RETURN_IF_FAILED(draw_submenu());
+    }
+    return XAML_S_OK;
+}
+
+xaml_result xaml_menu_bar_internal::draw_submenu() noexcept
+{
+    XAML_FOREACH_START(xaml_control, cc, m_children);
+    {
+        XAML_RETURN_IF_FAILED(cc->draw({}));
+    }
+    XAML_FOREACH_END();
+    return XAML_S_OK;
+}
@@ -0,0 +1,12 @@
+#include <xaml/ui/monitor.h>
+
+using namespace std;
+
+xaml_result XAML_CALL xaml_monitor_get_all(xaml_vector_view<xaml_monitor>** ptr) noexcept
+{
+    // One fixed monitor, so that the placement of windows is reproducible.
+    xaml_ptr<xaml_vector<xaml_monitor>> result;
+    XAML_RETURN_IF_FAILED(xaml_vector_new(&result));
+    XAML_RETURN_IF_FAILED(result->append({ { 0, 0, 1920, 1080 }, { 0, 0, 1920, 1080 } }));
+    return result->query(ptr);
+}
@@ -0,0 +1,19 @@
+#include <xaml/ui/msgbox.h>
+
+using namespace std;
+
+xaml_result XAML_CALL xaml_msgbox_custom(xaml_window*, xaml_string*, xaml_string*, xaml_string*, xaml_msgbox_style, xaml_vector_view<xaml_msgbox_custom_button>* buttons, xaml_msgbox_result* presult) noexcept
+{
+    // Nobody is there to answer, so the first button is chosen.
+    xaml_msgbox_result result = xaml_msgbox_result_cancel;
+    int32_t size;
+    XAML_RETURN_IF_FAILED(buttons->get_size(&size));
+    if (size)
+    {
+        xaml_msgbox_custom_button button;
+        XAML_RETURN_IF_FAILED(buttons->get_at(0, &button));
+        result = button.result;
+    }
+    *presult = result;
+    return XAML_S_OK;
+}
@@ -0,0 +1,29 @@
+#include <algorithm>
+#include <headless/dispatcher.hpp>
+#include <shared/timer.hpp>
+#include <xaml/ui/headless/application.h>
+#include <xaml/ui/timer.h>
+
+using namespace std;
+
+int64_t xaml_timer_service::now() noexcept
+{
+    int64_t clock;
+    XAML_ASSERT_SUCCEEDED(xaml_headless_get_clock(&clock));
+    return clock;
+}
+
+void xaml_timer_service::arm(int64_t deadline) noexcept
+{
+    if (m_task)
+    {
+        xaml_headless_cancel(m_task);
+        m_task = 0;
+    }
+    if (deadline < 0) return;
+    int32_t delay = (int32_t)(min)((max)(deadline - now(), int64_t{ 0 }), (int64_t)INT32_MAX);
+    m_task = xaml_headless_post(delay, [this]() noexcept {
+        m_task = 0;
+        on_wake();
+    });
+}
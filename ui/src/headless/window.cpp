@@ -0,0 +1,117 @@
+#include <headless/dispatcher.hpp>
+#include <shared/window.hpp>
+#include <xaml/ui/application.h>
+#include <xaml/ui/window.h>
+
+using namespace std;
+
+xaml_window_internal::~xaml_window_internal()
+{
+    if (m_layout_task) xaml_headless_cancel(m_layout_task);
+}
+
+xaml_result xaml_window_internal::draw(xaml_rectangle const&) noexcept
+{
+    if (!m_handle)
+    {
+        m_handle = new (nothrow) xaml_headless_widget{};
+        if (!m_handle) return XAML_E_OUTOFMEMORY;
+        xaml_ptr<xaml_application> app;
+        XAML_RETURN_IF_FAILED(xaml_application_current(&app));
+        XAML_RETURN_IF_FAILED(app->window_added(static_cast<xaml_window*>(m_outer_this)));
+        XAML_RETURN_IF_FAILED(draw_title());
+        XAML_RETURN_IF_FAILED(draw_resizable());
+    }
+    XAML_RETURN_IF_FAILED(draw_size());
+    XAML_RETURN_IF_FAILED(draw_menu_bar());
+    return XAML_S_OK;
+}
+
+xaml_result xaml_window_internal::post_layout() noexcept
+{
+    m_layout_task = xaml_headless_post(0, [this]() noexcept {
+        m_layout_task = 0;
+        XAML_ASSERT_SUCCEEDED(update_layout());
+    });
+    return m_layout_task ? XAML_S_OK : XAML_E_OUTOFMEMORY;
+}
+
+xaml_result xaml_window_internal::draw_size() noexcept
+{
+    m_handle->rect = m_location + m_size;
+    // No native resize comes back, so the child is drawn here.
+    return draw_child();
+}
+
+xaml_result xaml_window_internal::draw_title() noexcept
+{
+    return XAML_S_OK;
+}
+
+xaml_result xaml_window_internal::draw_child() noexcept
+{
+    if (m_child)
+    {
+        xaml_rectangle region;
+        XAML_RETURN_IF_FAILED(get_client_region(&region));
+        return m_child->draw(region);
+    }
+    return XAML_S_OK;
+}
+
+xaml_result xaml_window_internal::draw_resizable() noexcept
+{
+    return XAML_S_OK;
+}
+
+xaml_result xaml_window_internal::draw_menu_bar() noexcept
+{
+    if (m_menu_bar)
+    {
+        XAML_RETURN_IF_FAILED(m_menu_bar->set_parent(static_cast<xaml_control*>(m_outer_this)));
+        XAML_RETURN_IF_FAILED(m_menu_bar->draw({}));
+    }
+    return XAML_S_OK;
+}
+
+xaml_result xaml_window_internal::show() noexcept
+{
+    XAML_RETURN_IF_FAILED(draw({}));
+    return set_is_visible(true);
+}
+
+xaml_result xaml_window_internal::close() noexcept
+{
+    if (!m_handle) return XAML_S_OK;
+    xaml_ptr<xaml_box<bool>> handled;
+    XAML_RETURN_IF_FAILED(xaml_box_new(false, &handled));
+    XAML_RETURN_IF_FAILED(m_closing->invoke(m_outer_this, handled));
+    bool value;
+    XAML_RETURN_IF_FAILED(xaml_unbox_value(handled, &value));
+    if (!value)
+    {
+        XAML_RETURN_IF_FAILED(set_is_visible(false));
+        xaml_ptr<xaml_application> app;
+        XAML_RETURN_IF_FAILED(xaml_application_current(&app));
+        XAML_RETURN_IF_FAILED(app->window_removed(static_cast<xaml_window*>(m_outer_this)));
+    }
+    return XAML_S_OK;
+}
+
+xaml_result xaml_window_internal::hide() noexcept
+{
+    return set_is_visible(false);
+}
+
+xaml_result xaml_window_internal::get_client_region(xaml_rectangle* pregion) noexcept
+{
+    // The menu bar takes no space, as it is not drawn.
+    *pregion = { 0, 0, m_size.width, m_size.height };
+    return XAML_S_OK;
+}
+
+xaml_result xaml_window_internal::get_dpi(double* pvalue) noexcept
+{
+    *pvalue = 96.0;
+    return XAML_S_OK;
+}
@@ -1,6 +1,7 @@
 #include <QCloseEvent>
 #include <QMainWindow>
 #include <QMenuBar>
+#include <QMetaObject>
 #include <QMoveEvent>
 #include <QResizeEvent>
 #include <QScreen>
@@ -55,6 +56,14 @@ xaml_result xaml_window_internal::draw(xaml_rectangle const&) noexcept
     return XAML_S_OK;
 }
 
+xaml_result xaml_window_internal::post_layout() noexcept
+{
+    // The queued call is posted as an event, and dropped if the window is destroyed.
+    QMetaObject::invokeMethod(
+        m_handle, [this]() { XAML_ASSERT_SUCCEEDED(update_layout()); }, Qt::QueuedConnection);
+    return XAML_S_OK;
+}
+
 xaml_result xaml_window_internal::draw_size() noexcept
 {
     return xaml_control_internal::draw_size();
@@ -8,7 +8,13 @@ xaml_control_internal::xaml_control_internal() noexcept : m_is_visible(true)
 {
 }
 
-xaml_control_internal::~xaml_control_internal() {}
+xaml_control_internal::~xaml_control_internal()
+{
+#ifdef XAML_UI_HEADLESS
+    // Every control owns its widget, as nothing else does without a display.
+    delete m_handle;
+#endif // XAML_UI_HEADLESS
+}
 
 xaml_result xaml_control_internal::parent_redraw() noexcept
 {
@@ -25,7 +31,7 @@ xaml_result xaml_control_internal::parent_redraw() noexcept
     }
     else
     {
-        return draw({});
+        return invalidate_layout(xaml_layout_measure);
     }
 }
 
@@ -36,6 +42,7 @@ xaml_result xaml_control_internal::init() noexcept
     XAML_RETURN_IF_FAILED(xaml_map_new(hasher.get(), &m_resources));
 
     XAML_RETURN_IF_FAILED(xaml_event_new(&m_parent_changed));
+    XAML_RETURN_IF_FAILED(xaml_event_new(&m_resource_changed));
     XAML_RETURN_IF_FAILED(xaml_event_new(&m_size_changed));
     XAML_RETURN_IF_FAILED(xaml_event_new(&m_margin_changed));
     XAML_RETURN_IF_FAILED(xaml_event_new(&m_halignment_changed));
@@ -9,6 +9,8 @@
     #include <xaml/ui/gtk3/control.h>
 #elif defined(XAML_UI_QT)
     #include <xaml/ui/qt5/control.hpp>
+#elif defined(XAML_UI_HEADLESS)
+    #include <xaml/ui/headless/control.h>
 #endif // XAML_UI_WINDOWS
 
 #include <xaml/event.h>
@@ -16,6 +18,16 @@
 #include <xaml/ui/control.h>
 #include <xaml/ui/drawing_conv.hpp>
 
+// What should be recomputed by a pending layout pass.
+enum xaml_layout_invalidation
+{
+    xaml_layout_valid = 0x0,
+    // The position or size of the root changed.
+    xaml_layout_arrange = 0x1,
+    // The desired size of some control changed, so the whole tree should be measured.
+    xaml_layout_measure = 0x2
+};
+
 struct xaml_control_internal
 {
     xaml_object* m_outer_this{ nullptr };
@@ -27,7 +39,8 @@ struct xaml_control_internal
     xaml_result XAML_CALL add_resource(xaml_string* key, xaml_object* value) noexcept
     {
         bool replaced;
-        return m_resources->insert(key, value, &replaced);
+        XAML_RETURN_IF_FAILED(m_resources->insert(key, value, &replaced));
+        return m_resource_changed->invoke(m_outer_this, key);
     }
 
     xaml_result XAML_CALL get_resource(xaml_string* key, xaml_object** pvalue) noexcept
@@ -41,6 +54,7 @@ struct xaml_control_internal
     }
 
     XAML_EVENT_IMPL(parent_changed, xaml_object, xaml_element_base)
+    XAML_EVENT_IMPL(resource_changed, xaml_object, xaml_string)
 
     xaml_ptr<xaml_weak_reference> m_parent{};
 
@@ -59,8 +73,12 @@ struct xaml_control_internal
 
     xaml_result XAML_CALL set_parent(xaml_element_base* value) noexcept
     {
+        xaml_ptr<xaml_element_base> parent;
+        XAML_RETURN_IF_FAILED(get_parent(&parent));
+        if (parent.get() == value) return XAML_S_OK;
         m_parent = nullptr;
-        return value->get_weak_reference(&m_parent);
+        if (value) XAML_RETURN_IF_FAILED(value->get_weak_reference(&m_parent));
+        return m_parent_changed->invoke(m_outer_this, value);
     }
 
     XAML_EVENT_IMPL(size_changed, xaml_object, xaml_size)
@@ -110,6 +128,10 @@ struct xaml_control_internal
 
     XAML_UI_API xaml_result XAML_CALL parent_redraw() noexcept;
 
+    // Called on the root control when the layout of the tree is out of date.
+    // Draws synchronously by default; a window defers it to the native loop.
+    virtual xaml_result XAML_CALL invalidate_layout(int) noexcept { return draw({}); }
+
     xaml_result XAML_CALL set_size_noevent(xaml_size const& value) noexcept
     {
         m_size = value;
@@ -185,6 +207,11 @@ struct xaml_control_internal
         }
         return m_handle ? XAML_S_OK : XAML_E_OUTOFMEMORY;
     }
+#elif defined(XAML_UI_HEADLESS)
+    XAML_PROP_IMPL(handle, xaml_headless_widget*, xaml_headless_widget**, xaml_headless_widget*)
+
+    // Measures the text with fixed metrics, so that the layout is the same on every machine.
+    XAML_UI_API xaml_result XAML_CALL measure_string(xaml_ptr<xaml_string> const&, xaml_size const&, xaml_size*) noexcept;
 #endif // XAML_UI_WINDOWS
 
     xaml_result XAML_CALL get_is_initialized(bool* pvalue) noexcept
@@ -233,6 +260,13 @@ struct xaml_qt5_control_implement : xaml_inner_implement<T2, D, Base2>
     xaml_result XAML_CALL get_handle(QWidget** pvalue) noexcept override { return this->m_outer->get_handle(pvalue); }
     xaml_result XAML_CALL set_handle(QWidget* value) noexcept override { return this->m_outer->set_handle(value); }
 };
+#elif defined(XAML_UI_HEADLESS)
+template <typename T2, typename D, typename Base2>
+struct xaml_headless_control_implement : xaml_inner_implement<T2, D, Base2>
+{
+    xaml_result XAML_CALL get_handle(xaml_headless_widget** pvalue) noexcept override { return this->m_outer->get_handle(pvalue); }
+    xaml_result XAML_CALL set_handle(xaml_headless_widget* value) noexcept override { return this->m_outer->set_handle(value); }
+};
 #endif // XAML_UI_WINDOWS
 
 template <typename T, typename Internal, typename Base>
@@ -245,6 +279,7 @@ struct xaml_control_implement : xaml_weak_implement<T, Base>
     xaml_result XAML_CALL get_resources(xaml_map_view<xaml_string, xaml_object>** ptr) noexcept override { return m_internal.get_resources(ptr); }
 
     XAML_EVENT_INTERNAL_IMPL(parent_changed, xaml_object, xaml_element_base)
+    XAML_EVENT_INTERNAL_IMPL(resource_changed, xaml_object, xaml_string)
     XAML_PROP_INTERNAL_IMPL(parent, xaml_element_base**, xaml_element_base*)
 
     XAML_EVENT_INTERNAL_IMPL(size_changed, xaml_object, xaml_size)
@@ -317,6 +352,14 @@ struct xaml_control_implement : xaml_weak_implement<T, Base>
     } m_native_control;
 
     using native_control_type = xaml_qt5_control;
+#elif defined(XAML_UI_HEADLESS)
+    XAML_PROP_INTERNAL_IMPL(handle, xaml_headless_widget**, xaml_headless_widget*)
+
+    struct xaml_headless_control_impl : xaml_headless_control_implement<xaml_headless_control_impl, T, xaml_headless_control>
+    {
+    } m_native_control;
+
+    using native_control_type = xaml_headless_control;
 #endif // XAML_UI_WINDOWS
 
     xaml_result XAML_CALL query(xaml_guid const& type, void** ptr) noexcept override
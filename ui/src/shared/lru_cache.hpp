@@ -0,0 +1,101 @@
+#ifndef XAML_UI_SHARED_LRU_CACHE_HPP
+#define XAML_UI_SHARED_LRU_CACHE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+// A map bounded by the count of entries,
+// which drops the least recently used one when it is full.
+// The entries own the keys, and the map is keyed by views of them, like std::string_view,
+// so that lookup builds no owning key, and needs no heterogeneous lookup of unordered_map.
+// A view is made from a key by static_cast.
+template <typename Key, typename Value, typename View = Key, typename Hash = std::hash<View>, typename Equal = std::equal_to<View>>
+struct xaml_lru_cache
+{
+private:
+    struct entry
+    {
+        Key key;
+        Value value;
+    };
+
+    // The list owns the entries, the most recent one first.
+    // Its nodes never move, so the views in the map stay valid.
+    using order_type = std::list<entry>;
+    using map_type = std::unordered_map<View, typename order_type::iterator, Hash, Equal>;
+
+    map_type m_map{};
+    order_type m_order{};
+    std::size_t m_capacity;
+    std::int64_t m_hits{ 0 };
+    std::int64_t m_misses{ 0 };
+
+    void shrink(std::size_t capacity) noexcept
+    {
+        while (m_map.size() > capacity)
+        {
+            m_map.erase(static_cast<View>(m_order.back().key));
+            m_order.pop_back();
+        }
+    }
+
+public:
+    xaml_lru_cache(std::size_t capacity) noexcept : m_capacity(capacity) {}
+
+    std::size_t size() const noexcept { return m_map.size(); }
+    std::size_t capacity() const noexcept { return m_capacity; }
+    std::int64_t hits() const noexcept { return m_hits; }
+    std::int64_t misses() const noexcept { return m_misses; }
+
+    void set_capacity(std::size_t capacity) noexcept
+    {
+        m_capacity = capacity;
+        shrink(capacity);
+    }
+
+    void clear() noexcept
+    {
+        m_map.clear();
+        m_order.clear();
+    }
+
+    // Returns the value and marks it as the most recent one, or nullptr.
+    // The pointer is valid until the next insertion.
+    Value* find(View const& key) noexcept
+    {
+        auto it = m_map.find(key);
+        if (it == m_map.end())
+        {
+            m_misses++;
+            return nullptr;
+        }
+        m_hits++;
+        m_order.splice(m_order.begin(), m_order, it->second);
+        return &it->second->value;
+    }
+
+    // Inserts or replaces the value, and drops the least recent ones if needed.
+    // The returned pointer is valid until the next insertion,
+    // so the new entry is kept even if the capacity is zero.
+    Value* insert(Key key, Value value)
+    {
+        auto it = m_map.find(static_cast<View>(key));
+        if (it != m_map.end())
+        {
+            it->second->value = std::move(value);
+            m_order.splice(m_order.begin(), m_order, it->second);
+            return &it->second->value;
+        }
+        m_order.push_front(entry{ std::move(key), std::move(value) });
+        m_map.emplace(static_cast<View>(m_order.front().key), m_order.begin());
+        shrink((std::max)(m_capacity, std::size_t{ 1 }));
+        return &m_order.front().value;
+    }
+};
+
+#endif // !XAML_UI_SHARED_LRU_CACHE_HPP
@@ -95,6 +95,7 @@ struct xaml_menu_bar_impl : xaml_multicontainer_implement<xaml_menu_bar_impl, xa
     using native_menu_bar_type = xaml_qt5_menu_bar;
 #endif // XAML_UI_WINDOWS
 
+#ifndef XAML_UI_HEADLESS
     xaml_result XAML_CALL query(xaml_guid const& type, void** ptr) noexcept override
     {
         if (type == xaml_type_guid_v<native_menu_bar_type>)
@@ -113,6 +114,7 @@ struct xaml_menu_bar_impl : xaml_multicontainer_implement<xaml_menu_bar_impl, xa
     {
         m_native_menu_bar.m_outer = this;
     }
+#endif // !XAML_UI_HEADLESS
 };
 
 #endif // !XAML_UI_SHARED_MENU_BAR_HPP
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <bit>
 #include <shared/timer.hpp>
 #include <xaml/ui/timer.h>
 
@@ -6,17 +8,99 @@ using namespace std;
 xaml_result xaml_timer_impl::init() noexcept
 {
     XAML_RETURN_IF_FAILED(xaml_event_new(&m_tick));
+    XAML_RETURN_IF_FAILED(xaml_event_args_empty(&m_tick_args));
 #ifdef XAML_UI_QT
     QObject::connect(&m_handle, &QTimer::timeout, [this]() noexcept -> void
                      {
-                         xaml_ptr<xaml_event_args> args;
-                         XAML_ASSERT_SUCCEEDED(xaml_event_args_empty(&args));
-                         XAML_ASSERT_SUCCEEDED(m_tick->invoke(this, args));
+                         XAML_ASSERT_SUCCEEDED(m_tick->invoke(this, m_tick_args));
                      });
 #endif // XAML_UI_QT
     return XAML_S_OK;
 }
 
+#if defined(XAML_UI_GTK3) || defined(XAML_UI_HEADLESS)
+xaml_timer_impl::~xaml_timer_impl()
+{
+    if (m_node.linked()) xaml_timer_service_current().stop(this);
+}
+
+xaml_result xaml_timer_impl::start() noexcept
+{
+    if (!m_is_enabled.exchange(true))
+    {
+        xaml_timer_service_current().start(this);
+    }
+    return XAML_S_OK;
+}
+
+xaml_result xaml_timer_impl::stop() noexcept
+{
+    if (m_is_enabled.exchange(false))
+    {
+        xaml_timer_service_current().stop(this);
+    }
+    return XAML_S_OK;
+}
+
+xaml_timer_service& xaml_timer_service_current() noexcept
+{
+    static xaml_timer_service service{};
+    return service;
+}
+
+// Rounds the deadline up to a granularity of about 1/32 of the interval,
+// so that timers due at almost the same time wake up together.
+static int64_t coalesce(int64_t deadline, int32_t interval) noexcept
+{
+    int64_t granularity = (int64_t)bit_floor((uint32_t)(max)(interval / 32, 1));
+    return (deadline + granularity - 1) & ~(granularity - 1);
+}
+
+void xaml_timer_service::start(xaml_timer_impl* t) noexcept
+{
+    int64_t current = now();
+    int32_t interval = (max)(t->m_interval, 1);
+    m_wheel.reset(current);
+    t->m_due = current + interval;
+    m_wheel.schedule(t->m_node, coalesce(t->m_due, interval));
+    rearm();
+}
+
+void xaml_timer_service::stop(xaml_timer_impl* t) noexcept
+{
+    m_wheel.cancel(t->m_node);
+    rearm();
+}
+
+void xaml_timer_service::on_wake() noexcept
+{
+    int64_t current = now();
+    m_wheel.advance(current, [this, current](xaml_timer_impl* t) noexcept {
+        // Keeps the timer alive while it raises the event.
+        xaml_ptr<xaml_timer> self = t;
+        int32_t interval = (max)(t->m_interval, 1);
+        // The ticks missed are dropped rather than raised at once.
+        t->m_due = t->m_due + interval > current ? t->m_due + interval : current + interval;
+        m_wheel.schedule(t->m_node, coalesce(t->m_due, interval));
+        XAML_ASSERT_SUCCEEDED(t->m_tick->invoke(t, t->m_tick_args));
+    });
+    // The source is armed again even for the same deadline,
+    // because the one it woke for has passed.
+    m_armed = m_wheel.next_deadline();
+    arm(m_armed);
+}
+
+void xaml_timer_service::rearm() noexcept
+{
+    int64_t deadline = m_wheel.next_deadline();
+    if (deadline != m_armed)
+    {
+        m_armed = deadline;
+        arm(deadline);
+    }
+}
+#endif // XAML_UI_GTK3 || XAML_UI_HEADLESS
+
 xaml_result XAML_CALL xaml_timer_new(xaml_timer** ptr) noexcept
 {
     return xaml_object_new_and_init<xaml_timer_impl>(ptr);
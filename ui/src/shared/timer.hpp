@@ -11,7 +11,12 @@
     #include <QTimer>
 #endif // XAML_UI_WINDOWS
 
+#if defined(XAML_UI_GTK3) || defined(XAML_UI_HEADLESS)
+    #include <shared/timer_wheel.hpp>
+#endif // XAML_UI_GTK3 || XAML_UI_HEADLESS
+
 #include <atomic>
+#include <cstdint>
 #include <xaml/event.h>
 #include <xaml/ui/timer.h>
 
@@ -21,6 +26,9 @@ struct xaml_timer_impl : xaml_implement<xaml_timer_impl, xaml_timer>
     XAML_PROP_IMPL_BASE(is_enabled, std::atomic_bool, bool*)
     XAML_EVENT_IMPL(tick, xaml_object, xaml_event_args)
 
+    // The same empty args are raised with every tick.
+    xaml_ptr<xaml_event_args> m_tick_args{};
+
     xaml_result XAML_CALL start() noexcept override;
     xaml_result XAML_CALL stop() noexcept override;
 
@@ -34,10 +42,14 @@ struct xaml_timer_impl : xaml_implement<xaml_timer_impl, xaml_timer>
     native_delegate_type m_delegate{ OBJC_NIL };
 
     void on_tick() noexcept;
-#elif defined(XAML_UI_GTK3)
-    static gboolean on_timeout(xaml_timer_impl* self) noexcept;
 #elif defined(XAML_UI_QT)
     QTimer m_handle{};
+#elif defined(XAML_UI_GTK3) || defined(XAML_UI_HEADLESS)
+    xaml_timer_wheel<xaml_timer_impl>::node m_node{ this };
+    // The time of the next tick, before it is coalesced.
+    std::int64_t m_due{ 0 };
+
+    ~xaml_timer_impl() override;
 #endif // XAML_UI_WINDOWS
 
     xaml_timer_impl() noexcept
@@ -51,4 +63,34 @@ struct xaml_timer_impl : xaml_implement<xaml_timer_impl, xaml_timer>
     xaml_result XAML_CALL init() noexcept;
 };
 
+#if defined(XAML_UI_GTK3) || defined(XAML_UI_HEADLESS)
+// All timers of the UI thread share a timing wheel,
+// which is driven by one native source armed for the earliest deadline.
+struct xaml_timer_service
+{
+    xaml_timer_wheel<xaml_timer_impl> m_wheel{};
+    // The deadline the native source is armed for, or -1.
+    std::int64_t m_armed{ -1 };
+#ifdef XAML_UI_GTK3
+    GSource* m_source{ nullptr };
+#else
+    // The wake posted to the dispatcher, or zero.
+    std::uint64_t m_task{ 0 };
+#endif // XAML_UI_GTK3
+
+    void start(xaml_timer_impl* t) noexcept;
+    void stop(xaml_timer_impl* t) noexcept;
+    // Runs the timers due, and arms the source for the next one.
+    void on_wake() noexcept;
+    void rearm() noexcept;
+
+    // The monotonic time in milliseconds.
+    static std::int64_t now() noexcept;
+    // Arms the native source for the deadline, or disarms it with -1.
+    void arm(std::int64_t deadline) noexcept;
+};
+
+xaml_timer_service& xaml_timer_service_current() noexcept;
+#endif // XAML_UI_GTK3 || XAML_UI_HEADLESS
+
 #endif // !XMAL_UI_SHARED_TIMER_HPP
@@ -0,0 +1,226 @@
+#ifndef XAML_UI_SHARED_TIMER_WHEEL_HPP
+#define XAML_UI_SHARED_TIMER_WHEEL_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// A hierarchical timing wheel, with 4 levels of 64 slots.
+// A slot of level n spans 64^n ticks, so a deadline up to 64^4 ticks away
+// is placed in O(1), and moves down a level each time its slot comes round.
+// Further deadlines wait in the last level until they are near enough.
+// The nodes are intrusive, so that scheduling and cancelling never allocate.
+template <typename T>
+struct xaml_timer_wheel
+{
+    static constexpr int level_bits = 6;
+    static constexpr int levels = 4;
+    static constexpr std::int64_t slots = 1 << level_bits;
+    static constexpr std::int64_t span = std::int64_t{ 1 } << (level_bits * levels);
+
+    // The links of the circular lists, whose sentinels are the slots.
+    struct link
+    {
+        link* prev{ nullptr };
+        link* next{ nullptr };
+    };
+
+    struct node : link
+    {
+        T* owner;
+        std::int64_t deadline{ 0 };
+        int level{ 0 };
+        int index{ 0 };
+
+        node(T* owner) noexcept : owner(owner) {}
+        node(node const&) = delete;
+        node& operator=(node const&) = delete;
+
+        bool linked() const noexcept { return this->next != nullptr; }
+    };
+
+private:
+    link m_slots[levels][slots];
+    // A bit for each non-empty slot.
+    std::uint64_t m_used[levels]{};
+    std::size_t m_count{ 0 };
+    // The next tick to run; all deadlines before it have run.
+    std::int64_t m_now{ 0 };
+
+    static void remove(link* n) noexcept
+    {
+        n->prev->next = n->next;
+        n->next->prev = n->prev;
+        n->prev = n->next = nullptr;
+    }
+
+    void unlink(node* n) noexcept
+    {
+        remove(n);
+        link& h = m_slots[n->level][n->index];
+        if (h.next == &h) m_used[n->level] &= ~(std::uint64_t{ 1 } << n->index);
+        m_count--;
+    }
+
+    void place(node* n) noexcept
+    {
+        std::int64_t deadline = (std::max)(n->deadline, m_now);
+        std::int64_t delta = deadline - m_now;
+        if (delta >= span) deadline = m_now + span - 1, delta = span - 1;
+        int level = 0;
+        while (delta >= (std::int64_t{ 1 } << (level_bits * (level + 1)))) level++;
+        int index = (int)((deadline >> (level_bits * level)) & (slots - 1));
+        n->level = level;
+        n->index = index;
+        link& h = m_slots[level][index];
+        n->prev = h.prev;
+        n->next = &h;
+        h.prev->next = n;
+        h.prev = n;
+        m_used[level] |= std::uint64_t{ 1 } << index;
+        m_count++;
+    }
+
+    // Moves the nodes of the slot to the lower levels.
+    void cascade(int level, int index) noexcept
+    {
+        link& h = m_slots[level][index];
+        while (h.next != &h)
+        {
+            node* n = static_cast<node*>(h.next);
+            unlink(n);
+            place(n);
+        }
+    }
+
+    // Moves the clock, and cascades the slots of the higher levels
+    // as it enters them, so that no slot at the current position waits for it.
+    void move_to(std::int64_t now) noexcept
+    {
+        m_now = now;
+        if (now & (slots - 1)) return;
+        for (int l = 1; l < levels; l++)
+        {
+            int i = (int)((now >> (level_bits * l)) & (slots - 1));
+            cascade(l, i);
+            if (i) break;
+        }
+    }
+
+public:
+    xaml_timer_wheel() noexcept
+    {
+        for (int l = 0; l < levels; l++)
+        {
+            for (int i = 0; i < slots; i++)
+            {
+                m_slots[l][i] = { &m_slots[l][i], &m_slots[l][i] };
+            }
+        }
+    }
+
+    xaml_timer_wheel(xaml_timer_wheel const&) = delete;
+    xaml_timer_wheel& operator=(xaml_timer_wheel const&) = delete;
+
+    bool empty() const noexcept { return m_count == 0; }
+    std::size_t size() const noexcept { return m_count; }
+    std::int64_t now() const noexcept { return m_now; }
+
+    // Moves the clock of an empty wheel.
+    void reset(std::int64_t now) noexcept
+    {
+        if (empty()) m_now = now;
+    }
+
+    // Schedules the node, or moves it if it is scheduled.
+    // A deadline already passed runs at the next advance.
+    void schedule(node& n, std::int64_t deadline) noexcept
+    {
+        if (n.linked()) unlink(&n);
+        n.deadline = deadline;
+        place(&n);
+    }
+
+    void cancel(node& n) noexcept
+    {
+        if (n.linked()) unlink(&n);
+    }
+
+    // The earliest deadline scheduled, or -1 if it is empty.
+    std::int64_t next_deadline() noexcept
+    {
+        if (empty()) return -1;
+        std::int64_t result = -1;
+        for (int l = 0; l < levels; l++)
+        {
+            if (!m_used[l]) continue;
+            int pos = (int)((m_now >> (level_bits * l)) & (slots - 1));
+            if (l == 0)
+            {
+                // The slot of a deadline is unique in the lowest level.
+                int index = (pos + std::countr_zero(std::rotr(m_used[0], pos))) & (slots - 1);
+                result = m_now + ((index - pos) & (slots - 1));
+            }
+            else
+            {
+                // The slot at the current position of a higher level has been cascaded,
+                // so the nodes in it are the latest ones.
+                int start = (pos + 1) & (slots - 1);
+                int index = (start + std::countr_zero(std::rotr(m_used[l], start))) & (slots - 1);
+                link& h = m_slots[l][index];
+                for (link* n = h.next; n != &h; n = n->next)
+                {
+                    std::int64_t deadline = (std::max)(static_cast<node*>(n)->deadline, m_now);
+                    if (result < 0 || deadline < result) result = deadline;
+                }
+            }
+        }
+        return result;
+    }
+
+    // Runs the nodes with deadlines up to now, in the order of deadlines.
+    // A node is unscheduled before the function is called with its owner,
+    // and the function may schedule or cancel any node.
+    template <typename F>
+    void advance(std::int64_t now, F&& f) noexcept
+    {
+        while (m_now <= now)
+        {
+            if (empty())
+            {
+                m_now = now + 1;
+                return;
+            }
+            int index = (int)(m_now & (slots - 1));
+            std::uint64_t pending = m_used[0] >> index;
+            if (!(pending & 1))
+            {
+                // Skips the empty slots, at most to the next cascade.
+                std::int64_t next = pending ? m_now + std::countr_zero(pending) : (m_now | (slots - 1)) + 1;
+                move_to((std::min)(next, now + 1));
+                continue;
+            }
+            // The slot is moved to a local list and the clock moves on,
+            // so that nodes scheduled by the function run at the next tick.
+            link local{};
+            link& h = m_slots[0][index];
+            local.prev = h.prev;
+            local.next = h.next;
+            h.next->prev = &local;
+            h.prev->next = &local;
+            h.next = h.prev = &h;
+            m_used[0] &= ~(std::uint64_t{ 1 } << index);
+            move_to(m_now + 1);
+            while (local.next != &local)
+            {
+                node* n = static_cast<node*>(local.next);
+                remove(n);
+                m_count--;
+                f(n->owner);
+            }
+        }
+    }
+};
+
+#endif // !XAML_UI_SHARED_TIMER_WHEEL_HPP
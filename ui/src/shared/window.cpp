@@ -1,5 +1,6 @@
 #include <shared/menu_bar.hpp>
 #include <shared/window.hpp>
+#include <utility>
 #include <xaml/ui/window.h>
 
 using namespace std;
@@ -20,7 +21,7 @@ xaml_result xaml_window_internal::init() noexcept
     int32_t token;
     XAML_RETURN_IF_FAILED((m_location_changed->add(
         [this](xaml_object*, xaml_point) noexcept -> xaml_result {
-            if (m_handle && !m_resizing) XAML_RETURN_IF_FAILED(draw({}));
+            if (m_handle && !m_resizing) XAML_RETURN_IF_FAILED(invalidate_layout(xaml_layout_arrange));
             return XAML_S_OK;
         },
         &token)));
@@ -39,6 +40,39 @@ xaml_result xaml_window_internal::init() noexcept
     return XAML_S_OK;
 }
 
+xaml_result xaml_window_internal::invalidate_layout(int flags) noexcept
+{
+    // Nothing to lay out until the window is created by show().
+    if (!m_handle) return XAML_S_OK;
+    bool pending = m_layout_invalid != xaml_layout_valid;
+    m_layout_invalid |= flags;
+    if (!pending)
+    {
+        xaml_result hr = post_layout();
+        if (XAML_FAILED(hr))
+        {
+            m_layout_invalid = xaml_layout_valid;
+            return hr;
+        }
+    }
+    return XAML_S_OK;
+}
+
+xaml_result xaml_window_internal::update_layout() noexcept
+{
+    int flags = exchange(m_layout_invalid, (int)xaml_layout_valid);
+    if (!m_handle) return XAML_S_OK;
+    if (flags & xaml_layout_measure)
+    {
+        return draw({});
+    }
+    else if (flags & xaml_layout_arrange)
+    {
+        return draw_size();
+    }
+    return XAML_S_OK;
+}
+
 xaml_result XAML_CALL xaml_window_new(xaml_window** ptr) noexcept
 {
     return xaml_object_init<xaml_window_impl>(ptr);
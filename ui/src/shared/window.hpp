@@ -10,9 +10,12 @@
 #elif defined(XAML_UI_QT)
     #include <QMainWindow>
     #include <xaml/ui/qt5/window.hpp>
+#elif defined(XAML_UI_HEADLESS)
+    #include <xaml/ui/headless/window.h>
 #endif // XAML_UI_WINDOWS
 
 #include <atomic>
+#include <cstdint>
 #include <shared/container.hpp>
 #include <xaml/ui/window.h>
 
@@ -25,6 +28,16 @@ struct xaml_window_internal : xaml_container_internal
     XAML_PROP_PTR_IMPL(menu_bar, xaml_control)
 
     XAML_UI_API xaml_result XAML_CALL draw(xaml_rectangle const&) noexcept override;
+
+    // Invalidations since the last layout pass; a pass is posted when it becomes non-zero.
+    int m_layout_invalid{ xaml_layout_valid };
+
+    XAML_UI_API xaml_result XAML_CALL invalidate_layout(int) noexcept override;
+    // Runs the pending layout pass, once for all the invalidations before it.
+    XAML_UI_API xaml_result XAML_CALL update_layout() noexcept;
+    // Schedules update_layout on the next idle tick of the native loop.
+    XAML_UI_API xaml_result XAML_CALL post_layout() noexcept;
+
     XAML_UI_API xaml_result XAML_CALL show() noexcept;
     XAML_UI_API xaml_result XAML_CALL close() noexcept;
     XAML_UI_API xaml_result XAML_CALL hide() noexcept;
@@ -107,10 +120,16 @@ struct xaml_window_internal : xaml_container_internal
     static void on_destroy(GtkWidget*, xaml_window_internal*) noexcept;
     static gboolean on_delete_event(GtkWidget*, GdkEvent*, xaml_window_internal*) noexcept;
     static gboolean on_configure_event(GtkWidget*, GdkEvent*, xaml_window_internal*) noexcept;
+
+    guint m_layout_source{ 0 };
+    static gboolean on_layout_idle(xaml_window_internal*) noexcept;
 #elif defined(XAML_UI_QT)
     void on_resize_event(QResizeEvent* event) noexcept;
     void on_move_event(QMoveEvent* event) noexcept;
     void on_close_event(QCloseEvent* event) noexcept;
+#elif defined(XAML_UI_HEADLESS)
+    // The layout pass posted to the dispatcher, or zero.
+    std::uint64_t m_layout_task{ 0 };
 #endif // XAML_UI_WINDOWS
 
     XAML_UI_API xaml_window_internal() noexcept;
@@ -192,6 +211,12 @@ struct xaml_window_implement : xaml_container_implement<T, Internal, Base>
     } m_native_window;
 
     using native_window_type = xaml_qt5_window;
+#elif defined(XAML_UI_HEADLESS)
+    struct xaml_headless_window_impl : xaml_headless_control_implement<xaml_headless_window_impl, T, xaml_headless_window>
+    {
+    } m_native_window;
+
+    using native_window_type = xaml_headless_window;
 #endif // XAML_UI_WINDOWS
 
     xaml_result XAML_CALL query(xaml_guid const& type, void** ptr) noexcept override
@@ -21,6 +21,9 @@ using namespace std;
 
 static unordered_map<HWND, xaml_ptr<xaml_weak_reference>> window_map;
 
+// Posted to run the pending layout pass.
+constexpr UINT WM_XAML_LAYOUT = WM_APP + 1;
+
 static wil::unique_hbrush edit_normal_back{ CreateSolidBrush(RGB(33, 33, 33)) };
 constexpr COLORREF black_color{ RGB(0, 0, 0) };
 constexpr COLORREF white_color{ RGB(255, 255, 255) };
@@ -120,6 +123,12 @@ xaml_result xaml_window_internal::draw(xaml_rectangle const&) noexcept
     return XAML_S_OK;
 }
 
+xaml_result xaml_window_internal::post_layout() noexcept
+{
+    XAML_RETURN_IF_WIN32_BOOL_FALSE(PostMessage(m_handle, WM_XAML_LAYOUT, 0, 0));
+    return XAML_S_OK;
+}
+
 xaml_result xaml_window_internal::draw_size() noexcept
 {
     xaml_atomic_guard guard(m_resizing);
@@ -279,6 +288,10 @@ xaml_result xaml_window_internal::wnd_proc(xaml_win32_window_message const& msg,
             }
             break;
         }
+        case WM_XAML_LAYOUT:
+            XAML_RETURN_IF_FAILED(update_layout());
+            *presult = 0;
+            return XAML_S_OK;
         case WM_CLOSE:
         {
             xaml_ptr<xaml_box<bool>> handled;
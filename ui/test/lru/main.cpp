@@ -0,0 +1,56 @@
+#include <iostream>
+#include <shared/lru_cache.hpp>
+#include <string>
+#include <string_view>
+#include <test_check.hpp>
+
+using namespace std;
+
+// Looked up by views, without building strings.
+using cache_type = xaml_lru_cache<string, int, string_view>;
+
+static void test_eviction()
+{
+    cache_type cache{ 2 };
+    cache.insert("a", 1);
+    cache.insert("b", 2);
+    // Touching "a" makes "b" the least recent one.
+    CHECK(cache.find("a"sv) && *cache.find("a"sv) == 1);
+    cache.insert("c", 3);
+    CHECK(cache.size() == 2);
+    CHECK(!cache.find("b"sv));
+    CHECK(cache.find("c"sv) && *cache.find("c"sv) == 3);
+    CHECK(cache.hits() == 4 && cache.misses() == 1);
+
+    // Replacing keeps the count.
+    cache.insert("c", 4);
+    CHECK(cache.size() == 2 && *cache.find("c"sv) == 4);
+
+    cache.set_capacity(1);
+    CHECK(cache.size() == 1 && cache.find("c"sv));
+    CHECK(*cache.insert("d", 5) == 5);
+    CHECK(cache.size() == 1 && !cache.find("c"sv));
+
+    cache.clear();
+    CHECK(cache.size() == 0 && !cache.find("d"sv));
+}
+
+static void test_churn()
+{
+    cache_type cache{ 64 };
+    for (int i = 0; i < 10000; i++)
+    {
+        string key = to_string(i % 100);
+        if (!cache.find(key)) cache.insert(key, i);
+        CHECK(cache.size() <= 64);
+    }
+    // Cycling over more keys than the capacity never hits.
+    CHECK(cache.hits() == 0 && cache.misses() == 10000);
+}
+
+int main()
+{
+    test_eviction();
+    test_churn();
+    return report_failures();
+}
@@ -1,6 +1,7 @@
 #ifndef XAML_UI_CANVAS_CANVAS_H
 #define XAML_UI_CANVAS_CANVAS_H
 
+#include <xaml/buffer.h>
 #include <xaml/ui/control.h>
 #include <xaml/ui/controls/brush.h>
 #include <xaml/ui/controls/pen.h>
@@ -16,34 +17,72 @@ typedef struct xaml_drawing_font
     xaml_valignment valign;
 } xaml_drawing_font;
 
+#ifndef xaml_enumerator_1__xaml_rectangle_defined
+    #define xaml_enumerator_1__xaml_rectangle_defined
+XAML_ENUMERATOR_1_TYPE(XAML_T_V(xaml_rectangle))
+#endif // !xaml_enumerator_1__xaml_rectangle_defined
+
+#ifndef xaml_vector_view_1__xaml_rectangle_defined
+    #define xaml_vector_view_1__xaml_rectangle_defined
+XAML_VECTOR_VIEW_1_TYPE(XAML_T_V(xaml_rectangle))
+#endif // !xaml_vector_view_1__xaml_rectangle_defined
+
 XAML_CLASS(xaml_drawing_context, { 0xf8b2a81c, 0x11ea, 0x4f0a, { 0x94, 0x97, 0x30, 0x4c, 0x90, 0x65, 0xa4, 0xe4 } })
 
-#define XAML_DRAWING_CONTEXT_VTBL(type)                                                                                     \
-    XAML_VTBL_INHERIT(XAML_OBJECT_VTBL(type));                                                                              \
-    XAML_METHOD(draw_arc, type, xaml_pen*, xaml_rectangle XAML_CONST_REF, double, double);                                  \
-    XAML_METHOD(fill_pie, type, xaml_brush*, xaml_rectangle XAML_CONST_REF, double, double);                                \
-    XAML_METHOD(draw_ellipse, type, xaml_pen*, xaml_rectangle XAML_CONST_REF);                                              \
-    XAML_METHOD(fill_ellipse, type, xaml_brush*, xaml_rectangle XAML_CONST_REF);                                            \
-    XAML_METHOD(draw_line, type, xaml_pen*, xaml_point XAML_CONST_REF, xaml_point XAML_CONST_REF);                          \
-    XAML_METHOD(draw_rect, type, xaml_pen*, xaml_rectangle XAML_CONST_REF);                                                 \
-    XAML_METHOD(fill_rect, type, xaml_brush*, xaml_rectangle XAML_CONST_REF);                                               \
-    XAML_METHOD(draw_round_rect, type, xaml_pen*, xaml_rectangle XAML_CONST_REF, xaml_size XAML_CONST_REF);                 \
-    XAML_METHOD(fill_round_rect, type, xaml_brush*, xaml_rectangle XAML_CONST_REF, xaml_size XAML_CONST_REF);               \
-    XAML_METHOD(draw_string, type, xaml_brush*, xaml_drawing_font XAML_CONST_REF, xaml_point XAML_CONST_REF, xaml_string*); \
-    XAML_METHOD(measure_string, type, xaml_drawing_font XAML_CONST_REF, xaml_point XAML_CONST_REF, xaml_string*, xaml_rectangle*)
+#define XAML_DRAWING_CONTEXT_VTBL(type)                                                                                            \
+    XAML_VTBL_INHERIT(XAML_OBJECT_VTBL(type));                                                                                     \
+    XAML_METHOD(draw_arc, type, xaml_pen*, xaml_rectangle XAML_CONST_REF, double, double);                                         \
+    XAML_METHOD(fill_pie, type, xaml_brush*, xaml_rectangle XAML_CONST_REF, double, double);                                       \
+    XAML_METHOD(draw_ellipse, type, xaml_pen*, xaml_rectangle XAML_CONST_REF);                                                     \
+    XAML_METHOD(fill_ellipse, type, xaml_brush*, xaml_rectangle XAML_CONST_REF);                                                   \
+    XAML_METHOD(draw_line, type, xaml_pen*, xaml_point XAML_CONST_REF, xaml_point XAML_CONST_REF);                                 \
+    XAML_METHOD(draw_rect, type, xaml_pen*, xaml_rectangle XAML_CONST_REF);                                                        \
+    XAML_METHOD(fill_rect, type, xaml_brush*, xaml_rectangle XAML_CONST_REF);                                                      \
+    XAML_METHOD(draw_round_rect, type, xaml_pen*, xaml_rectangle XAML_CONST_REF, xaml_size XAML_CONST_REF);                        \
+    XAML_METHOD(fill_round_rect, type, xaml_brush*, xaml_rectangle XAML_CONST_REF, xaml_size XAML_CONST_REF);                      \
+    XAML_METHOD(draw_string, type, xaml_brush*, xaml_drawing_font XAML_CONST_REF, xaml_point XAML_CONST_REF, xaml_string*);        \
+    XAML_METHOD(measure_string, type, xaml_drawing_font XAML_CONST_REF, xaml_point XAML_CONST_REF, xaml_string*, xaml_rectangle*); \
+    XAML_METHOD(get_clip, type, xaml_rectangle*);                                                                                  \
+    XAML_METHOD(get_dirty_rects, type, XAML_VECTOR_VIEW_1_NAME(xaml_rectangle)**)
 
 XAML_DECL_INTERFACE_(xaml_drawing_context, xaml_object)
 {
     XAML_DECL_VTBL(xaml_drawing_context, XAML_DRAWING_CONTEXT_VTBL);
 };
 
+// An offscreen image to draw on, without a window or a display.
+// The pixels are 32-bit premultiplied ARGB in native byte order, row by row with the stride.
+// It is supported by the GTK3 and Qt backends; Qt needs an initialized application to draw strings.
+XAML_CLASS(xaml_drawing_surface, { 0xb534f126, 0x4e85, 0x4f0f, { 0x86, 0xee, 0xbc, 0x54, 0xb4, 0xbc, 0x3f, 0x48 } })
+
+#define XAML_DRAWING_SURFACE_VTBL(type)                     \
+    XAML_VTBL_INHERIT(XAML_OBJECT_VTBL(type));              \
+    XAML_METHOD(get_size, type, xaml_size*);                \
+    XAML_METHOD(get_stride, type, XAML_STD int32_t*);       \
+    XAML_METHOD(get_context, type, xaml_drawing_context**); \
+    XAML_METHOD(clear, type, xaml_color);                   \
+    XAML_METHOD(get_pixels, type, xaml_buffer**);           \
+    XAML_METHOD(encode_png, type, xaml_buffer**);           \
+    XAML_METHOD(save_png, type, xaml_string*)
+
+XAML_DECL_INTERFACE_(xaml_drawing_surface, xaml_object)
+{
+    XAML_DECL_VTBL(xaml_drawing_surface, XAML_DRAWING_SURFACE_VTBL);
+};
+
+EXTERN_C XAML_UI_CANVAS_API xaml_result XAML_CALL xaml_drawing_surface_new(XAML_STD int32_t, XAML_STD int32_t, xaml_drawing_surface**) XAML_NOEXCEPT;
+
+// The drawing context only covers the dirty rectangles, and primitives outside them are skipped.
+// A cached canvas keeps its drawing in offscreen tiles, and only redraws the invalidated ones;
+// the cache is supported by the GTK3 and Qt backends.
 XAML_CLASS(xaml_canvas, { 0x111d5785, 0x4e7e, 0x48c6, { 0x8d, 0xd6, 0x39, 0xab, 0x4a, 0x9c, 0x19, 0x97 } })
 
-#define XAML_CANVAS_VTBL(type)                                   \
-    XAML_VTBL_INHERIT(XAML_CONTROL_VTBL(type));                  \
-    XAML_EVENT(redraw, type, xaml_object, xaml_drawing_context); \
-    XAML_METHOD(invalidate, type);                               \
-    XAML_METHOD(invalidate_rect, type, xaml_rectangle XAML_CONST_REF)
+#define XAML_CANVAS_VTBL(type)                                         \
+    XAML_VTBL_INHERIT(XAML_CONTROL_VTBL(type));                        \
+    XAML_EVENT(redraw, type, xaml_object, xaml_drawing_context);       \
+    XAML_METHOD(invalidate, type);                                     \
+    XAML_METHOD(invalidate_rect, type, xaml_rectangle XAML_CONST_REF); \
+    XAML_PROP(is_cached, type, bool*, bool)
 
 XAML_DECL_INTERFACE_(xaml_canvas, xaml_control)
 {
@@ -54,4 +93,9 @@ EXTERN_C XAML_UI_CANVAS_API xaml_result XAML_CALL xaml_canvas_new(xaml_canvas**)
 EXTERN_C XAML_UI_CANVAS_API xaml_result XAML_CALL xaml_canvas_members(xaml_type_info_registration*) XAML_NOEXCEPT;
 EXTERN_C XAML_UI_CANVAS_API xaml_result XAML_CALL xaml_canvas_register(xaml_meta_context*) XAML_NOEXCEPT;
 
+// Measured and shaped text is cached by the font and the text, and shared by all drawing contexts.
+// The counters are only maintained by the GTK3 and Qt backends.
+EXTERN_C XAML_UI_CANVAS_API xaml_result XAML_CALL xaml_drawing_text_cache_get_stats(XAML_STD int64_t*, XAML_STD int64_t*) XAML_NOEXCEPT;
+EXTERN_C XAML_UI_CANVAS_API xaml_result XAML_CALL xaml_drawing_text_cache_set_capacity(XAML_STD int32_t) XAML_NOEXCEPT;
+
 #endif // !XAML_UI_CANVAS_CANVAS_H
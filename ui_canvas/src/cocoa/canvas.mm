@@ -133,6 +133,7 @@ static constexpr tuple<xaml_size, xaml_rectangle> get_scaled_rect(xaml_size cons
 
 xaml_result xaml_drawing_context_impl::draw_arc(xaml_pen* pen, xaml_rectangle const& region, double start_angle, double end_angle) noexcept
 {
+    CHECK_STROKE_VISIBLE(pen, region);
     [[NSGraphicsContext currentContext] saveGraphicsState];
     NSBezierPath* arc = path_arc(m_size, region, start_angle, end_angle);
     auto [scaled_size, scaled_region] = get_scaled_rect(m_size, region);
@@ -143,6 +144,7 @@ xaml_result xaml_drawing_context_impl::draw_arc(xaml_pen* pen, xaml_rectangle co
 
 xaml_result xaml_drawing_context_impl::fill_pie(xaml_brush* brush, xaml_rectangle const& region, double start_angle, double end_angle) noexcept
 {
+    CHECK_VISIBLE(region);
     [[NSGraphicsContext currentContext] saveGraphicsState];
     NSBezierPath* arc = path_arc(m_size, region, start_angle, end_angle);
     [arc closePath];
@@ -159,12 +161,14 @@ static NSBezierPath* path_ellipse(xaml_size const& base_size, xaml_rectangle con
 
 xaml_result xaml_drawing_context_impl::draw_ellipse(xaml_pen* pen, xaml_rectangle const& region) noexcept
 {
+    CHECK_STROKE_VISIBLE(pen, region);
     NSBezierPath* ellipse = path_ellipse(m_size, region);
     return set_pen(ellipse, pen, m_size, region);
 }
 
 xaml_result xaml_drawing_context_impl::fill_ellipse(xaml_brush* brush, xaml_rectangle const& region) noexcept
 {
+    CHECK_VISIBLE(region);
     NSBezierPath* ellipse = path_ellipse(m_size, region);
     return set_brush(ellipse, brush, m_size, region);
 }
@@ -173,10 +177,12 @@ xaml_result xaml_drawing_context_impl::draw_line(xaml_pen* pen, xaml_point const
 {
     xaml_point minp{ (min)(startp.x, endp.x), (min)(startp.y, endp.y) };
     xaml_point maxp{ (max)(startp.x, endp.x), (max)(startp.y, endp.y) };
+    xaml_rectangle region = { minp.x, minp.y, maxp.x - minp.x, maxp.y - minp.y };
+    CHECK_STROKE_VISIBLE(pen, region);
     NSBezierPath* line = [NSBezierPath bezierPath];
     [line moveToPoint:NSMakePoint(startp.x, m_size.height - startp.y)];
     [line lineToPoint:NSMakePoint(endp.x, m_size.height - endp.y)];
-    return set_pen(line, pen, m_size, { minp.x, minp.y, maxp.x - minp.x, maxp.y - minp.y });
+    return set_pen(line, pen, m_size, region);
 }
 
 static NSBezierPath* path_rect(xaml_size const& base_size, xaml_rectangle const& rect) noexcept
@@ -186,12 +192,14 @@ static NSBezierPath* path_rect(xaml_size const& base_size, xaml_rectangle const&
 
 xaml_result xaml_drawing_context_impl::draw_rect(xaml_pen* pen, xaml_rectangle const& rect) noexcept
 {
+    CHECK_STROKE_VISIBLE(pen, rect);
     NSBezierPath* path = path_rect(m_size, rect);
     return set_pen(path, pen, m_size, rect);
 }
 
 xaml_result xaml_drawing_context_impl::fill_rect(xaml_brush* brush, xaml_rectangle const& rect) noexcept
 {
+    CHECK_VISIBLE(rect);
     NSBezierPath* path = path_rect(m_size, rect);
     return set_brush(path, brush, m_size, rect);
 }
@@ -205,12 +213,14 @@ static NSBezierPath* path_round_rect(xaml_size const& base_size, xaml_rectangle
 
 xaml_result xaml_drawing_context_impl::draw_round_rect(xaml_pen* pen, xaml_rectangle const& rect, xaml_size const& round) noexcept
 {
+    CHECK_STROKE_VISIBLE(pen, rect);
     NSBezierPath* path = path_round_rect(m_size, rect, round);
     return set_pen(path, pen, m_size, rect);
 }
 
 xaml_result xaml_drawing_context_impl::fill_round_rect(xaml_brush* brush, xaml_rectangle const& rect, xaml_size const& round) noexcept
 {
+    CHECK_VISIBLE(rect);
     NSBezierPath* path = path_round_rect(m_size, rect, round);
     return set_brush(path, brush, m_size, rect);
 }
@@ -272,6 +282,7 @@ xaml_result xaml_drawing_context_impl::draw_string(xaml_brush* brush, xaml_drawi
     xaml_rectangle rect;
     NSAttributedString* astr;
     XAML_RETURN_IF_FAILED(measure_string_impl(font, p, str, &rect, &astr));
+    CHECK_VISIBLE(rect);
     auto location = NSMakePoint(rect.x, m_size.height - rect.y - rect.height);
     return draw_mask(
         m_size,
@@ -303,10 +314,29 @@ xaml_result xaml_canvas_internal::draw(const xaml_rectangle& region) noexcept
     return XAML_S_OK;
 }
 
+static xaml_result get_rects_being_drawn(NSView* view, xaml_size const& size, vector<xaml_rectangle>* prects) noexcept
+try
+{
+    NSRect const* rects;
+    NSInteger count;
+    [view getRectsBeingDrawn:&rects count:&count];
+    for (NSInteger i = 0; i < count; i++)
+    {
+        xaml_rectangle r = xaml_from_native(rects[i]);
+        // The view isn't flipped.
+        prects->push_back({ r.x, size.height - r.y - r.height, r.width, r.height });
+    }
+    return XAML_S_OK;
+}
+XAML_CATCH_RETURN()
+
 void xaml_canvas_internal::on_draw_rect() noexcept
 {
-    xaml_ptr<xaml_drawing_context> dc;
+    vector<xaml_rectangle> rects;
+    XAML_ASSERT_SUCCEEDED(get_rects_being_drawn(m_handle, m_size, &rects));
+    xaml_ptr<xaml_drawing_context_impl> dc;
     XAML_ASSERT_SUCCEEDED(xaml_object_new<xaml_drawing_context_impl>(&dc, m_size));
+    XAML_ASSERT_SUCCEEDED(dc->set_dirty_rects(move(rects)));
     XAML_ASSERT_SUCCEEDED(m_redraw->invoke(m_outer_this, dc));
 }
 
@@ -314,7 +344,7 @@ xaml_result xaml_canvas_internal::invalidate(const xaml_rectangle* prect) noexce
 {
     if (prect)
     {
-        NSRect r = xaml_to_native<NSRect>(*prect);
+        NSRect r = xaml_to_native<NSRect>(xaml_rectangle{ prect->x, m_size.height - prect->y - prect->height, prect->width, prect->height });
         [m_handle setNeedsDisplayInRect:r];
     }
     else
@@ -6,9 +6,19 @@
 
 using namespace std;
 
+// Consecutive primitives with the same brush keep the source as is.
+static void set_source(cairo_t* handle, cairo_pattern_t* pattern) noexcept
+{
+    if (cairo_get_source(handle) != pattern) cairo_set_source(handle, pattern);
+}
+
 xaml_result xaml_solid_brush_impl::set(cairo_t* handle, xaml_rectangle const&) noexcept
 {
-    cairo_set_source_rgba(handle, m_color.r / 255.0, m_color.g / 255.0, m_color.b / 255.0, m_color.a / 255.0);
+    if (!m_pattern)
+    {
+        m_pattern.reset(cairo_pattern_create_rgba(m_color.r / 255.0, m_color.g / 255.0, m_color.b / 255.0, m_color.a / 255.0));
+    }
+    set_source(handle, m_pattern.get());
     return XAML_S_OK;
 }
 
@@ -24,32 +34,48 @@ static xaml_result add_stops(cairo_pattern_t* pattern, xaml_ptr<xaml_vector<xaml
 
 xaml_result xaml_linear_gradient_brush_impl::set(cairo_t* handle, xaml_rectangle const& region) noexcept
 {
-    xaml_point real_start_point = lerp_point(region, m_start_point);
-    xaml_point real_end_point = lerp_point(region, m_end_point);
-    unique_ptr<cairo_pattern_t, g_free_deleter<cairo_pattern_t, cairo_pattern_destroy>> pattern{
-        cairo_pattern_create_linear(
-            real_start_point.x, real_start_point.y,
-            real_end_point.x, real_end_point.y)
-    };
-    XAML_RETURN_IF_FAILED(add_stops(pattern.get(), m_gradient_stops));
-    cairo_set_source(handle, pattern.get());
+    xaml_size size{ region.width, region.height };
+    if (!m_pattern || m_pattern_size != size)
+    {
+        xaml_point real_start_point = lerp_point({ 0, 0, size.width, size.height }, m_start_point);
+        xaml_point real_end_point = lerp_point({ 0, 0, size.width, size.height }, m_end_point);
+        decltype(m_pattern) pattern{
+            cairo_pattern_create_linear(
+                real_start_point.x, real_start_point.y,
+                real_end_point.x, real_end_point.y)
+        };
+        XAML_RETURN_IF_FAILED(add_stops(pattern.get(), m_gradient_stops));
+        m_pattern = move(pattern);
+        m_pattern_size = size;
+    }
+    cairo_matrix_t matrix{};
+    cairo_matrix_init_translate(&matrix, -region.x, -region.y);
+    cairo_pattern_set_matrix(m_pattern.get(), &matrix);
+    set_source(handle, m_pattern.get());
     return XAML_S_OK;
 }
 
 xaml_result xaml_radial_gradient_brush_impl::set(cairo_t* handle, xaml_rectangle const& region) noexcept
 {
-    xaml_point real_origin = lerp_point(region, m_origin);
-    xaml_point real_center = lerp_point(region, m_center);
+    xaml_size size{ region.width, region.height };
     double rate = region.height / region.width * m_radius.height / m_radius.width;
-    unique_ptr<cairo_pattern_t, g_free_deleter<cairo_pattern_t, cairo_pattern_destroy>> pattern{
-        cairo_pattern_create_radial(
-            real_origin.x, real_origin.y / rate, 0,
-            real_center.x, real_center.y / rate, m_radius.width * region.width)
-    };
+    if (!m_pattern || m_pattern_size != size)
+    {
+        xaml_point real_origin = lerp_point({ 0, 0, size.width, size.height }, m_origin);
+        xaml_point real_center = lerp_point({ 0, 0, size.width, size.height }, m_center);
+        decltype(m_pattern) pattern{
+            cairo_pattern_create_radial(
+                real_origin.x, real_origin.y / rate, 0,
+                real_center.x, real_center.y / rate, m_radius.width * region.width)
+        };
+        XAML_RETURN_IF_FAILED(add_stops(pattern.get(), m_gradient_stops));
+        m_pattern = move(pattern);
+        m_pattern_size = size;
+    }
     cairo_matrix_t matrix{};
     cairo_matrix_init_scale(&matrix, 1, 1 / rate);
-    cairo_pattern_set_matrix(pattern.get(), &matrix);
-    XAML_RETURN_IF_FAILED(add_stops(pattern.get(), m_gradient_stops));
-    cairo_set_source(handle, pattern.get());
+    cairo_matrix_translate(&matrix, -region.x, -region.y);
+    cairo_pattern_set_matrix(m_pattern.get(), &matrix);
+    set_source(handle, m_pattern.get());
     return XAML_S_OK;
 }
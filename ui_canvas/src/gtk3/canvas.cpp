@@ -8,18 +8,28 @@
 
 using namespace std;
 
-static xaml_result set_pen(cairo_t* handle, xaml_pen* pen, xaml_rectangle const& region) noexcept
+xaml_result xaml_drawing_context_impl::set_pen(xaml_pen* pen, xaml_rectangle const& region) noexcept
 {
-    xaml_ptr<xaml_gtk3_pen> native_pen;
-    XAML_RETURN_IF_FAILED(pen->query(&native_pen));
-    return native_pen->set(handle, region);
+    if (m_pen.get() != pen)
+    {
+        xaml_ptr<xaml_gtk3_pen> native_pen;
+        XAML_RETURN_IF_FAILED(pen->query(&native_pen));
+        m_pen = pen;
+        m_native_pen = native_pen;
+    }
+    return m_native_pen->set(m_handle, region);
 }
 
-static xaml_result set_brush(cairo_t* handle, xaml_brush* brush, xaml_rectangle const& region) noexcept
+xaml_result xaml_drawing_context_impl::set_brush(xaml_brush* brush, xaml_rectangle const& region) noexcept
 {
-    xaml_ptr<xaml_gtk3_brush> native_brush;
-    XAML_RETURN_IF_FAILED(brush->query(&native_brush));
-    return native_brush->set(handle, region);
+    if (m_brush.get() != brush)
+    {
+        xaml_ptr<xaml_gtk3_brush> native_brush;
+        XAML_RETURN_IF_FAILED(brush->query(&native_brush));
+        m_brush = brush;
+        m_native_brush = native_brush;
+    }
+    return m_native_brush->set(m_handle, region);
 }
 
 static void path_arc(cairo_t* handle, xaml_rectangle const& region, double start_angle, double end_angle) noexcept
@@ -35,16 +45,18 @@ static void path_arc(cairo_t* handle, xaml_rectangle const& region, double start
 
 xaml_result xaml_drawing_context_impl::draw_arc(xaml_pen* pen, xaml_rectangle const& region, double start_angle, double end_angle) noexcept
 {
+    CHECK_STROKE_VISIBLE(pen, region);
     path_arc(m_handle, region, start_angle, end_angle);
-    XAML_RETURN_IF_FAILED(set_pen(m_handle, pen, region));
+    XAML_RETURN_IF_FAILED(set_pen(pen, region));
     cairo_stroke(m_handle);
     return XAML_S_OK;
 }
 
 xaml_result xaml_drawing_context_impl::fill_pie(xaml_brush* brush, xaml_rectangle const& region, double start_angle, double end_angle) noexcept
 {
+    CHECK_VISIBLE(region);
     path_arc(m_handle, region, start_angle, end_angle);
-    XAML_RETURN_IF_FAILED(set_brush(m_handle, brush, region));
+    XAML_RETURN_IF_FAILED(set_brush(brush, region));
     cairo_fill(m_handle);
     return XAML_S_OK;
 }
@@ -63,10 +75,12 @@ xaml_result xaml_drawing_context_impl::draw_line(xaml_pen* pen, xaml_point const
 {
     xaml_point minp{ (min)(startp.x, endp.x), (min)(startp.y, endp.y) };
     xaml_point maxp{ (max)(startp.x, endp.x), (max)(startp.y, endp.y) };
+    xaml_rectangle region = { minp.x, minp.y, maxp.x - minp.x, maxp.y - minp.y };
+    CHECK_STROKE_VISIBLE(pen, region);
     cairo_new_path(m_handle);
     cairo_move_to(m_handle, startp.x, startp.y);
     cairo_line_to(m_handle, endp.x, endp.y);
-    XAML_RETURN_IF_FAILED(set_pen(m_handle, pen, { minp.x, minp.y, maxp.x - minp.x, maxp.y - minp.y }));
+    XAML_RETURN_IF_FAILED(set_pen(pen, region));
     cairo_stroke(m_handle);
     return XAML_S_OK;
 }
@@ -79,16 +93,18 @@ static void path_rect(cairo_t* handle, xaml_rectangle const& rect) noexcept
 
 xaml_result xaml_drawing_context_impl::draw_rect(xaml_pen* pen, xaml_rectangle const& rect) noexcept
 {
+    CHECK_STROKE_VISIBLE(pen, rect);
     path_rect(m_handle, rect);
-    XAML_RETURN_IF_FAILED(set_pen(m_handle, pen, rect));
+    XAML_RETURN_IF_FAILED(set_pen(pen, rect));
     cairo_stroke(m_handle);
     return XAML_S_OK;
 }
 
 xaml_result xaml_drawing_context_impl::fill_rect(xaml_brush* brush, const xaml_rectangle& rect) noexcept
 {
+    CHECK_VISIBLE(rect);
     path_rect(m_handle, rect);
-    XAML_RETURN_IF_FAILED(set_brush(m_handle, brush, rect));
+    XAML_RETURN_IF_FAILED(set_brush(brush, rect));
     cairo_fill(m_handle);
     return XAML_S_OK;
 }
@@ -109,40 +125,54 @@ static void path_round_rect(cairo_t* handle, xaml_rectangle const& rect, xaml_si
 
 xaml_result xaml_drawing_context_impl::draw_round_rect(xaml_pen* pen, xaml_rectangle const& rect, xaml_size const& round) noexcept
 {
+    CHECK_STROKE_VISIBLE(pen, rect);
     path_round_rect(m_handle, rect, round);
-    XAML_RETURN_IF_FAILED(set_pen(m_handle, pen, rect));
+    XAML_RETURN_IF_FAILED(set_pen(pen, rect));
     cairo_stroke(m_handle);
     return XAML_S_OK;
 }
 
 xaml_result xaml_drawing_context_impl::fill_round_rect(xaml_brush* brush, xaml_rectangle const& rect, xaml_size const& round) noexcept
 {
+    CHECK_VISIBLE(rect);
     path_round_rect(m_handle, rect, round);
-    XAML_RETURN_IF_FAILED(set_brush(m_handle, brush, rect));
+    XAML_RETURN_IF_FAILED(set_brush(brush, rect));
     cairo_fill(m_handle);
     return XAML_S_OK;
 }
 
-xaml_result xaml_drawing_context_impl::draw_string(xaml_brush* brush, xaml_drawing_font const& font, xaml_point const& p, xaml_string* str) noexcept
+void xaml_drawing_context_impl::select_font(xaml_drawing_font const& font) noexcept
 {
-    xaml_rectangle rect;
-    XAML_RETURN_IF_FAILED(measure_string(font, p, str, &rect));
-    cairo_move_to(m_handle, rect.x, rect.y + rect.height);
-    XAML_RETURN_IF_FAILED(set_brush(m_handle, brush, rect));
-    char const* data;
-    XAML_RETURN_IF_FAILED(str->get_data(&data));
-    cairo_show_text(m_handle, data);
+    if (!m_font_selected || !xaml_text_key_equal{}(m_font, xaml_text_key_of(font, {})))
+    {
+        cairo_select_font_face(m_handle, font.font_family, font.italic ? CAIRO_FONT_SLANT_ITALIC : CAIRO_FONT_SLANT_NORMAL, font.bold ? CAIRO_FONT_WEIGHT_BOLD : CAIRO_FONT_WEIGHT_NORMAL);
+        cairo_set_font_size(m_handle, font.size);
+        m_font = xaml_text_key_copy(xaml_text_key_of(font, {}));
+        m_font_selected = true;
+    }
+}
+
+xaml_result xaml_drawing_context_impl::get_text_layout(xaml_drawing_font const& font, string_view text, xaml_text_layout** ptr) noexcept
+try
+{
+    auto key = xaml_text_key_of(font, text);
+    auto& cache = xaml_text_layout_cache_current();
+    xaml_text_layout* layout = cache.find(key);
+    if (!layout)
+    {
+        select_font(font);
+        // The data of xaml_string is null-terminated.
+        cairo_text_extents_t extents;
+        cairo_text_extents(m_handle, text.data(), &extents);
+        layout = cache.insert(xaml_text_key_copy(key), { extents, {}, false });
+    }
+    *ptr = layout;
     return XAML_S_OK;
 }
+XAML_CATCH_RETURN()
 
-xaml_result xaml_drawing_context_impl::measure_string(xaml_drawing_font const& font, xaml_point const& p, xaml_string* str, xaml_rectangle* pvalue) noexcept
+static xaml_rectangle place_text(xaml_drawing_font const& font, xaml_point const& p, cairo_text_extents_t const& extent) noexcept
 {
-    cairo_select_font_face(m_handle, font.font_family, font.italic ? CAIRO_FONT_SLANT_ITALIC : CAIRO_FONT_SLANT_NORMAL, font.bold ? CAIRO_FONT_WEIGHT_BOLD : CAIRO_FONT_WEIGHT_NORMAL);
-    cairo_set_font_size(m_handle, font.size);
-    char const* data;
-    XAML_RETURN_IF_FAILED(str->get_data(&data));
-    cairo_text_extents_t extent;
-    cairo_text_extents(m_handle, data, &extent);
     auto [x, y] = p;
     switch (font.halign)
     {
@@ -166,7 +196,51 @@ xaml_result xaml_drawing_context_impl::measure_string(xaml_drawing_font const& f
     default:
         break;
     }
-    *pvalue = { x, y - extent.height, extent.width, extent.height };
+    return { x, y - extent.height, extent.width, extent.height };
+}
+
+xaml_result xaml_drawing_context_impl::draw_string(xaml_brush* brush, xaml_drawing_font const& font, xaml_point const& p, xaml_string* str) noexcept
+try
+{
+    string_view text;
+    XAML_RETURN_IF_FAILED(to_string_view(str, &text));
+    xaml_text_layout* layout;
+    XAML_RETURN_IF_FAILED(get_text_layout(font, text, &layout));
+    xaml_rectangle rect = place_text(font, p, layout->extents);
+    // The extents don't include the bearings of the glyphs.
+    xaml_margin bearings{ font.size / 2, font.size / 2, font.size / 2, font.size / 2 };
+    CHECK_VISIBLE(rect + bearings);
+    select_font(font);
+    if (!layout->shaped)
+    {
+        cairo_glyph_t* glyphs = nullptr;
+        int count = 0;
+        if (cairo_scaled_font_text_to_glyphs(cairo_get_scaled_font(m_handle), 0, 0, text.data(), (int)text.length(), &glyphs, &count, nullptr, nullptr, nullptr) == CAIRO_STATUS_SUCCESS)
+        {
+            layout->glyphs.assign(glyphs, glyphs + count);
+            cairo_glyph_free(glyphs);
+        }
+        layout->shaped = true;
+    }
+    XAML_RETURN_IF_FAILED(set_brush(brush, rect));
+    // The source is locked to the user space when it is set,
+    // so moving the glyphs by the matrix doesn't move the brush.
+    cairo_matrix_t save_matrix;
+    cairo_get_matrix(m_handle, &save_matrix);
+    cairo_translate(m_handle, rect.x, rect.y + rect.height);
+    cairo_show_glyphs(m_handle, layout->glyphs.data(), (int)layout->glyphs.size());
+    cairo_set_matrix(m_handle, &save_matrix);
+    return XAML_S_OK;
+}
+XAML_CATCH_RETURN()
+
+xaml_result xaml_drawing_context_impl::measure_string(xaml_drawing_font const& font, xaml_point const& p, xaml_string* str, xaml_rectangle* pvalue) noexcept
+{
+    string_view text;
+    XAML_RETURN_IF_FAILED(to_string_view(str, &text));
+    xaml_text_layout* layout;
+    XAML_RETURN_IF_FAILED(get_text_layout(font, text, &layout));
+    *pvalue = place_text(font, p, layout->extents);
     return XAML_S_OK;
 }
 
@@ -185,16 +259,113 @@ xaml_result xaml_canvas_internal::draw(const xaml_rectangle& region) noexcept
     return set_rect(region);
 }
 
+static xaml_result get_clip_rects(cairo_t* cr, vector<xaml_rectangle>* prects) noexcept
+try
+{
+    unique_ptr<cairo_rectangle_list_t, g_free_deleter<cairo_rectangle_list_t, cairo_rectangle_list_destroy>> list{ cairo_copy_clip_rectangle_list(cr) };
+    if (list->status == CAIRO_STATUS_SUCCESS)
+    {
+        for (int i = 0; i < list->num_rectangles; i++)
+        {
+            auto& r = list->rectangles[i];
+            prects->push_back({ r.x, r.y, r.width, r.height });
+        }
+    }
+    else
+    {
+        double x1, y1, x2, y2;
+        cairo_clip_extents(cr, &x1, &y1, &x2, &y2);
+        prects->push_back({ x1, y1, x2 - x1, y2 - y1 });
+    }
+    return XAML_S_OK;
+}
+XAML_CATCH_RETURN()
+
+xaml_result xaml_canvas_internal::draw_tiles(cairo_t* cr, xaml_rectangle const& region) noexcept
+try
+{
+    m_tiles.resize(m_size);
+    cairo_surface_t* target = cairo_get_target(cr);
+    double sx, sy;
+    cairo_surface_get_device_scale(target, &sx, &sy);
+    using tile_type = decltype(m_tiles)::tile;
+    auto prepare = [&](tile_type& t) noexcept -> xaml_result {
+        double tsx = 0, tsy = 0;
+        if (t.surface) cairo_surface_get_device_scale(t.surface.get(), &tsx, &tsy);
+        if (tsx != sx || tsy != sy)
+        {
+            t.surface.reset(cairo_surface_create_similar_image(target, CAIRO_FORMAT_ARGB32, (int)ceil(t.rect.width * sx), (int)ceil(t.rect.height * sy)));
+            if (cairo_surface_status(t.surface.get()) != CAIRO_STATUS_SUCCESS) return XAML_E_OUTOFMEMORY;
+            cairo_surface_set_device_scale(t.surface.get(), sx, sy);
+            t.stale = true;
+        }
+        return XAML_S_OK;
+    };
+    auto redraw = [&](xaml_rectangle const& bounds, vector<tile_type*> const& stale) -> xaml_result {
+        tile_surface scratch{ cairo_surface_create_similar_image(target, CAIRO_FORMAT_ARGB32, (int)ceil(bounds.width * sx), (int)ceil(bounds.height * sy)) };
+        if (cairo_surface_status(scratch.get()) != CAIRO_STATUS_SUCCESS) return XAML_E_OUTOFMEMORY;
+        cairo_surface_set_device_scale(scratch.get(), sx, sy);
+        {
+            unique_ptr<cairo_t, g_free_deleter<cairo_t, cairo_destroy>> scr{ cairo_create(scratch.get()) };
+            // The handlers draw in the coordinates of the canvas, clipped to the stale tiles.
+            cairo_translate(scr.get(), -bounds.x, -bounds.y);
+            vector<xaml_rectangle> rects;
+            rects.reserve(stale.size());
+            for (tile_type* t : stale)
+            {
+                rects.push_back(t->rect);
+                cairo_rectangle(scr.get(), t->rect.x, t->rect.y, t->rect.width, t->rect.height);
+            }
+            cairo_clip(scr.get());
+            xaml_ptr<xaml_drawing_context_impl> dc;
+            XAML_RETURN_IF_FAILED(xaml_object_new<xaml_drawing_context_impl>(&dc, scr.get()));
+            XAML_RETURN_IF_FAILED(dc->set_dirty_rects(move(rects)));
+            XAML_RETURN_IF_FAILED(m_redraw->invoke(m_outer_this, dc));
+        }
+        cairo_surface_flush(scratch.get());
+        for (tile_type* t : stale)
+        {
+            unique_ptr<cairo_t, g_free_deleter<cairo_t, cairo_destroy>> tcr{ cairo_create(t->surface.get()) };
+            cairo_set_operator(tcr.get(), CAIRO_OPERATOR_SOURCE);
+            cairo_set_source_surface(tcr.get(), scratch.get(), bounds.x - t->rect.x, bounds.y - t->rect.y);
+            cairo_paint(tcr.get());
+        }
+        return XAML_S_OK;
+    };
+    auto present = [&](tile_type& t) noexcept -> xaml_result {
+        cairo_set_source_surface(cr, t.surface.get(), t.rect.x, t.rect.y);
+        cairo_rectangle(cr, t.rect.x, t.rect.y, t.rect.width, t.rect.height);
+        cairo_fill(cr);
+        return XAML_S_OK;
+    };
+    return m_tiles.draw(region, prepare, redraw, present);
+}
+XAML_CATCH_RETURN()
+
 gboolean xaml_canvas_internal::on_draw(GtkWidget*, cairo_t* cr, xaml_canvas_internal* self) noexcept
 {
-    xaml_ptr<xaml_drawing_context> dc;
-    XAML_ASSERT_SUCCEEDED(xaml_object_new<xaml_drawing_context_impl>(&dc, cr));
-    XAML_ASSERT_SUCCEEDED(self->m_redraw->invoke(self->m_outer_this, dc));
+    if (self->m_is_cached)
+    {
+        double x1, y1, x2, y2;
+        cairo_clip_extents(cr, &x1, &y1, &x2, &y2);
+        XAML_ASSERT_SUCCEEDED(self->draw_tiles(cr, { x1, y1, x2 - x1, y2 - y1 }));
+    }
+    else
+    {
+        self->m_tiles.clear();
+        vector<xaml_rectangle> rects;
+        XAML_ASSERT_SUCCEEDED(get_clip_rects(cr, &rects));
+        xaml_ptr<xaml_drawing_context_impl> dc;
+        XAML_ASSERT_SUCCEEDED(xaml_object_new<xaml_drawing_context_impl>(&dc, cr));
+        XAML_ASSERT_SUCCEEDED(dc->set_dirty_rects(move(rects)));
+        XAML_ASSERT_SUCCEEDED(self->m_redraw->invoke(self->m_outer_this, dc));
+    }
     return FALSE;
 }
 
 xaml_result XAML_CALL xaml_canvas_internal::invalidate(xaml_rectangle const* prect) noexcept
 {
+    m_tiles.invalidate(prect);
     GdkRectangle r;
     if (prect)
     {
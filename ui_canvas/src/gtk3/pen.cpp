@@ -4,9 +4,11 @@
 
 xaml_result xaml_brush_pen_impl::set(cairo_t* handle, xaml_rectangle const& region) noexcept
 {
-    xaml_ptr<xaml_gtk3_brush> native_brush;
-    XAML_RETURN_IF_FAILED(m_brush->query(&native_brush));
-    XAML_RETURN_IF_FAILED(native_brush->set(handle, region));
-    cairo_set_line_width(handle, m_width);
+    if (!m_native_brush)
+    {
+        XAML_RETURN_IF_FAILED(m_brush->query(&m_native_brush));
+    }
+    XAML_RETURN_IF_FAILED(m_native_brush->set(handle, region));
+    if (cairo_get_line_width(handle) != m_width) cairo_set_line_width(handle, m_width);
     return XAML_S_OK;
 }
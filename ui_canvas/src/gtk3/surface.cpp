@@ -0,0 +1,70 @@
+#include <shared/surface.hpp>
+#include <vector>
+
+using namespace std;
+
+xaml_result xaml_drawing_surface_impl::init() noexcept
+{
+    m_surface.reset(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, m_width, m_height));
+    if (cairo_surface_status(m_surface.get()) != CAIRO_STATUS_SUCCESS) return XAML_E_OUTOFMEMORY;
+    m_handle.reset(cairo_create(m_surface.get()));
+    if (cairo_status(m_handle.get()) != CAIRO_STATUS_SUCCESS) return XAML_E_OUTOFMEMORY;
+    return XAML_S_OK;
+}
+
+xaml_result xaml_drawing_surface_impl::get_stride(int32_t* pvalue) noexcept
+{
+    *pvalue = cairo_image_surface_get_stride(m_surface.get());
+    return XAML_S_OK;
+}
+
+xaml_result xaml_drawing_surface_impl::clear(xaml_color color) noexcept
+{
+    // The source is restored, so that the context could keep its brush.
+    cairo_save(m_handle.get());
+    cairo_set_operator(m_handle.get(), CAIRO_OPERATOR_SOURCE);
+    cairo_set_source_rgba(m_handle.get(), color.r / 255.0, color.g / 255.0, color.b / 255.0, color.a / 255.0);
+    cairo_paint(m_handle.get());
+    cairo_restore(m_handle.get());
+    return XAML_S_OK;
+}
+
+xaml_result xaml_drawing_surface_impl::get_pixels(xaml_buffer** ptr) noexcept
+try
+{
+    cairo_surface_flush(m_surface.get());
+    uint8_t const* data = cairo_image_surface_get_data(m_surface.get());
+    vector<uint8_t> pixels(data, data + (size_t)cairo_image_surface_get_stride(m_surface.get()) * m_height);
+    return xaml_buffer_new(move(pixels), ptr);
+}
+XAML_CATCH_RETURN()
+
+static cairo_status_t write_png(void* closure, unsigned char const* data, unsigned int length) noexcept
+try
+{
+    auto& bytes = *(vector<uint8_t>*)closure;
+    bytes.insert(bytes.end(), data, data + length);
+    return CAIRO_STATUS_SUCCESS;
+}
+catch (...)
+{
+    return CAIRO_STATUS_NO_MEMORY;
+}
+
+xaml_result xaml_drawing_surface_impl::encode_png(xaml_buffer** ptr) noexcept
+{
+    vector<uint8_t> bytes;
+    cairo_status_t status = cairo_surface_write_to_png_stream(m_surface.get(), write_png, &bytes);
+    if (status == CAIRO_STATUS_NO_MEMORY) return XAML_E_OUTOFMEMORY;
+    if (status != CAIRO_STATUS_SUCCESS) return XAML_E_FAIL;
+    return xaml_buffer_new(move(bytes), ptr);
+}
+
+xaml_result xaml_drawing_surface_impl::save_png(xaml_string* path) noexcept
+{
+    string_view data;
+    XAML_RETURN_IF_FAILED(to_string_view(path, &data));
+    // The data of xaml_string is null-terminated.
+    if (cairo_surface_write_to_png(m_surface.get(), data.data()) != CAIRO_STATUS_SUCCESS) return XAML_E_FAIL;
+    return XAML_S_OK;
+}
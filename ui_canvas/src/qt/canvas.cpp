@@ -42,6 +42,7 @@ static int get_drawing_angle(double angle) noexcept
 xaml_result xaml_drawing_context_impl::draw_arc(xaml_pen* pen, xaml_rectangle const& region, double start_angle, double end_angle) noexcept
 {
     CHECK_SIZE(region);
+    CHECK_STROKE_VISIBLE(pen, region);
     XAML_RETURN_IF_FAILED(set_pen(m_handle, pen, region));
     m_handle->drawArc(xaml_to_native<QRectF>(region), get_drawing_angle(start_angle), get_drawing_angle(end_angle - start_angle));
     return XAML_S_OK;
@@ -50,6 +51,7 @@ xaml_result xaml_drawing_context_impl::draw_arc(xaml_pen* pen, xaml_rectangle co
 xaml_result xaml_drawing_context_impl::fill_pie(xaml_brush* brush, xaml_rectangle const& region, double start_angle, double end_angle) noexcept
 {
     CHECK_SIZE(region);
+    CHECK_VISIBLE(region);
     XAML_RETURN_IF_FAILED(set_brush(m_handle, brush, region));
     m_handle->drawPie(xaml_to_native<QRectF>(region), get_drawing_angle(start_angle), get_drawing_angle(end_angle - start_angle));
     return XAML_S_OK;
@@ -58,6 +60,7 @@ xaml_result xaml_drawing_context_impl::fill_pie(xaml_brush* brush, xaml_rectangl
 xaml_result xaml_drawing_context_impl::draw_ellipse(xaml_pen* pen, xaml_rectangle const& region) noexcept
 {
     CHECK_SIZE(region);
+    CHECK_STROKE_VISIBLE(pen, region);
     XAML_RETURN_IF_FAILED(set_pen(m_handle, pen, region));
     m_handle->drawEllipse(xaml_to_native<QRectF>(region));
     return XAML_S_OK;
@@ -66,6 +69,7 @@ xaml_result xaml_drawing_context_impl::draw_ellipse(xaml_pen* pen, xaml_rectangl
 xaml_result xaml_drawing_context_impl::fill_ellipse(xaml_brush* brush, xaml_rectangle const& region) noexcept
 {
     CHECK_SIZE(region);
+    CHECK_VISIBLE(region);
     XAML_RETURN_IF_FAILED(set_brush(m_handle, brush, region));
     m_handle->drawEllipse(xaml_to_native<QRectF>(region));
     return XAML_S_OK;
@@ -76,6 +80,7 @@ xaml_result xaml_drawing_context_impl::draw_line(xaml_pen* pen, xaml_point const
     xaml_point minp{ (min)(startp.x, endp.x), (min)(startp.y, endp.y) };
     xaml_point maxp{ (max)(startp.x, endp.x), (max)(startp.y, endp.y) };
     xaml_rectangle region = { minp.x, minp.y, maxp.x - minp.x, maxp.y - minp.y };
+    CHECK_STROKE_VISIBLE(pen, region);
     XAML_RETURN_IF_FAILED(set_pen(m_handle, pen, region));
     m_handle->drawLine(xaml_to_native<QPointF>(startp), xaml_to_native<QPointF>(endp));
     return XAML_S_OK;
@@ -84,6 +89,7 @@ xaml_result xaml_drawing_context_impl::draw_line(xaml_pen* pen, xaml_point const
 xaml_result xaml_drawing_context_impl::draw_rect(xaml_pen* pen, xaml_rectangle const& rect) noexcept
 {
     CHECK_SIZE(rect);
+    CHECK_STROKE_VISIBLE(pen, rect);
     XAML_RETURN_IF_FAILED(set_pen(m_handle, pen, rect));
     m_handle->drawRect(xaml_to_native<QRectF>(rect));
     return XAML_S_OK;
@@ -92,6 +98,7 @@ xaml_result xaml_drawing_context_impl::draw_rect(xaml_pen* pen, xaml_rectangle c
 xaml_result xaml_drawing_context_impl::fill_rect(xaml_brush* brush, xaml_rectangle const& rect) noexcept
 {
     CHECK_SIZE(rect);
+    CHECK_VISIBLE(rect);
     XAML_RETURN_IF_FAILED(set_brush(m_handle, brush, rect));
     m_handle->drawRect(xaml_to_native<QRectF>(rect));
     return XAML_S_OK;
@@ -112,6 +119,7 @@ xaml_result xaml_drawing_context_impl::draw_round_rect(xaml_pen* pen, xaml_recta
 {
     CHECK_SIZE(rect);
     CHECK_SIZE(round);
+    CHECK_STROKE_VISIBLE(pen, rect);
     XAML_RETURN_IF_FAILED(set_pen(m_handle, pen, rect));
     m_handle->drawPath(get_round_rect_path(rect, round));
     return XAML_S_OK;
@@ -121,36 +129,45 @@ xaml_result xaml_drawing_context_impl::fill_round_rect(xaml_brush* brush, xaml_r
 {
     CHECK_SIZE(rect);
     CHECK_SIZE(round);
+    CHECK_VISIBLE(rect);
     XAML_RETURN_IF_FAILED(set_brush(m_handle, brush, rect));
     m_handle->drawPath(get_round_rect_path(rect, round));
     return XAML_S_OK;
 }
 
-xaml_result xaml_drawing_context_impl::draw_string(xaml_brush* brush, xaml_drawing_font const& font, xaml_point const& p, xaml_string* str) noexcept
+void xaml_drawing_context_impl::select_font(xaml_drawing_font const& font) noexcept
 {
-    xaml_rectangle rect;
-    XAML_RETURN_IF_FAILED(measure_string(font, p, str, &rect));
-    xaml_ptr<xaml_brush_pen> pen;
-    XAML_RETURN_IF_FAILED(xaml_brush_pen_new(brush, 1, &pen));
-    XAML_RETURN_IF_FAILED(set_pen(m_handle, pen, rect));
-    QTextOption option;
-    option.setWrapMode(QTextOption::NoWrap);
-    QString text;
-    XAML_RETURN_IF_FAILED(to_QString(str, &text));
-    m_handle->drawText(xaml_to_native<QRectF>(rect), text, option);
+    if (!m_font_selected || !xaml_text_key_equal{}(m_font, xaml_text_key_of(font, {})))
+    {
+        QFont qfont{ font.font_family, -1, font.bold ? QFont::Bold : QFont::Normal, font.italic };
+        qfont.setPixelSize((int)font.size);
+        m_handle->setFont(qfont);
+        m_font = xaml_text_key_copy(xaml_text_key_of(font, {}));
+        m_font_selected = true;
+    }
+}
+
+xaml_result xaml_drawing_context_impl::get_text_layout(xaml_drawing_font const& font, string_view text, xaml_text_layout** ptr) noexcept
+try
+{
+    auto key = xaml_text_key_of(font, text);
+    auto& cache = xaml_text_layout_cache_current();
+    xaml_text_layout* layout = cache.find(key);
+    if (!layout)
+    {
+        select_font(font);
+        QFontMetricsF fm{ m_handle->font() };
+        QString qtext = QString::fromUtf8(text.data(), (int)text.length());
+        layout = cache.insert(xaml_text_key_copy(key), { { fm.horizontalAdvance(qtext), fm.height() }, {}, false });
+    }
+    *ptr = layout;
     return XAML_S_OK;
 }
+XAML_CATCH_RETURN()
 
-xaml_result xaml_drawing_context_impl::measure_string(xaml_drawing_font const& font, xaml_point const& p, xaml_string* str, xaml_rectangle* pvalue) noexcept
+static xaml_rectangle place_text(xaml_drawing_font const& font, xaml_point const& p, xaml_size const& size) noexcept
 {
-    if (font.size <= 0) return XAML_S_OK;
-    QFont qfont{ font.font_family, -1, font.bold ? QFont::Bold : QFont::Normal, font.italic };
-    qfont.setPixelSize((int)font.size);
-    m_handle->setFont(qfont);
-    QString text;
-    XAML_RETURN_IF_FAILED(to_QString(str, &text));
-    QFontMetricsF fm{ qfont };
-    xaml_rectangle rect = { 0, 0, fm.horizontalAdvance(text), fm.height() };
+    xaml_rectangle rect = { 0, 0, size.width, size.height };
     switch (font.halign)
     {
     case xaml_halignment_center:
@@ -175,7 +192,46 @@ xaml_result xaml_drawing_context_impl::measure_string(xaml_drawing_font const& f
         rect.y = p.y;
         break;
     }
-    *pvalue = rect;
+    return rect;
+}
+
+xaml_result xaml_drawing_context_impl::draw_string(xaml_brush* brush, xaml_drawing_font const& font, xaml_point const& p, xaml_string* str) noexcept
+{
+    if (font.size <= 0) return XAML_S_OK;
+    string_view text;
+    XAML_RETURN_IF_FAILED(to_string_view(str, &text));
+    xaml_text_layout* layout;
+    XAML_RETURN_IF_FAILED(get_text_layout(font, text, &layout));
+    xaml_rectangle rect = place_text(font, p, layout->size);
+    // The advance doesn't include the overhang of the glyphs.
+    xaml_margin overhang{ font.size / 2, 0, font.size / 2, 0 };
+    CHECK_VISIBLE(rect + overhang);
+    select_font(font);
+    if (!layout->shaped)
+    {
+        QTextOption option;
+        option.setWrapMode(QTextOption::NoWrap);
+        layout->text.setTextFormat(Qt::PlainText);
+        layout->text.setTextOption(option);
+        layout->text.setText(QString::fromUtf8(text.data(), (int)text.length()));
+        layout->text.prepare(m_handle->transform(), m_handle->font());
+        layout->shaped = true;
+    }
+    xaml_ptr<xaml_brush_pen> pen;
+    XAML_RETURN_IF_FAILED(xaml_brush_pen_new(brush, 1, &pen));
+    XAML_RETURN_IF_FAILED(set_pen(m_handle, pen, rect));
+    m_handle->drawStaticText(QPointF{ rect.x, rect.y }, layout->text);
+    return XAML_S_OK;
+}
+
+xaml_result xaml_drawing_context_impl::measure_string(xaml_drawing_font const& font, xaml_point const& p, xaml_string* str, xaml_rectangle* pvalue) noexcept
+{
+    if (font.size <= 0) return XAML_S_OK;
+    string_view text;
+    XAML_RETURN_IF_FAILED(to_string_view(str, &text));
+    xaml_text_layout* layout;
+    XAML_RETURN_IF_FAILED(get_text_layout(font, text, &layout));
+    *pvalue = place_text(font, p, layout->size);
     return XAML_S_OK;
 }
 
@@ -207,18 +263,103 @@ xaml_result XAML_CALL xaml_canvas_internal::draw(xaml_rectangle const& region) n
     return set_rect(region);
 }
 
-xaml_result XAML_CALL xaml_canvas_internal::invalidate(xaml_rectangle const*) noexcept
+xaml_result XAML_CALL xaml_canvas_internal::invalidate(xaml_rectangle const* prect) noexcept
 {
-    m_handle->repaint();
+    m_tiles.invalidate(prect);
+    if (prect)
+    {
+        m_handle->update(xaml_to_native<QRectF>(*prect).toAlignedRect());
+    }
+    else
+    {
+        m_handle->update();
+    }
     return XAML_S_OK;
 }
 
-void xaml_canvas_internal::on_paint_event(QPaintEvent*) noexcept
+xaml_result xaml_canvas_internal::draw_tiles(QPainter* painter, xaml_rectangle const& region) noexcept
+try
+{
+    m_tiles.resize(m_size);
+    qreal ratio = m_handle->devicePixelRatioF();
+    using tile_type = decltype(m_tiles)::tile;
+    auto prepare = [&](tile_type& t) noexcept -> xaml_result {
+        if (t.surface.isNull() || t.surface.devicePixelRatio() != ratio)
+        {
+            t.surface = QPixmap{ (int)ceil(t.rect.width * ratio), (int)ceil(t.rect.height * ratio) };
+            if (t.surface.isNull()) return XAML_E_OUTOFMEMORY;
+            t.surface.setDevicePixelRatio(ratio);
+            t.stale = true;
+        }
+        return XAML_S_OK;
+    };
+    auto redraw = [&](xaml_rectangle const& bounds, vector<tile_type*> const& stale) -> xaml_result {
+        QPixmap scratch{ (int)ceil(bounds.width * ratio), (int)ceil(bounds.height * ratio) };
+        if (scratch.isNull()) return XAML_E_OUTOFMEMORY;
+        scratch.setDevicePixelRatio(ratio);
+        scratch.fill(Qt::transparent);
+        {
+            QPainter scratch_painter{ &scratch };
+            // The handlers draw in the coordinates of the canvas, clipped to the stale tiles.
+            scratch_painter.translate(-bounds.x, -bounds.y);
+            vector<xaml_rectangle> rects;
+            rects.reserve(stale.size());
+            QRegion clip;
+            for (tile_type* t : stale)
+            {
+                rects.push_back(t->rect);
+                clip += xaml_to_native<QRect>(t->rect);
+            }
+            scratch_painter.setClipRegion(clip);
+            xaml_ptr<xaml_drawing_context_impl> dc;
+            XAML_RETURN_IF_FAILED(xaml_object_new<xaml_drawing_context_impl>(&dc, &scratch_painter));
+            XAML_RETURN_IF_FAILED(dc->set_dirty_rects(move(rects)));
+            XAML_RETURN_IF_FAILED(m_redraw->invoke(m_outer_this, dc));
+        }
+        for (tile_type* t : stale)
+        {
+            QPainter tile_painter{ &t->surface };
+            tile_painter.setCompositionMode(QPainter::CompositionMode_Source);
+            tile_painter.drawPixmap(QPointF{ bounds.x - t->rect.x, bounds.y - t->rect.y }, scratch);
+        }
+        return XAML_S_OK;
+    };
+    auto present = [&](tile_type& t) noexcept -> xaml_result {
+        painter->drawPixmap(QPointF{ t.rect.x, t.rect.y }, t.surface);
+        return XAML_S_OK;
+    };
+    return m_tiles.draw(region, prepare, redraw, present);
+}
+XAML_CATCH_RETURN()
+
+static xaml_result get_region_rects(QRegion const& region, vector<xaml_rectangle>* prects) noexcept
+try
+{
+    for (QRect const& r : region)
+    {
+        prects->push_back(xaml_from_native(r));
+    }
+    return XAML_S_OK;
+}
+XAML_CATCH_RETURN()
+
+void xaml_canvas_internal::on_paint_event(QPaintEvent* event) noexcept
 {
     QPainter painter{ m_handle };
-    xaml_ptr<xaml_drawing_context> dc;
-    XAML_ASSERT_SUCCEEDED(xaml_object_new<xaml_drawing_context_impl>(&dc, &painter));
-    XAML_ASSERT_SUCCEEDED(m_redraw->invoke(m_outer_this, dc));
+    if (m_is_cached)
+    {
+        XAML_ASSERT_SUCCEEDED(draw_tiles(&painter, xaml_from_native(event->rect())));
+    }
+    else
+    {
+        m_tiles.clear();
+        vector<xaml_rectangle> rects;
+        XAML_ASSERT_SUCCEEDED(get_region_rects(event->region(), &rects));
+        xaml_ptr<xaml_drawing_context_impl> dc;
+        XAML_ASSERT_SUCCEEDED(xaml_object_new<xaml_drawing_context_impl>(&dc, &painter));
+        XAML_ASSERT_SUCCEEDED(dc->set_dirty_rects(move(rects)));
+        XAML_ASSERT_SUCCEEDED(m_redraw->invoke(m_outer_this, dc));
+    }
 }
 
 void xaml_canvas_internal::on_mouse_move_event(QMouseEvent* event) noexcept
@@ -0,0 +1,66 @@
+#include <QBuffer>
+#include <QByteArray>
+#include <QColor>
+#include <qt/qstring.hpp>
+#include <shared/surface.hpp>
+#include <vector>
+
+using namespace std;
+
+xaml_result xaml_drawing_surface_impl::init() noexcept
+{
+    m_image = QImage{ m_width, m_height, QImage::Format_ARGB32_Premultiplied };
+    if (m_image.isNull()) return XAML_E_OUTOFMEMORY;
+    m_image.fill(Qt::transparent);
+    m_handle.reset(new (nothrow) QPainter{ &m_image });
+    if (!m_handle) return XAML_E_OUTOFMEMORY;
+    return XAML_S_OK;
+}
+
+xaml_result xaml_drawing_surface_impl::get_stride(int32_t* pvalue) noexcept
+{
+    *pvalue = (int32_t)m_image.bytesPerLine();
+    return XAML_S_OK;
+}
+
+xaml_result xaml_drawing_surface_impl::clear(xaml_color color) noexcept
+{
+    m_handle->save();
+    m_handle->setCompositionMode(QPainter::CompositionMode_Source);
+    m_handle->fillRect(m_image.rect(), QColor::fromRgba((uint32_t)color));
+    m_handle->restore();
+    return XAML_S_OK;
+}
+
+// The image is being painted, so it is only read by the const members.
+xaml_result xaml_drawing_surface_impl::get_pixels(xaml_buffer** ptr) noexcept
+try
+{
+    QImage const& image = m_image;
+    uint8_t const* data = image.constBits();
+    vector<uint8_t> pixels(data, data + (size_t)image.bytesPerLine() * m_height);
+    return xaml_buffer_new(move(pixels), ptr);
+}
+XAML_CATCH_RETURN()
+
+xaml_result xaml_drawing_surface_impl::encode_png(xaml_buffer** ptr) noexcept
+try
+{
+    QByteArray bytes;
+    QBuffer buffer{ &bytes };
+    buffer.open(QIODevice::WriteOnly);
+    QImage const& image = m_image;
+    if (!image.save(&buffer, "PNG")) return XAML_E_FAIL;
+    vector<uint8_t> data(bytes.begin(), bytes.end());
+    return xaml_buffer_new(move(data), ptr);
+}
+XAML_CATCH_RETURN()
+
+xaml_result xaml_drawing_surface_impl::save_png(xaml_string* path) noexcept
+{
+    QString qpath;
+    XAML_RETURN_IF_FAILED(to_QString(path, &qpath));
+    QImage const& image = m_image;
+    if (!image.save(qpath, "PNG")) return XAML_E_FAIL;
+    return XAML_S_OK;
+}
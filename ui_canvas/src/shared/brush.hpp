@@ -6,6 +6,7 @@
 #elif defined(XAML_UI_COCOA)
     #include <xaml/ui/cocoa/controls/brush.h>
 #elif defined(XAML_UI_GTK3)
+    #include <gtk3/resources.hpp>
     #include <xaml/ui/gtk3/controls/brush.h>
 #elif defined(XAML_UI_QT)
     #include <xaml/ui/qt5/controls/brush.hpp>
@@ -13,6 +14,16 @@
 
 #include <xaml/ui/controls/brush.h>
 
+// Sets the property and drops the native resource built from it.
+#define XAML_BRUSH_PROP_IMPL(name, vtype, gtype, stype)    \
+    XAML_PROP_IMPL_BASE(name, vtype, gtype)                \
+    xaml_result XAML_CALL set_##name(stype value) noexcept \
+    {                                                      \
+        m_##name = value;                                  \
+        this->invalidate();                                \
+        return XAML_S_OK;                                  \
+    }
+
 template <typename T, typename Base>
 struct xaml_brush_implement : xaml_implement<T, Base>
 {
@@ -37,6 +48,11 @@ struct xaml_brush_implement : xaml_implement<T, Base>
 #elif defined(XAML_UI_GTK3)
     virtual xaml_result XAML_CALL set(cairo_t*, xaml_rectangle const&) noexcept = 0;
 
+    // The pattern built for a region of the size, at the origin.
+    // It is moved to other regions of the same size by its matrix.
+    std::unique_ptr<cairo_pattern_t, g_free_deleter<cairo_pattern_t, cairo_pattern_destroy>> m_pattern{};
+    xaml_size m_pattern_size{};
+
     struct xaml_gtk3_brush_impl : xaml_inner_implement<xaml_gtk3_brush_impl, T, xaml_gtk3_brush>
     {
         xaml_result XAML_CALL set(cairo_t* handle, xaml_rectangle const& region) noexcept override { return this->m_outer->set(handle, region); }
@@ -54,6 +70,13 @@ struct xaml_brush_implement : xaml_implement<T, Base>
     using native_brush_type = xaml_qt5_brush;
 #endif // XAML_UI_WINDOWS
 
+    void invalidate() noexcept
+    {
+#ifdef XAML_UI_GTK3
+        m_pattern = nullptr;
+#endif // XAML_UI_GTK3
+    }
+
     xaml_result XAML_CALL query(xaml_guid const& type, void** ptr) noexcept override
     {
         if (type == xaml_type_guid_v<native_brush_type>)
@@ -76,7 +99,7 @@ struct xaml_brush_implement : xaml_implement<T, Base>
 
 struct xaml_solid_brush_impl : xaml_brush_implement<xaml_solid_brush_impl, xaml_solid_brush>
 {
-    XAML_PROP_IMPL(color, xaml_color, xaml_color*, xaml_color)
+    XAML_BRUSH_PROP_IMPL(color, xaml_color, xaml_color*, xaml_color)
 
 #ifdef XAML_UI_WINDOWS
     xaml_result XAML_CALL create(ID2D1RenderTarget*, xaml_rectangle const&, ID2D1Brush**) noexcept override;
@@ -105,6 +128,7 @@ struct xaml_gradient_brush_implement : xaml_brush_implement<T, Base>
 
     xaml_result XAML_CALL add_stop(xaml_gradient_stop const& stop) noexcept override
     {
+        this->invalidate();
         return m_gradient_stops->append(stop);
     }
 
@@ -114,6 +138,7 @@ struct xaml_gradient_brush_implement : xaml_brush_implement<T, Base>
         XAML_RETURN_IF_FAILED(m_gradient_stops->index_of(stop, &index));
         if (index != -1)
         {
+            this->invalidate();
             return m_gradient_stops->remove_at(index);
         }
         return XAML_S_OK;
@@ -129,8 +154,8 @@ struct xaml_gradient_brush_implement : xaml_brush_implement<T, Base>
 
 struct xaml_linear_gradient_brush_impl : xaml_gradient_brush_implement<xaml_linear_gradient_brush_impl, xaml_linear_gradient_brush>
 {
-    XAML_PROP_IMPL(start_point, xaml_point, xaml_point*, xaml_point const&)
-    XAML_PROP_IMPL(end_point, xaml_point, xaml_point*, xaml_point const&)
+    XAML_BRUSH_PROP_IMPL(start_point, xaml_point, xaml_point*, xaml_point const&)
+    XAML_BRUSH_PROP_IMPL(end_point, xaml_point, xaml_point*, xaml_point const&)
 
 #ifdef XAML_UI_WINDOWS
     xaml_result XAML_CALL create(ID2D1RenderTarget*, xaml_rectangle const&, ID2D1Brush**) noexcept override;
@@ -145,9 +170,9 @@ struct xaml_linear_gradient_brush_impl : xaml_gradient_brush_implement<xaml_line
 
 struct xaml_radial_gradient_brush_impl : xaml_gradient_brush_implement<xaml_radial_gradient_brush_impl, xaml_radial_gradient_brush>
 {
-    XAML_PROP_IMPL(origin, xaml_point, xaml_point*, xaml_point const&)
-    XAML_PROP_IMPL(center, xaml_point, xaml_point*, xaml_point const&)
-    XAML_PROP_IMPL(radius, xaml_size, xaml_size*, xaml_size const&)
+    XAML_BRUSH_PROP_IMPL(origin, xaml_point, xaml_point*, xaml_point const&)
+    XAML_BRUSH_PROP_IMPL(center, xaml_point, xaml_point*, xaml_point const&)
+    XAML_BRUSH_PROP_IMPL(radius, xaml_size, xaml_size*, xaml_size const&)
 
 #ifdef XAML_UI_WINDOWS
     xaml_result XAML_CALL create(ID2D1RenderTarget*, xaml_rectangle const&, ID2D1Brush**) noexcept override;
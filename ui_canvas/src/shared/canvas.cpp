@@ -3,6 +3,38 @@
 
 using namespace std;
 
+xaml_result xaml_drawing_context_impl::set_dirty_rects(vector<xaml_rectangle>&& rects) noexcept
+try
+{
+    m_clip = {};
+    if (!rects.empty())
+    {
+        double left = rects.front().x, top = rects.front().y;
+        double right = left + rects.front().width, bottom = top + rects.front().height;
+        for (auto& r : rects)
+        {
+            left = (min)(left, r.x);
+            top = (min)(top, r.y);
+            right = (max)(right, r.x + r.width);
+            bottom = (max)(bottom, r.y + r.height);
+        }
+        m_clip = { left, top, right - left, bottom - top };
+    }
+    xaml_ptr<xaml_vector<xaml_rectangle>> vec;
+    XAML_RETURN_IF_FAILED(xaml_vector_new(move(rects), &vec));
+    return vec.query(&m_dirty_rects);
+}
+XAML_CATCH_RETURN()
+
+xaml_result xaml_drawing_context_impl::is_stroke_visible(xaml_pen* pen, xaml_rectangle const& bounds, bool* pvalue) noexcept
+{
+    // The stroke is centered on the path.
+    double width;
+    XAML_RETURN_IF_FAILED(pen->get_width(&width));
+    *pvalue = is_visible(bounds + xaml_margin{ width / 2, width / 2, width / 2, width / 2 });
+    return XAML_S_OK;
+}
+
 xaml_result xaml_canvas_internal::init() noexcept
 {
     XAML_RETURN_IF_FAILED(xaml_control_internal::init());
@@ -25,6 +57,7 @@ xaml_result XAML_CALL xaml_canvas_members(xaml_type_info_registration* __info) n
     XAML_RETURN_IF_FAILED(xaml_control_members(__info));
     XAML_TYPE_INFO_ADD_CTOR(xaml_canvas_new);
     XAML_TYPE_INFO_ADD_EVENT(redraw);
+    XAML_TYPE_INFO_ADD_PROP(is_cached, bool);
     return XAML_S_OK;
 }
 
@@ -34,3 +67,24 @@ xaml_result XAML_CALL xaml_canvas_register(xaml_meta_context* ctx) noexcept
     XAML_RETURN_IF_FAILED(xaml_canvas_members(__info));
     return ctx->add_type(__info);
 }
+
+xaml_text_layout_cache& xaml_text_layout_cache_current() noexcept
+{
+    static xaml_text_layout_cache cache{ 1024 };
+    return cache;
+}
+
+xaml_result XAML_CALL xaml_drawing_text_cache_get_stats(int64_t* phits, int64_t* pmisses) noexcept
+{
+    auto& cache = xaml_text_layout_cache_current();
+    *phits = cache.hits();
+    *pmisses = cache.misses();
+    return XAML_S_OK;
+}
+
+xaml_result XAML_CALL xaml_drawing_text_cache_set_capacity(int32_t value) noexcept
+{
+    if (value < 0) return XAML_E_INVALIDARG;
+    xaml_text_layout_cache_current().set_capacity((size_t)value);
+    return XAML_S_OK;
+}
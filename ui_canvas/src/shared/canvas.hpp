@@ -17,14 +17,33 @@ HRESULT DWriteCreateFactory(DWRITE_FACTORY_TYPE factoryType, Factory** factory)
     #include <xaml/ui/cocoa/objc.h>
 #elif defined(XAML_UI_GTK3)
     #include <cairo.h>
+    #include <gtk3/resources.hpp>
+    #include <xaml/ui/gtk3/controls/brush.h>
+    #include <xaml/ui/gtk3/controls/pen.h>
 #elif defined(XAML_UI_QT)
     #include <QPaintEvent>
     #include <QPainter>
+    #include <QPixmap>
 #endif // XAML_UI_GTK3
 
 #include <shared/control.hpp>
+#include <shared/text_cache.hpp>
+#include <shared/tile_cache.hpp>
+#include <vector>
 #include <xaml/ui/controls/canvas.h>
 
+// Returns early from a primitive that couldn't be seen in the clip.
+#define CHECK_VISIBLE(r) \
+    if (!is_visible(r)) return XAML_S_OK
+
+#define CHECK_STROKE_VISIBLE(pen, r)                                    \
+    do                                                                  \
+    {                                                                   \
+        bool visible;                                                   \
+        XAML_RETURN_IF_FAILED(is_stroke_visible((pen), (r), &visible)); \
+        if (!visible) return XAML_S_OK;                                 \
+    } while (0)
+
 struct xaml_drawing_context_impl : xaml_implement<xaml_drawing_context_impl, xaml_drawing_context>
 {
 #ifdef XAML_UI_WINDOWS
@@ -41,6 +60,16 @@ struct xaml_drawing_context_impl : xaml_implement<xaml_drawing_context_impl, xam
 #elif defined(XAML_UI_GTK3)
     cairo_t* m_handle;
 
+    // The last brush and pen with their native interfaces,
+    // so that consecutive primitives sharing them don't query again.
+    xaml_ptr<xaml_brush> m_brush{ nullptr };
+    xaml_ptr<xaml_gtk3_brush> m_native_brush{ nullptr };
+    xaml_ptr<xaml_pen> m_pen{ nullptr };
+    xaml_ptr<xaml_gtk3_pen> m_native_pen{ nullptr };
+
+    xaml_result set_brush(xaml_brush*, xaml_rectangle const&) noexcept;
+    xaml_result set_pen(xaml_pen*, xaml_rectangle const&) noexcept;
+
     xaml_drawing_context_impl(cairo_t* handle) noexcept : m_handle(handle) {}
 #elif defined(XAML_UI_QT)
     QPainter* m_handle;
@@ -48,6 +77,15 @@ struct xaml_drawing_context_impl : xaml_implement<xaml_drawing_context_impl, xam
     xaml_drawing_context_impl(QPainter* handle) noexcept : m_handle(handle) {}
 #endif // XAML_UI_GTK3
 
+#if defined(XAML_UI_GTK3) || defined(XAML_UI_QT)
+    // The font selected into the context, with empty text.
+    xaml_text_key m_font{};
+    bool m_font_selected{ false };
+
+    void select_font(xaml_drawing_font const&) noexcept;
+    xaml_result get_text_layout(xaml_drawing_font const&, std::string_view, xaml_text_layout**) noexcept;
+#endif // XAML_UI_GTK3 || XAML_UI_QT
+
     xaml_result XAML_CALL draw_arc(xaml_pen* pen, xaml_rectangle const& region, double start_angle, double end_angle) noexcept override;
     xaml_result XAML_CALL fill_pie(xaml_brush* brush, xaml_rectangle const& region, double start_angle, double end_angle) noexcept override;
     xaml_result XAML_CALL draw_ellipse(xaml_pen* pen, xaml_rectangle const& region) noexcept override;
@@ -59,6 +97,30 @@ struct xaml_drawing_context_impl : xaml_implement<xaml_drawing_context_impl, xam
     xaml_result XAML_CALL fill_round_rect(xaml_brush* brush, xaml_rectangle const& rect, xaml_size const& round) noexcept override;
     xaml_result XAML_CALL draw_string(xaml_brush* brush, xaml_drawing_font const& font, xaml_point const& p, xaml_string* str) noexcept override;
     xaml_result XAML_CALL measure_string(xaml_drawing_font const& font, xaml_point const& p, xaml_string* str, xaml_rectangle* psize) noexcept override;
+
+    // The bounds of the area being drawn, and the parts of it to repaint.
+    // Primitives entirely outside the clip are skipped.
+    xaml_rectangle m_clip{};
+    xaml_ptr<xaml_vector_view<xaml_rectangle>> m_dirty_rects{ nullptr };
+
+    xaml_result set_dirty_rects(std::vector<xaml_rectangle>&&) noexcept;
+
+    // The object owning the handle, if the context may outlive the drawing, like a surface.
+    xaml_ptr<xaml_object> m_owner{ nullptr };
+
+    bool is_visible(xaml_rectangle const& bounds) const noexcept { return xaml_rectangle_intersects(bounds, m_clip); }
+    xaml_result is_stroke_visible(xaml_pen*, xaml_rectangle const&, bool*) noexcept;
+
+    xaml_result XAML_CALL get_clip(xaml_rectangle* pvalue) noexcept override
+    {
+        *pvalue = m_clip;
+        return XAML_S_OK;
+    }
+
+    xaml_result XAML_CALL get_dirty_rects(xaml_vector_view<xaml_rectangle>** ptr) noexcept override
+    {
+        return m_dirty_rects.query(ptr);
+    }
 };
 
 struct xaml_canvas_internal : xaml_control_internal
@@ -69,6 +131,8 @@ struct xaml_canvas_internal : xaml_control_internal
 
     xaml_result XAML_CALL invalidate(xaml_rectangle const*) noexcept;
 
+    XAML_PROP_IMPL(is_cached, bool, bool*, bool)
+
 #ifdef XAML_UI_WINDOWS
     wil::com_ptr_nothrow<ID2D1HwndRenderTarget> target{ nullptr };
     wil::com_ptr_nothrow<ID2D1Factory> d2d{ nullptr };
@@ -78,8 +142,18 @@ struct xaml_canvas_internal : xaml_control_internal
 #elif defined(XAML_UI_COCOA)
     void on_draw_rect() noexcept;
 #elif defined(XAML_UI_GTK3)
+    using tile_surface = std::unique_ptr<cairo_surface_t, g_free_deleter<cairo_surface_t, cairo_surface_destroy>>;
+
+    xaml_tile_cache<tile_surface> m_tiles{};
+
+    xaml_result draw_tiles(cairo_t*, xaml_rectangle const&) noexcept;
+
     static gboolean on_draw(GtkWidget*, cairo_t*, xaml_canvas_internal*) noexcept;
 #elif defined(XAML_UI_QT)
+    xaml_tile_cache<QPixmap> m_tiles{};
+
+    xaml_result draw_tiles(QPainter*, xaml_rectangle const&) noexcept;
+
     void on_paint_event(QPaintEvent*) noexcept;
     void on_mouse_move_event(QMouseEvent*) noexcept;
     void on_mouse_press_event(QMouseEvent*) noexcept;
@@ -95,6 +169,8 @@ struct xaml_canvas_impl : xaml_control_implement<xaml_canvas_impl, xaml_canvas_i
 
     xaml_result XAML_CALL invalidate() noexcept override { return m_internal.invalidate(nullptr); }
     xaml_result XAML_CALL invalidate_rect(xaml_rectangle const& rect) noexcept override { return m_internal.invalidate(&rect); }
+
+    XAML_PROP_INTERNAL_IMPL(is_cached, bool*, bool)
 };
 
 #endif // !XAML_UI_CANVAS_SHARED_CANVAS_HPP
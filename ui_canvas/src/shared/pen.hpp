@@ -6,6 +6,7 @@
 #elif defined(XAML_UI_COCOA)
     #include <xaml/ui/cocoa/controls/pen.h>
 #elif defined(XAML_UI_GTK3)
+    #include <xaml/ui/gtk3/controls/brush.h>
     #include <xaml/ui/gtk3/controls/pen.h>
 #elif defined(XAML_UI_QT)
     #include <xaml/ui/qt5/controls/pen.hpp>
@@ -78,13 +79,25 @@ struct xaml_pen_implement : xaml_implement<T, Base>
 
 struct xaml_brush_pen_impl : xaml_pen_implement<xaml_brush_pen_impl, xaml_brush_pen>
 {
-    XAML_PROP_PTR_IMPL(brush, xaml_brush)
+    XAML_PROP_PTR_IMPL_BASE(brush, xaml_brush)
+
+    xaml_result XAML_CALL set_brush(xaml_brush* value) noexcept
+    {
+        m_brush = value;
+#ifdef XAML_UI_GTK3
+        m_native_brush = nullptr;
+#endif // XAML_UI_GTK3
+        return XAML_S_OK;
+    }
 
 #ifdef XAML_UI_WINDOWS
     xaml_result XAML_CALL create(ID2D1RenderTarget*, xaml_rectangle const&, ID2D1Brush**, FLOAT*) noexcept override;
 #elif defined(XAML_UI_COCOA)
     xaml_result XAML_CALL draw(OBJC_OBJECT(NSBezierPath), xaml_size const&, xaml_rectangle const&) noexcept override;
 #elif defined(XAML_UI_GTK3)
+    // The native interface of the brush, queried on first use.
+    xaml_ptr<xaml_gtk3_brush> m_native_brush{ nullptr };
+
     xaml_result XAML_CALL set(cairo_t*, xaml_rectangle const&) noexcept override;
 #elif defined(XAML_UI_QT)
     xaml_result XAML_CALL create(xaml_rectangle const&, QPen*) noexcept override;
@@ -0,0 +1,27 @@
+#include <shared/surface.hpp>
+#include <xaml/ui/controls/canvas.h>
+
+using namespace std;
+
+#if defined(XAML_UI_GTK3) || defined(XAML_UI_QT)
+// A new context is returned each time, and it keeps the surface alive,
+// as it draws with the handle of the surface.
+xaml_result xaml_drawing_surface_impl::get_context(xaml_drawing_context** ptr) noexcept
+{
+    xaml_ptr<xaml_drawing_context_impl> context;
+    XAML_RETURN_IF_FAILED(xaml_object_new<xaml_drawing_context_impl>(&context, m_handle.get()));
+    XAML_RETURN_IF_FAILED(context->set_dirty_rects({ { 0, 0, (double)m_width, (double)m_height } }));
+    context->m_owner = this;
+    return context->query(ptr);
+}
+#endif // XAML_UI_GTK3 || XAML_UI_QT
+
+xaml_result XAML_CALL xaml_drawing_surface_new(int32_t width, int32_t height, xaml_drawing_surface** ptr) noexcept
+{
+    if (width <= 0 || height <= 0) return XAML_E_INVALIDARG;
+#if defined(XAML_UI_GTK3) || defined(XAML_UI_QT)
+    return xaml_object_new_and_init<xaml_drawing_surface_impl>(ptr, width, height);
+#else
+    return XAML_E_NOTIMPL;
+#endif // XAML_UI_GTK3 || XAML_UI_QT
+}
@@ -0,0 +1,47 @@
+#ifndef XAML_UI_CANVAS_SHARED_SURFACE_HPP
+#define XAML_UI_CANVAS_SHARED_SURFACE_HPP
+
+#ifdef XAML_UI_QT
+    #include <QImage>
+#endif // XAML_UI_QT
+
+#include <cstdint>
+#include <memory>
+#include <shared/canvas.hpp>
+#include <xaml/buffer.h>
+#include <xaml/ui/controls/canvas.h>
+
+#if defined(XAML_UI_GTK3) || defined(XAML_UI_QT)
+struct xaml_drawing_surface_impl : xaml_implement<xaml_drawing_surface_impl, xaml_drawing_surface>
+{
+    std::int32_t m_width;
+    std::int32_t m_height;
+
+    #ifdef XAML_UI_GTK3
+    std::unique_ptr<cairo_surface_t, g_free_deleter<cairo_surface_t, cairo_surface_destroy>> m_surface{};
+    std::unique_ptr<cairo_t, g_free_deleter<cairo_t, cairo_destroy>> m_handle{};
+    #elif defined(XAML_UI_QT)
+    QImage m_image{};
+    std::unique_ptr<QPainter> m_handle{};
+    #endif // XAML_UI_GTK3
+
+    xaml_drawing_surface_impl(std::int32_t width, std::int32_t height) noexcept : m_width(width), m_height(height) {}
+
+    xaml_result init() noexcept;
+
+    xaml_result XAML_CALL get_size(xaml_size* pvalue) noexcept override
+    {
+        *pvalue = { (double)m_width, (double)m_height };
+        return XAML_S_OK;
+    }
+
+    xaml_result XAML_CALL get_context(xaml_drawing_context**) noexcept override;
+    xaml_result XAML_CALL get_stride(std::int32_t*) noexcept override;
+    xaml_result XAML_CALL clear(xaml_color) noexcept override;
+    xaml_result XAML_CALL get_pixels(xaml_buffer**) noexcept override;
+    xaml_result XAML_CALL encode_png(xaml_buffer**) noexcept override;
+    xaml_result XAML_CALL save_png(xaml_string*) noexcept override;
+};
+#endif // XAML_UI_GTK3 || XAML_UI_QT
+
+#endif // !XAML_UI_CANVAS_SHARED_SURFACE_HPP
@@ -0,0 +1,92 @@
+#ifndef XAML_UI_CANVAS_SHARED_TEXT_CACHE_HPP
+#define XAML_UI_CANVAS_SHARED_TEXT_CACHE_HPP
+
+#ifdef XAML_UI_GTK3
+    #include <cairo.h>
+    #include <vector>
+#elif defined(XAML_UI_QT)
+    #include <QStaticText>
+#endif // XAML_UI_GTK3
+
+#include <shared/lru_cache.hpp>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <xaml/ui/controls/canvas.h>
+
+template <typename String>
+struct xaml_text_key_base
+{
+    String font_family;
+    double size;
+    bool italic;
+    bool bold;
+    String text;
+
+    // Views an owning key, which is how the cache looks it up.
+    template <typename S, typename = std::enable_if_t<std::is_same_v<S, std::string_view> && !std::is_same_v<String, S>>>
+    operator xaml_text_key_base<S>() const noexcept
+    {
+        return { font_family, size, italic, bold, text };
+    }
+};
+
+using xaml_text_key = xaml_text_key_base<std::string>;
+using xaml_text_key_view = xaml_text_key_base<std::string_view>;
+
+inline xaml_text_key_view xaml_text_key_of(xaml_drawing_font const& font, std::string_view text) noexcept
+{
+    return { font.font_family ? font.font_family : std::string_view{}, font.size, font.italic, font.bold, text };
+}
+
+inline xaml_text_key xaml_text_key_copy(xaml_text_key_view const& key)
+{
+    return { std::string{ key.font_family }, key.size, key.italic, key.bold, std::string{ key.text } };
+}
+
+struct xaml_text_key_hash
+{
+    template <typename String>
+    std::size_t operator()(xaml_text_key_base<String> const& key) const noexcept
+    {
+        std::hash<std::string_view> h{};
+        std::size_t seed = h(key.text);
+        seed ^= h(key.font_family) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        seed ^= std::hash<double>{}(key.size) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        return seed ^ ((std::size_t)key.italic << 1 | (std::size_t)key.bold);
+    }
+};
+
+struct xaml_text_key_equal
+{
+    template <typename S1, typename S2>
+    bool operator()(xaml_text_key_base<S1> const& lhs, xaml_text_key_base<S2> const& rhs) const noexcept
+    {
+        return lhs.size == rhs.size && lhs.italic == rhs.italic && lhs.bold == rhs.bold &&
+               std::string_view{ lhs.text } == std::string_view{ rhs.text } &&
+               std::string_view{ lhs.font_family } == std::string_view{ rhs.font_family };
+    }
+};
+
+// The measured, and possibly shaped text, independent of where it is drawn.
+struct xaml_text_layout
+{
+#ifdef XAML_UI_GTK3
+    cairo_text_extents_t extents;
+    // The glyphs at the origin, shaped when the text is first drawn.
+    std::vector<cairo_glyph_t> glyphs;
+    bool shaped;
+#elif defined(XAML_UI_QT)
+    xaml_size size;
+    // Laid out when the text is first drawn.
+    QStaticText text;
+    bool shaped;
+#endif // XAML_UI_GTK3
+};
+
+using xaml_text_layout_cache = xaml_lru_cache<xaml_text_key, xaml_text_layout, xaml_text_key_view, xaml_text_key_hash, xaml_text_key_equal>;
+
+// The cache shared by all drawing contexts on the UI thread.
+xaml_text_layout_cache& xaml_text_layout_cache_current() noexcept;
+
+#endif // !XAML_UI_CANVAS_SHARED_TEXT_CACHE_HPP
@@ -0,0 +1,148 @@
+#ifndef XAML_UI_CANVAS_SHARED_TILE_CACHE_HPP
+#define XAML_UI_CANVAS_SHARED_TILE_CACHE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include <xaml/result.h>
+#include <xaml/ui/drawing.h>
+
+// Empty rectangles never intersect anything.
+constexpr bool xaml_rectangle_intersects(xaml_rectangle const& lhs, xaml_rectangle const& rhs) noexcept
+{
+    return lhs.width > 0 && lhs.height > 0 && rhs.width > 0 && rhs.height > 0 &&
+           lhs.x < rhs.x + rhs.width && rhs.x < lhs.x + lhs.width &&
+           lhs.y < rhs.y + rhs.height && rhs.y < lhs.y + lhs.height;
+}
+
+inline xaml_rectangle xaml_rectangle_intersect(xaml_rectangle const& lhs, xaml_rectangle const& rhs) noexcept
+{
+    double left = (std::max)(lhs.x, rhs.x);
+    double top = (std::max)(lhs.y, rhs.y);
+    double right = (std::min)(lhs.x + lhs.width, rhs.x + rhs.width);
+    double bottom = (std::min)(lhs.y + lhs.height, rhs.y + rhs.height);
+    return { left, top, (std::max)(right - left, 0.0), (std::max)(bottom - top, 0.0) };
+}
+
+// The bounds of both; an empty rectangle adds nothing.
+inline xaml_rectangle xaml_rectangle_union(xaml_rectangle const& lhs, xaml_rectangle const& rhs) noexcept
+{
+    if (lhs.width <= 0 || lhs.height <= 0) return rhs;
+    if (rhs.width <= 0 || rhs.height <= 0) return lhs;
+    double left = (std::min)(lhs.x, rhs.x);
+    double top = (std::min)(lhs.y, rhs.y);
+    double right = (std::max)(lhs.x + lhs.width, rhs.x + rhs.width);
+    double bottom = (std::max)(lhs.y + lhs.height, rhs.y + rhs.height);
+    return { left, top, right - left, bottom - top };
+}
+
+// The offscreen copy of a canvas, split into tiles of a fixed size.
+// A tile is drawn again only after a part of it is invalidated,
+// otherwise it is copied to the screen as is.
+template <typename Surface>
+struct xaml_tile_cache
+{
+    static constexpr double tile_size = 256;
+
+    struct tile
+    {
+        xaml_rectangle rect;
+        Surface surface;
+        bool stale;
+    };
+
+private:
+    xaml_size m_size{};
+    std::size_t m_columns{ 0 };
+    std::vector<tile> m_tiles{};
+
+public:
+    bool empty() const noexcept { return m_tiles.empty(); }
+
+    void clear() noexcept
+    {
+        m_size = {};
+        m_columns = 0;
+        m_tiles.clear();
+    }
+
+    // Drops all tiles if the size of the canvas changes.
+    void resize(xaml_size const& size)
+    {
+        if (size == m_size) return;
+        clear();
+        if (size.width <= 0 || size.height <= 0) return;
+        m_size = size;
+        m_columns = (std::size_t)std::ceil(size.width / tile_size);
+        std::size_t rows = (std::size_t)std::ceil(size.height / tile_size);
+        m_tiles.reserve(m_columns * rows);
+        for (std::size_t j = 0; j < rows; j++)
+        {
+            for (std::size_t i = 0; i < m_columns; i++)
+            {
+                double x = i * tile_size, y = j * tile_size;
+                m_tiles.push_back({ { x, y, (std::min)(tile_size, size.width - x), (std::min)(tile_size, size.height - y) }, {}, true });
+            }
+        }
+    }
+
+    // Marks the tiles intersecting the rectangle as stale, or all of them.
+    void invalidate(xaml_rectangle const* prect) noexcept
+    {
+        for (auto& t : m_tiles)
+        {
+            if (!prect || xaml_rectangle_intersects(t.rect, *prect)) t.stale = true;
+        }
+    }
+
+    // Calls the function with each tile intersecting the rectangle,
+    // and stops at the first failure.
+    template <typename F>
+    xaml_result for_each(xaml_rectangle const& region, F&& f) noexcept
+    {
+        if (m_tiles.empty() || region.width <= 0 || region.height <= 0) return XAML_S_OK;
+        std::size_t rows = m_tiles.size() / m_columns;
+        auto first = [](double pos) noexcept { return (std::size_t)(std::max)(std::floor(pos / tile_size), 0.0); };
+        auto last = [](double pos, std::size_t count) noexcept { return (std::min)((std::size_t)(std::max)(std::ceil(pos / tile_size), 0.0), count); };
+        std::size_t right = last(region.x + region.width, m_columns);
+        std::size_t bottom = last(region.y + region.height, rows);
+        for (std::size_t j = first(region.y); j < bottom; j++)
+        {
+            for (std::size_t i = first(region.x); i < right; i++)
+            {
+                XAML_RETURN_IF_FAILED(f(m_tiles[j * m_columns + i]));
+            }
+        }
+        return XAML_S_OK;
+    }
+
+    // Draws the tiles intersecting the region.
+    // prepare(tile) makes the surface of each tile ready, and may mark it stale.
+    // Then redraw(bounds, stale) draws all stale tiles at once from the bounds of them,
+    // because the handlers draw the whole canvas each time, and present(tile) shows each tile.
+    template <typename Prepare, typename Redraw, typename Present>
+    xaml_result draw(xaml_rectangle const& region, Prepare&& prepare, Redraw&& redraw, Present&& present)
+    {
+        std::vector<tile*> stale;
+        stale.reserve(m_tiles.size());
+        xaml_rectangle bounds{};
+        XAML_RETURN_IF_FAILED(for_each(region, [&](tile& t) noexcept -> xaml_result {
+            XAML_RETURN_IF_FAILED(prepare(t));
+            if (t.stale)
+            {
+                stale.push_back(&t);
+                bounds = xaml_rectangle_union(bounds, t.rect);
+            }
+            return XAML_S_OK;
+        }));
+        if (!stale.empty())
+        {
+            XAML_RETURN_IF_FAILED(redraw(bounds, stale));
+            for (tile* t : stale) t->stale = false;
+        }
+        return for_each(region, present);
+    }
+};
+
+#endif // !XAML_UI_CANVAS_SHARED_TILE_CACHE_HPP
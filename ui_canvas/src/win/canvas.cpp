@@ -250,8 +250,10 @@ xaml_result xaml_canvas_internal::wnd_proc(xaml_win32_window_message const& msg,
             target->Clear(background_color);
             wil::com_ptr_nothrow<ID2D1RenderTarget> ctx_target;
             XAML_RETURN_IF_FAILED(target.query_to(&ctx_target));
-            xaml_ptr<xaml_drawing_context> dc;
+            xaml_ptr<xaml_drawing_context_impl> dc;
             XAML_RETURN_IF_FAILED(xaml_object_new<xaml_drawing_context_impl>(&dc, ctx_target, d2d, dwrite));
+            // The update region is validated before WM_DRAWITEM, so the whole canvas is drawn.
+            XAML_RETURN_IF_FAILED(dc->set_dirty_rects({ { 0, 0, m_size.width, m_size.height } }));
             XAML_RETURN_IF_FAILED(m_redraw->invoke(m_outer_this, dc));
             XAML_RETURN_IF_FAILED(target->EndDraw());
         }
@@ -0,0 +1,248 @@
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <numbers>
+#include <test_check.hpp>
+#include <xaml/ui/application.h>
+#include <xaml/ui/controls/canvas.h>
+
+namespace colors
+{
+#include <xaml/ui/colors.h>
+}
+
+using namespace std;
+
+// Draws each primitive many times on an offscreen surface,
+// and prints the time of one call.
+// Checks a few pixels and the PNG output, which is saved to the first argument if any,
+// and that the gradients of the same size drawn everywhere follow the changes of their brush.
+
+static constexpr int width = 800;
+static constexpr int height = 600;
+static constexpr int calls = 5000;
+
+struct primitive
+{
+    char const* name;
+    function<xaml_result(xaml_drawing_context*, xaml_rectangle const&)> draw;
+};
+
+static xaml_result bench(xaml_drawing_surface* surface, primitive const& p) noexcept
+{
+    xaml_ptr<xaml_drawing_context> dc;
+    XAML_RETURN_IF_FAILED(surface->get_context(&dc));
+    XAML_RETURN_IF_FAILED(surface->clear(colors::white));
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < calls; i++)
+    {
+        xaml_rectangle rect{ (double)(i * 37 % (width - 100)), (double)(i * 53 % (height - 60)), 100, 60 };
+        XAML_RETURN_IF_FAILED(p.draw(dc, rect));
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << p.name << ": " << seconds / calls * 1e6 << " us/call" << endl;
+    return XAML_S_OK;
+}
+
+static uint32_t get_pixel(xaml_buffer* pixels, int32_t stride, int x, int y) noexcept
+{
+    uint8_t* data;
+    XAML_ASSERT_SUCCEEDED(pixels->get_data(&data));
+    uint32_t value;
+    memcpy(&value, data + y * stride + x * 4, sizeof(value));
+    return value;
+}
+
+static xaml_result check_pixels(xaml_drawing_surface* surface, xaml_string* path) noexcept
+{
+    xaml_ptr<xaml_drawing_context> dc;
+    XAML_RETURN_IF_FAILED(surface->get_context(&dc));
+    XAML_RETURN_IF_FAILED(surface->clear(colors::white));
+    xaml_ptr<xaml_solid_brush> red;
+    XAML_RETURN_IF_FAILED(xaml_solid_brush_new(colors::red, &red));
+    XAML_RETURN_IF_FAILED(dc->fill_rect(red, { 10, 10, 20, 20 }));
+
+    int32_t stride;
+    XAML_RETURN_IF_FAILED(surface->get_stride(&stride));
+    CHECK(stride >= width * 4);
+    xaml_ptr<xaml_buffer> pixels;
+    XAML_RETURN_IF_FAILED(surface->get_pixels(&pixels));
+    int32_t size;
+    XAML_RETURN_IF_FAILED(pixels->get_size(&size));
+    CHECK(size == stride * height);
+    CHECK(get_pixel(pixels, stride, 20, 20) == 0xFFFF0000);
+    CHECK(get_pixel(pixels, stride, 5, 5) == 0xFFFFFFFF);
+    CHECK(get_pixel(pixels, stride, 30, 30) == 0xFFFFFFFF);
+
+    xaml_ptr<xaml_buffer> png;
+    XAML_RETURN_IF_FAILED(surface->encode_png(&png));
+    uint8_t* data;
+    XAML_RETURN_IF_FAILED(png->get_data(&data));
+    XAML_RETURN_IF_FAILED(png->get_size(&size));
+    CHECK(size > 8 && memcmp(data, "\x89PNG", 4) == 0);
+    if (path) XAML_RETURN_IF_FAILED(surface->save_png(path));
+    return XAML_S_OK;
+}
+
+// Whether each channel of the pixel is near that of the color.
+static bool near_color(uint32_t pixel, xaml_color color) noexcept
+{
+    uint32_t expected = color;
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        int diff = (int)((pixel >> shift) & 0xFF) - (int)((expected >> shift) & 0xFF);
+        if (diff < -16 || diff > 16) return false;
+    }
+    return true;
+}
+
+// Fills the rects of the same size across the surface with the brush,
+// and checks the colors near the left and the right edges of each.
+static xaml_result check_gradient_rects(xaml_drawing_surface* surface, xaml_brush* brush, xaml_color left, xaml_color right) noexcept
+{
+    xaml_ptr<xaml_drawing_context> dc;
+    XAML_RETURN_IF_FAILED(surface->get_context(&dc));
+    XAML_RETURN_IF_FAILED(surface->clear(colors::white));
+    for (int y = 0; y + 60 <= height; y += 60)
+    {
+        for (int x = 0; x + 100 <= width; x += 100)
+        {
+            XAML_RETURN_IF_FAILED(dc->fill_rect(brush, { (double)x, (double)y, 100, 60 }));
+        }
+    }
+    int32_t stride;
+    XAML_RETURN_IF_FAILED(surface->get_stride(&stride));
+    xaml_ptr<xaml_buffer> pixels;
+    XAML_RETURN_IF_FAILED(surface->get_pixels(&pixels));
+    bool all_near = true;
+    for (int y = 0; y + 60 <= height; y += 60)
+    {
+        for (int x = 0; x + 100 <= width; x += 100)
+        {
+            all_near = all_near && near_color(get_pixel(pixels, stride, x + 1, y + 30), left);
+            all_near = all_near && near_color(get_pixel(pixels, stride, x + 98, y + 30), right);
+        }
+    }
+    CHECK(all_near);
+    return XAML_S_OK;
+}
+
+// The pattern of a gradient is built once for a size, so it is checked to be rebuilt
+// after each change of the brush.
+static xaml_result check_gradient(xaml_drawing_surface* surface) noexcept
+{
+    xaml_ptr<xaml_linear_gradient_brush> linear;
+    XAML_RETURN_IF_FAILED(xaml_linear_gradient_brush_new(&linear));
+    XAML_RETURN_IF_FAILED(linear->set_start_point({ 0, 0 }));
+    XAML_RETURN_IF_FAILED(linear->set_end_point({ 1, 0 }));
+    XAML_RETURN_IF_FAILED(linear->add_stop({ colors::red, 0 }));
+    XAML_RETURN_IF_FAILED(linear->add_stop({ colors::blue, 1 }));
+    XAML_RETURN_IF_FAILED(check_gradient_rects(surface, linear, colors::red, colors::blue));
+
+    XAML_RETURN_IF_FAILED(linear->remove_stop({ colors::blue, 1 }));
+    XAML_RETURN_IF_FAILED(linear->add_stop({ colors::lime, 1 }));
+    XAML_RETURN_IF_FAILED(check_gradient_rects(surface, linear, colors::red, colors::lime));
+
+    XAML_RETURN_IF_FAILED(linear->set_start_point({ 1, 0 }));
+    XAML_RETURN_IF_FAILED(linear->set_end_point({ 0, 0 }));
+    XAML_RETURN_IF_FAILED(check_gradient_rects(surface, linear, colors::lime, colors::red));
+
+    xaml_ptr<xaml_solid_brush> solid;
+    XAML_RETURN_IF_FAILED(xaml_solid_brush_new(colors::red, &solid));
+    XAML_RETURN_IF_FAILED(check_gradient_rects(surface, solid, colors::red, colors::red));
+    XAML_RETURN_IF_FAILED(solid->set_color(colors::blue));
+    XAML_RETURN_IF_FAILED(check_gradient_rects(surface, solid, colors::blue, colors::blue));
+    return XAML_S_OK;
+}
+
+// Fills 10k gradient rects of the same size, whose pattern is reused,
+// and of a size changed each time, whose pattern is built for each.
+static xaml_result bench_gradient(xaml_drawing_surface* surface, xaml_brush* brush) noexcept
+{
+    constexpr int count = 10000;
+    xaml_ptr<xaml_drawing_context> dc;
+    XAML_RETURN_IF_FAILED(surface->get_context(&dc));
+    for (bool same_size : { true, false })
+    {
+        XAML_RETURN_IF_FAILED(surface->clear(colors::white));
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < count; i++)
+        {
+            double w = same_size ? 100 : 100 + i % 2;
+            xaml_rectangle rect{ (double)(i * 37 % (width - 101)), (double)(i * 53 % (height - 60)), w, 60 };
+            XAML_RETURN_IF_FAILED(dc->fill_rect(brush, rect));
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << count << " gradient rects" << (same_size ? " of the same size: " : " of changing sizes: ") << seconds * 1e3 << " ms" << endl;
+    }
+    return XAML_S_OK;
+}
+
+static xaml_result run(xaml_string* path) noexcept
+{
+    xaml_ptr<xaml_drawing_surface> surface;
+    XAML_RETURN_IF_FAILED(xaml_drawing_surface_new(width, height, &surface));
+    XAML_RETURN_IF_FAILED(check_pixels(surface, path));
+    XAML_RETURN_IF_FAILED(check_gradient(surface));
+
+    xaml_ptr<xaml_solid_brush> brush;
+    XAML_RETURN_IF_FAILED(xaml_solid_brush_new(colors::sky_blue, &brush));
+    xaml_ptr<xaml_brush_pen> pen;
+    XAML_RETURN_IF_FAILED(xaml_brush_pen_new_solid(colors::black, 2, &pen));
+    xaml_ptr<xaml_linear_gradient_brush> linear;
+    XAML_RETURN_IF_FAILED(xaml_linear_gradient_brush_new(&linear));
+    XAML_RETURN_IF_FAILED(linear->set_start_point({ 0, 0 }));
+    XAML_RETURN_IF_FAILED(linear->set_end_point({ 1, 1 }));
+    XAML_RETURN_IF_FAILED(linear->add_stop({ colors::sky_blue, 0 }));
+    XAML_RETURN_IF_FAILED(linear->add_stop({ colors::black, 1 }));
+    xaml_ptr<xaml_radial_gradient_brush> radial;
+    XAML_RETURN_IF_FAILED(xaml_radial_gradient_brush_new(&radial));
+    XAML_RETURN_IF_FAILED(radial->set_center({ 0.5, 0.5 }));
+    XAML_RETURN_IF_FAILED(radial->set_origin({ 0.2, 0.5 }));
+    XAML_RETURN_IF_FAILED(radial->set_radius({ 0.5, 0.5 }));
+    XAML_RETURN_IF_FAILED(radial->add_stop({ colors::white_smoke, 0 }));
+    XAML_RETURN_IF_FAILED(radial->add_stop({ colors::pink, 1 }));
+    xaml_ptr<xaml_string> text;
+    XAML_RETURN_IF_FAILED(xaml_string_new(U("Hello world!"), &text));
+    xaml_drawing_font font = { U("Arial"), 14, false, false, xaml_halignment_left, xaml_valignment_top };
+
+    primitive primitives[] = {
+        { "draw_arc", [&](xaml_drawing_context* dc, xaml_rectangle const& r) { return dc->draw_arc(pen, r, 0, numbers::pi); } },
+        { "fill_pie", [&](xaml_drawing_context* dc, xaml_rectangle const& r) { return dc->fill_pie(brush, r, 0, numbers::pi); } },
+        { "draw_ellipse", [&](xaml_drawing_context* dc, xaml_rectangle const& r) { return dc->draw_ellipse(pen, r); } },
+        { "fill_ellipse", [&](xaml_drawing_context* dc, xaml_rectangle const& r) { return dc->fill_ellipse(brush, r); } },
+        { "draw_line", [&](xaml_drawing_context* dc, xaml_rectangle const& r) { return dc->draw_line(pen, { r.x, r.y }, { r.x + r.width, r.y + r.height }); } },
+        { "draw_rect", [&](xaml_drawing_context* dc, xaml_rectangle const& r) { return dc->draw_rect(pen, r); } },
+        { "fill_rect", [&](xaml_drawing_context* dc, xaml_rectangle const& r) { return dc->fill_rect(brush, r); } },
+        { "draw_round_rect", [&](xaml_drawing_context* dc, xaml_rectangle const& r) { return dc->draw_round_rect(pen, r, { 10, 10 }); } },
+        { "fill_round_rect", [&](xaml_drawing_context* dc, xaml_rectangle const& r) { return dc->fill_round_rect(brush, r, { 10, 10 }); } },
+        { "draw_string", [&](xaml_drawing_context* dc, xaml_rectangle const& r) { return dc->draw_string(brush, font, { r.x, r.y }, text); } },
+        { "fill_rect (linear gradient)", [&](xaml_drawing_context* dc, xaml_rectangle const& r) { return dc->fill_rect(linear, r); } },
+        { "fill_ellipse (radial gradient)", [&](xaml_drawing_context* dc, xaml_rectangle const& r) { return dc->fill_ellipse(radial, r); } },
+    };
+    for (auto& p : primitives)
+    {
+        XAML_RETURN_IF_FAILED(bench(surface, p));
+    }
+    XAML_RETURN_IF_FAILED(bench_gradient(surface, linear));
+    return XAML_S_OK;
+}
+
+int main(int argc, char** argv)
+{
+#ifdef XAML_UI_QT
+    // Qt needs an application to draw strings.
+    xaml_ptr<xaml_application> app;
+    XAML_ASSERT_SUCCEEDED(xaml_application_init_with_args(argc, argv, &app));
+#endif // XAML_UI_QT
+    xaml_ptr<xaml_string> path;
+    if (argc > 1) XAML_ASSERT_SUCCEEDED(xaml_string_new(argv[1], &path));
+    xaml_result hr = run(path);
+    if (XAML_FAILED(hr))
+    {
+        cout << "error: " << hex << hr << endl;
+        failures++;
+    }
+    return report_failures();
+}
@@ -0,0 +1,89 @@
+#include <iostream>
+#include <shared/tile_cache.hpp>
+#include <test_check.hpp>
+#include <vector>
+
+using namespace std;
+
+// The surface counts how many times the tile is drawn.
+using cache_type = xaml_tile_cache<int>;
+
+// How many times the canvas is drawn, and the last bounds drawn.
+static int redraws = 0;
+static xaml_rectangle redraw_bounds{};
+
+// Draws the stale tiles in the region, and returns how many of them.
+static int draw(cache_type& cache, xaml_rectangle const& region)
+{
+    int count = 0;
+    xaml_result hr = cache.draw(
+        region,
+        [](cache_type::tile&) noexcept -> xaml_result { return XAML_S_OK; },
+        [&](xaml_rectangle const& bounds, vector<cache_type::tile*> const& stale) noexcept -> xaml_result {
+            redraws++;
+            redraw_bounds = bounds;
+            for (auto t : stale) t->surface++;
+            count += (int)stale.size();
+            return XAML_S_OK;
+        },
+        // Every tile shown is drawn.
+        [](cache_type::tile& t) noexcept -> xaml_result { return t.stale ? XAML_E_FAIL : XAML_S_OK; });
+    CHECK_OK(hr);
+    return count;
+}
+
+static void invalidate(cache_type& cache, xaml_rectangle const& rect)
+{
+    cache.invalidate(&rect);
+}
+
+static void test_intersect()
+{
+    CHECK(xaml_rectangle_intersects({ 0, 0, 10, 10 }, { 5, 5, 10, 10 }));
+    CHECK(!xaml_rectangle_intersects({ 0, 0, 10, 10 }, { 10, 0, 10, 10 }));
+    CHECK(!xaml_rectangle_intersects({ 0, 0, 10, 10 }, { 5, 5, 0, 0 }));
+    CHECK((xaml_rectangle_intersect({ 0, 0, 10, 10 }, { 5, 5, 10, 10 }) == xaml_rectangle{ 5, 5, 5, 5 }));
+    CHECK((xaml_rectangle_union({ 0, 0, 10, 10 }, { 5, 5, 10, 10 }) == xaml_rectangle{ 0, 0, 15, 15 }));
+    CHECK((xaml_rectangle_union({}, { 5, 5, 10, 10 }) == xaml_rectangle{ 5, 5, 10, 10 }));
+}
+
+static void test_tiles()
+{
+    cache_type cache;
+    cache.resize({ 600, 300 });
+    // 3 columns and 2 rows, the last ones clipped to the size, all drawn at once.
+    CHECK(draw(cache, { 0, 0, 600, 300 }) == 6);
+    CHECK(redraws == 1 && (redraw_bounds == xaml_rectangle{ 0, 0, 600, 300 }));
+    CHECK(draw(cache, { 0, 0, 600, 300 }) == 0);
+    CHECK(redraws == 1);
+
+    // A small change only redraws the tile under it.
+    invalidate(cache, { 300, 10, 20, 20 });
+    CHECK(draw(cache, { 0, 0, 600, 300 }) == 1);
+
+    // A change across the corner of four tiles.
+    invalidate(cache, { 250, 250, 10, 10 });
+    CHECK(draw(cache, { 0, 0, 600, 300 }) == 4);
+    CHECK(redraws == 3 && (redraw_bounds == xaml_rectangle{ 0, 0, 512, 300 }));
+
+    // A stale tile outside the drawn region stays stale.
+    invalidate(cache, { 550, 280, 10, 10 });
+    CHECK(draw(cache, { 0, 0, 100, 100 }) == 0);
+    CHECK(draw(cache, { 500, 200, 100, 100 }) == 1);
+
+    cache.invalidate(nullptr);
+    CHECK(draw(cache, { 0, 0, 600, 300 }) == 6);
+
+    // Resizing drops all tiles.
+    cache.resize({ 600, 300 });
+    CHECK(draw(cache, { 0, 0, 600, 300 }) == 0);
+    cache.resize({ 100, 100 });
+    CHECK(draw(cache, { 0, 0, 600, 300 }) == 1);
+}
+
+int main()
+{
+    test_intersect();
+    test_tiles();
+    return report_failures();
+}
@@ -0,0 +1,31 @@
+#ifndef XAML_UI_CONTROLS_VIRTUALIZING_STACK_PANEL_H
+#define XAML_UI_CONTROLS_VIRTUALIZING_STACK_PANEL_H
+
+#include <xaml/ui/controls/items_base.h>
+#include <xaml/ui/controls/layout_base.h>
+
+#ifndef xaml_delegate_2__xaml_object__double_defined
+    #define xaml_delegate_2__xaml_object__double_defined
+XAML_DELEGATE_2_TYPE(XAML_T_O(xaml_object), XAML_T_V(double))
+#endif // !xaml_delegate_2__xaml_object__double_defined
+
+XAML_CLASS(xaml_virtualizing_stack_panel, { 0x21364a59, 0x7606, 0x4adc, { 0x90, 0xdb, 0xcd, 0x61, 0x7b, 0xe0, 0x94, 0x87 } })
+
+#define XAML_VIRTUALIZING_STACK_PANEL_VTBL(type)                       \
+    XAML_VTBL_INHERIT(XAML_ITEMS_BASE_VTBL(type));                     \
+    XAML_PROP(orientation, type, xaml_orientation*, xaml_orientation); \
+    XAML_PROP(overscan, type, XAML_STD int32_t*, XAML_STD int32_t);    \
+    XAML_PROP(estimated_item_size, type, double*, double);             \
+    XAML_PROP(offset, type, double*, double);                          \
+    XAML_EVENT(offset_changed, type, xaml_object, double)
+
+XAML_DECL_INTERFACE_(xaml_virtualizing_stack_panel, xaml_items_base)
+{
+    XAML_DECL_VTBL(xaml_virtualizing_stack_panel, XAML_VIRTUALIZING_STACK_PANEL_VTBL);
+};
+
+EXTERN_C XAML_UI_CONTROLS_API xaml_result XAML_CALL xaml_virtualizing_stack_panel_new(xaml_virtualizing_stack_panel**) XAML_NOEXCEPT;
+EXTERN_C XAML_UI_CONTROLS_API xaml_result XAML_CALL xaml_virtualizing_stack_panel_members(xaml_type_info_registration*) XAML_NOEXCEPT;
+EXTERN_C XAML_UI_CONTROLS_API xaml_result XAML_CALL xaml_virtualizing_stack_panel_register(xaml_meta_context*) XAML_NOEXCEPT;
+
+#endif // !XAML_UI_CONTROLS_VIRTUALIZING_STACK_PANEL_H
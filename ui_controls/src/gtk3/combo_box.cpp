@@ -50,18 +50,8 @@ xaml_result xaml_combo_box_internal::draw_text() noexcept
 
 xaml_result xaml_combo_box_internal::draw_items() noexcept
 {
-    XAML_FOREACH_START(xaml_object, item, m_items);
-    {
-        XAML_RETURN_IF_FAILED(create_item(item));
-        xaml_ptr<xaml_string> s = item.query<xaml_string>();
-        if (s)
-        {
-            char const* data;
-            XAML_RETURN_IF_FAILED(s->get_data(&data));
-            gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(m_handle), data);
-        }
-    }
-    XAML_FOREACH_END();
+    gtk_combo_box_text_remove_all(GTK_COMBO_BOX_TEXT(m_handle));
+    if (m_items) XAML_RETURN_IF_FAILED(insert_items(0, m_items));
     return XAML_S_OK;
 }
 
@@ -153,3 +143,78 @@ xaml_result xaml_combo_box_internal::replace_item(int32_t index, xaml_ptr<xaml_o
     XAML_RETURN_IF_FAILED(insert_item(index, value));
     return XAML_S_OK;
 }
+
+// The model is detached while it is changed, so that the view is not updated row by row.
+// Detaching resets the active item, so the handler of "changed" is blocked meanwhile,
+// and the active item is restored after the model is attached again.
+struct xaml_gtk3_combo_box_batch
+{
+    GtkComboBox* m_combo;
+    GtkListStore* m_store;
+    gint m_active;
+
+    xaml_gtk3_combo_box_batch(GtkWidget* handle, xaml_combo_box_internal* self) noexcept
+        : m_combo(GTK_COMBO_BOX(handle)), m_store(GTK_LIST_STORE(gtk_combo_box_get_model(m_combo))), m_active(gtk_combo_box_get_active(m_combo))
+    {
+        g_object_ref(m_store);
+        g_signal_handlers_block_by_func(m_combo, (gpointer)xaml_combo_box_internal::on_changed, self);
+        gtk_combo_box_set_model(m_combo, NULL);
+    }
+
+    void commit(gint active, xaml_combo_box_internal* self) noexcept
+    {
+        gtk_combo_box_set_model(m_combo, GTK_TREE_MODEL(m_store));
+        gtk_combo_box_set_active(m_combo, active);
+        g_signal_handlers_unblock_by_func(m_combo, (gpointer)xaml_combo_box_internal::on_changed, self);
+        g_object_unref(m_store);
+        if (active != m_active)
+        {
+            xaml_combo_box_internal::on_changed(GTK_WIDGET(m_combo), self);
+        }
+    }
+};
+
+xaml_result xaml_combo_box_internal::insert_items(int32_t index, xaml_vector_view<xaml_object>* items) noexcept
+{
+    xaml_gtk3_combo_box_batch batch{ m_handle, this };
+    int32_t count = 0;
+    xaml_result hr = [&]() noexcept -> xaml_result {
+        XAML_FOREACH_START(xaml_object, item, items);
+        {
+            XAML_RETURN_IF_FAILED(create_item(item));
+            xaml_ptr<xaml_string> s = item.query<xaml_string>();
+            if (s)
+            {
+                char const* data;
+                XAML_RETURN_IF_FAILED(s->get_data(&data));
+                gtk_list_store_insert_with_values(batch.m_store, NULL, index + count, 0, data, -1);
+                count++;
+            }
+        }
+        XAML_FOREACH_END();
+        return XAML_S_OK;
+    }();
+    batch.commit(batch.m_active >= index ? batch.m_active + count : batch.m_active, this);
+    return hr;
+}
+
+xaml_result xaml_combo_box_internal::remove_items(int32_t index, int32_t count) noexcept
+{
+    xaml_gtk3_combo_box_batch batch{ m_handle, this };
+    GtkTreeIter iter;
+    if (gtk_tree_model_iter_nth_child(GTK_TREE_MODEL(batch.m_store), &iter, NULL, index))
+    {
+        // The iter is moved to the next row after removing.
+        for (int32_t i = 0; i < count; i++)
+        {
+            if (!gtk_list_store_remove(batch.m_store, &iter)) break;
+        }
+    }
+    gint active = batch.m_active;
+    if (active >= index + count)
+        active -= count;
+    else if (active >= index)
+        active = -1;
+    batch.commit(active, this);
+    return XAML_S_OK;
+}
@@ -0,0 +1,69 @@
+#include <shared/virtualizing_stack_panel.hpp>
+#include <xaml/ui/controls/virtualizing_stack_panel.h>
+#include <xaml/ui/drawing_conv.hpp>
+#include <xaml/ui/gtk3/xamlfixed.h>
+
+using namespace std;
+
+xaml_result xaml_virtualizing_stack_panel_internal::draw(xaml_rectangle const& region) noexcept
+{
+    if (!m_handle)
+    {
+        m_handle = gtk_scrolled_window_new(NULL, NULL);
+        m_content_handle = xaml_fixed_new();
+        gtk_container_add(GTK_CONTAINER(m_handle), m_content_handle);
+        GtkAdjustment* adjustment;
+        if (m_orientation == xaml_orientation_vertical)
+        {
+            gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(m_handle), GTK_POLICY_NEVER, GTK_POLICY_AUTOMATIC);
+            adjustment = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(m_handle));
+        }
+        else
+        {
+            gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(m_handle), GTK_POLICY_AUTOMATIC, GTK_POLICY_NEVER);
+            adjustment = gtk_scrolled_window_get_hadjustment(GTK_SCROLLED_WINDOW(m_handle));
+        }
+        g_signal_connect(G_OBJECT(adjustment), "value-changed", G_CALLBACK(xaml_virtualizing_stack_panel_internal::on_value_changed), this);
+        gtk_widget_show(m_content_handle);
+        XAML_RETURN_IF_FAILED(draw_visible());
+    }
+    m_viewport = region;
+    XAML_RETURN_IF_FAILED(set_rect(region));
+    return draw_items();
+}
+
+xaml_result xaml_virtualizing_stack_panel_internal::draw_extent(double extent) noexcept
+{
+    gint size = (gint)extent;
+    if (m_orientation == xaml_orientation_vertical)
+        gtk_widget_set_size_request(m_content_handle, -1, size);
+    else
+        gtk_widget_set_size_request(m_content_handle, size, -1);
+    return XAML_S_OK;
+}
+
+xaml_result xaml_virtualizing_stack_panel_internal::draw_offset() noexcept
+{
+    GtkAdjustment* adjustment = m_orientation == xaml_orientation_vertical ? gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(m_handle)) : gtk_scrolled_window_get_hadjustment(GTK_SCROLLED_WINDOW(m_handle));
+    if (gtk_adjustment_get_value(adjustment) != m_offset)
+    {
+        gtk_adjustment_set_value(adjustment, m_offset);
+    }
+    return XAML_S_OK;
+}
+
+xaml_result xaml_virtualizing_stack_panel_internal::place_container(xaml_control* container, xaml_rectangle const& region) noexcept
+{
+    xaml_ptr<xaml_gtk3_control> native_container;
+    XAML_RETURN_IF_FAILED(container->query(&native_container));
+    GtkWidget* handle;
+    XAML_RETURN_IF_FAILED(native_container->get_handle(&handle));
+    GtkAllocation alloc = xaml_to_native<GtkAllocation>(region);
+    xaml_fixed_child_size_allocate(XAML_FIXED(m_content_handle), handle, &alloc);
+    return XAML_S_OK;
+}
+
+void xaml_virtualizing_stack_panel_internal::on_value_changed(GtkAdjustment* adjustment, xaml_virtualizing_stack_panel_internal* self) noexcept
+{
+    XAML_ASSERT_SUCCEEDED(self->set_offset(gtk_adjustment_get_value(adjustment)));
+}
@@ -0,0 +1,28 @@
+#include <shared/button.hpp>
+#include <xaml/ui/controls/button.h>
+
+using namespace std;
+
+xaml_result xaml_button_internal::draw(xaml_rectangle const& region) noexcept
+{
+    if (!m_handle)
+    {
+        m_handle = new (nothrow) xaml_headless_widget{};
+        if (!m_handle) return XAML_E_OUTOFMEMORY;
+        XAML_RETURN_IF_FAILED(draw_visible());
+        XAML_RETURN_IF_FAILED(draw_text());
+        XAML_RETURN_IF_FAILED(draw_default());
+    }
+    return set_rect(region);
+}
+
+xaml_result xaml_button_internal::draw_text() noexcept { return XAML_S_OK; }
+
+xaml_result xaml_button_internal::draw_default() noexcept { return XAML_S_OK; }
+
+xaml_result xaml_button_internal::size_to_fit() noexcept
+{
+    xaml_size res;
+    XAML_RETURN_IF_FAILED(measure_string(m_text, { 5, 5 }, &res));
+    return set_size_noevent(res);
+}
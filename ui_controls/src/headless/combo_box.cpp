@@ -0,0 +1,57 @@
+#include <algorithm>
+#include <shared/combo_box.hpp>
+#include <xaml/ui/controls/combo_box.h>
+
+using namespace std;
+
+xaml_result xaml_combo_box_internal::draw(xaml_rectangle const& region) noexcept
+{
+    if (!m_handle)
+    {
+        m_handle = new (nothrow) xaml_headless_widget{};
+        if (!m_handle) return XAML_E_OUTOFMEMORY;
+        XAML_RETURN_IF_FAILED(draw_items());
+        XAML_RETURN_IF_FAILED(draw_sel());
+        XAML_RETURN_IF_FAILED(draw_editable());
+        XAML_RETURN_IF_FAILED(draw_visible());
+    }
+    return set_rect(region);
+}
+
+xaml_result xaml_combo_box_internal::draw_text() noexcept { return XAML_S_OK; }
+
+xaml_result xaml_combo_box_internal::draw_items() noexcept { return XAML_S_OK; }
+
+xaml_result xaml_combo_box_internal::draw_sel() noexcept { return XAML_S_OK; }
+
+xaml_result xaml_combo_box_internal::draw_editable() noexcept { return XAML_S_OK; }
+
+xaml_result xaml_combo_box_internal::size_to_fit() noexcept
+{
+    double fw = 0.0, fh = 0.0;
+    if (m_items)
+    {
+        XAML_FOREACH_START(xaml_object, item, m_items);
+        {
+            XAML_RETURN_IF_FAILED(create_item(item));
+            xaml_ptr<xaml_string> s = item.query<xaml_string>();
+            if (s)
+            {
+                xaml_size msize;
+                XAML_RETURN_IF_FAILED(measure_string(s, { 5, 10 }, &msize));
+                fw = (max)(fw, msize.width);
+                fh = (max)(fh, msize.height);
+            }
+        }
+        XAML_FOREACH_END();
+    }
+    return set_size_noevent({ fw, fh });
+}
+
+xaml_result xaml_combo_box_internal::insert_item(int32_t, xaml_ptr<xaml_object> const&) noexcept { return XAML_S_OK; }
+
+xaml_result xaml_combo_box_internal::remove_item(int32_t) noexcept { return XAML_S_OK; }
+
+xaml_result xaml_combo_box_internal::clear_items() noexcept { return XAML_S_OK; }
+
+xaml_result xaml_combo_box_internal::replace_item(int32_t, xaml_ptr<xaml_object> const&) noexcept { return XAML_S_OK; }
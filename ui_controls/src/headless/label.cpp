@@ -0,0 +1,28 @@
+#include <shared/label.hpp>
+#include <xaml/ui/controls/label.h>
+
+using namespace std;
+
+xaml_result xaml_label_internal::draw(xaml_rectangle const& region) noexcept
+{
+    if (!m_handle)
+    {
+        m_handle = new (nothrow) xaml_headless_widget{};
+        if (!m_handle) return XAML_E_OUTOFMEMORY;
+        XAML_RETURN_IF_FAILED(draw_visible());
+        XAML_RETURN_IF_FAILED(draw_text());
+        XAML_RETURN_IF_FAILED(draw_alignment());
+    }
+    return set_rect(region);
+}
+
+xaml_result xaml_label_internal::draw_text() noexcept { return XAML_S_OK; }
+
+xaml_result xaml_label_internal::draw_alignment() noexcept { return XAML_S_OK; }
+
+xaml_result xaml_label_internal::size_to_fit() noexcept
+{
+    xaml_size res;
+    XAML_RETURN_IF_FAILED(measure_string(m_text, {}, &res));
+    return set_size_noevent(res);
+}
@@ -0,0 +1,19 @@
+#include <shared/layout_base.hpp>
+#include <xaml/ui/controls/layout_base.h>
+
+using namespace std;
+
+xaml_result xaml_layout_base_internal::draw(xaml_rectangle const& region) noexcept
+{
+    // A layout owns a widget only to record its region,
+    // and draws without a parent, so that it could be tested alone.
+    if (!m_handle)
+    {
+        m_handle = new (nothrow) xaml_headless_widget{};
+        if (!m_handle) return XAML_E_OUTOFMEMORY;
+        XAML_RETURN_IF_FAILED(draw_visible());
+    }
+    m_handle->rect = region - m_margin;
+    m_handle->arrange_count++;
+    return draw_impl(region, {});
+}
@@ -0,0 +1,65 @@
+#include <shared/menu_item.hpp>
+#include <xaml/ui/controls/menu_item.h>
+
+using namespace std;
+
+xaml_result xaml_menu_item_internal::draw(xaml_rectangle const&) noexcept
+{
+    if (!m_handle)
+    {
+        m_handle = new (nothrow) xaml_headless_widget{};
+        if (!m_handle) return XAML_E_OUTOFMEMORY;
+        XAML_RETURN_IF_FAILED(draw_visible());
+    }
+    return XAML_S_OK;
+}
+
+xaml_result xaml_popup_menu_item_internal::draw(xaml_rectangle const& region) noexcept
+{
+    if (!m_handle)
+    {
+        XAML_RETURN_IF_FAILED(xaml_menu_item_internal::draw(region));
+        XAML_RETURN_IF_FAILED(draw_submenu());
+    }
+    return XAML_S_OK;
+}
+
+xaml_result xaml_popup_menu_item_internal::draw_submenu() noexcept
+{
+    XAML_FOREACH_START(xaml_menu_item, cc, m_submenu);
+    {
+        XAML_RETURN_IF_FAILED(cc->draw({}));
+    }
+    XAML_FOREACH_END();
+    return XAML_S_OK;
+}
+
+xaml_result xaml_check_menu_item_internal::draw(xaml_rectangle const& region) noexcept
+{
+    if (!m_handle)
+    {
+        XAML_RETURN_IF_FAILED(xaml_menu_item_internal::draw(region));
+        XAML_RETURN_IF_FAILED(draw_checked());
+    }
+    return XAML_S_OK;
+}
+
+xaml_result xaml_check_menu_item_internal::draw_checked() noexcept { return XAML_S_OK; }
+
+xaml_result xaml_radio_menu_item_internal::draw(xaml_rectangle const& region) noexcept
+{
+    if (!m_handle)
+    {
+        XAML_RETURN_IF_FAILED(xaml_menu_item_internal::draw(region));
+        XAML_RETURN_IF_FAILED(draw_checked());
+        XAML_RETURN_IF_FAILED(draw_group());
+    }
+    return XAML_S_OK;
+}
+
+xaml_result xaml_radio_menu_item_internal::draw_checked() noexcept { return XAML_S_OK; }
+
+xaml_result xaml_separator_menu_item_internal::draw(xaml_rectangle const& region) noexcept
+{
+    return xaml_menu_item_internal::draw(region);
+}
@@ -0,0 +1,27 @@
+#include <shared/progress.hpp>
+#include <xaml/ui/controls/progress.h>
+
+using namespace std;
+
+xaml_result xaml_progress_internal::draw(xaml_rectangle const& region) noexcept
+{
+    if (!m_handle)
+    {
+        m_handle = new (nothrow) xaml_headless_widget{};
+        if (!m_handle) return XAML_E_OUTOFMEMORY;
+        XAML_RETURN_IF_FAILED(draw_visible());
+        XAML_RETURN_IF_FAILED(draw_progress());
+        XAML_RETURN_IF_FAILED(draw_indeterminate());
+    }
+    return set_rect(region);
+}
+
+xaml_result xaml_progress_internal::draw_progress() noexcept { return XAML_S_OK; }
+
+xaml_result xaml_progress_internal::draw_indeterminate() noexcept { return XAML_S_OK; }
+
+xaml_result xaml_progress_internal::size_to_fit() noexcept
+{
+    // The height of a horizontal scroll bar at 96 DPI, as on Windows.
+    return set_size_noevent({ m_size.width, 17 });
+}
@@ -0,0 +1,33 @@
+#include <shared/virtualizing_stack_panel.hpp>
+#include <xaml/ui/controls/virtualizing_stack_panel.h>
+
+using namespace std;
+
+xaml_result xaml_virtualizing_stack_panel_internal::draw(xaml_rectangle const& region) noexcept
+{
+    if (!m_handle)
+    {
+        m_handle = new (nothrow) xaml_headless_widget{};
+        if (!m_handle) return XAML_E_OUTOFMEMORY;
+        XAML_RETURN_IF_FAILED(draw_visible());
+    }
+    m_viewport = region;
+    XAML_RETURN_IF_FAILED(set_rect(region));
+    return draw_items();
+}
+
+xaml_result xaml_virtualizing_stack_panel_internal::draw_extent(double) noexcept
+{
+    return XAML_S_OK;
+}
+
+xaml_result xaml_virtualizing_stack_panel_internal::draw_offset() noexcept
+{
+    return XAML_S_OK;
+}
+
+// The containers keep the regions in the scrolled content, as drawn by draw_items.
+xaml_result xaml_virtualizing_stack_panel_internal::place_container(xaml_control*, xaml_rectangle const&) noexcept
+{
+    return XAML_S_OK;
+}
@@ -1,3 +1,4 @@
+#include <QAbstractItemModel>
 #include <QComboBox>
 #include <QStringListModel>
 #include <qt/qstring.hpp>
@@ -38,23 +39,10 @@ xaml_result xaml_combo_box_internal::draw_text() noexcept
 
 xaml_result xaml_combo_box_internal::draw_items() noexcept
 {
-    if (auto combo = qobject_cast<QComboBox*>(m_handle); combo && m_items)
+    if (auto combo = qobject_cast<QComboBox*>(m_handle))
     {
-        QStringList list;
-        XAML_FOREACH_START(xaml_object, item, m_items);
-        {
-            XAML_RETURN_IF_FAILED(create_item(item));
-            xaml_ptr<xaml_string> s = item.query<xaml_string>();
-            if (s)
-            {
-                QString ss;
-                XAML_RETURN_IF_FAILED(to_QString(s, &ss));
-                list.append(std::move(ss));
-            }
-        }
-        XAML_FOREACH_END();
         combo->clear();
-        combo->addItems(list);
+        if (m_items) XAML_RETURN_IF_FAILED(insert_items(0, m_items));
     }
     return XAML_S_OK;
 }
@@ -125,6 +113,37 @@ xaml_result xaml_combo_box_internal::replace_item(int32_t index, xaml_ptr<xaml_o
     return XAML_S_OK;
 }
 
+xaml_result xaml_combo_box_internal::insert_items(int32_t index, xaml_vector_view<xaml_object>* items) noexcept
+{
+    if (auto combo = qobject_cast<QComboBox*>(m_handle))
+    {
+        QStringList list;
+        XAML_FOREACH_START(xaml_object, item, items);
+        {
+            XAML_RETURN_IF_FAILED(create_item(item));
+            xaml_ptr<xaml_string> s = item.query<xaml_string>();
+            if (s)
+            {
+                QString ss;
+                XAML_RETURN_IF_FAILED(to_QString(s, &ss));
+                list.append(std::move(ss));
+            }
+        }
+        XAML_FOREACH_END();
+        combo->insertItems(index, list);
+    }
+    return XAML_S_OK;
+}
+
+xaml_result xaml_combo_box_internal::remove_items(int32_t index, int32_t count) noexcept
+{
+    if (auto combo = qobject_cast<QComboBox*>(m_handle))
+    {
+        combo->model()->removeRows(index, count);
+    }
+    return XAML_S_OK;
+}
+
 void xaml_combo_box_internal::on_current_index_changed(int index) noexcept
 {
     XAML_ASSERT_SUCCEEDED(set_sel_id(index));
@@ -0,0 +1,75 @@
+#include <QScrollArea>
+#include <QScrollBar>
+#include <shared/virtualizing_stack_panel.hpp>
+#include <xaml/ui/controls/virtualizing_stack_panel.h>
+#include <xaml/ui/drawing_conv.hpp>
+
+using namespace std;
+
+xaml_result xaml_virtualizing_stack_panel_internal::draw(xaml_rectangle const& region) noexcept
+{
+    if (!m_handle)
+    {
+        XAML_RETURN_IF_FAILED(create<QScrollArea>());
+        auto area = static_cast<QScrollArea*>(m_handle);
+        m_content_handle = new QWidget();
+        area->setWidget(m_content_handle);
+        area->setWidgetResizable(false);
+        QScrollBar* bar;
+        if (m_orientation == xaml_orientation_vertical)
+        {
+            area->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+            bar = area->verticalScrollBar();
+        }
+        else
+        {
+            area->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+            bar = area->horizontalScrollBar();
+        }
+        QObject::connect(
+            bar, &QScrollBar::valueChanged,
+            [this](int value) { XAML_ASSERT_SUCCEEDED(set_offset(value)); });
+        XAML_RETURN_IF_FAILED(draw_visible());
+    }
+    m_viewport = region;
+    XAML_RETURN_IF_FAILED(set_rect(region));
+    return draw_items();
+}
+
+xaml_result xaml_virtualizing_stack_panel_internal::draw_extent(double extent) noexcept
+{
+    auto area = static_cast<QScrollArea*>(m_handle);
+    QSize viewport = area->viewport()->size();
+    if (m_orientation == xaml_orientation_vertical)
+        m_content_handle->resize(viewport.width(), (int)extent);
+    else
+        m_content_handle->resize((int)extent, viewport.height());
+    return XAML_S_OK;
+}
+
+xaml_result xaml_virtualizing_stack_panel_internal::draw_offset() noexcept
+{
+    auto area = static_cast<QScrollArea*>(m_handle);
+    QScrollBar* bar = m_orientation == xaml_orientation_vertical ? area->verticalScrollBar() : area->horizontalScrollBar();
+    if (bar->value() != (int)m_offset)
+    {
+        bar->setValue((int)m_offset);
+    }
+    return XAML_S_OK;
+}
+
+xaml_result xaml_virtualizing_stack_panel_internal::place_container(xaml_control* container, xaml_rectangle const& region) noexcept
+{
+    xaml_ptr<xaml_qt5_control> native_container;
+    XAML_RETURN_IF_FAILED(container->query(&native_container));
+    QWidget* handle;
+    XAML_RETURN_IF_FAILED(native_container->get_handle(&handle));
+    // The containers are created as the children of the scroll area.
+    if (handle->parentWidget() != m_content_handle)
+    {
+        handle->setParent(m_content_handle);
+        handle->show();
+    }
+    handle->setGeometry(xaml_to_native<QRect>(region));
+    return XAML_S_OK;
+}
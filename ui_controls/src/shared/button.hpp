@@ -31,6 +31,8 @@ struct xaml_button_internal : xaml_control_internal
     static void on_clicked(GtkWidget*, xaml_button_internal*) noexcept;
 #elif defined(XAML_UI_QT)
     void on_clicked(bool) noexcept;
+#elif defined(XAML_UI_HEADLESS)
+    xaml_result XAML_CALL size_to_fit() noexcept override;
 #endif // XAML_UI_WINDOWS
 
     xaml_result XAML_CALL init() noexcept override;
@@ -23,6 +23,11 @@ struct xaml_combo_box_internal : xaml_items_base_internal
     xaml_result XAML_CALL clear_items() noexcept override;
     xaml_result XAML_CALL replace_item(std::int32_t index, xaml_ptr<xaml_object> const& value) noexcept override;
 
+#if defined(XAML_UI_GTK3) || defined(XAML_UI_QT)
+    xaml_result XAML_CALL insert_items(std::int32_t index, xaml_vector_view<xaml_object>* items) noexcept override;
+    xaml_result XAML_CALL remove_items(std::int32_t index, std::int32_t count) noexcept override;
+#endif // XAML_UI_GTK3 || XAML_UI_QT
+
 #ifdef XAML_UI_WINDOWS
     xaml_result XAML_CALL wnd_proc(xaml_win32_window_message const&, LRESULT*) noexcept override;
     xaml_result XAML_CALL size_to_fit() noexcept override;
@@ -33,6 +38,8 @@ struct xaml_combo_box_internal : xaml_items_base_internal
 #elif defined(XAML_UI_QT)
     void on_current_index_changed(int) noexcept;
     void on_current_text_changed(QString const&) noexcept;
+#elif defined(XAML_UI_HEADLESS)
+    xaml_result XAML_CALL size_to_fit() noexcept override;
 #endif // XAML_UI_WINDOWS
 
     xaml_result XAML_CALL init() noexcept override;
@@ -1,5 +1,4 @@
 #include <algorithm>
-#include <numeric>
 #include <shared/grid.hpp>
 #include <xaml/ui/controls/grid.h>
 
@@ -13,90 +12,28 @@ xaml_result xaml_grid_internal::init() noexcept
     return XAML_S_OK;
 }
 
-static xaml_result get_max_compact(int32_t index, xaml_ptr<xaml_vector<xaml_control>> const& children, bool vertical, double* presult) noexcept
-{
-    double result = 0;
-    XAML_FOREACH_START(xaml_control, cc, children);
-    {
-        int32_t crow, ccol, crows, ccols;
-        XAML_RETURN_IF_FAILED(xaml_grid_get_column(cc, &ccol));
-        XAML_RETURN_IF_FAILED(xaml_grid_get_row(cc, &crow));
-        XAML_RETURN_IF_FAILED(xaml_grid_get_column_span(cc, &ccols));
-        XAML_RETURN_IF_FAILED(xaml_grid_get_row_span(cc, &crows));
-        if (((vertical ? crow : ccol) == index) && ((vertical ? crows : ccols) <= 1))
-        {
-            xaml_size csize;
-            XAML_RETURN_IF_FAILED(cc->get_size(&csize));
-            xaml_margin cmargin;
-            XAML_RETURN_IF_FAILED(cc->get_margin(&cmargin));
-            auto len = vertical ? (csize.height + cmargin.top + cmargin.bottom) : (csize.width + cmargin.left + cmargin.right);
-            result = (max)(result, len);
-        }
-    }
-    XAML_FOREACH_END();
-    *presult = result;
-    return XAML_S_OK;
-}
-
-static xaml_result get_real_length(xaml_ptr<xaml_vector<xaml_grid_length>> const& lengths, xaml_ptr<xaml_vector<xaml_control>> const& children, double total, bool vertical, vector<tuple<double, double>>* presult) noexcept
+// Snapshots the definitions; no definition is the same as one "*".
+static xaml_result get_tracks(xaml_ptr<xaml_vector<xaml_grid_length>> const& lengths, vector<xaml_grid_track>* ptracks) noexcept
 {
     int32_t size;
     XAML_RETURN_IF_FAILED(lengths->get_size(&size));
-    vector<tuple<double, double>> result(size);
-    if (result.empty())
-    {
-        result.push_back(make_tuple(total, 0));
-        *presult = result;
-        return XAML_S_OK;
-    }
-    double total_star = 0;
-    double total_remain = total;
+    ptracks->clear();
+    ptracks->reserve((max)(size, 1));
     for (int32_t i = 0; i < size; i++)
     {
         xaml_grid_length length;
         XAML_RETURN_IF_FAILED(lengths->get_at(i, &length));
-        switch (length.layout)
-        {
-        case xaml_grid_layout_abs:
-            get<0>(result[i]) = length.value;
-            total_remain -= length.value;
-            break;
-        case xaml_grid_layout_star:
-            total_star += length.value;
-            break;
-        case xaml_grid_layout_auto:
-        {
-            double compact;
-            XAML_RETURN_IF_FAILED(get_max_compact(i, children, vertical, &compact));
-            get<0>(result[i]) = compact;
-            total_remain -= get<0>(result[i]);
-            break;
-        }
-        }
+        ptracks->push_back({ length, 0, 0 });
     }
-    for (int32_t i = 0; i < size; i++)
+    if (ptracks->empty())
     {
-        xaml_grid_length length;
-        XAML_RETURN_IF_FAILED(lengths->get_at(i, &length));
-        if (length.layout == xaml_grid_layout_star)
-        {
-            get<0>(result[i]) = total_remain * length.value / total_star;
-        }
-        if (i)
-        {
-            get<1>(result[i]) = get<0>(result[i - 1]) + get<1>(result[i - 1]);
-        }
+        ptracks->push_back({ { 1, xaml_grid_layout_star }, 0, 0 });
     }
-    *presult = result;
     return XAML_S_OK;
 }
 
-static xaml_result get_real_region(xaml_ptr<xaml_control> const& cc, xaml_rectangle& max_region) noexcept
+static xaml_result get_real_region(xaml_ptr<xaml_control> const& cc, xaml_size const& csize, xaml_margin const& cmargin, xaml_rectangle& max_region) noexcept
 {
-    xaml_size csize;
-    XAML_RETURN_IF_FAILED(cc->get_size(&csize));
-    xaml_margin cmargin;
-    XAML_RETURN_IF_FAILED(cc->get_margin(&cmargin));
     double cwidth = csize.width + cmargin.left + cmargin.right;
     cwidth = (min)(cwidth, max_region.width);
     xaml_halignment chalign;
@@ -148,31 +85,87 @@ struct xaml_grid_index
 
 unordered_map<xaml_control*, xaml_grid_index> s_grid_indecies{};
 
-static inline double real_length_plus(double lhs, tuple<double, double> const& rhs) { return lhs + get<0>(rhs); }
-
 xaml_result xaml_grid_internal::draw_impl(xaml_rectangle const& region, __xaml_function_view_wrapper_t<xaml_result(xaml_control*, xaml_rectangle const&) noexcept> func) noexcept
 {
     XAML_RETURN_IF_FAILED(xaml_layout_base_internal::draw_impl(region, func));
     xaml_rectangle real = region - m_margin;
-    vector<tuple<double, double>> columns, rows;
-    XAML_RETURN_IF_FAILED(get_real_length(m_columns, m_children, real.width, false, &columns));
-    XAML_RETURN_IF_FAILED(get_real_length(m_rows, m_children, real.height, true, &rows));
+    XAML_RETURN_IF_FAILED(get_tracks(m_columns, &m_column_tracks));
+    XAML_RETURN_IF_FAILED(get_tracks(m_rows, &m_row_tracks));
+    int32_t count;
+    XAML_RETURN_IF_FAILED(m_children->get_size(&count));
+    m_child_sizes.clear();
+    m_column_cells.clear();
+    m_row_cells.clear();
+    m_child_sizes.reserve(count);
+    m_column_cells.reserve(count);
+    m_row_cells.reserve(count);
+    // Buckets the children into their cells in one pass.
+    XAML_FOREACH_START(xaml_control, cc, m_children);
+    {
+        xaml_size csize;
+        XAML_RETURN_IF_FAILED(cc->get_size(&csize));
+        xaml_margin cmargin;
+        XAML_RETURN_IF_FAILED(cc->get_margin(&cmargin));
+        m_child_sizes.push_back({ csize, cmargin });
+        xaml_grid_index index{};
+        auto it = s_grid_indecies.find(cc.get());
+        if (it != s_grid_indecies.end()) index = it->second;
+        xaml_grid_cell column{ index.column, index.column_span, csize.width + cmargin.left + cmargin.right };
+        xaml_grid_clamp_cell(column, (int32_t)m_column_tracks.size());
+        m_column_cells.push_back(column);
+        xaml_grid_cell row{ index.row, index.row_span, csize.height + cmargin.top + cmargin.bottom };
+        xaml_grid_clamp_cell(row, (int32_t)m_row_tracks.size());
+        m_row_cells.push_back(row);
+    }
+    XAML_FOREACH_END();
+    xaml_grid_measure_tracks(m_column_tracks, m_column_cells, real.width);
+    xaml_grid_measure_tracks(m_row_tracks, m_row_cells, real.height);
+    size_t i = 0;
     XAML_FOREACH_START(xaml_control, cc, m_children);
     {
-        xaml_grid_index const& index = s_grid_indecies[cc];
-        double subx = get<1>(columns[(min)((size_t)index.column, columns.size() - 1)]) + real.x;
-        double suby = get<1>(rows[(min)((size_t)index.row, rows.size() - 1)]) + real.y;
-        double subw = accumulate(columns.begin() + (min)((size_t)index.column, columns.size() - 1), columns.begin() + (min)((size_t)index.column + (max<int32_t>)(index.column_span, 1), columns.size()), 0.0, real_length_plus);
-        double subh = accumulate(rows.begin() + (min)((size_t)index.row, rows.size() - 1), rows.begin() + (min)((size_t)index.row + (max<int32_t>)(index.row_span, 1), rows.size()), 0.0, real_length_plus);
+        auto const& column = m_column_cells[i];
+        auto const& row = m_row_cells[i];
+        double subx = m_column_tracks[column.start].offset + real.x;
+        double suby = m_row_tracks[row.start].offset + real.y;
+        double subw = xaml_grid_cell_length(m_column_tracks, column);
+        double subh = xaml_grid_cell_length(m_row_tracks, row);
         xaml_rectangle subrect = { subx, suby, subw, subh };
-        XAML_RETURN_IF_FAILED(get_real_region(cc, subrect));
+        XAML_RETURN_IF_FAILED(get_real_region(cc, m_child_sizes[i].size, m_child_sizes[i].margin, subrect));
         XAML_RETURN_IF_FAILED(cc->draw(subrect));
         if (func) func(cc, subrect);
+        i++;
     }
     XAML_FOREACH_END();
     return XAML_S_OK;
 }
 
+static xaml_result parse_grid_length(std::string_view str, xaml_grid_length* plen) noexcept
+{
+    if (str == "auto" || str == "Auto")
+    {
+        *plen = { 0, xaml_grid_layout_auto };
+    }
+    else if (str.back() == '*')
+    {
+        // "*" is the same as "1*".
+        double rate = 1;
+        if (str.length() > 1)
+        {
+            xaml_result hr = __stof<double>(str.substr(0, str.length() - 1), &rate);
+            if (XAML_FAILED(hr)) return hr;
+        }
+        *plen = { rate, xaml_grid_layout_star };
+    }
+    else
+    {
+        double value;
+        xaml_result hr = __stof<double>(str, &value);
+        if (XAML_FAILED(hr)) return hr;
+        *plen = { value, xaml_grid_layout_abs };
+    }
+    return XAML_S_OK;
+}
+
 template <>
 struct __xaml_converter<xaml_ptr<xaml_vector<xaml_grid_length>>, void>
 {
@@ -186,33 +179,16 @@ struct __xaml_converter<xaml_ptr<xaml_vector<xaml_grid_length>>, void>
         {
             std::string_view str;
             XAML_RETURN_IF_FAILED(to_string_view(s, &str));
-            constexpr char __delimeter[] = " ,\t\r\n";
-            constexpr char __auto[] = "auto";
             xaml_ptr<xaml_vector<xaml_grid_length>> result;
             XAML_RETURN_IF_FAILED(xaml_vector_new(&result));
-            std::size_t offset = 0;
-            do
-            {
-                std::size_t index = str.find_first_of(__delimeter, offset);
-                std::string_view lenstr = str.substr(offset, index - offset);
+            // A malformed literal is expected, so it is returned without raising.
+            xaml_result hr = __xaml_split_list(str, [&](std::string_view item) noexcept -> xaml_result {
                 xaml_grid_length len;
-                if (lenstr == __auto)
-                {
-                    len = { 0, xaml_grid_layout_auto };
-                }
-                else if (lenstr.back() == '*')
-                {
-                    double rate = __stof<double>(lenstr.substr(0, lenstr.length() - 1));
-                    len = { rate, xaml_grid_layout_star };
-                }
-                else
-                {
-                    double value = __stof<double>(lenstr);
-                    len = { value, xaml_grid_layout_abs };
-                }
-                XAML_RETURN_IF_FAILED(result->append(len));
-                offset = str.find_first_not_of(__delimeter, index);
-            } while (offset != std::string_view::npos);
+                xaml_result len_hr = parse_grid_length(item, &len);
+                if (XAML_FAILED(len_hr)) return len_hr;
+                return result->append(len);
+            });
+            if (XAML_FAILED(hr)) return hr;
             return result->query(ptr);
         }
         else
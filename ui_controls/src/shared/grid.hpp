@@ -1,7 +1,9 @@
 #ifndef XAML_UI_CONTROLS_SHARED_GRID_HPP
 #define XAML_UI_CONTROLS_SHARED_GRID_HPP
 
+#include <shared/grid_layout.hpp>
 #include <shared/layout_base.hpp>
+#include <vector>
 #include <xaml/ui/controls/grid.h>
 
 struct xaml_grid_internal : xaml_layout_base_internal
@@ -41,6 +43,19 @@ struct xaml_grid_internal : xaml_layout_base_internal
         return XAML_S_OK;
     }
 
+    // Reused by each layout pass.
+    std::vector<xaml_grid_track> m_column_tracks{};
+    std::vector<xaml_grid_track> m_row_tracks{};
+    std::vector<xaml_grid_cell> m_column_cells{};
+    std::vector<xaml_grid_cell> m_row_cells{};
+
+    struct child_size
+    {
+        xaml_size size;
+        xaml_margin margin;
+    };
+    std::vector<child_size> m_child_sizes{};
+
     xaml_result XAML_CALL draw_impl(xaml_rectangle const&, __xaml_function_view_wrapper_t<xaml_result(xaml_control*, xaml_rectangle const&) noexcept>) noexcept override;
 
     xaml_result XAML_CALL init() noexcept override;
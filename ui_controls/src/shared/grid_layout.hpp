@@ -0,0 +1,131 @@
+#ifndef XAML_UI_CONTROLS_SHARED_GRID_LAYOUT_HPP
+#define XAML_UI_CONTROLS_SHARED_GRID_LAYOUT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <xaml/ui/controls/grid.h>
+
+// The sizing of grid tracks along one axis.
+// It works on plain arrays snapshotted before the pass,
+// so that no virtual call is made while measuring.
+
+// A column or a row.
+struct xaml_grid_track
+{
+    xaml_grid_length length;
+    double size;
+    double offset;
+};
+
+// The cells of a child along one axis, and its desired length including margins.
+struct xaml_grid_cell
+{
+    std::int32_t start;
+    std::int32_t span;
+    double length;
+};
+
+// Clamps the cell into [0, count), with at least one track.
+inline void xaml_grid_clamp_cell(xaml_grid_cell& cell, std::int32_t count) noexcept
+{
+    cell.start = (std::clamp)(cell.start, 0, count - 1);
+    cell.span = (std::clamp)(cell.span, 1, count - cell.start);
+}
+
+// Sizes the tracks to fill the total length, and computes their offsets.
+// Cells should be clamped with the count of tracks.
+inline void xaml_grid_measure_tracks(std::vector<xaml_grid_track>& tracks, std::vector<xaml_grid_cell> const& cells, double total)
+{
+    if (tracks.empty())
+    {
+        tracks.push_back({ { 1, xaml_grid_layout_star }, 0, 0 });
+    }
+    double total_star = 0;
+    for (auto& t : tracks)
+    {
+        t.size = 0;
+        switch (t.length.layout)
+        {
+        case xaml_grid_layout_abs:
+            t.size = t.length.value;
+            break;
+        case xaml_grid_layout_star:
+            total_star += t.length.value;
+            break;
+        default:
+            break;
+        }
+    }
+    // Cells in one track size the auto tracks directly.
+    std::vector<xaml_grid_cell const*> spanned;
+    for (auto& c : cells)
+    {
+        if (c.span == 1)
+        {
+            auto& t = tracks[c.start];
+            if (t.length.layout == xaml_grid_layout_auto)
+            {
+                t.size = (std::max)(t.size, c.length);
+            }
+        }
+        else
+        {
+            spanned.push_back(&c);
+        }
+    }
+    // Cells spanning several tracks only grow the auto tracks,
+    // when they are not large enough and there is no star track to take the space.
+    // The narrower spans are distributed first, as they are more constrained.
+    std::stable_sort(spanned.begin(), spanned.end(), [](xaml_grid_cell const* lhs, xaml_grid_cell const* rhs) { return lhs->span < rhs->span; });
+    for (auto pc : spanned)
+    {
+        double current = 0;
+        std::int32_t autos = 0;
+        bool has_star = false;
+        for (std::int32_t i = pc->start; i < pc->start + pc->span; i++)
+        {
+            auto& t = tracks[i];
+            current += t.size;
+            if (t.length.layout == xaml_grid_layout_auto)
+                autos++;
+            else if (t.length.layout == xaml_grid_layout_star)
+                has_star = true;
+        }
+        if (!has_star && autos && pc->length > current)
+        {
+            double extra = (pc->length - current) / autos;
+            for (std::int32_t i = pc->start; i < pc->start + pc->span; i++)
+            {
+                auto& t = tracks[i];
+                if (t.length.layout == xaml_grid_layout_auto) t.size += extra;
+            }
+        }
+    }
+    double total_remain = total;
+    for (auto& t : tracks)
+    {
+        if (t.length.layout != xaml_grid_layout_star) total_remain -= t.size;
+    }
+    total_remain = (std::max)(total_remain, 0.0);
+    double offset = 0;
+    for (auto& t : tracks)
+    {
+        if (t.length.layout == xaml_grid_layout_star && total_star > 0)
+        {
+            t.size = total_remain * t.length.value / total_star;
+        }
+        t.offset = offset;
+        offset += t.size;
+    }
+}
+
+// The length of the tracks covered by the cell.
+inline double xaml_grid_cell_length(std::vector<xaml_grid_track> const& tracks, xaml_grid_cell const& cell) noexcept
+{
+    auto const& last = tracks[cell.start + cell.span - 1];
+    return last.offset + last.size - tracks[cell.start].offset;
+}
+
+#endif // !XAML_UI_CONTROLS_SHARED_GRID_LAYOUT_HPP
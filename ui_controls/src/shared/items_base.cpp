@@ -12,30 +12,59 @@ xaml_result xaml_items_base_internal::create_item(xaml_ptr<xaml_object>& item) n
     return XAML_S_OK;
 }
 
+xaml_result xaml_items_base_internal::release_item(xaml_ptr<xaml_object> const& value, xaml_ptr<xaml_object> const& item) noexcept
+{
+    if (m_items_template)
+    {
+        return m_items_template->recycle(value, item);
+    }
+    return XAML_S_OK;
+}
+
+xaml_result xaml_items_base_internal::insert_items(std::int32_t index, xaml_vector_view<xaml_object>* items) noexcept
+{
+    XAML_FOREACH_START(xaml_object, item, items);
+    {
+        XAML_RETURN_IF_FAILED(create_item(item));
+        XAML_RETURN_IF_FAILED(insert_item(index++, item));
+    }
+    XAML_FOREACH_END();
+    return XAML_S_OK;
+}
+
+xaml_result xaml_items_base_internal::remove_items(std::int32_t index, std::int32_t count) noexcept
+{
+    // Removes from the back, so that the indices before are not shifted.
+    for (std::int32_t i = index + count - 1; i >= index; i--)
+    {
+        XAML_RETURN_IF_FAILED(remove_item(i));
+    }
+    return XAML_S_OK;
+}
+
 xaml_result xaml_items_base_internal::on_items_vector_changed(xaml_object*, xaml_vector_changed_args<xaml_object>* args) noexcept
 {
+    // The native control is filled from the items when it is created.
+    if (!m_handle) return XAML_S_OK;
     xaml_vector_changed_action action;
     XAML_RETURN_IF_FAILED(args->get_action(&action));
     switch (action)
     {
     case xaml_vector_changed_reset:
+    {
         XAML_RETURN_IF_FAILED(clear_items());
-        [[fallthrough]];
+        xaml_ptr<xaml_vector_view<xaml_object>> new_items;
+        XAML_RETURN_IF_FAILED(args->get_new_items(&new_items));
+        if (new_items) XAML_RETURN_IF_FAILED(insert_items(0, new_items));
+        break;
+    }
     case xaml_vector_changed_add:
     {
         xaml_ptr<xaml_vector_view<xaml_object>> new_items;
         XAML_RETURN_IF_FAILED(args->get_new_items(&new_items));
-        std::int32_t size;
-        XAML_RETURN_IF_FAILED(new_items->get_size(&size));
         std::int32_t new_index;
         XAML_RETURN_IF_FAILED(args->get_new_index(&new_index));
-        for (std::int32_t i = 0; i < size; i++)
-        {
-            xaml_ptr<xaml_object> item;
-            XAML_RETURN_IF_FAILED(new_items->get_at(i, &item));
-            XAML_RETURN_IF_FAILED(create_item(item));
-            XAML_RETURN_IF_FAILED(insert_item(i + new_index, item));
-        }
+        XAML_RETURN_IF_FAILED(insert_items(new_index, new_items));
         break;
     }
     case xaml_vector_changed_erase:
@@ -46,9 +75,15 @@ xaml_result xaml_items_base_internal::on_items_vector_changed(xaml_object*, xaml
         XAML_RETURN_IF_FAILED(old_items->get_size(&size));
         std::int32_t old_index;
         XAML_RETURN_IF_FAILED(args->get_old_index(&old_index));
-        for (std::int32_t i = old_index; i < size + old_index; i++)
+        std::int32_t remain;
+        XAML_RETURN_IF_FAILED(m_items->get_size(&remain));
+        if (remain)
+        {
+            XAML_RETURN_IF_FAILED(remove_items(old_index, size));
+        }
+        else
         {
-            XAML_RETURN_IF_FAILED(remove_item(i));
+            XAML_RETURN_IF_FAILED(clear_items());
         }
         break;
     }
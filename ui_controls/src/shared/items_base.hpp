@@ -11,12 +11,19 @@ struct xaml_items_base_internal : xaml_control_internal
     XAML_PROP_PTR_IMPL(items_template, xaml_template_base)
 
     xaml_result XAML_CALL create_item(xaml_ptr<xaml_object>& item) noexcept;
+    // Gives an object created for the value back to the template, so that it could be reused.
+    xaml_result XAML_CALL release_item(xaml_ptr<xaml_object> const& value, xaml_ptr<xaml_object> const& item) noexcept;
 
     virtual xaml_result XAML_CALL insert_item(std::int32_t index, xaml_ptr<xaml_object> const& value) noexcept = 0;
     virtual xaml_result XAML_CALL remove_item(std::int32_t index) noexcept = 0;
     virtual xaml_result XAML_CALL clear_items() noexcept = 0;
     virtual xaml_result XAML_CALL replace_item(std::int32_t index, xaml_ptr<xaml_object> const& value) = 0;
 
+    // Applies a change of several items at once.
+    // The default implementations call the methods above item by item.
+    virtual xaml_result XAML_CALL insert_items(std::int32_t index, xaml_vector_view<xaml_object>* items) noexcept;
+    virtual xaml_result XAML_CALL remove_items(std::int32_t index, std::int32_t count) noexcept;
+
     std::int32_t m_items_changed_token{ 0 };
 
     virtual xaml_result XAML_CALL on_items_vector_changed(xaml_object*, xaml_vector_changed_args<xaml_object>* args) noexcept;
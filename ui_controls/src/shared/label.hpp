@@ -16,9 +16,9 @@ struct xaml_label_internal : xaml_control_internal
 
     xaml_result XAML_CALL draw(xaml_rectangle const&) noexcept override;
 
-#ifdef XAML_UI_WINDOWS
+#if defined(XAML_UI_WINDOWS) || defined(XAML_UI_HEADLESS)
     xaml_result XAML_CALL size_to_fit() noexcept override;
-#endif // XAML_UI_WINDOWS
+#endif // XAML_UI_WINDOWS || XAML_UI_HEADLESS
 
     xaml_result XAML_CALL init() noexcept override;
 };
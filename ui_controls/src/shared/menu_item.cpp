@@ -55,7 +55,7 @@ xaml_result xaml_check_menu_item_internal::init() noexcept
             if (m_menu_id)
 #elif defined(XAML_UI_COCOA)
             if (m_menu)
-#elif defined(XAML_UI_GTK3)
+#elif defined(XAML_UI_GTK3) || defined(XAML_UI_HEADLESS)
             if (m_handle)
 #endif // XAML_UI_WINDOWS
                 XAML_RETURN_IF_FAILED(draw_checked());
@@ -77,7 +77,7 @@ xaml_result xaml_radio_menu_item_internal::init() noexcept
             if (m_menu_id)
 #elif defined(XAML_UI_COCOA)
             if (m_menu)
-#elif defined(XAML_UI_GTK3)
+#elif defined(XAML_UI_GTK3) || defined(XAML_UI_HEADLESS)
             if (m_handle)
 #endif // XAML_UI_WINDOWS
             {
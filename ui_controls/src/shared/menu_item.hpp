@@ -108,7 +108,7 @@ struct xaml_menu_item_implement : xaml_control_implement<T, Internal, Base>
     XAML_PROP_INTERNAL_IMPL(action, QAction**, QAction*)
 #endif // XAML_UI_WINDOWS
 
-#ifndef XAML_UI_GTK3
+#if !defined(XAML_UI_GTK3) && !defined(XAML_UI_HEADLESS)
     xaml_result XAML_CALL query(xaml_guid const& type, void** ptr) noexcept override
     {
         if (type == xaml_type_guid_v<native_menu_item_type>)
@@ -127,7 +127,7 @@ struct xaml_menu_item_implement : xaml_control_implement<T, Internal, Base>
     {
         m_native_menu_item.m_outer = static_cast<T*>(this);
     }
-#endif // !XAML_UI_GTK3
+#endif // !XAML_UI_GTK3 && !XAML_UI_HEADLESS
 };
 
 struct xaml_menu_item_impl : xaml_menu_item_implement<xaml_menu_item_impl, xaml_menu_item_internal, xaml_menu_item>
@@ -12,6 +12,7 @@
 #include <xaml/ui/controls/stack_panel.h>
 #include <xaml/ui/controls/text_box.h>
 #include <xaml/ui/controls/uniform_grid.h>
+#include <xaml/ui/controls/virtualizing_stack_panel.h>
 
 struct xaml_module_info_impl : xaml_implement<xaml_module_info_impl, xaml_module_info>
 {
@@ -43,6 +44,7 @@ struct xaml_module_info_impl : xaml_implement<xaml_module_info_impl, xaml_module
         XAML_RETURN_IF_FAILED(xaml_text_box_register(ctx));
         XAML_RETURN_IF_FAILED(xaml_items_base_register(ctx));
         XAML_RETURN_IF_FAILED(xaml_combo_box_register(ctx));
+        XAML_RETURN_IF_FAILED(xaml_virtualizing_stack_panel_register(ctx));
         XAML_RETURN_IF_FAILED(xaml_menu_item_register(ctx));
         XAML_RETURN_IF_FAILED(xaml_popup_menu_item_register(ctx));
         XAML_RETURN_IF_FAILED(xaml_check_menu_item_register(ctx));
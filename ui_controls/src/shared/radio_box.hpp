@@ -25,6 +25,8 @@ struct xaml_radio_box_internal : xaml_button_internal
     static void on_toggled(GtkWidget*, xaml_radio_box_internal*) noexcept;
 #elif defined(XAML_UI_QT)
     void on_toggled(bool) noexcept;
+#elif defined(XAML_UI_HEADLESS)
+    xaml_result XAML_CALL size_to_fit() noexcept override;
 #endif // XAML_UI_WINDOWS
 
     xaml_result XAML_CALL init() noexcept override;
@@ -26,6 +26,8 @@ struct xaml_text_box_internal : xaml_control_internal
     static void on_changed(GtkTextBuffer*, xaml_text_box_internal*) noexcept;
 #elif defined(XAML_UI_QT)
     void on_text_changed_event() noexcept;
+#elif defined(XAML_UI_HEADLESS)
+    xaml_result XAML_CALL size_to_fit() noexcept override;
 #endif // XAML_UI_WINDOWS
 
     xaml_result XAML_CALL init() noexcept override;
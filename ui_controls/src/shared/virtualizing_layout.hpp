@@ -0,0 +1,165 @@
+#ifndef XAML_UI_CONTROLS_SHARED_VIRTUALIZING_LAYOUT_HPP
+#define XAML_UI_CONTROLS_SHARED_VIRTUALIZING_LAYOUT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The extents of the items of a virtualizing panel along the stacking axis.
+// Items not measured yet are estimated by the average of the measured ones,
+// or a default length if none is measured.
+// The offsets are queried in O(log n) with two Fenwick trees,
+// one for the measured lengths and one for the count of measured items.
+class xaml_virtualizing_extents
+{
+private:
+    // Negative if not measured.
+    std::vector<double> m_sizes{};
+    std::vector<double> m_sum_tree{};
+    std::vector<std::int32_t> m_count_tree{};
+    double m_measured_total{ 0 };
+    std::int32_t m_measured_count{ 0 };
+    double m_default_size{ 24 };
+
+    void tree_add(std::int32_t index, double size, std::int32_t count) noexcept
+    {
+        for (std::size_t i = (std::size_t)index + 1; i <= m_sizes.size(); i += i & (~i + 1))
+        {
+            m_sum_tree[i - 1] += size;
+            m_count_tree[i - 1] += count;
+        }
+    }
+
+    // The measured length and count of the items before the index.
+    void tree_prefix(std::int32_t index, double* psize, std::int32_t* pcount) const noexcept
+    {
+        double size = 0;
+        std::int32_t count = 0;
+        for (std::size_t i = (std::size_t)index; i > 0; i -= i & (~i + 1))
+        {
+            size += m_sum_tree[i - 1];
+            count += m_count_tree[i - 1];
+        }
+        *psize = size;
+        *pcount = count;
+    }
+
+    void rebuild()
+    {
+        m_sum_tree.assign(m_sizes.size(), 0);
+        m_count_tree.assign(m_sizes.size(), 0);
+        m_measured_total = 0;
+        m_measured_count = 0;
+        for (std::size_t i = 0; i < m_sizes.size(); i++)
+        {
+            if (m_sizes[i] >= 0)
+            {
+                m_measured_total += m_sizes[i];
+                m_measured_count++;
+                m_sum_tree[i] += m_sizes[i];
+                m_count_tree[i]++;
+            }
+            // Builds the trees in linear time.
+            std::size_t parent = i + ((i + 1) & (~(i + 1) + 1));
+            if (parent < m_sizes.size())
+            {
+                m_sum_tree[parent] += m_sum_tree[i];
+                m_count_tree[parent] += m_count_tree[i];
+            }
+        }
+    }
+
+public:
+    std::int32_t count() const noexcept { return (std::int32_t)m_sizes.size(); }
+
+    double default_size() const noexcept { return m_default_size; }
+    void set_default_size(double value) noexcept { m_default_size = value; }
+
+    // Forgets all measured lengths.
+    void reset(std::int32_t count)
+    {
+        m_sizes.assign((std::size_t)(std::max)(count, 0), -1);
+        rebuild();
+    }
+
+    void insert(std::int32_t index, std::int32_t count)
+    {
+        m_sizes.insert(m_sizes.begin() + index, (std::size_t)count, -1);
+        rebuild();
+    }
+
+    void erase(std::int32_t index, std::int32_t count)
+    {
+        m_sizes.erase(m_sizes.begin() + index, m_sizes.begin() + index + count);
+        rebuild();
+    }
+
+    void invalidate(std::int32_t index) noexcept
+    {
+        double& size = m_sizes[index];
+        if (size >= 0)
+        {
+            tree_add(index, -size, -1);
+            m_measured_total -= size;
+            m_measured_count--;
+            size = -1;
+        }
+    }
+
+    bool is_measured(std::int32_t index) const noexcept { return m_sizes[index] >= 0; }
+
+    void set_size(std::int32_t index, double value) noexcept
+    {
+        invalidate(index);
+        value = (std::max)(value, 0.0);
+        m_sizes[index] = value;
+        tree_add(index, value, 1);
+        m_measured_total += value;
+        m_measured_count++;
+    }
+
+    // The length of an item which is not measured.
+    double estimate() const noexcept
+    {
+        return m_measured_count ? m_measured_total / m_measured_count : m_default_size;
+    }
+
+    double size(std::int32_t index) const noexcept
+    {
+        double size = m_sizes[index];
+        return size >= 0 ? size : estimate();
+    }
+
+    // The start of the item; the count gives the total extent.
+    double offset(std::int32_t index) const noexcept
+    {
+        double size;
+        std::int32_t measured;
+        tree_prefix(index, &size, &measured);
+        return size + (index - measured) * estimate();
+    }
+
+    double extent() const noexcept
+    {
+        return m_measured_total + (count() - m_measured_count) * estimate();
+    }
+
+    // The item containing the offset, clamped to the items.
+    std::int32_t index_at(double value) const noexcept
+    {
+        std::int32_t low = 0, high = count();
+        // Finds the first item whose end is after the value.
+        while (low < high)
+        {
+            std::int32_t mid = low + (high - low) / 2;
+            if (offset(mid + 1) <= value)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+        return (std::min)(low, count() - 1);
+    }
+};
+
+#endif // !XAML_UI_CONTROLS_SHARED_VIRTUALIZING_LAYOUT_HPP
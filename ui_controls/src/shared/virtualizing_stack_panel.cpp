@@ -0,0 +1,349 @@
+#include <algorithm>
+#include <shared/virtualizing_stack_panel.hpp>
+#include <xaml/ui/controls/label.h>
+#include <xaml/ui/controls/virtualizing_stack_panel.h>
+
+using namespace std;
+
+xaml_virtualizing_stack_panel_internal::xaml_virtualizing_stack_panel_internal() noexcept : xaml_items_base_internal(), m_orientation(xaml_orientation_vertical), m_overscan(4)
+{
+}
+
+xaml_result xaml_virtualizing_stack_panel_internal::init() noexcept
+{
+    XAML_RETURN_IF_FAILED(xaml_items_base_internal::init());
+
+    XAML_RETURN_IF_FAILED(xaml_event_new(&m_offset_changed));
+
+    int32_t token;
+    XAML_RETURN_IF_FAILED((m_items_changed->add(
+        [this](xaml_object*, xaml_observable_vector<xaml_object>*) noexcept -> xaml_result {
+            XAML_RETURN_IF_FAILED(clear_items());
+            if (m_handle) XAML_RETURN_IF_FAILED(draw_items());
+            return XAML_S_OK;
+        },
+        &token)));
+    XAML_RETURN_IF_FAILED((m_offset_changed->add(
+        [this](xaml_object*, double) noexcept -> xaml_result {
+            if (m_handle)
+            {
+                XAML_RETURN_IF_FAILED(draw_offset());
+                XAML_RETURN_IF_FAILED(draw_items());
+            }
+            return XAML_S_OK;
+        },
+        &token)));
+    return XAML_S_OK;
+}
+
+xaml_result xaml_virtualizing_stack_panel_internal::realize(int32_t index, realized_item* pitem) noexcept
+{
+    xaml_ptr<xaml_object> data;
+    XAML_RETURN_IF_FAILED(m_items->get_at(index, &data));
+    xaml_ptr<xaml_object> item = data;
+    XAML_RETURN_IF_FAILED(create_item(item));
+    xaml_ptr<xaml_control> container;
+    bool recyclable = false;
+    if (item && XAML_SUCCEEDED(item->query(&container)))
+    {
+        // The item is a control itself, so it is shown directly.
+        // A control created by the template goes back to it when recycled.
+        if (!m_items_template || item.get() == data.get()) data = nullptr;
+    }
+    else
+    {
+        xaml_ptr<xaml_label> label;
+        if (m_recycled.empty())
+        {
+            XAML_RETURN_IF_FAILED(xaml_label_new(&label));
+        }
+        else
+        {
+            XAML_RETURN_IF_FAILED(m_recycled.back()->query(&label));
+            m_recycled.pop_back();
+        }
+        XAML_RETURN_IF_FAILED(label->set_text(item.query<xaml_string>()));
+        XAML_RETURN_IF_FAILED(label->query(&container));
+        recyclable = true;
+        data = nullptr;
+    }
+    XAML_RETURN_IF_FAILED(container->set_parent(static_cast<xaml_control*>(m_outer_this)));
+    XAML_RETURN_IF_FAILED(container->set_is_visible(true));
+    *pitem = { index, container, recyclable, data };
+    return XAML_S_OK;
+}
+
+xaml_result xaml_virtualizing_stack_panel_internal::recycle(realized_item& item) noexcept
+{
+    XAML_RETURN_IF_FAILED(item.container->set_is_visible(false));
+    // Detached, so that binding it to other data doesn't redraw the panel while realizing.
+    XAML_RETURN_IF_FAILED(item.container->set_parent(nullptr));
+    if (item.recyclable)
+    {
+        m_recycled.push_back(item.container);
+    }
+    else if (item.data)
+    {
+        XAML_RETURN_IF_FAILED(release_item(item.data, item.container));
+    }
+    item.container = nullptr;
+    item.data = nullptr;
+    return XAML_S_OK;
+}
+
+xaml_result xaml_virtualizing_stack_panel_internal::recycle_all() noexcept
+{
+    for (auto& item : m_realized)
+    {
+        XAML_RETURN_IF_FAILED(recycle(item));
+    }
+    m_realized.clear();
+    return XAML_S_OK;
+}
+
+xaml_result xaml_virtualizing_stack_panel_internal::draw_items() noexcept
+{
+    bool vertical = m_orientation == xaml_orientation_vertical;
+    xaml_rectangle real = m_viewport - m_margin;
+    double viewport = vertical ? real.height : real.width;
+    int32_t count = m_extents.count();
+    int32_t first = 0, last = -1;
+    if (count > 0)
+    {
+        first = (max)(m_extents.index_at(m_offset) - m_overscan, 0);
+        last = (min)(m_extents.index_at(m_offset + viewport) + m_overscan, count - 1);
+    }
+    // Recycles the items out of the range first,
+    // so that their containers could be reused by the new ones.
+    vector<realized_item> kept;
+    kept.reserve(m_realized.size());
+    for (auto& item : m_realized)
+    {
+        if (item.index >= first && item.index <= last)
+            kept.push_back(move(item));
+        else
+            XAML_RETURN_IF_FAILED(recycle(item));
+    }
+    m_realized.clear();
+    m_realized.reserve((size_t)(max)(last - first + 1, 0));
+    auto it = kept.begin();
+    for (int32_t i = first; i <= last; i++)
+    {
+        if (it != kept.end() && it->index == i)
+        {
+            m_realized.push_back(move(*it));
+            ++it;
+        }
+        else
+        {
+            realized_item item;
+            XAML_RETURN_IF_FAILED(realize(i, &item));
+            m_realized.push_back(move(item));
+        }
+    }
+    // Measures before positioning, as the estimation of the offsets changes.
+    for (auto& item : m_realized)
+    {
+        auto& cc = item.container;
+        bool inited;
+        XAML_RETURN_IF_FAILED(cc->get_is_initialized(&inited));
+        if (!inited)
+        {
+            xaml_margin margin;
+            XAML_RETURN_IF_FAILED(cc->get_margin(&margin));
+            XAML_RETURN_IF_FAILED(cc->draw(xaml_rectangle{} + margin));
+        }
+        XAML_RETURN_IF_FAILED(cc->size_to_fit());
+        xaml_margin cm;
+        XAML_RETURN_IF_FAILED(cc->get_margin(&cm));
+        xaml_size cs;
+        XAML_RETURN_IF_FAILED(cc->get_size(&cs));
+        m_extents.set_size(item.index, vertical ? cs.height + cm.top + cm.bottom : cs.width + cm.left + cm.right);
+    }
+    XAML_RETURN_IF_FAILED(draw_extent(m_extents.extent()));
+    for (auto& item : m_realized)
+    {
+        double suboffset = m_extents.offset(item.index);
+        double subsize = m_extents.size(item.index);
+        xaml_rectangle subrect = vertical ? xaml_rectangle{ 0, suboffset, real.width, subsize } : xaml_rectangle{ suboffset, 0, subsize, real.height };
+        XAML_RETURN_IF_FAILED(item.container->draw(subrect));
+        xaml_margin cm;
+        XAML_RETURN_IF_FAILED(item.container->get_margin(&cm));
+        XAML_RETURN_IF_FAILED(place_container(item.container, subrect - cm));
+    }
+    return XAML_S_OK;
+}
+
+xaml_result xaml_virtualizing_stack_panel_internal::insert_item(int32_t index, xaml_ptr<xaml_object> const&) noexcept
+{
+    m_extents.insert(index, 1);
+    for (auto& item : m_realized)
+    {
+        if (item.index >= index) item.index++;
+    }
+    return XAML_S_OK;
+}
+
+xaml_result xaml_virtualizing_stack_panel_internal::remove_item(int32_t index) noexcept
+{
+    m_extents.erase(index, 1);
+    for (auto it = m_realized.begin(); it != m_realized.end();)
+    {
+        if (it->index == index)
+        {
+            XAML_RETURN_IF_FAILED(recycle(*it));
+            it = m_realized.erase(it);
+        }
+        else
+        {
+            if (it->index > index) it->index--;
+            ++it;
+        }
+    }
+    return XAML_S_OK;
+}
+
+xaml_result xaml_virtualizing_stack_panel_internal::clear_items() noexcept
+{
+    XAML_RETURN_IF_FAILED(recycle_all());
+    int32_t size = 0;
+    if (m_items) XAML_RETURN_IF_FAILED(m_items->get_size(&size));
+    m_extents.reset(size);
+    return XAML_S_OK;
+}
+
+xaml_result xaml_virtualizing_stack_panel_internal::replace_item(int32_t index, xaml_ptr<xaml_object> const&) noexcept
+{
+    m_extents.invalidate(index);
+    for (auto it = m_realized.begin(); it != m_realized.end(); ++it)
+    {
+        if (it->index == index)
+        {
+            XAML_RETURN_IF_FAILED(recycle(*it));
+            m_realized.erase(it);
+            break;
+        }
+    }
+    return XAML_S_OK;
+}
+
+xaml_result xaml_virtualizing_stack_panel_internal::on_items_vector_changed(xaml_object*, xaml_vector_changed_args<xaml_object>* args) noexcept
+{
+    xaml_vector_changed_action action;
+    XAML_RETURN_IF_FAILED(args->get_action(&action));
+    switch (action)
+    {
+    case xaml_vector_changed_add:
+    {
+        xaml_ptr<xaml_vector_view<xaml_object>> new_items;
+        XAML_RETURN_IF_FAILED(args->get_new_items(&new_items));
+        int32_t size;
+        XAML_RETURN_IF_FAILED(new_items->get_size(&size));
+        int32_t new_index;
+        XAML_RETURN_IF_FAILED(args->get_new_index(&new_index));
+        m_extents.insert(new_index, size);
+        for (auto& item : m_realized)
+        {
+            if (item.index >= new_index) item.index += size;
+        }
+        break;
+    }
+    case xaml_vector_changed_erase:
+    {
+        xaml_ptr<xaml_vector_view<xaml_object>> old_items;
+        XAML_RETURN_IF_FAILED(args->get_old_items(&old_items));
+        int32_t size;
+        XAML_RETURN_IF_FAILED(old_items->get_size(&size));
+        int32_t old_index;
+        XAML_RETURN_IF_FAILED(args->get_old_index(&old_index));
+        m_extents.erase(old_index, size);
+        vector<realized_item> kept;
+        kept.reserve(m_realized.size());
+        for (auto& item : m_realized)
+        {
+            if (item.index < old_index)
+            {
+                kept.push_back(move(item));
+            }
+            else if (item.index >= old_index + size)
+            {
+                item.index -= size;
+                kept.push_back(move(item));
+            }
+            else
+            {
+                XAML_RETURN_IF_FAILED(recycle(item));
+            }
+        }
+        m_realized = move(kept);
+        break;
+    }
+    case xaml_vector_changed_replace:
+    {
+        int32_t old_index;
+        XAML_RETURN_IF_FAILED(args->get_old_index(&old_index));
+        XAML_RETURN_IF_FAILED(replace_item(old_index, nullptr));
+        break;
+    }
+    case xaml_vector_changed_move:
+    {
+        int32_t old_index, new_index;
+        XAML_RETURN_IF_FAILED(args->get_old_index(&old_index));
+        XAML_RETURN_IF_FAILED(args->get_new_index(&new_index));
+        XAML_RETURN_IF_FAILED(remove_item(old_index));
+        XAML_RETURN_IF_FAILED(insert_item(new_index, nullptr));
+        break;
+    }
+    default:
+        XAML_RETURN_IF_FAILED(clear_items());
+        break;
+    }
+    if (m_handle) XAML_RETURN_IF_FAILED(draw_items());
+    return XAML_S_OK;
+}
+
+#if !defined(XAML_UI_GTK3) && !defined(XAML_UI_QT) && !defined(XAML_UI_HEADLESS)
+xaml_result xaml_virtualizing_stack_panel_internal::draw(xaml_rectangle const&) noexcept
+{
+    return XAML_E_NOTIMPL;
+}
+
+xaml_result xaml_virtualizing_stack_panel_internal::draw_extent(double) noexcept
+{
+    return XAML_E_NOTIMPL;
+}
+
+xaml_result xaml_virtualizing_stack_panel_internal::draw_offset() noexcept
+{
+    return XAML_E_NOTIMPL;
+}
+
+xaml_result xaml_virtualizing_stack_panel_internal::place_container(xaml_control*, xaml_rectangle const&) noexcept
+{
+    return XAML_E_NOTIMPL;
+}
+#endif // !XAML_UI_GTK3 && !XAML_UI_QT && !XAML_UI_HEADLESS
+
+xaml_result XAML_CALL xaml_virtualizing_stack_panel_new(xaml_virtualizing_stack_panel** ptr) noexcept
+{
+    return xaml_object_init<xaml_virtualizing_stack_panel_impl>(ptr);
+}
+
+xaml_result XAML_CALL xaml_virtualizing_stack_panel_members(xaml_type_info_registration* __info) noexcept
+{
+    using self_type = xaml_virtualizing_stack_panel;
+    XAML_RETURN_IF_FAILED(xaml_items_base_members(__info));
+    XAML_TYPE_INFO_ADD_CTOR(xaml_virtualizing_stack_panel_new);
+    XAML_TYPE_INFO_ADD_PROP(orientation, xaml_orientation);
+    XAML_TYPE_INFO_ADD_PROP(overscan, int32_t);
+    XAML_TYPE_INFO_ADD_PROP(estimated_item_size, double);
+    XAML_TYPE_INFO_ADD_PROP_EVENT(offset, double);
+    return XAML_S_OK;
+}
+
+xaml_result XAML_CALL xaml_virtualizing_stack_panel_register(xaml_meta_context* ctx) noexcept
+{
+    XAML_TYPE_INFO_NEW(xaml_virtualizing_stack_panel, "xaml/ui/controls/virtualizing_stack_panel.h");
+    XAML_RETURN_IF_FAILED(xaml_virtualizing_stack_panel_members(__info));
+    return ctx->add_type(__info);
+}
@@ -0,0 +1,96 @@
+#ifndef XAML_UI_CONTROLS_SHARED_VIRTUALIZING_STACK_PANEL_HPP
+#define XAML_UI_CONTROLS_SHARED_VIRTUALIZING_STACK_PANEL_HPP
+
+#include <shared/items_base.hpp>
+#include <shared/virtualizing_layout.hpp>
+#include <vector>
+#include <xaml/ui/controls/virtualizing_stack_panel.h>
+
+struct xaml_virtualizing_stack_panel_internal : xaml_items_base_internal
+{
+    XAML_PROP_IMPL(orientation, xaml_orientation, xaml_orientation*, xaml_orientation)
+    XAML_PROP_IMPL(overscan, std::int32_t, std::int32_t*, std::int32_t)
+
+    XAML_EVENT_IMPL(offset_changed, xaml_object, double)
+    XAML_PROP_EVENT_IMPL(offset, double, double*, double)
+
+    xaml_virtualizing_extents m_extents{};
+
+    xaml_result XAML_CALL get_estimated_item_size(double* pvalue) noexcept
+    {
+        *pvalue = m_extents.default_size();
+        return XAML_S_OK;
+    }
+
+    xaml_result XAML_CALL set_estimated_item_size(double value) noexcept
+    {
+        m_extents.set_default_size(value);
+        return XAML_S_OK;
+    }
+
+    struct realized_item
+    {
+        std::int32_t index;
+        xaml_ptr<xaml_control> container;
+        // The container is created by the panel and could show another item.
+        bool recyclable;
+        // The data the container is created for by the template, or null.
+        xaml_ptr<xaml_object> data;
+    };
+
+    // Sorted by the index.
+    std::vector<realized_item> m_realized{};
+    std::vector<xaml_ptr<xaml_control>> m_recycled{};
+
+    // The region of the last draw.
+    xaml_rectangle m_viewport{};
+
+    xaml_result XAML_CALL draw(xaml_rectangle const&) noexcept override;
+    // The size is given by the parent, rather than the items.
+    xaml_result XAML_CALL size_to_fit() noexcept override { return XAML_S_OK; }
+
+    // Realizes the items in the viewport and the overscan, and positions them.
+    xaml_result XAML_CALL draw_items() noexcept;
+    // Sets the size of the scrolled content.
+    virtual xaml_result XAML_CALL draw_extent(double) noexcept;
+    // Scrolls the native handle to the offset.
+    virtual xaml_result XAML_CALL draw_offset() noexcept;
+    // Positions a container in the scrolled content.
+    virtual xaml_result XAML_CALL place_container(xaml_control*, xaml_rectangle const&) noexcept;
+
+    xaml_result XAML_CALL realize(std::int32_t index, realized_item* pitem) noexcept;
+    xaml_result XAML_CALL recycle(realized_item& item) noexcept;
+    xaml_result XAML_CALL recycle_all() noexcept;
+
+    xaml_result XAML_CALL insert_item(std::int32_t index, xaml_ptr<xaml_object> const& value) noexcept override;
+    xaml_result XAML_CALL remove_item(std::int32_t index) noexcept override;
+    xaml_result XAML_CALL clear_items() noexcept override;
+    xaml_result XAML_CALL replace_item(std::int32_t index, xaml_ptr<xaml_object> const& value) noexcept override;
+
+    // The items are realized lazily, so the changes only move the bookkeeping.
+    xaml_result XAML_CALL on_items_vector_changed(xaml_object*, xaml_vector_changed_args<xaml_object>* args) noexcept override;
+
+#ifdef XAML_UI_GTK3
+    GtkWidget* m_content_handle{ nullptr };
+
+    static void on_value_changed(GtkAdjustment*, xaml_virtualizing_stack_panel_internal*) noexcept;
+#elif defined(XAML_UI_QT)
+    QWidget* m_content_handle{ nullptr };
+#endif // XAML_UI_GTK3
+
+    xaml_virtualizing_stack_panel_internal() noexcept;
+
+    xaml_result XAML_CALL init() noexcept override;
+};
+
+struct xaml_virtualizing_stack_panel_impl : xaml_items_base_implement<xaml_virtualizing_stack_panel_impl, xaml_virtualizing_stack_panel_internal, xaml_virtualizing_stack_panel>
+{
+    XAML_PROP_INTERNAL_IMPL(orientation, xaml_orientation*, xaml_orientation)
+    XAML_PROP_INTERNAL_IMPL(overscan, std::int32_t*, std::int32_t)
+    XAML_PROP_INTERNAL_IMPL(estimated_item_size, double*, double)
+
+    XAML_EVENT_INTERNAL_IMPL(offset_changed, xaml_object, double)
+    XAML_PROP_INTERNAL_IMPL(offset, double*, double)
+};
+
+#endif // !XAML_UI_CONTROLS_SHARED_VIRTUALIZING_STACK_PANEL_HPP
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <shared/grid_layout.hpp>
+#include <test_check.hpp>
+#include <vector>
+
+using namespace std;
+
+static bool approx(double lhs, double rhs) { return abs(lhs - rhs) < 1e-6; }
+
+// The old algorithm: scans every cell for each auto track.
+static void reference_measure(vector<xaml_grid_track>& tracks, vector<xaml_grid_cell> const& cells, double total)
+{
+    double total_star = 0;
+    double total_remain = total;
+    for (size_t i = 0; i < tracks.size(); i++)
+    {
+        auto& t = tracks[i];
+        t.size = 0;
+        switch (t.length.layout)
+        {
+        case xaml_grid_layout_abs:
+            t.size = t.length.value;
+            break;
+        case xaml_grid_layout_star:
+            total_star += t.length.value;
+            break;
+        case xaml_grid_layout_auto:
+            for (auto& c : cells)
+            {
+                if ((size_t)c.start == i && c.span <= 1) t.size = (max)(t.size, c.length);
+            }
+            break;
+        }
+        if (t.length.layout != xaml_grid_layout_star) total_remain -= t.size;
+    }
+    double offset = 0;
+    for (auto& t : tracks)
+    {
+        if (t.length.layout == xaml_grid_layout_star) t.size = (max)(total_remain, 0.0) * t.length.value / total_star;
+        t.offset = offset;
+        offset += t.size;
+    }
+}
+
+static vector<xaml_grid_track> make_tracks(initializer_list<xaml_grid_length> lengths)
+{
+    vector<xaml_grid_track> tracks;
+    for (auto& len : lengths) tracks.push_back({ len, 0, 0 });
+    return tracks;
+}
+
+static void test_spans()
+{
+    constexpr xaml_grid_length a{ 0, xaml_grid_layout_auto };
+    constexpr xaml_grid_length s{ 1, xaml_grid_layout_star };
+    {
+        // No definition is one star track.
+        vector<xaml_grid_track> tracks;
+        xaml_grid_measure_tracks(tracks, {}, 100);
+        CHECK(tracks.size() == 1 && approx(tracks[0].size, 100));
+    }
+    {
+        // A spanning cell grows the auto tracks equally.
+        auto tracks = make_tracks({ a, a, { 30, xaml_grid_layout_abs } });
+        vector<xaml_grid_cell> cells{ { 0, 1, 10 }, { 0, 3, 100 } };
+        xaml_grid_measure_tracks(tracks, cells, 200);
+        CHECK(approx(tracks[0].size, 40));
+        CHECK(approx(tracks[1].size, 30));
+        CHECK(approx(tracks[2].offset, 70));
+        CHECK(approx(xaml_grid_cell_length(tracks, cells[1]), 100));
+    }
+    {
+        // A star track in the span takes the space instead.
+        auto tracks = make_tracks({ a, s });
+        vector<xaml_grid_cell> cells{ { 0, 2, 100 } };
+        xaml_grid_measure_tracks(tracks, cells, 150);
+        CHECK(approx(tracks[0].size, 0));
+        CHECK(approx(tracks[1].size, 150));
+    }
+    {
+        // Narrow spans are distributed first.
+        auto tracks = make_tracks({ a, a, a });
+        vector<xaml_grid_cell> cells{ { 0, 3, 90 }, { 0, 2, 60 } };
+        xaml_grid_measure_tracks(tracks, cells, 300);
+        CHECK(approx(tracks[0].size, 40) && approx(tracks[1].size, 40) && approx(tracks[2].size, 10));
+    }
+    {
+        // Stars never get negative lengths.
+        auto tracks = make_tracks({ { 80, xaml_grid_layout_abs }, s });
+        xaml_grid_measure_tracks(tracks, {}, 50);
+        CHECK(approx(tracks[1].size, 0));
+    }
+    {
+        xaml_grid_cell cell{ 5, 10, 0 };
+        xaml_grid_clamp_cell(cell, 3);
+        CHECK(cell.start == 2 && cell.span == 1);
+        cell = { -1, 0, 0 };
+        xaml_grid_clamp_cell(cell, 3);
+        CHECK(cell.start == 0 && cell.span == 1);
+    }
+}
+
+static vector<xaml_grid_track> random_tracks(mt19937& rnd, size_t count)
+{
+    uniform_int_distribution<int> layout{ 0, 2 };
+    uniform_real_distribution<double> value{ 1, 50 };
+    vector<xaml_grid_track> tracks(count);
+    for (auto& t : tracks) t = { { value(rnd), (xaml_grid_layout)layout(rnd) }, 0, 0 };
+    return tracks;
+}
+
+static vector<xaml_grid_cell> random_cells(mt19937& rnd, size_t count, int32_t tracks)
+{
+    uniform_int_distribution<int32_t> start{ 0, tracks - 1 };
+    uniform_real_distribution<double> length{ 0, 100 };
+    vector<xaml_grid_cell> cells(count);
+    for (auto& c : cells)
+    {
+        c = { start(rnd), 1, length(rnd) };
+        xaml_grid_clamp_cell(c, tracks);
+    }
+    return cells;
+}
+
+static void test_equivalence()
+{
+    mt19937 rnd{ 42 };
+    for (int n = 0; n < 100; n++)
+    {
+        auto tracks = random_tracks(rnd, 1 + n % 20);
+        auto cells = random_cells(rnd, n * 3, (int32_t)tracks.size());
+        auto expected = tracks;
+        reference_measure(expected, cells, 1000);
+        xaml_grid_measure_tracks(tracks, cells, 1000);
+        for (size_t i = 0; i < tracks.size(); i++)
+        {
+            if (!approx(tracks[i].size, expected[i].size) || !approx(tracks[i].offset, expected[i].offset))
+            {
+                cout << "Mismatch in grid " << n << " track " << i << endl;
+                failures++;
+                break;
+            }
+        }
+    }
+}
+
+// 1k children across 100x100 definitions.
+static void bench()
+{
+    mt19937 rnd{ 42 };
+    auto columns = random_tracks(rnd, 100);
+    auto rows = random_tracks(rnd, 100);
+    auto column_cells = random_cells(rnd, 1000, 100);
+    auto row_cells = random_cells(rnd, 1000, 100);
+    constexpr int rounds = 1000;
+    {
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < rounds; i++)
+        {
+            reference_measure(columns, column_cells, 1920);
+            reference_measure(rows, row_cells, 1080);
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << "scan per track: " << seconds / rounds * 1e6 << " us/layout" << endl;
+    }
+    {
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < rounds; i++)
+        {
+            xaml_grid_measure_tracks(columns, column_cells, 1920);
+            xaml_grid_measure_tracks(rows, row_cells, 1080);
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << "bucketed: " << seconds / rounds * 1e6 << " us/layout" << endl;
+    }
+}
+
+int main()
+{
+    test_spans();
+    test_equivalence();
+    bench();
+    return report_failures();
+}
@@ -0,0 +1,481 @@
+#include <chrono>
+#include <iostream>
+#include <test_check.hpp>
+#include <vector>
+#include <xaml/markup/data_template.h>
+#include <xaml/markup/dynamic_resource.h>
+#include <xaml/meta/meta_context.h>
+#include <xaml/ui/application.h>
+#include <xaml/ui/controls/button.h>
+#include <xaml/ui/controls/grid.h>
+#include <xaml/ui/controls/label.h>
+#include <xaml/ui/controls/stack_panel.h>
+#include <xaml/ui/controls/uniform_grid.h>
+#include <xaml/ui/controls/virtualizing_stack_panel.h>
+#include <xaml/ui/headless/application.h>
+#include <xaml/ui/headless/control.h>
+#include <xaml/ui/timer.h>
+#include <xaml/ui/window.h>
+
+using namespace std;
+
+static xaml_headless_widget* widget_of(xaml_control* c)
+{
+    xaml_ptr<xaml_headless_control> native_control;
+    if (XAML_FAILED(c->query(&native_control))) return nullptr;
+    xaml_headless_widget* handle = nullptr;
+    XAML_ASSERT_SUCCEEDED(native_control->get_handle(&handle));
+    return handle;
+}
+
+// The region of the control, or an empty one if it is not drawn.
+static xaml_rectangle rect_of(xaml_control* c)
+{
+    auto handle = widget_of(c);
+    return handle ? handle->rect : xaml_rectangle{};
+}
+
+static xaml_ptr<xaml_label> make_label(char const* text)
+{
+    xaml_ptr<xaml_label> label;
+    XAML_ASSERT_SUCCEEDED(xaml_label_new(&label));
+    xaml_ptr<xaml_string> str;
+    XAML_ASSERT_SUCCEEDED(xaml_string_new_view(text, &str));
+    XAML_ASSERT_SUCCEEDED(label->set_text(str));
+    return label;
+}
+
+static xaml_ptr<xaml_button> make_button(char const* text)
+{
+    xaml_ptr<xaml_button> button;
+    XAML_ASSERT_SUCCEEDED(xaml_button_new(&button));
+    xaml_ptr<xaml_string> str;
+    XAML_ASSERT_SUCCEEDED(xaml_string_new_view(text, &str));
+    XAML_ASSERT_SUCCEEDED(button->set_text(str));
+    return button;
+}
+
+static void test_stack_panel()
+{
+    xaml_ptr<xaml_stack_panel> panel;
+    XAML_ASSERT_SUCCEEDED(xaml_stack_panel_new(&panel));
+    XAML_ASSERT_SUCCEEDED(panel->set_orientation(xaml_orientation_vertical));
+    auto a = make_label("a");
+    auto b = make_label("abc");
+    auto c = make_button("hello");
+    XAML_ASSERT_SUCCEEDED(b->set_margin({ 1, 2, 3, 4 }));
+    CHECK_OK(panel->add_child(a));
+    CHECK_OK(panel->add_child(b));
+    CHECK_OK(panel->add_child(c));
+    CHECK_OK(panel->draw({ 0, 0, 200, 300 }));
+    // Labels are 7 per code point by 16; buttons are 5 larger.
+    CHECK((rect_of(a) == xaml_rectangle{ 0, 0, 200, 16 }));
+    CHECK((rect_of(b) == xaml_rectangle{ 1, 18, 196, 16 }));
+    CHECK((rect_of(c) == xaml_rectangle{ 0, 38, 200, 21 }));
+    CHECK((rect_of(panel) == xaml_rectangle{ 0, 0, 200, 300 }));
+
+    XAML_ASSERT_SUCCEEDED(panel->set_orientation(xaml_orientation_horizontal));
+    CHECK_OK(panel->draw({ 10, 20, 200, 30 }));
+    CHECK((rect_of(a) == xaml_rectangle{ 10, 20, 7, 30 }));
+    CHECK((rect_of(b) == xaml_rectangle{ 18, 22, 21, 24 }));
+    CHECK((rect_of(c) == xaml_rectangle{ 42, 20, 40, 30 }));
+}
+
+static void test_grid()
+{
+    xaml_ptr<xaml_grid> grid;
+    XAML_ASSERT_SUCCEEDED(xaml_grid_new(&grid));
+    CHECK_OK(grid->add_column({ 100, xaml_grid_layout_abs }));
+    CHECK_OK(grid->add_column({ 1, xaml_grid_layout_star }));
+    CHECK_OK(grid->add_column({ 0, xaml_grid_layout_auto }));
+    CHECK_OK(grid->add_row({ 0, xaml_grid_layout_auto }));
+    CHECK_OK(grid->add_row({ 1, xaml_grid_layout_star }));
+    auto title = make_label("title");
+    auto ok = make_button("ok");
+    auto body = make_label("body");
+    XAML_ASSERT_SUCCEEDED(xaml_grid_set_column_span(title, 2));
+    XAML_ASSERT_SUCCEEDED(xaml_grid_set_column(ok, 2));
+    XAML_ASSERT_SUCCEEDED(ok->set_valignment(xaml_valignment_center));
+    XAML_ASSERT_SUCCEEDED(xaml_grid_set_column(body, 1));
+    XAML_ASSERT_SUCCEEDED(xaml_grid_set_row(body, 1));
+    XAML_ASSERT_SUCCEEDED(body->set_halignment(xaml_halignment_right));
+    CHECK_OK(grid->add_child(title));
+    CHECK_OK(grid->add_child(ok));
+    CHECK_OK(grid->add_child(body));
+    CHECK_OK(grid->draw({ 0, 0, 400, 300 }));
+    // The auto column fits the button, and the auto row fits the tallest child.
+    CHECK((rect_of(title) == xaml_rectangle{ 0, 0, 381, 21 }));
+    CHECK((rect_of(ok) == xaml_rectangle{ 381, 0, 19, 21 }));
+    CHECK((rect_of(body) == xaml_rectangle{ 353, 21, 28, 279 }));
+}
+
+static void test_uniform_grid()
+{
+    xaml_ptr<xaml_uniform_grid> grid;
+    XAML_ASSERT_SUCCEEDED(xaml_uniform_grid_new(&grid));
+    XAML_ASSERT_SUCCEEDED(grid->set_columns(2));
+    xaml_ptr<xaml_label> labels[3];
+    for (auto& label : labels)
+    {
+        label = make_label("x");
+        CHECK_OK(grid->add_child(label));
+    }
+    CHECK_OK(grid->draw({ 0, 0, 100, 60 }));
+    CHECK((rect_of(labels[0]) == xaml_rectangle{ 0, 0, 50, 30 }));
+    CHECK((rect_of(labels[1]) == xaml_rectangle{ 50, 0, 50, 30 }));
+    CHECK((rect_of(labels[2]) == xaml_rectangle{ 0, 30, 50, 30 }));
+}
+
+static void test_window()
+{
+    xaml_ptr<xaml_window> window;
+    XAML_ASSERT_SUCCEEDED(xaml_window_new(&window));
+    XAML_ASSERT_SUCCEEDED(window->set_size({ 320, 240 }));
+    xaml_ptr<xaml_stack_panel> panel;
+    XAML_ASSERT_SUCCEEDED(xaml_stack_panel_new(&panel));
+    XAML_ASSERT_SUCCEEDED(panel->set_orientation(xaml_orientation_vertical));
+    auto a = make_label("a");
+    auto b = make_label("b");
+    CHECK_OK(panel->add_child(a));
+    CHECK_OK(panel->add_child(b));
+    XAML_ASSERT_SUCCEEDED(window->set_child(panel));
+    CHECK_OK(window->show());
+    CHECK((rect_of(panel) == xaml_rectangle{ 0, 0, 320, 240 }));
+    CHECK((rect_of(b) == xaml_rectangle{ 0, 16, 320, 16 }));
+    int32_t arranged = widget_of(b)->arrange_count;
+
+    // The changes are laid out once, on the next turn of the loop.
+    XAML_ASSERT_SUCCEEDED(a->set_margin({ 0, 10, 0, 0 }));
+    xaml_ptr<xaml_string> text;
+    XAML_ASSERT_SUCCEEDED(xaml_string_new_view(U("changed"), &text));
+    XAML_ASSERT_SUCCEEDED(a->set_text(text));
+    XAML_ASSERT_SUCCEEDED(b->set_text(text));
+    CHECK(widget_of(b)->arrange_count == arranged);
+    CHECK_OK(xaml_headless_process_events(0));
+    CHECK(widget_of(b)->arrange_count == arranged + 1);
+    CHECK((rect_of(b) == xaml_rectangle{ 0, 26, 320, 16 }));
+
+    XAML_ASSERT_SUCCEEDED(window->set_size({ 100, 50 }));
+    CHECK_OK(xaml_headless_process_events(0));
+    CHECK((rect_of(panel) == xaml_rectangle{ 0, 0, 100, 50 }));
+    CHECK_OK(window->close());
+}
+
+static void test_timer()
+{
+    xaml_ptr<xaml_timer> timer;
+    XAML_ASSERT_SUCCEEDED(xaml_timer_new_interval(100, &timer));
+    int ticks = 0;
+    xaml_ptr<xaml_delegate<xaml_object, xaml_event_args>> callback;
+    XAML_ASSERT_SUCCEEDED((xaml_delegate_new(
+        [&ticks](xaml_object*, xaml_event_args*) noexcept -> xaml_result {
+            ticks++;
+            return XAML_S_OK;
+        },
+        &callback)));
+    int32_t token;
+    XAML_ASSERT_SUCCEEDED(timer->add_tick(callback, &token));
+    int64_t start;
+    CHECK_OK(xaml_headless_get_clock(&start));
+    CHECK_OK(timer->start());
+    CHECK_OK(xaml_headless_process_events(250));
+    CHECK(ticks == 2);
+    CHECK_OK(timer->stop());
+    CHECK_OK(xaml_headless_process_events(1000));
+    CHECK(ticks == 2);
+    int64_t end;
+    CHECK_OK(xaml_headless_get_clock(&end));
+    CHECK(end - start == 1250);
+
+    // Restarting at once leaves a single schedule.
+    CHECK_OK(timer->start());
+    CHECK_OK(timer->stop());
+    CHECK_OK(timer->start());
+    CHECK_OK(xaml_headless_process_events(250));
+    CHECK(ticks == 4);
+    CHECK_OK(timer->stop());
+
+    // Timers share the wheel, and each keeps its own interval.
+    vector<xaml_ptr<xaml_timer>> timers;
+    int counts[3]{};
+    for (int i = 0; i < 3; i++)
+    {
+        xaml_ptr<xaml_timer> t;
+        XAML_ASSERT_SUCCEEDED(xaml_timer_new_interval(30 * (i + 1), &t));
+        int* pcount = &counts[i];
+        xaml_ptr<xaml_delegate<xaml_object, xaml_event_args>> cb;
+        XAML_ASSERT_SUCCEEDED((xaml_delegate_new(
+            [pcount](xaml_object*, xaml_event_args*) noexcept -> xaml_result {
+                (*pcount)++;
+                return XAML_S_OK;
+            },
+            &cb)));
+        XAML_ASSERT_SUCCEEDED(t->add_tick(cb, &token));
+        CHECK_OK(t->start());
+        timers.push_back(t);
+    }
+    CHECK_OK(xaml_headless_process_events(185));
+    CHECK(ticks == 4);
+    CHECK(counts[0] == 6 && counts[1] == 3 && counts[2] == 2);
+    timers.clear();
+    CHECK_OK(xaml_headless_process_events(1000));
+    CHECK(counts[0] == 6 && counts[1] == 3 && counts[2] == 2);
+}
+
+// Provides markup extensions for a property of the element itself.
+struct test_markup_context : xaml_implement<test_markup_context, xaml_markup_context>
+{
+    xaml_ptr<xaml_object> m_element;
+    xaml_ptr<xaml_string> m_prop;
+
+    test_markup_context(xaml_ptr<xaml_object> const& element, xaml_ptr<xaml_string> const& prop) noexcept
+        : m_element(element), m_prop(prop) {}
+
+    xaml_result XAML_CALL get_current_element(xaml_object** ptr) noexcept override { return m_element.query(ptr); }
+    xaml_result XAML_CALL get_current_object(xaml_object** ptr) noexcept override { return m_element.query(ptr); }
+    xaml_result XAML_CALL get_current_property(xaml_string** ptr) noexcept override { return m_prop.query(ptr); }
+    xaml_result XAML_CALL find_element(xaml_string*, xaml_object**) noexcept override { return XAML_E_KEYNOTFOUND; }
+};
+
+static xaml_ptr<xaml_string> make_string(char const* str)
+{
+    xaml_ptr<xaml_string> result;
+    XAML_ASSERT_SUCCEEDED(xaml_string_new_view(str, &result));
+    return result;
+}
+
+static bool text_is(xaml_label* label, string_view expected)
+{
+    xaml_ptr<xaml_string> text;
+    XAML_ASSERT_SUCCEEDED(label->get_text(&text));
+    string_view view;
+    XAML_ASSERT_SUCCEEDED(to_string_view(text, &view));
+    return view == expected;
+}
+
+static void test_dynamic_resource()
+{
+    xaml_ptr<xaml_meta_context> ctx;
+    XAML_ASSERT_SUCCEEDED(xaml_meta_context_new(&ctx));
+    XAML_ASSERT_SUCCEEDED(xaml_label_register(ctx));
+    xaml_ptr<xaml_grid> outer, inner, other;
+    XAML_ASSERT_SUCCEEDED(xaml_grid_new(&outer));
+    XAML_ASSERT_SUCCEEDED(xaml_grid_new(&inner));
+    XAML_ASSERT_SUCCEEDED(xaml_grid_new(&other));
+    XAML_ASSERT_SUCCEEDED(outer->add_child(inner));
+    auto label = make_label("");
+    XAML_ASSERT_SUCCEEDED(inner->add_child(label));
+    auto key = make_string("text");
+    CHECK_OK(outer->add_resource(key, make_string("first")));
+
+    xaml_ptr<xaml_dynamic_resource> res;
+    XAML_ASSERT_SUCCEEDED(xaml_dynamic_resource_new(&res));
+    XAML_ASSERT_SUCCEEDED(res->set_key(key));
+    xaml_ptr<xaml_markup_context> mkctx;
+    XAML_ASSERT_SUCCEEDED(xaml_object_new<test_markup_context>(&mkctx, label, make_string("text")));
+    CHECK_OK(res->provide(ctx, mkctx));
+    CHECK(text_is(label, "first"));
+    // Providing again watches the same property once.
+    CHECK_OK(res->provide(ctx, mkctx));
+    CHECK(text_is(label, "first"));
+    CHECK_OK(outer->add_resource(make_string("unrelated"), make_string("none")));
+    CHECK(text_is(label, "first"));
+
+    // Changes in the chain are applied to the property.
+    CHECK_OK(outer->add_resource(key, make_string("second")));
+    CHECK(text_is(label, "second"));
+    CHECK_OK(inner->add_resource(key, make_string("third")));
+    CHECK(text_is(label, "third"));
+    CHECK_OK(other->add_resource(key, make_string("fourth")));
+    CHECK(text_is(label, "third"));
+
+    // So is a move to another tree.
+    CHECK_OK(inner->remove_child(label));
+    CHECK(text_is(label, "third"));
+    CHECK_OK(other->add_child(label));
+    CHECK(text_is(label, "fourth"));
+}
+
+// Creates a label for a string, and counts the labels.
+struct test_label_converter : xaml_implement<test_label_converter, xaml_converter>
+{
+    int* m_count;
+
+    test_label_converter(int* count) noexcept : m_count(count) {}
+
+    xaml_result XAML_CALL convert(xaml_object* value, xaml_guid const&, xaml_object*, xaml_string*, xaml_object** ptr) noexcept override
+    {
+        (*m_count)++;
+        xaml_ptr<xaml_label> label;
+        XAML_RETURN_IF_FAILED(xaml_label_new(&label));
+        XAML_RETURN_IF_FAILED(label->set_text(xaml_ptr<xaml_object>{ value }.query<xaml_string>()));
+        return label->query(ptr);
+    }
+
+    xaml_result XAML_CALL convert_back(xaml_object*, xaml_guid const&, xaml_object*, xaml_string*, xaml_object**) noexcept override
+    {
+        return XAML_E_NOTIMPL;
+    }
+};
+
+static xaml_ptr<xaml_data_template> make_label_template(int* count, bool pooled)
+{
+    xaml_ptr<xaml_data_template> t;
+    XAML_ASSERT_SUCCEEDED(xaml_data_template_new(&t));
+    xaml_ptr<xaml_converter> conv;
+    XAML_ASSERT_SUCCEEDED(xaml_object_new<test_label_converter>(&conv, count));
+    XAML_ASSERT_SUCCEEDED(t->set_converter(conv));
+    if (pooled)
+    {
+        xaml_ptr<xaml_delegate<xaml_object, xaml_object>> binder;
+        XAML_ASSERT_SUCCEEDED((xaml_delegate_new(
+            [](xaml_object* obj, xaml_object* value) noexcept -> xaml_result {
+                xaml_ptr<xaml_label> label;
+                XAML_RETURN_IF_FAILED(obj->query(&label));
+                return label->set_text(xaml_ptr<xaml_object>{ value }.query<xaml_string>());
+            },
+            &binder)));
+        XAML_ASSERT_SUCCEEDED(t->set_binder(binder));
+    }
+    return t;
+}
+
+static xaml_ptr<xaml_virtualizing_stack_panel> make_items_panel(int32_t count, xaml_template_base* t)
+{
+    xaml_ptr<xaml_observable_vector<xaml_object>> items;
+    XAML_ASSERT_SUCCEEDED(xaml_observable_vector_new(&items));
+    for (int32_t i = 0; i < count; i++)
+    {
+        xaml_ptr<xaml_string> str;
+        XAML_ASSERT_SUCCEEDED(xaml_string_new("item " + to_string(i), &str));
+        XAML_ASSERT_SUCCEEDED(items->append(str));
+    }
+    xaml_ptr<xaml_virtualizing_stack_panel> panel;
+    XAML_ASSERT_SUCCEEDED(xaml_virtualizing_stack_panel_new(&panel));
+    XAML_ASSERT_SUCCEEDED(panel->set_items_template(t));
+    XAML_ASSERT_SUCCEEDED(panel->set_items(items));
+    XAML_ASSERT_SUCCEEDED(panel->draw({ 0, 0, 200, 400 }));
+    return panel;
+}
+
+// Scrolls through the items, a viewport at a time, until the end.
+// The items are a line of 16 pixels high each.
+static void scroll_through(xaml_virtualizing_stack_panel* panel, int32_t count)
+{
+    for (double offset = 400; offset < count * 16.0; offset += 400)
+    {
+        XAML_ASSERT_SUCCEEDED(panel->set_offset(offset));
+    }
+}
+
+static void test_data_template_pool()
+{
+    int created = 0;
+    auto t = make_label_template(&created, true);
+    auto panel = make_items_panel(1000, t);
+    int first = created;
+    CHECK(first > 0);
+    scroll_through(panel, 1000);
+    // The containers scrolled out are bound to the new items.
+    int64_t hits, misses;
+    CHECK_OK(t->get_pool_stats(&hits, &misses));
+    CHECK(misses == created);
+    CHECK(hits > 0 && created < 2 * first);
+
+    // Nothing is kept beyond the limit.
+    int limited = 0;
+    auto l = make_label_template(&limited, true);
+    XAML_ASSERT_SUCCEEDED(l->set_pool_limit(0));
+    auto panel3 = make_items_panel(1000, l);
+    scroll_through(panel3, 1000);
+    CHECK_OK(l->get_pool_stats(&hits, &misses));
+    CHECK(hits == 0 && misses == limited && limited > created);
+
+    // Without a binder nothing is pooled.
+    int unpooled = 0;
+    auto u = make_label_template(&unpooled, false);
+    auto panel2 = make_items_panel(1000, u);
+    scroll_through(panel2, 1000);
+    CHECK_OK(u->get_pool_stats(&hits, &misses));
+    CHECK(hits == 0 && misses == 0 && unpooled > created);
+
+    // Without a converter the data is its own object, so it is never pooled or bound to other data.
+    int bound = 0;
+    auto b = make_label_template(&bound, true);
+    XAML_ASSERT_SUCCEEDED(b->set_converter(nullptr));
+    auto first_label = make_label("first");
+    auto second_label = make_label("second");
+    xaml_ptr<xaml_object> obj;
+    CHECK_OK(b->create(first_label, &obj));
+    CHECK(obj.get() == first_label.get());
+    CHECK_OK(b->recycle(first_label, obj));
+    CHECK_OK(b->create(second_label, &obj));
+    CHECK(obj.get() == second_label.get());
+    CHECK(text_is(first_label, "first") && text_is(second_label, "second"));
+    CHECK_OK(b->get_pool_stats(&hits, &misses));
+    CHECK(hits == 0 && misses == 0 && bound == 0);
+}
+
+// A grid of labels, measured and arranged as a whole.
+static void bench()
+{
+    constexpr int32_t size = 32;
+    xaml_ptr<xaml_grid> grid;
+    XAML_ASSERT_SUCCEEDED(xaml_grid_new(&grid));
+    for (int32_t i = 0; i < size; i++)
+    {
+        XAML_ASSERT_SUCCEEDED(grid->add_column({ 0, xaml_grid_layout_auto }));
+        XAML_ASSERT_SUCCEEDED(grid->add_row({ 1, xaml_grid_layout_star }));
+    }
+    for (int32_t i = 0; i < size * size; i++)
+    {
+        auto label = make_label(i % 3 ? "label" : "a longer label");
+        XAML_ASSERT_SUCCEEDED(xaml_grid_set_column(label, i % size));
+        XAML_ASSERT_SUCCEEDED(xaml_grid_set_row(label, i / size));
+        XAML_ASSERT_SUCCEEDED(grid->add_child(label));
+    }
+    constexpr int rounds = 100;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++)
+    {
+        XAML_ASSERT_SUCCEEDED(grid->draw({ 0, 0, 1920, 1080 }));
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << size * size << " children: " << seconds / rounds * 1e6 << " us/layout" << endl;
+}
+
+// 10k items churned through a virtualizing panel, with and without recycling.
+static void bench_items()
+{
+    constexpr int32_t count = 10000;
+    for (bool pooled : { false, true })
+    {
+        int created = 0;
+        auto t = make_label_template(&created, pooled);
+        auto start = chrono::steady_clock::now();
+        auto panel = make_items_panel(count, t);
+        scroll_through(panel, count);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        int64_t hits, misses;
+        XAML_ASSERT_SUCCEEDED(t->get_pool_stats(&hits, &misses));
+        cout << count << " items" << (pooled ? " pooled: " : ": ") << seconds * 1e3 << " ms, " << created << " created";
+        if (pooled) cout << ", " << (hits * 100.0 / (hits + misses)) << "% hits";
+        cout << endl;
+    }
+}
+
+int main()
+{
+    xaml_ptr<xaml_application> app;
+    XAML_ASSERT_SUCCEEDED(xaml_application_init(&app));
+    test_stack_panel();
+    test_grid();
+    test_uniform_grid();
+    test_window();
+    test_timer();
+    test_dynamic_resource();
+    test_data_template_pool();
+    bench();
+    bench_items();
+    return report_failures();
+}
@@ -0,0 +1,108 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <xaml/ui/application.h>
+#include <xaml/ui/controls/canvas.h>
+#include <xaml/ui/timer.h>
+#include <xaml/ui/window.h>
+
+namespace colors
+{
+#include <xaml/ui/colors.h>
+}
+
+using namespace std;
+
+// A canvas full of short strings, redrawn a number of times.
+// Prints the time of a redraw and the counters of the text cache.
+
+static constexpr int columns = 20;
+static constexpr int rows = 60;
+static constexpr int frames = 50;
+
+struct bench_state
+{
+    vector<xaml_ptr<xaml_string>> texts{};
+    xaml_ptr<xaml_solid_brush> brush{};
+    xaml_ptr<xaml_canvas> canvas{};
+    xaml_ptr<xaml_timer> timer{};
+    int frame{ 0 };
+    double seconds{ 0 };
+};
+
+static xaml_result on_redraw(bench_state& state, xaml_drawing_context* dc) noexcept
+{
+    auto start = chrono::steady_clock::now();
+    xaml_drawing_font fonts[] = {
+        { U("Arial"), 12, false, false, xaml_halignment_left, xaml_valignment_top },
+        { U("Arial"), 12, false, true, xaml_halignment_center, xaml_valignment_top },
+        { U("Arial"), 14, true, false, xaml_halignment_right, xaml_valignment_top },
+    };
+    for (int i = 0; i < columns * rows; i++)
+    {
+        auto& text = state.texts[i % state.texts.size()];
+        auto& font = fonts[i % size(fonts)];
+        xaml_point p{ 40.0 * (i % columns) + 20, 10.0 * (i / columns) };
+        xaml_rectangle rect;
+        XAML_RETURN_IF_FAILED(dc->measure_string(font, p, text, &rect));
+        XAML_RETURN_IF_FAILED(dc->draw_string(state.brush, font, p, text));
+    }
+    state.seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    state.frame++;
+    return XAML_S_OK;
+}
+
+static xaml_result on_tick(bench_state& state) noexcept
+{
+    if (state.frame < frames)
+    {
+        return state.canvas->invalidate();
+    }
+    XAML_RETURN_IF_FAILED(state.timer->stop());
+    int64_t hits, misses;
+    XAML_RETURN_IF_FAILED(xaml_drawing_text_cache_get_stats(&hits, &misses));
+    cout << columns * rows << " strings: " << state.seconds / state.frame * 1e3 << " ms/redraw" << endl;
+    cout << "text cache: " << hits << " hit(s), " << misses << " miss(es)." << endl;
+    xaml_ptr<xaml_application> app;
+    XAML_RETURN_IF_FAILED(xaml_application_current(&app));
+    return app->quit(0);
+}
+
+xaml_result XAML_CALL xaml_main(xaml_application*) noexcept
+{
+    static bench_state state{};
+    for (int i = 0; i < 300; i++)
+    {
+        xaml_ptr<xaml_string> text;
+        XAML_RETURN_IF_FAILED(xaml_string_new(to_string(i * 7919 % 100000).c_str(), &text));
+        state.texts.push_back(text);
+    }
+    XAML_RETURN_IF_FAILED(xaml_solid_brush_new(colors::black, &state.brush));
+
+    xaml_ptr<xaml_window> window;
+    XAML_RETURN_IF_FAILED(xaml_window_new(&window));
+    XAML_RETURN_IF_FAILED(window->set_size({ 800, 600 }));
+    XAML_RETURN_IF_FAILED(xaml_canvas_new(&state.canvas));
+    {
+        xaml_ptr<xaml_delegate<xaml_object, xaml_drawing_context>> callback;
+        XAML_RETURN_IF_FAILED((xaml_delegate_new(
+            [](xaml_object*, xaml_drawing_context* dc) noexcept { return on_redraw(state, dc); },
+            &callback)));
+        int32_t token;
+        XAML_RETURN_IF_FAILED(state.canvas->add_redraw(callback, &token));
+    }
+    XAML_RETURN_IF_FAILED(window->set_child(state.canvas));
+
+    XAML_RETURN_IF_FAILED(xaml_timer_new_interval(10, &state.timer));
+    {
+        xaml_ptr<xaml_delegate<xaml_object, xaml_event_args>> callback;
+        XAML_RETURN_IF_FAILED((xaml_delegate_new(
+            [](xaml_object*, xaml_event_args*) noexcept { return on_tick(state); },
+            &callback)));
+        int32_t token;
+        XAML_RETURN_IF_FAILED(state.timer->add_tick(callback, &token));
+    }
+    XAML_RETURN_IF_FAILED(window->show());
+    return state.timer->start();
+}
@@ -0,0 +1,95 @@
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <shared/virtualizing_layout.hpp>
+#include <test_check.hpp>
+#include <vector>
+
+using namespace std;
+
+static bool approx(double lhs, double rhs) { return abs(lhs - rhs) < 1e-6; }
+
+static void test_estimate()
+{
+    xaml_virtualizing_extents extents;
+    extents.set_default_size(10);
+    extents.reset(100);
+    CHECK(approx(extents.extent(), 1000));
+    CHECK(extents.index_at(95) == 9);
+    CHECK(extents.index_at(-5) == 0);
+    CHECK(extents.index_at(5000) == 99);
+
+    // The unmeasured items take the average of the measured ones.
+    extents.set_size(0, 20);
+    extents.set_size(1, 40);
+    CHECK(approx(extents.estimate(), 30));
+    CHECK(approx(extents.offset(2), 60));
+    CHECK(approx(extents.offset(3), 90));
+    CHECK(approx(extents.extent(), 60 + 98 * 30));
+    CHECK(extents.index_at(59) == 1 && extents.index_at(60) == 2);
+
+    extents.invalidate(1);
+    CHECK(!extents.is_measured(1));
+    CHECK(approx(extents.offset(2), 40));
+
+    // The measured lengths move with the items.
+    extents.insert(0, 2);
+    CHECK(extents.count() == 102 && extents.is_measured(2) && !extents.is_measured(0));
+    CHECK(approx(extents.offset(3), 60));
+    extents.erase(0, 3);
+    CHECK(extents.count() == 99 && !extents.is_measured(0));
+    CHECK(approx(extents.extent(), 99 * 10));
+
+    extents.reset(0);
+    CHECK(extents.count() == 0 && approx(extents.extent(), 0));
+}
+
+// Compares the offsets with a plain prefix sum.
+static void test_equivalence()
+{
+    mt19937 rnd{ 42 };
+    uniform_real_distribution<double> length{ 0, 50 };
+    for (int n = 1; n < 200; n += 7)
+    {
+        xaml_virtualizing_extents extents;
+        extents.reset(n);
+        vector<double> sizes(n, -1);
+        uniform_int_distribution<int> index{ 0, n - 1 };
+        for (int i = 0; i < n; i++)
+        {
+            int k = index(rnd);
+            sizes[k] = length(rnd);
+            extents.set_size(k, sizes[k]);
+        }
+        double total = 0;
+        int count = 0;
+        for (double s : sizes)
+        {
+            if (s >= 0)
+            {
+                total += s;
+                count++;
+            }
+        }
+        double estimate = count ? total / count : extents.default_size();
+        double offset = 0;
+        for (int i = 0; i < n; i++)
+        {
+            if (!approx(extents.offset(i), offset))
+            {
+                cout << "Mismatch in extents " << n << " item " << i << endl;
+                failures++;
+                break;
+            }
+            offset += sizes[i] >= 0 ? sizes[i] : estimate;
+        }
+        CHECK(approx(extents.extent(), offset));
+    }
+}
+
+int main()
+{
+    test_estimate();
+    test_equivalence();
+    return report_failures();
+}
@@ -57,6 +57,11 @@ XAML_DELEGATE_2_TYPE(XAML_T_O(xaml_object), XAML_T_O(xaml_string))
 XAML_DELEGATE_2_TYPE(XAML_T_O(xaml_object), XAML_T_O(xaml_webview_resource_requested_args))
 #endif // !xaml_delegate_2__xaml_object__xaml_webview_resource_requested_args_defined
 
+// The scheme of the URIs served without a network stack, as xaml-res://<any host>/<path>.
+// The path is looked up in the resource root of the webview if set, and then in the embedded resources.
+// Only served by the GTK3 backend now.
+#define XAML_WEBVIEW_RESOURCE_SCHEME "xaml-res"
+
 XAML_CLASS(xaml_webview, { 0xb39028bb, 0xc65f, 0x4df9, { 0xa0, 0xef, 0xf2, 0x04, 0x30, 0x77, 0x40, 0xda } })
 
 #define XAML_WEBVIEW_VTBL(type)                              \
@@ -67,7 +72,8 @@ XAML_CLASS(xaml_webview, { 0xb39028bb, 0xc65f, 0x4df9, { 0xa0, 0xef, 0xf2, 0x04,
     XAML_METHOD(get_can_go_back, type, bool*);               \
     XAML_METHOD(go_forward, type);                           \
     XAML_METHOD(go_back, type);                              \
-    XAML_EVENT(resource_requested, type, xaml_object, xaml_webview_resource_requested_args)
+    XAML_EVENT(resource_requested, type, xaml_object, xaml_webview_resource_requested_args); \
+    XAML_PROP(resource_root, type, xaml_string**, xaml_string*)
 
 XAML_DECL_INTERFACE_(xaml_webview, xaml_control)
 {
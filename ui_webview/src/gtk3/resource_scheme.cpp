@@ -0,0 +1,254 @@
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <glib/gstdio.h>
+#include <gtk3/resource_scheme.hpp>
+#include <gtk3/resources.hpp>
+#include <optional>
+#include <shared/http_range.hpp>
+#include <shared/webview.hpp>
+#include <string>
+#include <sys/stat.h>
+#include <unordered_map>
+#include <xaml/resource/resource.h>
+
+using namespace std;
+
+using g_bytes_unique_ptr = unique_ptr<GBytes, g_free_deleter<GBytes, ::g_bytes_unref>>;
+using g_mapped_file_unique_ptr = unique_ptr<GMappedFile, g_free_deleter<GMappedFile, ::g_mapped_file_unref>>;
+
+static constexpr char const s_view_key[] = "xaml-webview-internal";
+static constexpr char const s_context_key[] = "xaml-webview-resource-scheme";
+
+// The types a page needs exactly, which the shared MIME database may guess otherwise.
+static constexpr pair<string_view, char const*> s_mime_types[] = {
+    { ".html", "text/html" },
+    { ".htm", "text/html" },
+    { ".css", "text/css" },
+    { ".js", "text/javascript" },
+    { ".mjs", "text/javascript" },
+    { ".json", "application/json" },
+    { ".wasm", "application/wasm" },
+    { ".svg", "image/svg+xml" },
+    { ".png", "image/png" },
+    { ".jpg", "image/jpeg" },
+    { ".jpeg", "image/jpeg" },
+    { ".gif", "image/gif" },
+    { ".webp", "image/webp" },
+    { ".ico", "image/vnd.microsoft.icon" },
+    { ".woff", "font/woff" },
+    { ".woff2", "font/woff2" },
+    { ".ttf", "font/ttf" },
+    { ".mp4", "video/mp4" },
+    { ".webm", "video/webm" },
+    { ".mp3", "audio/mpeg" },
+    { ".txt", "text/plain" },
+    { ".xml", "application/xml" },
+};
+
+// The content of a resource, referred without copying.
+struct xaml_webview_resource_content
+{
+    g_bytes_unique_ptr bytes;
+    string etag;
+};
+
+static string get_mime_type(string const& key, GBytes* bytes) noexcept
+{
+    string_view view = key;
+    for (auto& [ext, type] : s_mime_types)
+    {
+        if (view.size() >= ext.size() && view.substr(view.size() - ext.size()) == ext) return type;
+    }
+    gsize size;
+    gconstpointer data = g_bytes_get_data(bytes, &size);
+    g_free_unique_ptr<gchar> content_type{ g_content_type_guess(key.c_str(), static_cast<guchar const*>(data), (min)(size, gsize{ 4096 }), nullptr) };
+    g_free_unique_ptr<gchar> mime_type{ g_content_type_get_mime_type(content_type.get()) };
+    return mime_type ? mime_type.get() : "application/octet-stream";
+}
+
+// The path of the URI without the leading slash, which could not escape the root.
+static optional<string> get_resource_key(char const* path) noexcept
+{
+    // An escaped slash would be ambiguous.
+    g_free_unique_ptr<gchar> unescaped{ g_uri_unescape_string(path ? path : "", "/") };
+    if (!unescaped) return nullopt;
+    string key = unescaped.get();
+    size_t start = key.find_first_not_of('/');
+    key.erase(0, start == string::npos ? key.size() : start);
+    if (key.empty() || key.back() == '/') key += "index.html";
+    for (size_t begin = 0; begin < key.size();)
+    {
+        size_t end = key.find('/', begin);
+        if (end == string::npos) end = key.size();
+        string_view segment{ key.data() + begin, end - begin };
+        if (segment == "." || segment == "..") return nullopt;
+        begin = end + 1;
+    }
+    return key;
+}
+
+static string format_etag(uint64_t value, uint64_t size) noexcept
+{
+    char buffer[40];
+    snprintf(buffer, sizeof(buffer), "\"%" PRIx64 "-%" PRIx64 "\"", value, size);
+    return buffer;
+}
+
+// Maps the file under the root, tagged by the time it is modified.
+static bool load_file(char const* root, string const& key, xaml_webview_resource_content* content) noexcept
+{
+    g_free_unique_ptr<gchar> file{ g_build_filename(root, key.c_str(), nullptr) };
+    GStatBuf st;
+    if (g_stat(file.get(), &st) || !S_ISREG(st.st_mode)) return false;
+    g_mapped_file_unique_ptr mapped{ g_mapped_file_new(file.get(), FALSE, nullptr) };
+    if (!mapped) return false;
+    content->bytes.reset(g_mapped_file_get_bytes(mapped.get()));
+    content->etag = format_etag(static_cast<uint64_t>(st.st_mtime), static_cast<uint64_t>(st.st_size));
+    return true;
+}
+
+// Refers the resource embedded by xamlrc, tagged by its hash.
+// The generated code registers the lookup, so nothing is found if the application embeds nothing.
+static bool load_embedded(string const& key, xaml_webview_resource_content* content) noexcept
+{
+    xaml_ptr<xaml_string> path;
+    if (XAML_FAILED(xaml_string_new_view(key.c_str(), &path))) return false;
+    void const* data;
+    int64_t size;
+    if (XAML_FAILED(xaml_resource_find_hashed(path, xaml_resource_hash(key.data(), key.size()), &data, &size))) return false;
+    // The embedded resources never change, so the hashes are computed once.
+    // All requests are handled on the main thread.
+    static unordered_map<void const*, string> s_etags{};
+    auto it = s_etags.find(data);
+    if (it == s_etags.end())
+    {
+        it = s_etags.emplace(data, format_etag(xaml_resource_hash(static_cast<char const*>(data), static_cast<size_t>(size)), static_cast<uint64_t>(size))).first;
+    }
+    content->bytes.reset(g_bytes_new_static(data, static_cast<gsize>(size)));
+    content->etag = it->second;
+    return true;
+}
+
+static void finish_request(WebKitURISchemeRequest* request, xaml_webview_resource_content& content, string const& mime_type) noexcept
+{
+#if WEBKIT_CHECK_VERSION(2, 36, 0)
+    SoupMessageHeaders* request_headers = webkit_uri_scheme_request_get_http_headers(request);
+    char const* if_none_match = request_headers ? soup_message_headers_get_one(request_headers, "If-None-Match") : nullptr;
+    char const* range_header = request_headers ? soup_message_headers_get_one(request_headers, "Range") : nullptr;
+
+    uint64_t size = g_bytes_get_size(content.bytes.get());
+    SoupMessageHeaders* headers = soup_message_headers_new(SOUP_MESSAGE_HEADERS_RESPONSE);
+    soup_message_headers_append(headers, "ETag", content.etag.c_str());
+    // Revalidated every time, which costs only a hash lookup or a stat.
+    soup_message_headers_append(headers, "Cache-Control", "no-cache");
+    soup_message_headers_append(headers, "Accept-Ranges", "bytes");
+
+    guint status = 200;
+    char const* reason = "OK";
+    g_bytes_unique_ptr body;
+    char content_range[64];
+    if (if_none_match && xaml_http_match_etag(if_none_match, content.etag))
+    {
+        status = 304;
+        reason = "Not Modified";
+        body.reset(g_bytes_new_static(nullptr, 0));
+    }
+    else
+    {
+        xaml_http_range range;
+        switch (range_header ? xaml_http_parse_range(range_header, size, &range) : xaml_http_range_result::full)
+        {
+        case xaml_http_range_result::partial:
+            status = 206;
+            reason = "Partial Content";
+            snprintf(content_range, sizeof(content_range), "bytes %" PRIu64 "-%" PRIu64 "/%" PRIu64, range.offset, range.offset + range.length - 1, size);
+            soup_message_headers_append(headers, "Content-Range", content_range);
+            body.reset(g_bytes_new_from_bytes(content.bytes.get(), range.offset, range.length));
+            break;
+        case xaml_http_range_result::unsatisfiable:
+            status = 416;
+            reason = "Range Not Satisfiable";
+            snprintf(content_range, sizeof(content_range), "bytes */%" PRIu64, size);
+            soup_message_headers_append(headers, "Content-Range", content_range);
+            body.reset(g_bytes_new_static(nullptr, 0));
+            break;
+        default:
+            body = move(content.bytes);
+            break;
+        }
+    }
+
+    g_object_unique_ptr<GInputStream> stream{ g_memory_input_stream_new_from_bytes(body.get()) };
+    WebKitURISchemeResponse* response = webkit_uri_scheme_response_new(stream.get(), static_cast<gint64>(g_bytes_get_size(body.get())));
+    webkit_uri_scheme_response_set_status(response, status, reason);
+    webkit_uri_scheme_response_set_content_type(response, mime_type.c_str());
+    // The response takes the headers.
+    webkit_uri_scheme_response_set_http_headers(response, headers);
+    webkit_uri_scheme_request_finish_with_response(request, response);
+    g_object_unref(response);
+#else
+    // Without the responses, neither the headers nor the ranges are supported.
+    g_object_unique_ptr<GInputStream> stream{ g_memory_input_stream_new_from_bytes(content.bytes.get()) };
+    webkit_uri_scheme_request_finish(request, stream.get(), static_cast<gint64>(g_bytes_get_size(content.bytes.get())), mime_type.c_str());
+#endif // WEBKIT_CHECK_VERSION(2, 36, 0)
+}
+
+static void on_request(WebKitURISchemeRequest* request, gpointer) noexcept
+{
+    xaml_webview_internal* self = nullptr;
+    if (WebKitWebView* view = webkit_uri_scheme_request_get_web_view(request))
+    {
+        self = static_cast<xaml_webview_internal*>(g_object_get_data(G_OBJECT(view), s_view_key));
+    }
+
+    xaml_webview_resource_content content{};
+    bool found = false;
+    bool embedded = false;
+    optional<string> key = get_resource_key(webkit_uri_scheme_request_get_path(request));
+    if (key)
+    {
+        char const* root = nullptr;
+        if (self && self->m_resource_root && XAML_SUCCEEDED(self->m_resource_root->get_data(&root)))
+        {
+            found = load_file(root, *key, &content);
+        }
+        if (!found)
+        {
+            found = embedded = load_embedded(*key, &content);
+        }
+    }
+    if (!found)
+    {
+        GError* error = g_error_new(G_IO_ERROR, G_IO_ERROR_NOT_FOUND, "%s is not found.", webkit_uri_scheme_request_get_uri(request));
+        webkit_uri_scheme_request_finish_error(request, error);
+        g_error_free(error);
+        return;
+    }
+
+    string mime_type = get_mime_type(*key, content.bytes.get());
+    // xamlrc terminates the text files with a zero, which is not a part of the page.
+    gsize size = g_bytes_get_size(content.bytes.get());
+    if (embedded && size > 0 && (mime_type.starts_with("text/") || mime_type.ends_with("xml")))
+    {
+        gconstpointer data = g_bytes_get_data(content.bytes.get(), nullptr);
+        if (static_cast<char const*>(data)[size - 1] == '\0')
+        {
+            content.bytes.reset(g_bytes_new_static(data, size - 1));
+        }
+    }
+    finish_request(request, content, mime_type);
+}
+
+void xaml_webview_resource_scheme_attach(WebKitWebView* view, xaml_webview_internal* self) noexcept
+{
+    g_object_set_data(G_OBJECT(view), s_view_key, self);
+    WebKitWebContext* context = webkit_web_view_get_context(view);
+    if (g_object_get_data(G_OBJECT(context), s_context_key)) return;
+    g_object_set_data(G_OBJECT(context), s_context_key, GINT_TO_POINTER(TRUE));
+    webkit_web_context_register_uri_scheme(context, XAML_WEBVIEW_RESOURCE_SCHEME, on_request, nullptr, nullptr);
+    // The pages are local, and fetch each other like those from one origin.
+    WebKitSecurityManager* security = webkit_web_context_get_security_manager(context);
+    webkit_security_manager_register_uri_scheme_as_secure(security, XAML_WEBVIEW_RESOURCE_SCHEME);
+    webkit_security_manager_register_uri_scheme_as_cors_enabled(security, XAML_WEBVIEW_RESOURCE_SCHEME);
+}
@@ -0,0 +1,12 @@
+#ifndef XAML_UI_WEBVIEW_GTK3_RESOURCE_SCHEME_HPP
+#define XAML_UI_WEBVIEW_GTK3_RESOURCE_SCHEME_HPP
+
+#include <webkit2/webkit2.h>
+
+struct xaml_webview_internal;
+
+// Registers XAML_WEBVIEW_RESOURCE_SCHEME to the context once,
+// and lets the requests from the view find the resource root of the webview.
+void xaml_webview_resource_scheme_attach(WebKitWebView* view, xaml_webview_internal* self) noexcept;
+
+#endif // !XAML_UI_WEBVIEW_GTK3_RESOURCE_SCHEME_HPP
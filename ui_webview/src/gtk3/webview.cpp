@@ -1,3 +1,4 @@
+#include <gtk3/resource_scheme.hpp>
 #include <shared/atomic_guard.hpp>
 #include <shared/webview.hpp>
 #include <xaml/ui/controls/webview.h>
@@ -9,6 +10,7 @@ xaml_result xaml_webview_internal::draw(const xaml_rectangle& region) noexcept
     if (!m_handle)
     {
         m_handle = webkit_web_view_new();
+        xaml_webview_resource_scheme_attach(WEBKIT_WEB_VIEW(m_handle), this);
         g_signal_connect(G_OBJECT(m_handle), "load-changed", G_CALLBACK(xaml_webview_internal::on_load_changed), this);
         XAML_RETURN_IF_FAILED(draw_visible());
         XAML_RETURN_IF_FAILED(draw_uri());
@@ -0,0 +1,96 @@
+#ifndef XAML_UI_WEBVIEW_SHARED_HTTP_RANGE_HPP
+#define XAML_UI_WEBVIEW_SHARED_HTTP_RANGE_HPP
+
+#include <charconv>
+#include <cstdint>
+#include <string_view>
+
+enum class xaml_http_range_result
+{
+    full,
+    partial,
+    unsatisfiable
+};
+
+struct xaml_http_range
+{
+    std::uint64_t offset;
+    std::uint64_t length;
+};
+
+inline std::string_view xaml_http_trim(std::string_view str) noexcept
+{
+    while (!str.empty() && (str.front() == ' ' || str.front() == '\t')) str.remove_prefix(1);
+    while (!str.empty() && (str.back() == ' ' || str.back() == '\t')) str.remove_suffix(1);
+    return str;
+}
+
+inline bool xaml_http_parse_uint(std::string_view str, std::uint64_t* pvalue) noexcept
+{
+    if (str.empty()) return false;
+    auto [end, ec] = std::from_chars(str.data(), str.data() + str.size(), *pvalue);
+    return ec == std::errc{} && end == str.data() + str.size();
+}
+
+// Parses the Range header of a request for a content of the size.
+// Only a single range of bytes is served partially, and the full content is served for the others.
+inline xaml_http_range_result xaml_http_parse_range(std::string_view header, std::uint64_t size, xaml_http_range* range) noexcept
+{
+    *range = { 0, size };
+    constexpr std::string_view unit = "bytes=";
+    header = xaml_http_trim(header);
+    if (header.substr(0, unit.size()) != unit) return xaml_http_range_result::full;
+    header.remove_prefix(unit.size());
+    if (header.find(',') != std::string_view::npos) return xaml_http_range_result::full;
+    std::size_t dash = header.find('-');
+    if (dash == std::string_view::npos) return xaml_http_range_result::full;
+    std::string_view first = xaml_http_trim(header.substr(0, dash));
+    std::string_view last = xaml_http_trim(header.substr(dash + 1));
+    if (first.empty())
+    {
+        // The last bytes of the given length.
+        std::uint64_t length;
+        if (!xaml_http_parse_uint(last, &length)) return xaml_http_range_result::full;
+        if (length == 0 || size == 0) return xaml_http_range_result::unsatisfiable;
+        if (length > size) length = size;
+        *range = { size - length, length };
+        return xaml_http_range_result::partial;
+    }
+    std::uint64_t begin;
+    if (!xaml_http_parse_uint(first, &begin)) return xaml_http_range_result::full;
+    std::uint64_t end;
+    if (last.empty())
+    {
+        end = UINT64_MAX;
+    }
+    else if (!xaml_http_parse_uint(last, &end) || end < begin)
+    {
+        return xaml_http_range_result::full;
+    }
+    if (begin >= size) return xaml_http_range_result::unsatisfiable;
+    if (end >= size) end = size - 1;
+    *range = { begin, end - begin + 1 };
+    return xaml_http_range_result::partial;
+}
+
+// Tells whether an If-None-Match header matches the entity tag, by the weak comparison.
+inline bool xaml_http_match_etag(std::string_view header, std::string_view etag) noexcept
+{
+    auto strip = [](std::string_view tag) {
+        tag = xaml_http_trim(tag);
+        if (tag.substr(0, 2) == "W/") tag.remove_prefix(2);
+        return tag;
+    };
+    etag = strip(etag);
+    while (!header.empty())
+    {
+        std::size_t comma = header.find(',');
+        std::string_view tag = strip(header.substr(0, comma));
+        if (tag == "*" || tag == etag) return true;
+        if (comma == std::string_view::npos) break;
+        header.remove_prefix(comma + 1);
+    }
+    return false;
+}
+
+#endif // !XAML_UI_WEBVIEW_SHARED_HTTP_RANGE_HPP
@@ -33,6 +33,7 @@ xaml_result XAML_CALL xaml_webview_members(xaml_type_info_registration* __info)
     using self_type = xaml_webview;
     XAML_TYPE_INFO_ADD_PROP_EVENT(uri, xaml_string);
     XAML_TYPE_INFO_ADD_EVENT(resource_requested);
+    XAML_TYPE_INFO_ADD_PROP(resource_root, xaml_string);
     return XAML_S_OK;
 }
 
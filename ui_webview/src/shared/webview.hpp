@@ -20,6 +20,8 @@ struct xaml_webview_internal : xaml_control_internal
 
     XAML_EVENT_IMPL(resource_requested, xaml_object, xaml_webview_resource_requested_args)
 
+    XAML_PROP_PTR_IMPL(resource_root, xaml_string)
+
     xaml_result XAML_CALL get_can_go_forward(bool*) noexcept;
     xaml_result XAML_CALL get_can_go_back(bool*) noexcept;
 
@@ -59,6 +61,7 @@ struct xaml_webview_impl : xaml_control_implement<xaml_webview_impl, xaml_webvie
     XAML_PROP_INTERNAL_IMPL_BASE(can_go_forward, bool*)
     XAML_PROP_INTERNAL_IMPL_BASE(can_go_back, bool*)
     XAML_EVENT_INTERNAL_IMPL(resource_requested, xaml_object, xaml_webview_resource_requested_args)
+    XAML_PROP_PTR_INTERNAL_IMPL(resource_root, xaml_string)
 
     xaml_result XAML_CALL go_forward() noexcept override { return m_internal.go_forward(); }
     xaml_result XAML_CALL go_back() noexcept override { return m_internal.go_back(); }
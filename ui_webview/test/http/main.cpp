@@ -0,0 +1,79 @@
+#include <shared/http_range.hpp>
+#include <test_check.hpp>
+
+using namespace std;
+
+static bool is_partial(string_view header, uint64_t size, uint64_t offset, uint64_t length)
+{
+    xaml_http_range range;
+    return xaml_http_parse_range(header, size, &range) == xaml_http_range_result::partial && range.offset == offset && range.length == length;
+}
+
+static bool is_full(string_view header, uint64_t size)
+{
+    xaml_http_range range;
+    return xaml_http_parse_range(header, size, &range) == xaml_http_range_result::full && range.offset == 0 && range.length == size;
+}
+
+static bool is_unsatisfiable(string_view header, uint64_t size)
+{
+    xaml_http_range range;
+    return xaml_http_parse_range(header, size, &range) == xaml_http_range_result::unsatisfiable;
+}
+
+static void test_parse_range()
+{
+    CHECK(is_partial("bytes=0-99", 1000, 0, 100));
+    CHECK(is_partial(" bytes=10 - 19 ", 1000, 10, 10));
+    // Open ended, and clamped to the content.
+    CHECK(is_partial("bytes=900-", 1000, 900, 100));
+    CHECK(is_partial("bytes=900-5000", 1000, 900, 100));
+    CHECK(is_partial("bytes=999-999", 1000, 999, 1));
+    // The last bytes.
+    CHECK(is_partial("bytes=-100", 1000, 900, 100));
+    CHECK(is_partial("bytes=-5000", 1000, 0, 1000));
+
+    CHECK(is_unsatisfiable("bytes=1000-", 1000));
+    CHECK(is_unsatisfiable("bytes=2000-3000", 1000));
+    CHECK(is_unsatisfiable("bytes=-0", 1000));
+    CHECK(is_unsatisfiable("bytes=-10", 0));
+    CHECK(is_unsatisfiable("bytes=0-", 0));
+
+    // The others are served fully.
+    CHECK(is_full("", 1000));
+    CHECK(is_full("items=0-99", 1000));
+    CHECK(is_full("bytes=0-9,20-29", 1000));
+    CHECK(is_full("bytes=100", 1000));
+    CHECK(is_full("bytes=20-10", 1000));
+    CHECK(is_full("bytes=a-10", 1000));
+    CHECK(is_full("bytes=10-b", 1000));
+    CHECK(is_full("bytes=-", 1000));
+    CHECK(is_full("bytes=+1-2", 1000));
+    CHECK(is_full("bytes=99999999999999999999-", 1000));
+}
+
+static void test_match_etag()
+{
+    constexpr string_view etag = "\"5f-10\"";
+    CHECK(xaml_http_match_etag("\"5f-10\"", etag));
+    CHECK(xaml_http_match_etag(" \"5f-10\" ", etag));
+    CHECK(xaml_http_match_etag("*", etag));
+    // The comparison is weak.
+    CHECK(xaml_http_match_etag("W/\"5f-10\"", etag));
+    CHECK(xaml_http_match_etag("\"5f-10\"", "W/\"5f-10\""));
+    CHECK(xaml_http_match_etag("\"1-1\", \"5f-10\"", etag));
+    CHECK(xaml_http_match_etag("\"1-1\",W/\"5f-10\",\"2-2\"", etag));
+
+    CHECK(!xaml_http_match_etag("", etag));
+    CHECK(!xaml_http_match_etag("\"5f-11\"", etag));
+    CHECK(!xaml_http_match_etag("5f-10", etag));
+    CHECK(!xaml_http_match_etag("\"1-1\", \"2-2\"", etag));
+    CHECK(!xaml_http_match_etag(",", etag));
+}
+
+int main()
+{
+    test_parse_range();
+    test_match_etag();
+    return report_failures();
+}